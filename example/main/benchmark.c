@@ -0,0 +1,560 @@
+/**
+ * @file benchmark.c
+ * @brief Overhead benchmark mode for the sysmon example.
+ *
+ * This file implements the phases described in benchmark.h: a synthetic load
+ * of worker tasks with allocation churn, lowest-priority spinner tasks that
+ * measure the CPU left over, HTTP client tasks that request the API endpoints
+ * over loopback, and a sample callback that records the sampler's wake-up
+ * latency and work time. Everything is reported on the log when phase 3 ends.
+ */
+
+// Project-specific includes
+#include "benchmark.h"
+#include "sysmon.h"
+#include "sysmon_stack.h"
+
+// ESP-IDF includes
+#include "esp_heap_caps.h"
+#include "esp_http_client.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "benchmark"
+
+#define BENCHMARK_TASK_STACK_SIZE   (4 * 1024)
+#define BENCHMARK_TASK_PRIORITY     5
+
+#define BENCHMARK_PHASE_COUNT       3
+
+/**
+ * @brief Latencies of one series, the newest BENCHMARK_LATENCY_SAMPLES kept.
+ *
+ * Members:
+ * - values : Latency ring in microseconds.
+ * - count  : Values recorded in the phase (the ring holds the newest of them).
+ * - max    : Largest value recorded in the phase.
+ */
+typedef struct
+{
+    uint32_t values[BENCHMARK_LATENCY_SAMPLES];
+    uint32_t count;
+    uint32_t max;
+} latency_series_t;
+
+/**
+ * @brief Client-side statistics of one endpoint.
+ *
+ * Members:
+ * - uri      : Endpoint path.
+ * - failures : Requests that failed or did not return 200.
+ * - bytes    : Response body bytes received.
+ * - time     : Response times.
+ */
+typedef struct
+{
+    const char *uri;
+    uint32_t failures;
+    uint64_t bytes;
+    latency_series_t time;
+} endpoint_stats_t;
+
+/**
+ * @brief Measurements of one phase.
+ *
+ * Members:
+ * - spin           : Spinner loop count per core.
+ * - duration_us    : Phase length.
+ * - dram_free      : Free DRAM at the end of the phase.
+ * - dram_min_free  : Lowest free DRAM since boot at the end of the phase.
+ * - sampler_cpu    : Mean sampler task CPU usage reported by sysmon.
+ */
+typedef struct
+{
+    uint32_t spin[portNUM_PROCESSORS];
+    int64_t duration_us;
+    size_t dram_free;
+    size_t dram_min_free;
+    float sampler_cpu;
+} phase_result_t;
+
+static endpoint_stats_t s_endpoints[] =
+{
+    { .uri = "/telemetry" },
+    { .uri = "/tasks" },
+    { .uri = "/history" },
+    { .uri = "/telemetry.bin" },
+    { .uri = "/history.bin" },
+};
+#define BENCHMARK_ENDPOINT_COUNT (sizeof(s_endpoints) / sizeof(s_endpoints[0]))
+
+static const char *s_phase_names[BENCHMARK_PHASE_COUNT] = { "sysmon off", "sysmon on", "sysmon loaded" };
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static volatile uint32_t s_spin_count[portNUM_PROCESSORS];
+static volatile bool s_clients_run = false;
+static latency_series_t s_sampler_latency;
+static latency_series_t s_sampler_work;
+static float s_sampler_cpu_sum = 0.0f;
+static volatile int s_clients_active = 0;
+static TaskHandle_t s_workers[BENCHMARK_TASK_COUNT];
+
+// ============================================================================
+// Measurement Helpers
+// ============================================================================
+
+/**
+ * @brief Record one latency (caller holds s_lock).
+ *
+ * @param series Series to add to.
+ * @param value_us Latency in microseconds.
+ */
+static void _latency_add(latency_series_t *series, uint32_t value_us)
+{
+    series->values[series->count % BENCHMARK_LATENCY_SAMPLES] = value_us;
+    series->count++;
+    if (value_us > series->max)
+    {
+        series->max = value_us;
+    }
+}
+
+/**
+ * @brief qsort() comparator for uint32_t values.
+ *
+ * @param a First value.
+ * @param b Second value.
+ * @return Negative, zero or positive as a is below, equal to or above b.
+ */
+static int _compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Log the percentiles of a latency series.
+ *
+ * @param label Series name.
+ * @param series Series (copied under s_lock, then sorted).
+ */
+static void _latency_report(const char *label, const latency_series_t *series)
+{
+    static uint32_t sorted[BENCHMARK_LATENCY_SAMPLES];
+
+    portENTER_CRITICAL(&s_lock);
+    uint32_t count = series->count;
+    uint32_t kept = (count < BENCHMARK_LATENCY_SAMPLES) ? count : BENCHMARK_LATENCY_SAMPLES;
+    uint32_t max = series->max;
+    memcpy(sorted, series->values, kept * sizeof(uint32_t));
+    portEXIT_CRITICAL(&s_lock);
+
+    if (kept == 0)
+    {
+        ESP_LOGI(LOG_TAG, "  %-16s no samples", label);
+        return;
+    }
+    qsort(sorted, kept, sizeof(uint32_t), _compare_u32);
+    ESP_LOGI(LOG_TAG, "  %-16s n=%-6" PRIu32 " p50=%-7" PRIu32 " p90=%-7" PRIu32 " p99=%-7" PRIu32 " max=%" PRIu32 " us",
+             label, count, sorted[kept / 2], sorted[(kept * 9) / 10], sorted[(kept * 99) / 100], max);
+}
+
+/**
+ * @brief Sample callback recording the sampler's own latency and work time.
+ *
+ * @param snapshot Snapshot of the new sample.
+ * @param arg Unused.
+ */
+static void _on_sample(const sysmon_snapshot_t *snapshot, void *arg)
+{
+    sysmon_summary_t summary;
+    if (sysmon_snapshot_summary(snapshot, &summary) != ESP_OK)
+    {
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    _latency_add(&s_sampler_latency, summary.sampler_latency_us);
+    _latency_add(&s_sampler_work, summary.sampler_work_us);
+    s_sampler_cpu_sum += summary.sampler_cpu_percent;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+/**
+ * @brief Clear the statistics collected during a phase.
+ */
+static void _reset_statistics(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    memset(&s_sampler_latency, 0, sizeof(s_sampler_latency));
+    memset(&s_sampler_work, 0, sizeof(s_sampler_work));
+    s_sampler_cpu_sum = 0.0f;
+    for (size_t i = 0; i < BENCHMARK_ENDPOINT_COUNT; i++)
+    {
+        s_endpoints[i].failures = 0;
+        s_endpoints[i].bytes = 0;
+        memset(&s_endpoints[i].time, 0, sizeof(s_endpoints[i].time));
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// ============================================================================
+// Load Tasks
+// ============================================================================
+
+/**
+ * @brief Spinner counting loops at idle priority, one per core.
+ *
+ * Runs at tskIDLE_PRIORITY, so it only gets the CPU nothing else wants and
+ * still lets the idle task feed the task watchdog.
+ *
+ * @param param Core index (cast to a pointer).
+ */
+static void _spinner_task(void *param)
+{
+    int core = (int)(intptr_t)param;
+    for (;;)
+    {
+        volatile uint32_t work = 0;
+        for (int i = 0; i < 100; i++)
+        {
+            work += (uint32_t)i * 7U;
+        }
+        s_spin_count[core]++;
+    }
+}
+
+/**
+ * @brief Worker burning a little CPU and churning the heap every period.
+ *
+ * @param param Unused task parameter.
+ */
+static void _worker_task(void *param)
+{
+    void *blocks[BENCHMARK_CHURN_ALLOCS];
+    TickType_t last_wake = xTaskGetTickCount();
+    for (;;)
+    {
+        int64_t busy_until = esp_timer_get_time() + BENCHMARK_WORKER_BUSY_US;
+        while (esp_timer_get_time() < busy_until)
+        {
+        }
+
+        for (int i = 0; i < BENCHMARK_CHURN_ALLOCS; i++)
+        {
+            blocks[i] = malloc(1 + esp_random() % BENCHMARK_CHURN_MAX_BYTES);
+        }
+        for (int i = 0; i < BENCHMARK_CHURN_ALLOCS; i++)
+        {
+            free(blocks[i]);
+        }
+
+        xTaskDelayUntil(&last_wake, pdMS_TO_TICKS(BENCHMARK_WORKER_PERIOD_MS));
+    }
+}
+
+/**
+ * @brief HTTP client event handler counting response body bytes.
+ *
+ * @param event Client event (user_data points to a byte counter).
+ * @return ESP_OK.
+ */
+static esp_err_t _client_event_handler(esp_http_client_event_t *event)
+{
+    if (event->event_id == HTTP_EVENT_ON_DATA)
+    {
+        *(uint32_t *)event->user_data += (uint32_t)event->data_len;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Client requesting the endpoints over loopback, back to back, while s_clients_run is set.
+ *
+ * @param param Client index (cast to a pointer), which selects the first endpoint.
+ */
+static void _client_task(void *param)
+{
+    size_t next = (size_t)(intptr_t)param % BENCHMARK_ENDPOINT_COUNT;
+    uint32_t body_bytes = 0;
+    char url[64];
+
+    snprintf(url, sizeof(url), "http://127.0.0.1:%d/", CONFIG_SYSMON_HTTPD_SERVER_PORT);
+    esp_http_client_config_t config =
+    {
+        .url           = url,
+        .timeout_ms    = 5000,
+        .event_handler = _client_event_handler,
+        .user_data     = &body_bytes,
+    };
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+
+    while (s_clients_run && client != NULL)
+    {
+        endpoint_stats_t *endpoint = &s_endpoints[next];
+        next = (next + 1) % BENCHMARK_ENDPOINT_COUNT;
+
+        snprintf(url, sizeof(url), "http://127.0.0.1:%d%s", CONFIG_SYSMON_HTTPD_SERVER_PORT, endpoint->uri);
+        esp_http_client_set_url(client, url);
+        body_bytes = 0;
+        int64_t start_us = esp_timer_get_time();
+        esp_err_t err = esp_http_client_perform(client);
+        uint32_t time_us = (uint32_t)(esp_timer_get_time() - start_us);
+        bool ok = (err == ESP_OK && esp_http_client_get_status_code(client) == 200);
+
+        portENTER_CRITICAL(&s_lock);
+        if (ok)
+        {
+            endpoint->bytes += body_bytes;
+            _latency_add(&endpoint->time, time_us);
+        }
+        else
+        {
+            endpoint->failures++;
+        }
+        portEXIT_CRITICAL(&s_lock);
+
+        if (!ok)
+        {
+            // Back off so a refused connection does not spin
+            vTaskDelay(pdMS_TO_TICKS(100));
+        }
+    }
+
+    if (client != NULL)
+    {
+        esp_http_client_cleanup(client);
+    }
+    portENTER_CRITICAL(&s_lock);
+    s_clients_active--;
+    portEXIT_CRITICAL(&s_lock);
+    vTaskDelete(NULL);
+}
+
+// ============================================================================
+// Phases and Report
+// ============================================================================
+
+/**
+ * @brief Run one phase and record its measurements.
+ *
+ * @param result Output measurements.
+ */
+static void _run_phase(phase_result_t *result)
+{
+    uint32_t spin_start[portNUM_PROCESSORS];
+    for (int core = 0; core < portNUM_PROCESSORS; core++)
+    {
+        spin_start[core] = s_spin_count[core];
+    }
+    int64_t start_us = esp_timer_get_time();
+
+    vTaskDelay(pdMS_TO_TICKS(BENCHMARK_PHASE_S * 1000));
+
+    result->duration_us = esp_timer_get_time() - start_us;
+    for (int core = 0; core < portNUM_PROCESSORS; core++)
+    {
+        result->spin[core] = s_spin_count[core] - spin_start[core];
+    }
+    result->dram_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    result->dram_min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+
+    portENTER_CRITICAL(&s_lock);
+    uint32_t samples = s_sampler_latency.count;
+    result->sampler_cpu = (samples > 0) ? s_sampler_cpu_sum / (float)samples : 0.0f;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+/**
+ * @brief Log the statistics collected during a phase.
+ *
+ * @param phase Phase index.
+ * @param results Measurements of all phases so far.
+ */
+static void _report_phase(int phase, const phase_result_t *results)
+{
+    const phase_result_t *baseline = &results[0];
+    const phase_result_t *result = &results[phase];
+
+    ESP_LOGI(LOG_TAG, "Phase %d (%s), %" PRId64 " ms:", phase + 1, s_phase_names[phase], result->duration_us / 1000);
+    for (int core = 0; core < portNUM_PROCESSORS; core++)
+    {
+        // Spinner rate against the baseline rate is the CPU left over
+        double rate = (double)result->spin[core] / (double)result->duration_us;
+        double baseline_rate = (double)baseline->spin[core] / (double)baseline->duration_us;
+        double taken = (baseline_rate > 0.0) ? 100.0 * (1.0 - rate / baseline_rate) : 0.0;
+        ESP_LOGI(LOG_TAG, "  core %d           CPU taken vs phase 1: %.2f%%", core, taken);
+    }
+    ESP_LOGI(LOG_TAG, "  DRAM             free %u, lowest since boot %u", (unsigned)result->dram_free,
+             (unsigned)result->dram_min_free);
+    if (phase == 0)
+    {
+        return;
+    }
+
+    ESP_LOGI(LOG_TAG, "  sampler task CPU %.2f%% (mean reported by sysmon)", result->sampler_cpu);
+    _latency_report("sampler latency", &s_sampler_latency);
+    _latency_report("sampler work", &s_sampler_work);
+    if (phase != 2)
+    {
+        return;
+    }
+    for (size_t i = 0; i < BENCHMARK_ENDPOINT_COUNT; i++)
+    {
+        endpoint_stats_t *endpoint = &s_endpoints[i];
+        _latency_report(endpoint->uri, &endpoint->time);
+
+        portENTER_CRITICAL(&s_lock);
+        uint32_t ok = endpoint->time.count;
+        uint32_t failures = endpoint->failures;
+        uint64_t bytes = endpoint->bytes;
+        portEXIT_CRITICAL(&s_lock);
+        ESP_LOGI(LOG_TAG, "  %-16s %" PRIu32 " failed, %u bytes per response", "",
+                 failures, (unsigned)(ok > 0 ? bytes / ok : 0));
+    }
+}
+
+/**
+ * @brief Create the workers and spinners, then run and report the three phases.
+ *
+ * @param param Unused task parameter.
+ */
+static void _benchmark_task(void *param)
+{
+    static phase_result_t results[BENCHMARK_PHASE_COUNT];
+
+    ESP_LOGI(LOG_TAG, "Benchmark: %d workers (%d ms period, %d us busy, %d allocs up to %d bytes), "
+             "%d clients, %d s per phase",
+             BENCHMARK_TASK_COUNT, BENCHMARK_WORKER_PERIOD_MS, BENCHMARK_WORKER_BUSY_US, BENCHMARK_CHURN_ALLOCS,
+             BENCHMARK_CHURN_MAX_BYTES, BENCHMARK_CLIENTS, BENCHMARK_PHASE_S);
+
+    for (int core = 0; core < portNUM_PROCESSORS; core++)
+    {
+        char name[configMAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "bench_spin%d", core);
+        xTaskCreatePinnedToCore(_spinner_task, name, 1536, (void *)(intptr_t)core, tskIDLE_PRIORITY, NULL, core);
+    }
+
+    int workers = 0;
+    for (int i = 0; i < BENCHMARK_TASK_COUNT; i++)
+    {
+        char name[configMAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "bench_w%03d", i);
+        if (xTaskCreate(_worker_task, name, BENCHMARK_WORKER_STACK_SIZE, NULL, BENCHMARK_WORKER_PRIORITY,
+                        &s_workers[workers]) != pdPASS)
+        {
+            ESP_LOGW(LOG_TAG, "Created %d of %d workers (out of memory)", workers, BENCHMARK_TASK_COUNT);
+            break;
+        }
+        workers++;
+    }
+
+    // Phase 1: load only
+    _run_phase(&results[0]);
+    _report_phase(0, results);
+    size_t free_before_init = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+
+    // Phase 2: sampler running (both 0 keeps the Kconfig defaults)
+    if (sysmon_set_sampling(BENCHMARK_INTERVAL_MS, BENCHMARK_SAMPLE_COUNT) != ESP_OK)
+    {
+        ESP_LOGW(LOG_TAG, "Sampling %d ms x %d samples out of range, using the defaults",
+                 BENCHMARK_INTERVAL_MS, BENCHMARK_SAMPLE_COUNT);
+    }
+    esp_err_t err = sysmon_init();
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(LOG_TAG, "sysmon_init() failed: %s (0x%x)", esp_err_to_name(err), err);
+        vTaskDelete(NULL);
+    }
+    for (int i = 0; i < workers; i++)
+    {
+        sysmon_stack_register(s_workers[i], BENCHMARK_WORKER_STACK_SIZE);
+    }
+    sysmon_subscribe(_on_sample, NULL);
+    // The sampler applies the queued change at its first sample; report what it runs with
+    uint32_t interval_ms = 0;
+    uint32_t sample_count = 0;
+    TickType_t wait_start = xTaskGetTickCount();
+    while (sysmon_get_sampling(&interval_ms, &sample_count))
+    {
+        if (xTaskGetTickCount() - wait_start >= pdMS_TO_TICKS(BENCHMARK_SAMPLING_WAIT_MS))
+        {
+            ESP_LOGW(LOG_TAG, "Sampling change not applied after %d ms, continuing with %" PRIu32 " ms x %" PRIu32
+                     " samples", BENCHMARK_SAMPLING_WAIT_MS, interval_ms, sample_count);
+            break;
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    // Let the first samples publish, so the snapshot buffers count as resident
+    vTaskDelay(pdMS_TO_TICKS(interval_ms * 2));
+    _reset_statistics();
+    _run_phase(&results[1]);
+    _report_phase(1, results);
+
+    // Phase 3: sampler and HTTP clients
+    _reset_statistics();
+    s_clients_run = true;
+    for (int i = 0; i < BENCHMARK_CLIENTS; i++)
+    {
+        char name[configMAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "bench_http%d", i);
+        portENTER_CRITICAL(&s_lock);
+        s_clients_active++;
+        portEXIT_CRITICAL(&s_lock);
+        if (xTaskCreate(_client_task, name, BENCHMARK_CLIENT_STACK_SIZE, (void *)(intptr_t)i,
+                        BENCHMARK_CLIENT_PRIORITY, NULL) != pdPASS)
+        {
+            ESP_LOGW(LOG_TAG, "Failed to create HTTP client %d", i);
+            portENTER_CRITICAL(&s_lock);
+            s_clients_active--;
+            portEXIT_CRITICAL(&s_lock);
+        }
+    }
+    _run_phase(&results[2]);
+    s_clients_run = false;
+    _report_phase(2, results);
+
+    ESP_LOGI(LOG_TAG, "Cost summary: %d tasks monitored, %" PRIu32 " ms x %" PRIu32 " samples", workers,
+             interval_ms, sample_count);
+    ESP_LOGI(LOG_TAG, "  heap resident    %d bytes (free before sysmon_init() minus free in phase 2)",
+             (int)free_before_init - (int)results[1].dram_free);
+    ESP_LOGI(LOG_TAG, "  heap high water  %d bytes (lowest free in phase 1 minus lowest free in phase 3)",
+             (int)results[0].dram_min_free - (int)results[2].dram_min_free);
+
+    // Wait for the clients to finish their last request; sysmon and the load keep running
+    while (s_clients_active > 0)
+    {
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    sysmon_unsubscribe(_on_sample, NULL);
+    ESP_LOGI(LOG_TAG, "Benchmark done");
+    vTaskDelete(NULL);
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+/**
+ * @brief Start the benchmark task.
+ */
+void benchmark_start(void)
+{
+    if (xTaskCreate(_benchmark_task, "bench_main", BENCHMARK_TASK_STACK_SIZE, NULL, BENCHMARK_TASK_PRIORITY,
+                    NULL) != pdPASS)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to create benchmark task");
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+/**
+ * @file benchmark.h
+ * @brief Overhead benchmark mode for the sysmon example.
+ *
+ * Enable it by defining EXAMPLE_BENCHMARK in main.c. Instead of the demo tasks
+ * the example then starts a synthetic load and measures what sysmon costs in
+ * three phases of BENCHMARK_PHASE_S seconds each:
+ *
+ *   1. sysmon off    : worker tasks and allocation churn only (the baseline).
+ *   2. sysmon on     : the same load with the sampler running, no HTTP clients.
+ *   3. sysmon loaded : as 2, plus BENCHMARK_CLIENTS tasks requesting the API
+ *                      endpoints over loopback, back to back.
+ *
+ * CPU cost is read from one lowest-priority spinner task per core: the work it
+ * gets through in a phase, against phase 1, is the CPU share the phase took
+ * away. Phase 3 includes the client tasks, which run on the same device; set
+ * BENCHMARK_CLIENTS to 0 and drive the endpoints from a PC to see the server
+ * side alone. The report (on the log) adds sampler wake-up latency and work
+ * time percentiles, response time percentiles per endpoint, and the resident
+ * and high-water heap cost.
+ *
+ * Change the settings below here, or override them for the component with
+ * target_compile_definitions() in main/CMakeLists.txt.
+ */
+
+// Worker tasks created (each costs BENCHMARK_WORKER_STACK_SIZE bytes of stack)
+#ifndef BENCHMARK_TASK_COUNT
+#define BENCHMARK_TASK_COUNT 32
+#endif
+
+// Worker period, busy time per period and allocation churn per period
+#ifndef BENCHMARK_WORKER_PERIOD_MS
+#define BENCHMARK_WORKER_PERIOD_MS 50
+#endif
+#ifndef BENCHMARK_WORKER_BUSY_US
+#define BENCHMARK_WORKER_BUSY_US 200
+#endif
+#ifndef BENCHMARK_CHURN_ALLOCS
+#define BENCHMARK_CHURN_ALLOCS 4
+#endif
+#ifndef BENCHMARK_CHURN_MAX_BYTES
+#define BENCHMARK_CHURN_MAX_BYTES 512
+#endif
+#define BENCHMARK_WORKER_STACK_SIZE (2 * 1024)
+#define BENCHMARK_WORKER_PRIORITY   2
+
+// Concurrent HTTP clients in phase 3 (0 = no on-device clients)
+#ifndef BENCHMARK_CLIENTS
+#define BENCHMARK_CLIENTS 4
+#endif
+#define BENCHMARK_CLIENT_STACK_SIZE (4 * 1024)
+#define BENCHMARK_CLIENT_PRIORITY   4
+
+// Length of each phase
+#ifndef BENCHMARK_PHASE_S
+#define BENCHMARK_PHASE_S 30
+#endif
+
+// Sampling configuration applied before sysmon_init() (0 = Kconfig default)
+#ifndef BENCHMARK_INTERVAL_MS
+#define BENCHMARK_INTERVAL_MS 0
+#endif
+#ifndef BENCHMARK_SAMPLE_COUNT
+#define BENCHMARK_SAMPLE_COUNT 0
+#endif
+
+// Longest wait for the sampler to apply that configuration before phase 2 starts anyway
+#ifndef BENCHMARK_SAMPLING_WAIT_MS
+#define BENCHMARK_SAMPLING_WAIT_MS 5000
+#endif
+
+// Newest latencies kept per series for the percentiles
+#ifndef BENCHMARK_LATENCY_SAMPLES
+#define BENCHMARK_LATENCY_SAMPLES 512
+#endif
+
+/**
+ * @brief Start the benchmark task.
+ *
+ * Call instead of sysmon_init(): the benchmark initializes sysmon itself at
+ * the start of phase 2 and leaves it running when the report is done.
+ */
+void benchmark_start(void);
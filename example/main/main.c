@@ -15,6 +15,7 @@
  *     - Task lifecycle manager (creates/deletes cycle tasks)
  *     - RGB LED strip color cycling task
  *   - Register all tasks with sysmon for stack usage tracking.
+ *   - Optionally run the overhead benchmark instead (EXAMPLE_BENCHMARK, see benchmark.h).
  *
  * Dependencies:
  *   - ESP-IDF WiFi, networking, and FreeRTOS APIs.
@@ -28,7 +29,9 @@
  */
 
 // Project-specific includes
+#include "benchmark.h"
 #include "sysmon.h"
+#include "sysmon_custom.h"
 #include "sysmon_stack.h"
 
 // ESP-IDF includes
@@ -51,6 +54,9 @@
 // #define WIFI_PASSWORD "YOUR_WIFI_PASSWORD"
 #include "wifi_credentials.h"
 
+// Uncomment to measure sysmon's overhead instead of running the demo tasks (see benchmark.h)
+// #define EXAMPLE_BENCHMARK
+
 /*
  * NO-OP FUNCTIONS FOR WHEN SYSMON COMPONENT IS DISABLED
  *
@@ -233,6 +239,7 @@ static void rgb_led_cycle_task(void *param)
  * minimum and maximum load percentages over a configurable cycle time.
  * The task alternates between busy-wait loops and idle delays to simulate
  * realistic CPU usage patterns. Used for testing system monitoring capabilities.
+ * The target load and the number of load steps are published as custom metrics.
  *
  * @param param Unused task parameter.
  *
@@ -248,6 +255,9 @@ static void demo_sine_wave_task(void *param)
     ESP_LOGI(LOG_TAG, "Demo sine wave task: Core %d, sine-wave fake load (%.0f–%.0f%%, %lus cycle)",
              xPortGetCoreID(), minLoad * 100.0f, maxLoad * 100.0f, cycleMs / 1000);
 
+    sysmon_metric_handle_t loadMetric = sysmon_metric_register("sine_load_pct", SYSMON_METRIC_GAUGE);
+    sysmon_metric_handle_t stepMetric = sysmon_metric_register("sine_steps", SYSMON_METRIC_COUNTER);
+
     TickType_t startCycle = xTaskGetTickCount();
 
     for (;;)
@@ -261,6 +271,8 @@ static void demo_sine_wave_task(void *param)
 
         uint32_t busyMs = (uint32_t)(stepMs * loadFrac);
         uint32_t idleMs = stepMs - busyMs;
+        sysmon_metric_set(loadMetric, (int32_t)(loadFrac * 100.0f));
+        sysmon_metric_add(stepMetric, 1);
 
         TickType_t t0 = xTaskGetTickCount();
         while ((pdTICKS_TO_MS(xTaskGetTickCount() - t0)) < busyMs)
@@ -429,6 +441,12 @@ void app_main(void)
         ESP_LOGE("MAIN", "WiFi connection failed: %s (0x%x)", esp_err_to_name(wifi_err), wifi_err);
     }
 
+#ifdef EXAMPLE_BENCHMARK
+    // The benchmark starts sysmon itself, after measuring the load without it
+    benchmark_start();
+    return;
+#endif
+
     esp_err_t sysmon_err = sysmon_init();
     if (sysmon_err != ESP_OK)
     {
@@ -0,0 +1,503 @@
+/**
+ * @file sysmon_bench.c
+ * @brief Host benchmark of the sysmon sampler and HTTP encoders.
+ *
+ * Runs the unmodified sysmon sources against the host shims and sweeps the
+ * reported task count and the history depth. For every combination it
+ * initializes sysmon, fills the history window, then measures:
+ *   - sample       : sampler CPU time per sample (the whole sysmon_monitor
+ *                    loop body: task scan, memory stats, rollups, stack
+ *                    alerts, heap profile, snapshot publish).
+ *   - sample+push  : the same with one WebSocket subscriber (binary encode
+ *                    and send of every sample).
+ *   - one row per endpoint: CPU time of the handler, response bytes and chunks.
+ * Every row also reports the bytes allocated per operation and the peak heap
+ * above the process baseline taken before sysmon_init() (so it includes the
+ * history window). The init row times sysmon_init(); its heap columns also
+ * cover filling the window.
+ *
+ * Usage: sysmon_bench [--tasks=a,b,...] [--depths=a,b,...] [--interval=ms]
+ *                     [--samples=n] [--repeat=n] [--csv] [--verbose]
+ */
+
+// Project-specific includes
+#include "sysmon.h"
+#include "sysmon_custom.h"
+#include "sysmon_host.h"
+#include "sysmon_stack.h"
+
+// ESP-IDF includes
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MAX_LIST      16
+#define BENCH_DELTA_SAMPLES 10     // '/history?since=' asks for this many new samples
+#define BENCH_METRIC_COUNT  4
+
+/**
+ * @brief Command line options.
+ *
+ * Members:
+ * - task_counts, task_count_len   : Reported task counts to sweep (sysmon's own tasks included).
+ * - depths, depth_len             : History depths to sweep (raised to sysmon_get_min_sample_count()).
+ * - interval_ms                   : Sampling interval.
+ * - samples                       : Measured samples per case.
+ * - repeat                        : Requests per endpoint per case.
+ * - csv                           : Print CSV instead of a table.
+ */
+typedef struct
+{
+    uint32_t task_counts[BENCH_MAX_LIST];
+    int task_count_len;
+    uint32_t depths[BENCH_MAX_LIST];
+    int depth_len;
+    uint32_t interval_ms;
+    uint32_t samples;
+    uint32_t repeat;
+    bool csv;
+} bench_options_t;
+
+/**
+ * @brief One measured row.
+ *
+ * Members:
+ * - item        : Row name.
+ * - ns          : CPU nanoseconds per operation.
+ * - bytes       : Response (or push frame) bytes per operation.
+ * - chunks      : Response chunks per operation.
+ * - alloc_bytes : Bytes allocated per operation.
+ * - heap_peak   : Peak heap above the process baseline.
+ * - status      : HTTP status (0 for sampler rows).
+ */
+typedef struct
+{
+    const char *item;
+    uint64_t ns;
+    uint64_t bytes;
+    uint32_t chunks;
+    uint64_t alloc_bytes;
+    size_t heap_peak;
+    int status;
+} bench_row_t;
+
+static sysmon_metric_handle_t s_metrics[BENCH_METRIC_COUNT];
+static size_t s_heap_baseline = 0;
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Read the calling thread's CPU time.
+ *
+ * @return CPU time in nanoseconds.
+ */
+static uint64_t _thread_cpu_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Parse a comma-separated list of positive integers.
+ *
+ * @param text List text.
+ * @param values Output: values.
+ * @param count Output: number of values.
+ * @return true if the list is valid.
+ */
+static bool _parse_list(const char *text, uint32_t *values, int *count)
+{
+    *count = 0;
+    while (*text != '\0')
+    {
+        char *end = NULL;
+        unsigned long value = strtoul(text, &end, 10);
+        if (end == text || value == 0 || value > UINT32_MAX || *count >= BENCH_MAX_LIST)
+        {
+            return false;
+        }
+        values[(*count)++] = (uint32_t)value;
+        text = (*end == ',') ? end + 1 : end;
+        if (*end != ',' && *end != '\0')
+        {
+            return false;
+        }
+    }
+    return *count > 0;
+}
+
+/**
+ * @brief Parse a positive integer option.
+ *
+ * @param text Option text.
+ * @param value Output: value.
+ * @return true if valid.
+ */
+static bool _parse_uint(const char *text, uint32_t *value)
+{
+    char *end = NULL;
+    unsigned long parsed = strtoul(text, &end, 10);
+    if (end == text || *end != '\0' || parsed == 0 || parsed > UINT32_MAX)
+    {
+        return false;
+    }
+    *value = (uint32_t)parsed;
+    return true;
+}
+
+/**
+ * @brief Print one row.
+ *
+ * @param options Options (output format).
+ * @param task_count Reported tasks of the case.
+ * @param depth History depth of the case.
+ * @param row Row.
+ */
+static void _print_row(const bench_options_t *options, uint32_t task_count, uint32_t depth, const bench_row_t *row)
+{
+    if (options->csv)
+    {
+        printf("%" PRIu32 ",%" PRIu32 ",%s,%" PRIu64 ",%" PRIu64 ",%" PRIu32 ",%" PRIu64 ",%zu,%d\n",
+               task_count, depth, row->item, row->ns, row->bytes, row->chunks, row->alloc_bytes,
+               row->heap_peak, row->status);
+        return;
+    }
+    printf("  %-26s %12" PRIu64 " %10" PRIu64 " %7" PRIu32 " %12" PRIu64 " %12zu",
+           row->item, row->ns, row->bytes, row->chunks, row->alloc_bytes, row->heap_peak);
+    if (row->status != 0 && row->status != 200)
+    {
+        printf("  (HTTP %d)", row->status);
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Peak heap above the process baseline since the last mark.
+ *
+ * @param stats Output: heap counters.
+ * @return Peak in bytes.
+ */
+static size_t _heap_peak(sysmon_host_heap_stats_t *stats)
+{
+    sysmon_host_heap_get(stats);
+    return (stats->peak > s_heap_baseline) ? stats->peak - s_heap_baseline : 0;
+}
+
+/**
+ * @brief Run one sample; the custom metrics move first so every sample has data.
+ *
+ * @return Sampler CPU nanoseconds.
+ */
+static uint64_t _step(void)
+{
+    sysmon_metric_add(s_metrics[0], 3);
+    sysmon_metric_add(s_metrics[1], 1);
+    sysmon_metric_set(s_metrics[2], (int32_t)(rand() % 100));
+    sysmon_metric_set(s_metrics[3], (int32_t)(rand() % 4096));
+    return sysmon_host_step();
+}
+
+/**
+ * @brief Measure sampling over a number of samples.
+ *
+ * @param item Row name.
+ * @param samples Samples to measure.
+ * @param row Output: measurement.
+ */
+static void _measure_samples(const char *item, uint32_t samples, bench_row_t *row)
+{
+    memset(row, 0, sizeof(*row));
+    row->item = item;
+
+    uint32_t frames = 0;
+    uint64_t frame_bytes = 0;
+    sysmon_host_ws_take_stats(&frames, &frame_bytes);
+
+    sysmon_host_heap_mark();
+    uint64_t total_ns = 0;
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        total_ns += _step();
+    }
+    sysmon_host_heap_stats_t stats;
+    row->heap_peak   = _heap_peak(&stats);
+    row->alloc_bytes = stats.alloc_bytes / samples;
+    row->ns          = total_ns / samples;
+
+    sysmon_host_ws_take_stats(&frames, &frame_bytes);
+    row->bytes = frame_bytes / samples;
+}
+
+/**
+ * @brief Measure one endpoint.
+ *
+ * @param item Row name.
+ * @param method HTTP method.
+ * @param uri Request URI.
+ * @param repeat Requests to average over.
+ * @param row Output: measurement.
+ */
+static void _measure_endpoint(const char *item, httpd_method_t method, const char *uri, uint32_t repeat,
+                              bench_row_t *row)
+{
+    memset(row, 0, sizeof(*row));
+    row->item = item;
+
+    sysmon_host_response_t response;
+    sysmon_host_heap_mark();
+    uint64_t start_ns = _thread_cpu_ns();
+    for (uint32_t i = 0; i < repeat; i++)
+    {
+        if (sysmon_host_request(method, uri, &response) != ESP_OK)
+        {
+            break;
+        }
+    }
+    row->ns = (_thread_cpu_ns() - start_ns) / repeat;
+
+    sysmon_host_heap_stats_t stats;
+    row->heap_peak   = _heap_peak(&stats);
+    row->alloc_bytes = stats.alloc_bytes / repeat;
+    row->bytes       = response.bytes;
+    row->chunks      = response.chunks;
+    row->status      = response.status;
+}
+
+/**
+ * @brief Run one case of the sweep.
+ *
+ * @param options Options.
+ * @param task_count Reported tasks, sysmon's own included.
+ * @param depth History depth.
+ * @return true if sysmon started.
+ */
+static bool _run_case(const bench_options_t *options, uint32_t task_count, uint32_t depth)
+{
+    uint32_t min_depth = sysmon_get_min_sample_count();
+    depth = (depth < min_depth) ? min_depth : depth;
+
+    if (sysmon_set_sampling(options->interval_ms, depth) != ESP_OK)
+    {
+        fprintf(stderr, "sysmon_bench: interval %" PRIu32 " ms / depth %" PRIu32 " rejected\n",
+                options->interval_ms, depth);
+        return false;
+    }
+
+    bench_row_t row;
+    memset(&row, 0, sizeof(row));
+    row.item = "init";
+    sysmon_host_heap_mark();
+    uint64_t start_ns = _thread_cpu_ns();
+    esp_err_t err = sysmon_init();
+    if (err != ESP_OK)
+    {
+        fprintf(stderr, "sysmon_bench: sysmon_init() failed: %s\n", esp_err_to_name(err));
+        sysmon_deinit();
+        return false;
+    }
+    row.ns = _thread_cpu_ns() - start_ns;
+    sysmon_host_wait_sample();
+
+    // Top up to the requested count with synthetic tasks
+    UBaseType_t own_tasks = uxTaskGetNumberOfTasks();
+    int synthetic = (task_count > own_tasks) ? (int)(task_count - own_tasks) : 0;
+    TaskHandle_t *handles = (TaskHandle_t *)calloc((size_t)synthetic + 1, sizeof(TaskHandle_t));
+    if (handles == NULL)
+    {
+        sysmon_deinit();
+        return false;
+    }
+    synthetic = sysmon_host_tasks_add(synthetic, handles);
+    for (int i = 0; i < synthetic; i++)
+    {
+        sysmon_stack_register(handles[i], SYSMON_HOST_TASK_STACK_SIZE);
+    }
+    uint32_t reported = (uint32_t)(own_tasks + (UBaseType_t)synthetic);
+
+    // Fill the window, so every encoder sees a full history
+    for (uint32_t i = 0; i <= depth; i++)
+    {
+        _step();
+    }
+    sysmon_host_heap_stats_t stats;
+    row.heap_peak   = _heap_peak(&stats);
+    row.alloc_bytes = stats.alloc_bytes;
+
+    if (options->csv)
+    {
+        _print_row(options, reported, depth, &row);
+    }
+    else
+    {
+        printf("\n%" PRIu32 " tasks, %" PRIu32 " samples at %" PRIu32 " ms\n", reported, depth, options->interval_ms);
+        printf("  %-26s %12s %10s %7s %12s %12s\n", "item", "cpu ns/op", "bytes", "chunks", "alloc B/op", "peak heap B");
+        _print_row(options, reported, depth, &row);
+    }
+
+    _measure_samples("sample", options->samples, &row);
+    _print_row(options, reported, depth, &row);
+
+    if (sysmon_host_ws_connect() >= 0)
+    {
+        _measure_samples("sample+push", options->samples, &row);
+        _print_row(options, reported, depth, &row);
+        sysmon_host_ws_close_all();
+        // The sampler drops closed subscribers on its next publish
+        _step();
+    }
+
+    char since_uri[48];
+    sysmon_summary_t summary = { 0 };
+    const sysmon_snapshot_t *snapshot = sysmon_get_snapshot();
+    if (snapshot != NULL)
+    {
+        sysmon_snapshot_summary(snapshot, &summary);
+        sysmon_release_snapshot(snapshot);
+    }
+    uint32_t since = (summary.sequence > BENCH_DELTA_SAMPLES) ? summary.sequence - BENCH_DELTA_SAMPLES : 0;
+    snprintf(since_uri, sizeof(since_uri), "/history?since=%" PRIu32, since);
+
+    const struct
+    {
+        const char *item;
+        const char *uri;
+    } endpoints[] =
+    {
+        { "GET /telemetry",            "/telemetry" },
+        { "GET /telemetry.bin",        "/telemetry.bin" },
+        { "GET /tasks",                "/tasks" },
+        { "GET /tasks?top=10",         "/tasks?top=10" },
+        { "GET /history",              "/history" },
+        { "GET /history?since",        since_uri },
+        { "GET /history?resolution=10", "/history?resolution=10" },
+        { "GET /history.bin",          "/history.bin" },
+        { "GET /hardware",             "/hardware" },
+        { "GET /sampling",             "/sampling" },
+        { "GET /heap",                 "/heap" },
+        { "GET /metrics",              "/metrics" },
+        { "GET /",                     "/" }
+    };
+    for (size_t i = 0; i < sizeof(endpoints) / sizeof(endpoints[0]); i++)
+    {
+        _measure_endpoint(endpoints[i].item, HTTP_GET, endpoints[i].uri, options->repeat, &row);
+        _print_row(options, reported, depth, &row);
+    }
+
+    sysmon_deinit();
+    sysmon_host_tasks_remove(synthetic);
+    free(handles);
+    return true;
+}
+
+/**
+ * @brief Print usage.
+ *
+ * @param program Program name.
+ */
+static void _usage(const char *program)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --tasks=LIST     reported task counts (default 10,32,64,128,256)\n"
+            "  --depths=LIST    history depths (default 10,100,1000)\n"
+            "  --interval=MS    sampling interval (default %d)\n"
+            "  --samples=N      measured samples per case (default 100)\n"
+            "  --repeat=N       requests per endpoint per case (default 20)\n"
+            "  --csv            print CSV\n"
+            "  --verbose        print sysmon log messages up to INFO\n",
+            program, CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS);
+}
+
+// ============================================================================
+// Entry Point
+// ============================================================================
+
+int main(int argc, char **argv)
+{
+    bench_options_t options =
+    {
+        .task_counts    = { 10, 32, 64, 128, 256 },
+        .task_count_len = 5,
+        .depths         = { 10, 100, 1000 },
+        .depth_len      = 3,
+        .interval_ms    = CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS,
+        .samples        = 100,
+        .repeat         = 20,
+        .csv            = false
+    };
+
+    static const struct option long_options[] =
+    {
+        { "tasks",    required_argument, NULL, 't' },
+        { "depths",   required_argument, NULL, 'd' },
+        { "interval", required_argument, NULL, 'i' },
+        { "samples",  required_argument, NULL, 's' },
+        { "repeat",   required_argument, NULL, 'r' },
+        { "csv",      no_argument,       NULL, 'c' },
+        { "verbose",  no_argument,       NULL, 'v' },
+        { "help",     no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "t:d:i:s:r:cvh", long_options, NULL)) != -1)
+    {
+        bool valid = true;
+        switch (opt)
+        {
+            case 't': valid = _parse_list(optarg, options.task_counts, &options.task_count_len); break;
+            case 'd': valid = _parse_list(optarg, options.depths, &options.depth_len); break;
+            case 'i': valid = _parse_uint(optarg, &options.interval_ms); break;
+            case 's': valid = _parse_uint(optarg, &options.samples); break;
+            case 'r': valid = _parse_uint(optarg, &options.repeat); break;
+            case 'c': options.csv = true; break;
+            case 'v': sysmon_host_set_log_level(ESP_LOG_INFO); break;
+            default:  valid = false; break;
+        }
+        if (!valid)
+        {
+            _usage(argv[0]);
+            return (opt == 'h') ? 0 : 2;
+        }
+    }
+
+    // Registered once: the metric registry outlives sysmon_deinit()
+    s_metrics[0] = sysmon_metric_register("bench_requests", SYSMON_METRIC_COUNTER);
+    s_metrics[1] = sysmon_metric_register("bench_errors", SYSMON_METRIC_COUNTER);
+    s_metrics[2] = sysmon_metric_register("bench_queue_depth", SYSMON_METRIC_GAUGE);
+    s_metrics[3] = sysmon_metric_register("bench_buffer_bytes", SYSMON_METRIC_GAUGE);
+
+    sysmon_host_heap_stats_t stats;
+    sysmon_host_heap_get(&stats);
+    s_heap_baseline = stats.in_use;
+
+    if (options.csv)
+    {
+        printf("tasks,depth,item,cpu_ns,bytes,chunks,alloc_bytes,heap_peak,status\n");
+    }
+    int failures = 0;
+    for (int t = 0; t < options.task_count_len; t++)
+    {
+        for (int d = 0; d < options.depth_len; d++)
+        {
+            if (!_run_case(&options, options.task_counts[t], options.depths[d]))
+            {
+                failures++;
+            }
+        }
+    }
+    return (failures == 0) ? 0 : 1;
+}
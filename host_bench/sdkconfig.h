@@ -0,0 +1,36 @@
+/**
+ * @file sdkconfig.h
+ * @brief Fixed sysmon configuration for the host benchmark build.
+ *
+ * Stands in for the header ESP-IDF generates from Kconfig. Values not set
+ * here fall back to the defaults in sysmon.h. Features that need hardware
+ * (trace hooks, gptimer, RTC memory, flash, UDP export, heap hooks) are left
+ * disabled; everything the HTTP encoders read is enabled.
+ */
+
+#pragma once
+
+// FreeRTOS options sysmon requires (see sysmon.h)
+#define CONFIG_FREERTOS_USE_TRACE_FACILITY              1
+#define CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS         1
+#define CONFIG_FREERTOS_NUMBER_OF_CORES                 2
+#define CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS   2
+#define CONFIG_FREERTOS_HZ                              1000
+#define CONFIG_LWIP_MAX_SOCKETS                         16
+#define CONFIG_HTTPD_WS_SUPPORT                         1
+
+// Sampling (the sweep changes interval and depth at runtime)
+#define CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS          1000
+#define CONFIG_SYSMON_SAMPLE_COUNT                      100
+#define CONFIG_SYSMON_SAMPLE_COUNT_MAX                  1000
+
+// Features read by the encoders; the stack alert window is lowered to the
+// minimum depth so the sweep can start at 10 samples
+#define CONFIG_SYSMON_ROLLUPS                           1
+#define CONFIG_SYSMON_STACK_ALERTS                      1
+#define CONFIG_SYSMON_STACK_ALERT_WINDOW                10
+#define CONFIG_SYSMON_STACK_ALERT_EVENT                 1
+#define CONFIG_SYSMON_HEAP_PROFILE                      1
+#define CONFIG_SYSMON_METRICS                           1
+#define CONFIG_SYSMON_CUSTOM_METRICS                    1
+#define CONFIG_SYSMON_WEBSOCKET_PUSH                    1
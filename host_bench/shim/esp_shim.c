@@ -0,0 +1,429 @@
+/**
+ * @file esp_shim.c
+ * @brief Host shim of the ESP-IDF system, logging, flash, partition and network APIs.
+ *
+ * Reports a fixed emulated board so the hardware encoder walks the same
+ * paths as on a device: a dual-core 240 MHz chip with 4 MB of flash, the
+ * default single-app partition table, an app image with four segments in the
+ * factory partition, and a Wi-Fi station connected with IP 127.0.0.1.
+ */
+
+// Project-specific includes
+#include "sysmon_host.h"
+
+// ESP-IDF includes
+#include "esp_chip_info.h"
+#include "esp_clk_tree.h"
+#include "esp_err.h"
+#include "esp_event.h"
+#include "esp_flash.h"
+#include "esp_image_format.h"
+#include "esp_log.h"
+#include "esp_netif.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "nvs_flash.h"
+
+// System includes
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_FLASH_SIZE   (4U * 1024U * 1024U)
+#define HOST_CPU_FREQ_HZ  240000000U
+
+/**
+ * @brief Partition iterator (what an esp_partition_iterator_t points to).
+ *
+ * Members:
+ * - index   : Current entry in s_partitions.
+ * - type    : Type filter.
+ * - subtype : Subtype filter.
+ * - label   : Label filter, or NULL.
+ */
+struct esp_partition_iterator_opaque_
+{
+    size_t index;
+    esp_partition_type_t type;
+    esp_partition_subtype_t subtype;
+    const char *label;
+};
+
+// Default ESP-IDF "single factory app" partition table
+static const esp_partition_t s_partitions[] =
+{
+    { .type = ESP_PARTITION_TYPE_DATA, .subtype = ESP_PARTITION_SUBTYPE_DATA_NVS,
+      .address = 0x9000, .size = 0x6000, .erase_size = 0x1000, .label = "nvs" },
+    { .type = ESP_PARTITION_TYPE_DATA, .subtype = ESP_PARTITION_SUBTYPE_DATA_PHY,
+      .address = 0xf000, .size = 0x1000, .erase_size = 0x1000, .label = "phy_init" },
+    { .type = ESP_PARTITION_TYPE_APP, .subtype = ESP_PARTITION_SUBTYPE_APP_FACTORY,
+      .address = 0x10000, .size = 0x100000, .erase_size = 0x1000, .label = "factory" }
+};
+
+// Segments of the app image in the factory partition
+static const esp_image_segment_header_t s_image_segments[] =
+{
+    { .load_addr = 0x3f400020, .data_len = 0x1a3c0 },
+    { .load_addr = 0x3ffb0000, .data_len = 0x03a94 },
+    { .load_addr = 0x40080000, .data_len = 0x14e58 },
+    { .load_addr = 0x400d0020, .data_len = 0x7b2a4 }
+};
+
+#define HOST_ERROR_ENTRY(code) { code, #code }
+
+static const struct
+{
+    esp_err_t code;
+    const char *name;
+} s_error_names[] =
+{
+    HOST_ERROR_ENTRY(ESP_OK),
+    HOST_ERROR_ENTRY(ESP_FAIL),
+    HOST_ERROR_ENTRY(ESP_ERR_NO_MEM),
+    HOST_ERROR_ENTRY(ESP_ERR_INVALID_ARG),
+    HOST_ERROR_ENTRY(ESP_ERR_INVALID_STATE),
+    HOST_ERROR_ENTRY(ESP_ERR_INVALID_SIZE),
+    HOST_ERROR_ENTRY(ESP_ERR_NOT_FOUND),
+    HOST_ERROR_ENTRY(ESP_ERR_NOT_SUPPORTED),
+    HOST_ERROR_ENTRY(ESP_ERR_TIMEOUT),
+    HOST_ERROR_ENTRY(ESP_ERR_INVALID_CRC),
+    HOST_ERROR_ENTRY(ESP_ERR_HTTPD_HANDLERS_FULL),
+    HOST_ERROR_ENTRY(ESP_ERR_HTTPD_HANDLER_EXISTS),
+    HOST_ERROR_ENTRY(ESP_ERR_HTTPD_INVALID_REQ),
+    HOST_ERROR_ENTRY(ESP_ERR_HTTPD_RESULT_TRUNC)
+};
+
+static esp_log_level_t s_log_level = ESP_LOG_ERROR;
+static uint8_t s_netif_instance;
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Check whether a partition matches an iterator's filters.
+ *
+ * @param it Iterator.
+ * @param part Partition.
+ * @return true if it matches.
+ */
+static bool _partition_matches(const struct esp_partition_iterator_opaque_ *it, const esp_partition_t *part)
+{
+    return (it->type == ESP_PARTITION_TYPE_ANY || it->type == part->type) &&
+           (it->subtype == ESP_PARTITION_SUBTYPE_ANY || it->subtype == part->subtype) &&
+           (it->label == NULL || strcmp(it->label, part->label) == 0);
+}
+
+/**
+ * @brief Move an iterator to the first matching partition at or after its index.
+ *
+ * @param it Iterator.
+ * @return true if one was found.
+ */
+static bool _partition_seek(struct esp_partition_iterator_opaque_ *it)
+{
+    for (; it->index < sizeof(s_partitions) / sizeof(s_partitions[0]); it->index++)
+    {
+        if (_partition_matches(it, &s_partitions[it->index]))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Copy the part of a flash structure that overlaps a read window.
+ *
+ * @param buffer Read buffer.
+ * @param address Read start address.
+ * @param length Read length.
+ * @param item Structure contents.
+ * @param item_address Flash address of the structure.
+ * @param item_size Structure size.
+ */
+static void _flash_overlay(uint8_t *buffer, uint32_t address, uint32_t length,
+                           const void *item, uint32_t item_address, uint32_t item_size)
+{
+    uint32_t start = (item_address > address) ? item_address : address;
+    uint32_t end_item = item_address + item_size;
+    uint32_t end_read = address + length;
+    uint32_t end = (end_item < end_read) ? end_item : end_read;
+    if (start < end)
+    {
+        memcpy(buffer + (start - address), (const uint8_t *)item + (start - item_address), end - start);
+    }
+}
+
+// ============================================================================
+// Logging and errors
+// ============================================================================
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    static const char letters[] = "NEWIDV";
+    if (level > s_log_level || level == ESP_LOG_NONE)
+    {
+        return;
+    }
+
+    fprintf(stderr, "%c (%lld) %s: ", letters[level], (long long)(esp_timer_get_time() / 1000), tag);
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    for (size_t i = 0; i < sizeof(s_error_names) / sizeof(s_error_names[0]); i++)
+    {
+        if (s_error_names[i].code == code)
+        {
+            return s_error_names[i].name;
+        }
+    }
+    return "UNKNOWN ERROR";
+}
+
+void sysmon_host_set_log_level(esp_log_level_t level)
+{
+    s_log_level = level;
+}
+
+// ============================================================================
+// System
+// ============================================================================
+
+esp_reset_reason_t esp_reset_reason(void)
+{
+    return ESP_RST_POWERON;
+}
+
+const char *esp_get_idf_version(void)
+{
+    return "v5.1-host";
+}
+
+void esp_chip_info(esp_chip_info_t *out_info)
+{
+    memset(out_info, 0, sizeof(*out_info));
+    out_info->model    = CHIP_POSIX_LINUX;
+    out_info->features = CHIP_FEATURE_WIFI_BGN | CHIP_FEATURE_BLE;
+    out_info->revision = 300;
+    out_info->cores    = CONFIG_FREERTOS_NUMBER_OF_CORES;
+}
+
+esp_err_t esp_clk_tree_src_get_freq_hz(soc_module_clk_t clk_src, esp_clk_tree_src_freq_precision_t precision,
+                                       uint32_t *freq_value)
+{
+    (void)precision;
+    if (clk_src != SOC_MOD_CLK_CPU || freq_value == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *freq_value = HOST_CPU_FREQ_HZ;
+    return ESP_OK;
+}
+
+esp_err_t esp_event_post(esp_event_base_t event_base, int32_t event_id, const void *event_data,
+                         size_t event_data_size, uint32_t ticks_to_wait)
+{
+    (void)event_base;
+    (void)event_id;
+    (void)event_data;
+    (void)event_data_size;
+    (void)ticks_to_wait;
+    return ESP_OK;
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        crc ^= buf[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+// ============================================================================
+// Flash and partitions
+// ============================================================================
+
+esp_err_t esp_flash_get_size(esp_flash_t *chip, uint32_t *out_size)
+{
+    (void)chip;
+    *out_size = HOST_FLASH_SIZE;
+    return ESP_OK;
+}
+
+/**
+ * @brief Read flash: erased (0xFF) except for the app image headers.
+ */
+esp_err_t esp_flash_read(esp_flash_t *chip, void *buffer, uint32_t address, uint32_t length)
+{
+    (void)chip;
+    if (address > HOST_FLASH_SIZE || length > HOST_FLASH_SIZE - address)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(buffer, 0xFF, length);
+
+    const esp_partition_t *app = &s_partitions[2];
+    esp_image_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic         = ESP_IMAGE_HEADER_MAGIC;
+    header.segment_count = (uint8_t)(sizeof(s_image_segments) / sizeof(s_image_segments[0]));
+    header.entry_addr    = 0x40081000;
+    _flash_overlay(buffer, address, length, &header, app->address, sizeof(header));
+
+    uint32_t offset = app->address + sizeof(header);
+    for (size_t i = 0; i < sizeof(s_image_segments) / sizeof(s_image_segments[0]); i++)
+    {
+        _flash_overlay(buffer, address, length, &s_image_segments[i], offset, sizeof(s_image_segments[i]));
+        offset += sizeof(s_image_segments[i]) + s_image_segments[i].data_len;
+    }
+    return ESP_OK;
+}
+
+esp_partition_iterator_t esp_partition_find(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                            const char *label)
+{
+    struct esp_partition_iterator_opaque_ it = { .index = 0, .type = type, .subtype = subtype, .label = label };
+    if (!_partition_seek(&it))
+    {
+        return NULL;
+    }
+    esp_partition_iterator_t result = (esp_partition_iterator_t)malloc(sizeof(it));
+    if (result != NULL)
+    {
+        *result = it;
+    }
+    return result;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char *label)
+{
+    struct esp_partition_iterator_opaque_ it = { .index = 0, .type = type, .subtype = subtype, .label = label };
+    return _partition_seek(&it) ? &s_partitions[it.index] : NULL;
+}
+
+const esp_partition_t *esp_partition_get(esp_partition_iterator_t iterator)
+{
+    return (iterator != NULL) ? &s_partitions[iterator->index] : NULL;
+}
+
+/**
+ * @brief Advance an iterator; like ESP-IDF, releases it and returns NULL at the end.
+ */
+esp_partition_iterator_t esp_partition_next(esp_partition_iterator_t iterator)
+{
+    if (iterator == NULL)
+    {
+        return NULL;
+    }
+    iterator->index++;
+    if (!_partition_seek(iterator))
+    {
+        free(iterator);
+        return NULL;
+    }
+    return iterator;
+}
+
+void esp_partition_iterator_release(esp_partition_iterator_t iterator)
+{
+    free(iterator);
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size)
+{
+    (void)partition;
+    (void)dst_offset;
+    (void)src;
+    (void)size;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size)
+{
+    (void)partition;
+    (void)offset;
+    (void)size;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t *partition, size_t offset, size_t size,
+                             esp_partition_mmap_memory_t memory, const void **out_ptr,
+                             esp_partition_mmap_handle_t *out_handle)
+{
+    (void)partition;
+    (void)offset;
+    (void)size;
+    (void)memory;
+    (void)out_ptr;
+    (void)out_handle;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle)
+{
+    (void)handle;
+}
+
+esp_err_t nvs_get_stats(const char *part_name, nvs_stats_t *nvs_stats)
+{
+    (void)part_name;
+    // 6 pages of 126 entries, one page kept free by NVS
+    nvs_stats->used_entries      = 37;
+    nvs_stats->free_entries      = 719;
+    nvs_stats->available_entries = 593;
+    nvs_stats->total_entries     = 756;
+    nvs_stats->namespace_count   = 3;
+    return ESP_OK;
+}
+
+// ============================================================================
+// Network
+// ============================================================================
+
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *ap_info)
+{
+    memset(ap_info, 0, sizeof(*ap_info));
+    memcpy(ap_info->ssid, "sysmon-host", sizeof("sysmon-host"));
+    ap_info->primary = 6;
+    ap_info->rssi    = -50;
+    return ESP_OK;
+}
+
+esp_netif_t *esp_netif_get_handle_from_ifkey(const char *if_key)
+{
+    return (strcmp(if_key, "WIFI_STA_DEF") == 0) ? (esp_netif_t *)&s_netif_instance : NULL;
+}
+
+esp_err_t esp_netif_get_ip_info(esp_netif_t *esp_netif, esp_netif_ip_info_t *ip_info)
+{
+    if (esp_netif == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    static const uint8_t ip[4]   = { 127, 0, 0, 1 };
+    static const uint8_t mask[4] = { 255, 0, 0, 0 };
+    memset(ip_info, 0, sizeof(*ip_info));
+    memcpy(&ip_info->ip.addr, ip, sizeof(ip));
+    memcpy(&ip_info->netmask.addr, mask, sizeof(mask));
+    memcpy(&ip_info->gw.addr, ip, sizeof(ip));
+    return ESP_OK;
+}
@@ -0,0 +1,841 @@
+/**
+ * @file freertos_shim.c
+ * @brief Host shim of the FreeRTOS task, notification and semaphore API.
+ *
+ * Every task is a record in one list, guarded by a single mutex that also
+ * guards notifications, semaphores and the clock; one condition variable is
+ * broadcast on any change. Tasks created with xTaskCreate*() run on POSIX
+ * threads. Idle tasks and the synthetic workload have no thread: their
+ * run-time counters are advanced from the virtual clock whenever
+ * uxTaskGetSystemState() is called.
+ *
+ * Virtual clock: while the sampler runs, the clock advances in real time,
+ * so its own processing shows up in the self-metrics. When it parks in
+ * xTaskDelayUntil() the clock stops; sysmon_host_step() moves it to the
+ * deadline and releases the sampler. The run time the synthetic tasks
+ * accumulate over the jump keeps the cores about HOST_APP_LOAD_PERCENT busy;
+ * idle tasks get the rest.
+ *
+ * A task deleted by another task exits at its next blocking call (the only
+ * one deleted that way is the sampler, parked in xTaskDelayUntil(); its
+ * park is dropped and the clock runs again).
+ * Blocking calls other than xTaskDelayUntil() time out in real time.
+ */
+
+#define _GNU_SOURCE
+
+// Project-specific includes
+#include "sysmon_host.h"
+
+// ESP-IDF includes
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+// System includes
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Share of all cores the synthetic tasks keep busy together
+#define HOST_APP_LOAD_PERCENT   60
+
+// A driver wait longer than this means the sampler is stuck
+#define HOST_STALL_TIMEOUT_S    30
+
+/**
+ * @brief Task record (what a TaskHandle_t points to).
+ *
+ * Members:
+ * - name, number, priority, core_id : Reported task identity.
+ * - stack_depth, stack_unused       : Stack size and high water mark in bytes.
+ * - run_time_us, run_time_frac      : Run-time counter (whole and fractional microseconds).
+ * - weight, load                    : Synthetic tasks: relative weight and share of one core.
+ * - kind                            : Idle, synthetic or thread-backed.
+ * - thread, code, parameters        : Thread-backed tasks: POSIX thread and entry point.
+ * - cpu_accounted_ns                : Thread CPU time already added to run_time_us.
+ * - notify_count                    : Pending task notifications.
+ * - delete_pending                  : Set when another task deleted this one.
+ * - tls                             : Thread-local storage pointers.
+ * - next                            : Next record in the task list.
+ */
+typedef enum
+{
+    HOST_TASK_IDLE,
+    HOST_TASK_SYNTHETIC,
+    HOST_TASK_THREAD,
+    HOST_TASK_MAIN
+} host_task_kind_t;
+
+struct tskTaskControlBlock
+{
+    char name[configMAX_TASK_NAME_LEN];
+    UBaseType_t number;
+    UBaseType_t priority;
+    BaseType_t core_id;
+    uint32_t stack_depth;
+    uint32_t stack_unused;
+    uint64_t run_time_us;
+    double run_time_frac;
+    double weight;
+    double load;
+    host_task_kind_t kind;
+    pthread_t thread;
+    TaskFunction_t code;
+    void *parameters;
+    uint64_t cpu_accounted_ns;
+    uint32_t notify_count;
+    bool delete_pending;
+    void *tls[CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS];
+    struct tskTaskControlBlock *next;
+};
+
+/**
+ * @brief Binary semaphore (what a SemaphoreHandle_t points to).
+ */
+struct QueueDefinition
+{
+    bool given;
+};
+
+// Task list, notifications, semaphores and clock
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_cond;
+
+// Critical sections (recursive, separate from s_lock)
+static pthread_mutex_t s_critical;
+
+static struct tskTaskControlBlock *s_tasks = NULL;
+static UBaseType_t s_task_count = 0;
+static UBaseType_t s_next_task_number = 1;
+static uint32_t s_synthetic_created = 0;
+static TaskHandle_t s_idle_tasks[portNUM_PROCESSORS];
+static __thread TaskHandle_t s_current_task = NULL;
+
+// Virtual clock: monotonic time plus offset, or a fixed value while stopped
+static int64_t s_clock_offset_us = 0;
+static bool s_clock_stopped = false;
+static int64_t s_clock_stopped_us = 0;
+static int64_t s_accounted_us = 0;
+
+// Sampler hand-off: parked task, parks and releases so far, and the CPU time of the last run
+static TaskHandle_t s_parked_task = NULL;
+static uint32_t s_park_count = 0;
+static uint32_t s_release_count = 0;
+static uint64_t s_sample_cpu_ns = 0;
+static __thread uint64_t s_run_start_ns = 0;
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Read a clock in microseconds.
+ *
+ * @param clock_id POSIX clock.
+ * @return Clock value.
+ */
+static int64_t _clock_us(clockid_t clock_id)
+{
+    struct timespec ts;
+    clock_gettime(clock_id, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief Read the calling thread's CPU time.
+ *
+ * @return CPU time in nanoseconds.
+ */
+static uint64_t _thread_cpu_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Read the virtual clock (s_lock held).
+ *
+ * @return Virtual time in microseconds.
+ */
+static int64_t _clock_now_locked(void)
+{
+    return s_clock_stopped ? s_clock_stopped_us : _clock_us(CLOCK_MONOTONIC) + s_clock_offset_us;
+}
+
+/**
+ * @brief Restart the virtual clock at a given time (s_lock held).
+ *
+ * @param now_us Virtual time to continue from.
+ */
+static void _clock_resume_locked(int64_t now_us)
+{
+    s_clock_offset_us = now_us - _clock_us(CLOCK_MONOTONIC);
+    s_clock_stopped   = false;
+}
+
+/**
+ * @brief Build an absolute CLOCK_MONOTONIC deadline ticks from now.
+ *
+ * @param ticks Timeout in ticks (portMAX_DELAY = none).
+ * @param deadline Output: deadline.
+ * @return deadline, or NULL for portMAX_DELAY.
+ */
+static const struct timespec *_deadline_after(TickType_t ticks, struct timespec *deadline)
+{
+    if (ticks == portMAX_DELAY)
+    {
+        return NULL;
+    }
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    uint64_t ns = (uint64_t)ticks * (1000000000ULL / configTICK_RATE_HZ) + (uint64_t)deadline->tv_nsec;
+    deadline->tv_sec += (time_t)(ns / 1000000000ULL);
+    deadline->tv_nsec = (long)(ns % 1000000000ULL);
+    return deadline;
+}
+
+/**
+ * @brief Wait for a state change (s_lock held); exits the thread if its task was deleted.
+ *
+ * @param deadline Absolute CLOCK_MONOTONIC deadline (NULL = none).
+ * @return false if the deadline passed.
+ */
+static bool _wait_locked(const struct timespec *deadline)
+{
+    int err = (deadline == NULL) ? pthread_cond_wait(&s_cond, &s_lock)
+                                 : pthread_cond_timedwait(&s_cond, &s_lock, deadline);
+    TaskHandle_t self_task = s_current_task;
+    if (self_task != NULL && self_task->delete_pending)
+    {
+        pthread_mutex_unlock(&s_lock);
+        pthread_exit(NULL);
+    }
+    return err != ETIMEDOUT;
+}
+
+/**
+ * @brief Allocate a task record and append it to the task list (s_lock held).
+ *
+ * @param name Task name.
+ * @param priority Priority.
+ * @param core_id Core affinity or tskNO_AFFINITY.
+ * @param stack_depth Stack size in bytes.
+ * @param kind Record kind.
+ * @return New record, or NULL if out of memory.
+ */
+static TaskHandle_t _task_create_locked(const char *name, UBaseType_t priority, BaseType_t core_id,
+                                        uint32_t stack_depth, host_task_kind_t kind)
+{
+    TaskHandle_t task = (TaskHandle_t)calloc(1, sizeof(*task));
+    if (task == NULL)
+    {
+        return NULL;
+    }
+    snprintf(task->name, sizeof(task->name), "%s", name);
+    task->number       = s_next_task_number++;
+    task->priority     = priority;
+    task->core_id      = core_id;
+    task->stack_depth  = stack_depth;
+    task->stack_unused = stack_depth / 2;
+    task->kind         = kind;
+
+    TaskHandle_t *link = &s_tasks;
+    while (*link != NULL)
+    {
+        link = &(*link)->next;
+    }
+    *link = task;
+    s_task_count++;
+    return task;
+}
+
+/**
+ * @brief Unlink a task record from the task list (s_lock held).
+ *
+ * @param task Task record.
+ * @return true if the task was in the list.
+ */
+static bool _task_unlink_locked(TaskHandle_t task)
+{
+    for (TaskHandle_t *link = &s_tasks; *link != NULL; link = &(*link)->next)
+    {
+        if (*link == task)
+        {
+            *link = task->next;
+            s_task_count--;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Spread the synthetic load over the synthetic tasks by weight (s_lock held).
+ */
+static void _synthetic_rebalance_locked(void)
+{
+    double weight_sum = 0.0;
+    for (TaskHandle_t task = s_tasks; task != NULL; task = task->next)
+    {
+        if (task->kind == HOST_TASK_SYNTHETIC)
+        {
+            weight_sum += task->weight;
+        }
+    }
+
+    double budget = (double)HOST_APP_LOAD_PERCENT / 100.0 * portNUM_PROCESSORS;
+    for (TaskHandle_t task = s_tasks; task != NULL; task = task->next)
+    {
+        if (task->kind == HOST_TASK_SYNTHETIC)
+        {
+            double load = budget * task->weight / weight_sum;
+            task->load = (load < 1.0) ? load : 1.0;
+        }
+    }
+}
+
+/**
+ * @brief Add run time to a task's counter.
+ *
+ * @param task Task record.
+ * @param us Microseconds (may be fractional).
+ */
+static void _add_run_time(TaskHandle_t task, double us)
+{
+    task->run_time_frac += us;
+    uint64_t whole = (uint64_t)task->run_time_frac;
+    task->run_time_us += whole;
+    task->run_time_frac -= (double)whole;
+}
+
+/**
+ * @brief Advance every run-time counter to the current virtual time (s_lock held).
+ *
+ * Synthetic tasks run their share of the elapsed time; thread-backed tasks
+ * are charged the CPU time their thread used. Each core's idle task gets
+ * what the tasks on that core (and their part of the unpinned tasks) left.
+ *
+ * @return Current virtual time in microseconds.
+ */
+static int64_t _account_run_time_locked(void)
+{
+    int64_t now = _clock_now_locked();
+    double elapsed = (double)(now - s_accounted_us);
+    if (elapsed < 0.0)
+    {
+        elapsed = 0.0;
+    }
+    s_accounted_us = now;
+
+    double busy[portNUM_PROCESSORS] = { 0 };
+    for (TaskHandle_t task = s_tasks; task != NULL; task = task->next)
+    {
+        double us = 0.0;
+        if (task->kind == HOST_TASK_SYNTHETIC)
+        {
+            us = task->load * elapsed;
+        }
+        else if (task->kind == HOST_TASK_THREAD)
+        {
+            clockid_t clock_id;
+            struct timespec ts;
+            if (pthread_getcpuclockid(task->thread, &clock_id) == 0 && clock_gettime(clock_id, &ts) == 0)
+            {
+                uint64_t cpu_ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+                us = (double)(cpu_ns - task->cpu_accounted_ns) / 1000.0;
+                task->cpu_accounted_ns = cpu_ns;
+            }
+        }
+        else
+        {
+            continue;
+        }
+
+        _add_run_time(task, us);
+        if (task->core_id >= 0 && task->core_id < portNUM_PROCESSORS)
+        {
+            busy[task->core_id] += us;
+        }
+        else
+        {
+            for (int core = 0; core < portNUM_PROCESSORS; core++)
+            {
+                busy[core] += us / portNUM_PROCESSORS;
+            }
+        }
+    }
+
+    for (int core = 0; core < portNUM_PROCESSORS; core++)
+    {
+        double idle = elapsed - busy[core];
+        _add_run_time(s_idle_tasks[core], (idle > 0.0) ? idle : 0.0);
+    }
+    return now;
+}
+
+/**
+ * @brief Thread entry point of a task created with xTaskCreate*().
+ *
+ * @param arg Task record.
+ * @return NULL (tasks end with vTaskDelete()).
+ */
+static void *_task_thread(void *arg)
+{
+    TaskHandle_t task = (TaskHandle_t)arg;
+    s_current_task = task;
+    task->code(task->parameters);
+    // FreeRTOS tasks must not return; treat it like vTaskDelete(NULL)
+    vTaskDelete(NULL);
+    return NULL;
+}
+
+/**
+ * @brief Wait until the sampler has parked for a release it has not been given yet (s_lock held).
+ */
+static void _wait_parked_locked(void)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += HOST_STALL_TIMEOUT_S;
+    while (s_park_count <= s_release_count)
+    {
+        if (!_wait_locked(&deadline))
+        {
+            fprintf(stderr, "sysmon_host: sampler did not reach xTaskDelayUntil() within %d s\n",
+                    HOST_STALL_TIMEOUT_S);
+            abort();
+        }
+    }
+}
+
+/**
+ * @brief Set up the clock, the idle tasks and the main task before main() runs.
+ */
+__attribute__((constructor))
+static void _freertos_shim_init(void)
+{
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&s_cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+
+    pthread_mutexattr_t mutex_attr;
+    pthread_mutexattr_init(&mutex_attr);
+    pthread_mutexattr_settype(&mutex_attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&s_critical, &mutex_attr);
+    pthread_mutexattr_destroy(&mutex_attr);
+
+    // Virtual time starts at zero, like esp_timer at boot
+    s_clock_offset_us = -_clock_us(CLOCK_MONOTONIC);
+
+    pthread_mutex_lock(&s_lock);
+    s_current_task = _task_create_locked("main", 1, 0, 3584, HOST_TASK_MAIN);
+    s_current_task->thread = pthread_self();
+    for (int core = 0; core < portNUM_PROCESSORS; core++)
+    {
+        char name[configMAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "IDLE%d", core);
+        s_idle_tasks[core] = _task_create_locked(name, 0, core, 1536, HOST_TASK_IDLE);
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+// ============================================================================
+// Port Layer
+// ============================================================================
+
+void vPortEnterCritical(portMUX_TYPE *mux)
+{
+    (void)mux;
+    pthread_mutex_lock(&s_critical);
+}
+
+void vPortExitCritical(portMUX_TYPE *mux)
+{
+    (void)mux;
+    pthread_mutex_unlock(&s_critical);
+}
+
+BaseType_t xPortGetCoreID(void)
+{
+    TaskHandle_t task = s_current_task;
+    return (task != NULL && task->core_id >= 0 && task->core_id < portNUM_PROCESSORS) ? task->core_id : 0;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    pthread_mutex_lock(&s_lock);
+    int64_t now = _clock_now_locked();
+    pthread_mutex_unlock(&s_lock);
+    return now;
+}
+
+// ============================================================================
+// Task API
+// ============================================================================
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task_code, const char *name, uint32_t stack_depth,
+                                   void *parameters, UBaseType_t priority, TaskHandle_t *created_task,
+                                   BaseType_t core_id)
+{
+    pthread_mutex_lock(&s_lock);
+    TaskHandle_t task = _task_create_locked(name, priority, core_id, stack_depth, HOST_TASK_THREAD);
+    if (task == NULL)
+    {
+        pthread_mutex_unlock(&s_lock);
+        return pdFAIL;
+    }
+    task->code       = task_code;
+    task->parameters = parameters;
+    if (created_task != NULL)
+    {
+        *created_task = task;
+    }
+
+    if (pthread_create(&task->thread, NULL, _task_thread, task) != 0)
+    {
+        _task_unlink_locked(task);
+        pthread_mutex_unlock(&s_lock);
+        free(task);
+        return pdFAIL;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task_code, const char *name, uint32_t stack_depth,
+                       void *parameters, UBaseType_t priority, TaskHandle_t *created_task)
+{
+    return xTaskCreatePinnedToCore(task_code, name, stack_depth, parameters, priority, created_task,
+                                   tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    TaskHandle_t self_task = s_current_task;
+    if (task == NULL)
+    {
+        task = self_task;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    bool listed = _task_unlink_locked(task);
+    task->delete_pending = true;
+    if (task == s_parked_task)
+    {
+        // The park will never be released: drop it and let the clock run again
+        s_parked_task   = NULL;
+        s_release_count = s_park_count;
+        _clock_resume_locked(s_clock_stopped_us);
+    }
+    pthread_cond_broadcast(&s_cond);
+    pthread_mutex_unlock(&s_lock);
+    if (!listed)
+    {
+        return;
+    }
+
+    if (task == self_task)
+    {
+        pthread_detach(pthread_self());
+        free(task);
+        pthread_exit(NULL);
+    }
+    if (task->kind == HOST_TASK_THREAD)
+    {
+        pthread_join(task->thread, NULL);
+    }
+    free(task);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    struct timespec deadline;
+    pthread_mutex_lock(&s_lock);
+    const struct timespec *until = _deadline_after(ticks, &deadline);
+    while (_wait_locked(until))
+    {
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+/**
+ * @brief Park the calling task until the driver releases the next sample.
+ *
+ * Records the CPU time used since the previous release for
+ * sysmon_host_step(), stops the clock, and on release moves it to the
+ * deadline (or leaves it, if the run took longer than the interval).
+ */
+BaseType_t xTaskDelayUntil(TickType_t *previous_wake, TickType_t increment)
+{
+    uint64_t cpu_ns = _thread_cpu_ns();
+
+    pthread_mutex_lock(&s_lock);
+    s_sample_cpu_ns    = cpu_ns - s_run_start_ns;
+    s_clock_stopped_us = _clock_now_locked();
+    s_clock_stopped    = true;
+    uint32_t ticket    = ++s_park_count;
+    s_parked_task      = s_current_task;
+    pthread_cond_broadcast(&s_cond);
+    while (s_release_count < ticket)
+    {
+        _wait_locked(NULL);
+    }
+    s_parked_task = NULL;
+
+    TickType_t deadline = *previous_wake + increment;
+    int64_t target_us = (int64_t)deadline * (1000000 / configTICK_RATE_HZ);
+    if (target_us < s_clock_stopped_us)
+    {
+        target_us = s_clock_stopped_us;
+    }
+    _clock_resume_locked(target_us);
+    *previous_wake = deadline;
+    pthread_mutex_unlock(&s_lock);
+
+    s_run_start_ns = _thread_cpu_ns();
+    return pdTRUE;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(esp_timer_get_time() / (1000000 / configTICK_RATE_HZ));
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *task_status_array, UBaseType_t array_size, uint32_t *total_run_time)
+{
+    TaskHandle_t self_task = s_current_task;
+    pthread_mutex_lock(&s_lock);
+    if (array_size < s_task_count)
+    {
+        pthread_mutex_unlock(&s_lock);
+        return 0;
+    }
+
+    int64_t now = _account_run_time_locked();
+    UBaseType_t count = 0;
+    for (TaskHandle_t task = s_tasks; task != NULL; task = task->next)
+    {
+        TaskStatus_t *status = &task_status_array[count++];
+        status->xHandle              = task;
+        status->pcTaskName           = task->name;
+        status->xTaskNumber          = task->number;
+        status->eCurrentState        = (task == self_task) ? eRunning
+                                       : (task->kind == HOST_TASK_SYNTHETIC) ? eReady : eBlocked;
+        status->uxCurrentPriority    = task->priority;
+        status->uxBasePriority       = task->priority;
+        status->ulRunTimeCounter     = (uint32_t)task->run_time_us;
+        status->pxStackBase          = NULL;
+        status->usStackHighWaterMark = task->stack_unused / sizeof(StackType_t);
+        status->xCoreID              = task->core_id;
+    }
+    if (total_run_time != NULL)
+    {
+        *total_run_time = (uint32_t)now;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return count;
+}
+
+UBaseType_t uxTaskGetNumberOfTasks(void)
+{
+    pthread_mutex_lock(&s_lock);
+    UBaseType_t count = s_task_count;
+    pthread_mutex_unlock(&s_lock);
+    return count;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return s_current_task;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandleForCore(BaseType_t core_id)
+{
+    TaskHandle_t task = s_current_task;
+    return (task != NULL && xPortGetCoreID() == core_id) ? task : xTaskGetIdleTaskHandleForCore(core_id);
+}
+
+TaskHandle_t xTaskGetIdleTaskHandleForCore(BaseType_t core_id)
+{
+    return (core_id >= 0 && core_id < portNUM_PROCESSORS) ? s_idle_tasks[core_id] : NULL;
+}
+
+char *pcTaskGetName(TaskHandle_t task)
+{
+    task = (task != NULL) ? task : s_current_task;
+    return (task != NULL) ? task->name : NULL;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    TaskHandle_t self_task = s_current_task;
+    struct timespec deadline;
+    pthread_mutex_lock(&s_lock);
+    const struct timespec *until = _deadline_after(ticks_to_wait, &deadline);
+    while (self_task->notify_count == 0 && ticks_to_wait > 0 && _wait_locked(until))
+    {
+    }
+    uint32_t count = self_task->notify_count;
+    if (count > 0)
+    {
+        self_task->notify_count = clear_on_exit ? 0 : count - 1;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return count;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    pthread_mutex_lock(&s_lock);
+    task->notify_count++;
+    pthread_cond_broadcast(&s_cond);
+    pthread_mutex_unlock(&s_lock);
+    return pdPASS;
+}
+
+void *pvTaskGetThreadLocalStoragePointer(TaskHandle_t task, BaseType_t index)
+{
+    task = (task != NULL) ? task : s_current_task;
+    return (task != NULL && index >= 0 && index < CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS)
+           ? task->tls[index] : NULL;
+}
+
+void vTaskSetThreadLocalStoragePointer(TaskHandle_t task, BaseType_t index, void *value)
+{
+    task = (task != NULL) ? task : s_current_task;
+    if (task != NULL && index >= 0 && index < CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS)
+    {
+        task->tls[index] = value;
+    }
+}
+
+// ============================================================================
+// Semaphore API
+// ============================================================================
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return (SemaphoreHandle_t)calloc(1, sizeof(struct QueueDefinition));
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait)
+{
+    struct timespec deadline;
+    pthread_mutex_lock(&s_lock);
+    const struct timespec *until = _deadline_after(ticks_to_wait, &deadline);
+    while (!semaphore->given && ticks_to_wait > 0 && _wait_locked(until))
+    {
+    }
+    bool taken = semaphore->given;
+    semaphore->given = false;
+    pthread_mutex_unlock(&s_lock);
+    return taken ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    pthread_mutex_lock(&s_lock);
+    bool was_given = semaphore->given;
+    semaphore->given = true;
+    pthread_cond_broadcast(&s_cond);
+    pthread_mutex_unlock(&s_lock);
+    return was_given ? pdFALSE : pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    free(semaphore);
+}
+
+// ============================================================================
+// Driver API
+// ============================================================================
+
+int sysmon_host_tasks_add(int count, TaskHandle_t *handles)
+{
+    pthread_mutex_lock(&s_lock);
+    // Bring the counters up to date, so the new split only applies from now on
+    _account_run_time_locked();
+
+    int added = 0;
+    for (; added < count; added++)
+    {
+        uint32_t sequence = s_synthetic_created++;
+        uint32_t hash = sequence * 2654435761U;
+        char name[configMAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "work%" PRIu32, sequence);
+
+        // Round-robin over the cores plus "unpinned"
+        int slot = (int)(sequence % (portNUM_PROCESSORS + 1));
+        BaseType_t core_id = (slot < portNUM_PROCESSORS) ? slot : tskNO_AFFINITY;
+        TaskHandle_t task = _task_create_locked(name, 1 + sequence % 10, core_id,
+                                                SYSMON_HOST_TASK_STACK_SIZE, HOST_TASK_SYNTHETIC);
+        if (task == NULL)
+        {
+            break;
+        }
+        task->weight       = 0.5 + (double)((hash >> 16) & 0xFF) / 255.0;
+        task->stack_unused = 512 + (hash >> 8) % 2048;
+        if (handles != NULL)
+        {
+            handles[added] = task;
+        }
+    }
+    _synthetic_rebalance_locked();
+    pthread_mutex_unlock(&s_lock);
+    return added;
+}
+
+int sysmon_host_tasks_remove(int count)
+{
+    pthread_mutex_lock(&s_lock);
+    _account_run_time_locked();
+
+    int removed = 0;
+    TaskHandle_t task = s_tasks;
+    while (task != NULL && removed < count)
+    {
+        TaskHandle_t next = task->next;
+        if (task->kind == HOST_TASK_SYNTHETIC)
+        {
+            _task_unlink_locked(task);
+            free(task);
+            removed++;
+        }
+        task = next;
+    }
+    _synthetic_rebalance_locked();
+    pthread_mutex_unlock(&s_lock);
+    return removed;
+}
+
+uint64_t sysmon_host_wait_sample(void)
+{
+    pthread_mutex_lock(&s_lock);
+    _wait_parked_locked();
+    uint64_t cpu_ns = s_sample_cpu_ns;
+    pthread_mutex_unlock(&s_lock);
+    return cpu_ns;
+}
+
+uint64_t sysmon_host_step(void)
+{
+    pthread_mutex_lock(&s_lock);
+    _wait_parked_locked();
+    s_release_count++;
+    pthread_cond_broadcast(&s_cond);
+    _wait_parked_locked();
+    uint64_t cpu_ns = s_sample_cpu_ns;
+    pthread_mutex_unlock(&s_lock);
+    return cpu_ns;
+}
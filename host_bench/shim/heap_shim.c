@@ -0,0 +1,310 @@
+/**
+ * @file heap_shim.c
+ * @brief Host shim of the ESP-IDF capability heap, with allocation accounting.
+ *
+ * The link wraps malloc(), calloc(), realloc() and free()
+ * (-Wl,--wrap=...), so every allocation made by sysmon, cJSON and the
+ * shims is counted in usable bytes. No header is added to blocks, so
+ * blocks freed here that the C library allocated internally stay valid; they
+ * are only ever subtracted down to zero.
+ *
+ * The emulated heap has a fixed size (sysmon_host_heap_set_size()); free,
+ * largest-block and minimum-free sizes of the internal heap are reported
+ * against it. Regions the host does not have (PSRAM, RTC RAM, IRAM) are
+ * reported with a size of 0 and allocations from them fail.
+ */
+
+#define _GNU_SOURCE
+
+// Project-specific includes
+#include "sysmon_host.h"
+
+// ESP-IDF includes
+#include "esp_heap_caps.h"
+#include "esp_system.h"
+
+// System includes
+#include <malloc.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Default emulated heap size
+#define HOST_HEAP_DEFAULT_SIZE (64U * 1024U * 1024U)
+
+// Capabilities the host heap does not provide
+#define HOST_HEAP_MISSING_CAPS (MALLOC_CAP_SPIRAM | MALLOC_CAP_RTCRAM | MALLOC_CAP_EXEC | MALLOC_CAP_IRAM_8BIT)
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+static pthread_mutex_t s_heap_lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t s_heap_size = HOST_HEAP_DEFAULT_SIZE;
+static size_t s_in_use = 0;
+static size_t s_peak = 0;
+static size_t s_lifetime_peak = 0;
+static uint64_t s_alloc_bytes = 0;
+static uint32_t s_alloc_count = 0;
+static size_t s_block_count = 0;
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Check whether an allocation fits in the emulated heap.
+ *
+ * @param size Requested size.
+ * @return true if it fits.
+ */
+static bool _heap_fits(size_t size)
+{
+    pthread_mutex_lock(&s_heap_lock);
+    bool fits = size <= s_heap_size && s_in_use <= s_heap_size - size;
+    pthread_mutex_unlock(&s_heap_lock);
+    return fits;
+}
+
+/**
+ * @brief Count a new block.
+ *
+ * @param ptr Block (NULL is ignored).
+ */
+static void _heap_count_alloc(void *ptr)
+{
+    if (ptr == NULL)
+    {
+        return;
+    }
+    size_t size = malloc_usable_size(ptr);
+    pthread_mutex_lock(&s_heap_lock);
+    s_in_use += size;
+    s_alloc_bytes += size;
+    s_alloc_count++;
+    s_block_count++;
+    if (s_in_use > s_peak)
+    {
+        s_peak = s_in_use;
+    }
+    if (s_in_use > s_lifetime_peak)
+    {
+        s_lifetime_peak = s_in_use;
+    }
+    pthread_mutex_unlock(&s_heap_lock);
+}
+
+/**
+ * @brief Count a released block.
+ *
+ * @param size Usable size of the block.
+ */
+static void _heap_count_free(size_t size)
+{
+    pthread_mutex_lock(&s_heap_lock);
+    s_in_use = (size < s_in_use) ? s_in_use - size : 0;
+    s_block_count = (s_block_count > 0) ? s_block_count - 1 : 0;
+    pthread_mutex_unlock(&s_heap_lock);
+}
+
+/**
+ * @brief Check whether a capability set is served by the host heap.
+ *
+ * @param caps MALLOC_CAP_* flags.
+ * @return true if the host heap provides the capabilities.
+ */
+static bool _heap_caps_available(uint32_t caps)
+{
+    return (caps & HOST_HEAP_MISSING_CAPS) == 0;
+}
+
+// ============================================================================
+// Wrapped C Allocator
+// ============================================================================
+
+void *__wrap_malloc(size_t size)
+{
+    if (!_heap_fits(size))
+    {
+        return NULL;
+    }
+    void *ptr = __real_malloc(size);
+    _heap_count_alloc(ptr);
+    return ptr;
+}
+
+void *__wrap_calloc(size_t n, size_t size)
+{
+    if (size != 0 && n > SIZE_MAX / size)
+    {
+        return NULL;
+    }
+    if (!_heap_fits(n * size))
+    {
+        return NULL;
+    }
+    void *ptr = __real_calloc(n, size);
+    _heap_count_alloc(ptr);
+    return ptr;
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    size_t old_size = (ptr != NULL) ? malloc_usable_size(ptr) : 0;
+    if (size > old_size && !_heap_fits(size - old_size))
+    {
+        return NULL;
+    }
+    void *resized = __real_realloc(ptr, size);
+    if (resized == NULL)
+    {
+        // realloc(ptr, 0) may free ptr and return NULL
+        if (ptr != NULL && size == 0)
+        {
+            _heap_count_free(old_size);
+        }
+        return NULL;
+    }
+    if (ptr != NULL)
+    {
+        _heap_count_free(old_size);
+    }
+    _heap_count_alloc(resized);
+    return resized;
+}
+
+void __wrap_free(void *ptr)
+{
+    if (ptr == NULL)
+    {
+        return;
+    }
+    _heap_count_free(malloc_usable_size(ptr));
+    __real_free(ptr);
+}
+
+// ============================================================================
+// Capability Heap API
+// ============================================================================
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    return _heap_caps_available(caps) ? malloc(size) : NULL;
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    return _heap_caps_available(caps) ? calloc(n, size) : NULL;
+}
+
+void *heap_caps_realloc(void *ptr, size_t size, uint32_t caps)
+{
+    return _heap_caps_available(caps) ? realloc(ptr, size) : NULL;
+}
+
+void heap_caps_free(void *ptr)
+{
+    free(ptr);
+}
+
+size_t heap_caps_get_total_size(uint32_t caps)
+{
+    if (!_heap_caps_available(caps))
+    {
+        return 0;
+    }
+    pthread_mutex_lock(&s_heap_lock);
+    size_t size = s_heap_size;
+    pthread_mutex_unlock(&s_heap_lock);
+    return size;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    if (!_heap_caps_available(caps))
+    {
+        return 0;
+    }
+    pthread_mutex_lock(&s_heap_lock);
+    size_t size = (s_in_use < s_heap_size) ? s_heap_size - s_in_use : 0;
+    pthread_mutex_unlock(&s_heap_lock);
+    return size;
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps)
+{
+    if (!_heap_caps_available(caps))
+    {
+        return 0;
+    }
+    pthread_mutex_lock(&s_heap_lock);
+    size_t size = (s_lifetime_peak < s_heap_size) ? s_heap_size - s_lifetime_peak : 0;
+    pthread_mutex_unlock(&s_heap_lock);
+    return size;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    // The host allocator does not fragment the emulated heap
+    return heap_caps_get_free_size(caps);
+}
+
+void heap_caps_get_info(multi_heap_info_t *info, uint32_t caps)
+{
+    memset(info, 0, sizeof(*info));
+    if (!_heap_caps_available(caps))
+    {
+        return;
+    }
+    pthread_mutex_lock(&s_heap_lock);
+    info->total_allocated_bytes = s_in_use;
+    info->total_free_bytes      = (s_in_use < s_heap_size) ? s_heap_size - s_in_use : 0;
+    info->largest_free_block    = info->total_free_bytes;
+    info->minimum_free_bytes    = (s_lifetime_peak < s_heap_size) ? s_heap_size - s_lifetime_peak : 0;
+    info->allocated_blocks      = s_block_count;
+    info->free_blocks           = 1;
+    info->total_blocks          = s_block_count + 1;
+    pthread_mutex_unlock(&s_heap_lock);
+}
+
+uint32_t esp_get_free_heap_size(void)
+{
+    return (uint32_t)heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+}
+
+uint32_t esp_get_minimum_free_heap_size(void)
+{
+    return (uint32_t)heap_caps_get_minimum_free_size(MALLOC_CAP_DEFAULT);
+}
+
+// ============================================================================
+// Driver API
+// ============================================================================
+
+void sysmon_host_heap_mark(void)
+{
+    pthread_mutex_lock(&s_heap_lock);
+    s_peak        = s_in_use;
+    s_alloc_bytes = 0;
+    s_alloc_count = 0;
+    pthread_mutex_unlock(&s_heap_lock);
+}
+
+void sysmon_host_heap_get(sysmon_host_heap_stats_t *stats)
+{
+    pthread_mutex_lock(&s_heap_lock);
+    stats->in_use      = s_in_use;
+    stats->peak        = s_peak;
+    stats->alloc_bytes = s_alloc_bytes;
+    stats->alloc_count = s_alloc_count;
+    pthread_mutex_unlock(&s_heap_lock);
+}
+
+void sysmon_host_heap_set_size(size_t total_bytes)
+{
+    pthread_mutex_lock(&s_heap_lock);
+    s_heap_size = total_bytes;
+    pthread_mutex_unlock(&s_heap_lock);
+}
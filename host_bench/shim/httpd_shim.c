@@ -0,0 +1,470 @@
+/**
+ * @file httpd_shim.c
+ * @brief Host shim of the ESP-IDF HTTP server, measuring responses instead of sending them.
+ *
+ * httpd_start() creates a handler table; sysmon_host_request() looks up the
+ * handler by exact path and method, builds an httpd_req_t and runs the
+ * handler on the calling thread. Every response function adds to the
+ * measurement for that request (status, body bytes, chunks) and discards
+ * the data. No request headers are present.
+ *
+ * WebSocket subscribers are plain descriptors: sysmon_host_ws_connect() runs
+ * the '/ws' handshake, httpd_ws_get_fd_info() reports open descriptors as
+ * WebSockets, and httpd_ws_send_frame_async() counts frames and bytes.
+ * httpd_queue_work() runs the work item immediately on the calling thread.
+ */
+
+// Project-specific includes
+#include "sysmon_host.h"
+
+// ESP-IDF includes
+#include "esp_http_server.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Descriptor reported for plain HTTP requests
+#define HOST_HTTP_FD        50
+
+// WebSocket descriptors are HOST_WS_FD_BASE + slot
+#define HOST_WS_FD_BASE     100
+#define HOST_WS_MAX_CLIENTS 16
+
+/**
+ * @brief Server instance (what an httpd_handle_t points to).
+ *
+ * Members:
+ * - handlers      : Registered handlers (max_handlers entries).
+ * - handler_count : Registered handlers in use.
+ * - max_handlers  : Table size from httpd_config_t.max_uri_handlers.
+ */
+typedef struct
+{
+    httpd_uri_t *handlers;
+    size_t handler_count;
+    size_t max_handlers;
+} host_server_t;
+
+/**
+ * @brief Request state behind httpd_req_t.aux.
+ *
+ * Members:
+ * - query    : Query string (without '?'), or NULL.
+ * - fd       : Descriptor returned by httpd_req_to_sockfd().
+ * - response : Measurement being filled.
+ */
+typedef struct
+{
+    const char *query;
+    int fd;
+    sysmon_host_response_t *response;
+} host_request_t;
+
+static host_server_t *s_server = NULL;
+static bool s_ws_open[HOST_WS_MAX_CLIENTS];
+static uint32_t s_ws_frames = 0;
+static uint64_t s_ws_bytes = 0;
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Get the measurement of a request.
+ *
+ * @param r Request.
+ * @return Response measurement.
+ */
+static sysmon_host_response_t *_response_of(httpd_req_t *r)
+{
+    return ((host_request_t *)r->aux)->response;
+}
+
+/**
+ * @brief Find the handler registered for a path and method.
+ *
+ * @param path Path (without query).
+ * @param path_len Path length.
+ * @param method HTTP method.
+ * @return Handler, or NULL.
+ */
+static const httpd_uri_t *_find_handler(const char *path, size_t path_len, httpd_method_t method)
+{
+    if (s_server == NULL)
+    {
+        return NULL;
+    }
+    for (size_t i = 0; i < s_server->handler_count; i++)
+    {
+        const httpd_uri_t *handler = &s_server->handlers[i];
+        if (handler->method == method && strlen(handler->uri) == path_len &&
+            strncmp(handler->uri, path, path_len) == 0)
+        {
+            return handler;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Copy a string into a caller buffer, truncating like ESP-IDF.
+ *
+ * @param buf Destination.
+ * @param buf_len Destination size (including the terminator).
+ * @param src Source.
+ * @param src_len Source length.
+ * @return ESP_OK, or ESP_ERR_HTTPD_RESULT_TRUNC if truncated.
+ */
+static esp_err_t _copy_truncated(char *buf, size_t buf_len, const char *src, size_t src_len)
+{
+    if (buf_len == 0)
+    {
+        return ESP_ERR_HTTPD_RESULT_TRUNC;
+    }
+    size_t copy = (src_len < buf_len - 1) ? src_len : buf_len - 1;
+    memcpy(buf, src, copy);
+    buf[copy] = '\0';
+    return (copy < src_len) ? ESP_ERR_HTTPD_RESULT_TRUNC : ESP_OK;
+}
+
+/**
+ * @brief Run a handler on a request built from a path and query.
+ *
+ * @param handler Handler.
+ * @param uri Full URI.
+ * @param query Query string, or NULL.
+ * @param fd Descriptor for httpd_req_to_sockfd().
+ * @param response Output: measurement.
+ */
+static void _run_handler(const httpd_uri_t *handler, const char *uri, const char *query, int fd,
+                         sysmon_host_response_t *response)
+{
+    memset(response, 0, sizeof(*response));
+    response->status = 200;
+
+    host_request_t state = { .query = query, .fd = fd, .response = response };
+    httpd_req_t request;
+    memset(&request, 0, sizeof(request));
+    request.handle   = s_server;
+    request.method   = handler->method;
+    request.aux      = &state;
+    request.user_ctx = handler->user_ctx;
+    snprintf((char *)request.uri, sizeof(request.uri), "%s", uri);
+
+    response->result = handler->handler(&request);
+    if (request.free_ctx != NULL && request.sess_ctx != NULL)
+    {
+        request.free_ctx(request.sess_ctx);
+    }
+}
+
+// ============================================================================
+// Server API
+// ============================================================================
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config)
+{
+    if (handle == NULL || config == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_server != NULL)
+    {
+        // One server per process, like one listening port
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    host_server_t *server = (host_server_t *)calloc(1, sizeof(*server));
+    if (server == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    server->handlers = (httpd_uri_t *)calloc(config->max_uri_handlers, sizeof(httpd_uri_t));
+    if (server->handlers == NULL)
+    {
+        free(server);
+        return ESP_ERR_NO_MEM;
+    }
+    server->max_handlers = config->max_uri_handlers;
+    s_server = server;
+    *handle  = server;
+    return ESP_OK;
+}
+
+esp_err_t httpd_stop(httpd_handle_t handle)
+{
+    if (handle == NULL || handle != s_server)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    free(s_server->handlers);
+    free(s_server);
+    s_server = NULL;
+    memset(s_ws_open, 0, sizeof(s_ws_open));
+    return ESP_OK;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler)
+{
+    if (handle == NULL || handle != s_server || uri_handler == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (_find_handler(uri_handler->uri, strlen(uri_handler->uri), uri_handler->method) != NULL)
+    {
+        return ESP_ERR_HTTPD_HANDLER_EXISTS;
+    }
+    if (s_server->handler_count >= s_server->max_handlers)
+    {
+        return ESP_ERR_HTTPD_HANDLERS_FULL;
+    }
+    s_server->handlers[s_server->handler_count++] = *uri_handler;
+    return ESP_OK;
+}
+
+esp_err_t httpd_queue_work(httpd_handle_t handle, httpd_work_fn_t work, void *arg)
+{
+    if (handle == NULL || handle != s_server || work == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    work(arg);
+    return ESP_OK;
+}
+
+// ============================================================================
+// Response API
+// ============================================================================
+
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len)
+{
+    if (buf_len == HTTPD_RESP_USE_STRLEN)
+    {
+        buf_len = (buf != NULL) ? (ssize_t)strlen(buf) : 0;
+    }
+    _response_of(r)->bytes += (size_t)buf_len;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send_chunk(httpd_req_t *r, const char *buf, ssize_t buf_len)
+{
+    if (buf_len == HTTPD_RESP_USE_STRLEN)
+    {
+        buf_len = (buf != NULL) ? (ssize_t)strlen(buf) : 0;
+    }
+    // A NULL/empty chunk terminates the response
+    if (buf != NULL && buf_len > 0)
+    {
+        sysmon_host_response_t *response = _response_of(r);
+        response->bytes += (size_t)buf_len;
+        response->chunks++;
+    }
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type)
+{
+    (void)r;
+    (void)type;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr(httpd_req_t *r, const char *field, const char *value)
+{
+    (void)r;
+    (void)field;
+    (void)value;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_status(httpd_req_t *r, const char *status)
+{
+    _response_of(r)->status = atoi(status);
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send_err(httpd_req_t *req, httpd_err_code_t error, const char *msg)
+{
+    static const int status_codes[] =
+    {
+        [HTTPD_500_INTERNAL_SERVER_ERROR] = 500,
+        [HTTPD_501_METHOD_NOT_IMPLEMENTED] = 501,
+        [HTTPD_505_VERSION_NOT_SUPPORTED] = 505,
+        [HTTPD_400_BAD_REQUEST] = 400,
+        [HTTPD_401_UNAUTHORIZED] = 401,
+        [HTTPD_403_FORBIDDEN] = 403,
+        [HTTPD_404_NOT_FOUND] = 404,
+        [HTTPD_405_METHOD_NOT_ALLOWED] = 405
+    };
+
+    sysmon_host_response_t *response = _response_of(req);
+    response->status = ((size_t)error < sizeof(status_codes) / sizeof(status_codes[0])) ? status_codes[error] : 500;
+    response->bytes += (msg != NULL) ? strlen(msg) : 0;
+    // ESP-IDF returns ESP_FAIL so the handler's return value closes the socket
+    return ESP_FAIL;
+}
+
+// ============================================================================
+// Request API
+// ============================================================================
+
+size_t httpd_req_get_url_query_len(httpd_req_t *r)
+{
+    const char *query = ((host_request_t *)r->aux)->query;
+    return (query != NULL) ? strlen(query) : 0;
+}
+
+esp_err_t httpd_req_get_url_query_str(httpd_req_t *r, char *buf, size_t buf_len)
+{
+    const char *query = ((host_request_t *)r->aux)->query;
+    if (query == NULL)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    return _copy_truncated(buf, buf_len, query, strlen(query));
+}
+
+esp_err_t httpd_query_key_value(const char *qry, const char *key, char *val, size_t val_size)
+{
+    if (qry == NULL || key == NULL || val == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t key_len = strlen(key);
+    const char *pair = qry;
+    while (*pair != '\0')
+    {
+        const char *end = strchr(pair, '&');
+        size_t pair_len = (end != NULL) ? (size_t)(end - pair) : strlen(pair);
+        if (pair_len > key_len && strncmp(pair, key, key_len) == 0 && pair[key_len] == '=')
+        {
+            return _copy_truncated(val, val_size, pair + key_len + 1, pair_len - key_len - 1);
+        }
+        if (end == NULL)
+        {
+            break;
+        }
+        pair = end + 1;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *r, const char *field, char *val, size_t val_size)
+{
+    (void)r;
+    (void)field;
+    (void)val;
+    (void)val_size;
+    return ESP_ERR_NOT_FOUND;
+}
+
+int httpd_req_to_sockfd(httpd_req_t *r)
+{
+    return ((host_request_t *)r->aux)->fd;
+}
+
+// ============================================================================
+// WebSocket API
+// ============================================================================
+
+esp_err_t httpd_ws_recv_frame(httpd_req_t *req, httpd_ws_frame_t *pkt, size_t max_len)
+{
+    (void)req;
+    (void)max_len;
+    // Clients never send anything
+    pkt->len = 0;
+    return ESP_OK;
+}
+
+esp_err_t httpd_ws_send_frame_async(httpd_handle_t hd, int fd, httpd_ws_frame_t *frame)
+{
+    if (hd == NULL || hd != s_server || httpd_ws_get_fd_info(hd, fd) != HTTPD_WS_CLIENT_WEBSOCKET)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_ws_frames++;
+    s_ws_bytes += frame->len;
+    return ESP_OK;
+}
+
+httpd_ws_client_info_t httpd_ws_get_fd_info(httpd_handle_t hd, int fd)
+{
+    if (hd == NULL || hd != s_server)
+    {
+        return HTTPD_WS_CLIENT_INVALID;
+    }
+    if (fd == HOST_HTTP_FD)
+    {
+        return HTTPD_WS_CLIENT_HTTP;
+    }
+    int slot = fd - HOST_WS_FD_BASE;
+    return (slot >= 0 && slot < HOST_WS_MAX_CLIENTS && s_ws_open[slot]) ? HTTPD_WS_CLIENT_WEBSOCKET
+                                                                        : HTTPD_WS_CLIENT_INVALID;
+}
+
+// ============================================================================
+// Driver API
+// ============================================================================
+
+esp_err_t sysmon_host_request(httpd_method_t method, const char *uri, sysmon_host_response_t *response)
+{
+    const char *query = strchr(uri, '?');
+    size_t path_len = (query != NULL) ? (size_t)(query - uri) : strlen(uri);
+    const httpd_uri_t *handler = _find_handler(uri, path_len, method);
+    if (handler == NULL)
+    {
+        memset(response, 0, sizeof(*response));
+        response->status = 404;
+        return ESP_ERR_NOT_FOUND;
+    }
+    _run_handler(handler, uri, (query != NULL) ? query + 1 : NULL, HOST_HTTP_FD, response);
+    return ESP_OK;
+}
+
+int sysmon_host_ws_connect(void)
+{
+    const httpd_uri_t *handler = _find_handler("/ws", 3, HTTP_GET);
+    if (handler == NULL)
+    {
+        return -1;
+    }
+
+    for (int slot = 0; slot < HOST_WS_MAX_CLIENTS; slot++)
+    {
+        if (s_ws_open[slot])
+        {
+            continue;
+        }
+        int fd = HOST_WS_FD_BASE + slot;
+        s_ws_open[slot] = true;
+
+        sysmon_host_response_t response;
+        _run_handler(handler, "/ws", NULL, fd, &response);
+        if (response.result != ESP_OK)
+        {
+            // A failed handshake closes the socket
+            s_ws_open[slot] = false;
+            return -1;
+        }
+        return fd;
+    }
+    return -1;
+}
+
+void sysmon_host_ws_close_all(void)
+{
+    memset(s_ws_open, 0, sizeof(s_ws_open));
+}
+
+void sysmon_host_ws_take_stats(uint32_t *frames, uint64_t *bytes)
+{
+    *frames = s_ws_frames;
+    *bytes  = s_ws_bytes;
+    s_ws_frames = 0;
+    s_ws_bytes  = 0;
+}
@@ -0,0 +1,14 @@
+/**
+ * @file gptimer.h
+ * @brief Host shim of the gptimer declarations (CONFIG_SYSMON_IRQ_ACCOUNTING stays disabled).
+ */
+
+#pragma once
+
+#include "esp_err.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct gptimer_t *gptimer_handle_t;
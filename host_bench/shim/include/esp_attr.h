@@ -0,0 +1,11 @@
+/**
+ * @file esp_attr.h
+ * @brief Host shim of the ESP-IDF placement attributes (all no-ops).
+ */
+
+#pragma once
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_NOINIT_ATTR
+#define EXT_RAM_NOINIT_ATTR
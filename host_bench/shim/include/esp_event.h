@@ -0,0 +1,20 @@
+/**
+ * @file esp_event.h
+ * @brief Host shim of the ESP-IDF default event loop (posts are counted and dropped).
+ */
+
+#pragma once
+
+#include "esp_err.h"
+
+// System includes
+#include <stddef.h>
+#include <stdint.h>
+
+typedef const char *esp_event_base_t;
+
+#define ESP_EVENT_DECLARE_BASE(id) extern esp_event_base_t const id
+#define ESP_EVENT_DEFINE_BASE(id)  esp_event_base_t const id = #id
+
+esp_err_t esp_event_post(esp_event_base_t event_base, int32_t event_id, const void *event_data,
+                         size_t event_data_size, uint32_t ticks_to_wait);
@@ -0,0 +1,16 @@
+/**
+ * @file esp_flash.h
+ * @brief Host shim of the SPI flash read API (a fixed fake flash image).
+ */
+
+#pragma once
+
+#include "esp_err.h"
+
+// System includes
+#include <stdint.h>
+
+typedef struct esp_flash_t esp_flash_t;
+
+esp_err_t esp_flash_read(esp_flash_t *chip, void *buffer, uint32_t address, uint32_t length);
+esp_err_t esp_flash_get_size(esp_flash_t *chip, uint32_t *out_size);
@@ -0,0 +1,27 @@
+/**
+ * @file esp_image_format.h
+ * @brief Host shim of the app image header layout.
+ */
+
+#pragma once
+
+// System includes
+#include <stdint.h>
+
+#define ESP_IMAGE_HEADER_MAGIC 0xE9
+
+typedef struct __attribute__((packed))
+{
+    uint8_t magic;
+    uint8_t segment_count;
+    uint8_t spi_mode;
+    uint8_t spi_speed_size;
+    uint32_t entry_addr;
+    uint8_t reserved[16];
+} esp_image_header_t;
+
+typedef struct
+{
+    uint32_t load_addr;
+    uint32_t data_len;
+} esp_image_segment_header_t;
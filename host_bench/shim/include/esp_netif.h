@@ -0,0 +1,33 @@
+/**
+ * @file esp_netif.h
+ * @brief Host shim of the station netif lookup (always up on 127.0.0.1).
+ */
+
+#pragma once
+
+#include "esp_err.h"
+
+// System includes
+#include <stdint.h>
+
+typedef struct esp_netif_obj esp_netif_t;
+
+typedef struct
+{
+    uint32_t addr;
+} esp_ip4_addr_t;
+
+typedef struct
+{
+    esp_ip4_addr_t ip;
+    esp_ip4_addr_t netmask;
+    esp_ip4_addr_t gw;
+} esp_netif_ip_info_t;
+
+#define esp_ip4_addr_get_byte(ipaddr, idx) (((const uint8_t *)(&(ipaddr)->addr))[idx])
+#define IP2STR(ipaddr) esp_ip4_addr_get_byte(ipaddr, 0), esp_ip4_addr_get_byte(ipaddr, 1), \
+                       esp_ip4_addr_get_byte(ipaddr, 2), esp_ip4_addr_get_byte(ipaddr, 3)
+#define IPSTR "%d.%d.%d.%d"
+
+esp_netif_t *esp_netif_get_handle_from_ifkey(const char *if_key);
+esp_err_t esp_netif_get_ip_info(esp_netif_t *esp_netif, esp_netif_ip_info_t *ip_info);
@@ -0,0 +1,69 @@
+/**
+ * @file esp_partition.h
+ * @brief Host shim of the partition table API (nvs, phy_init and factory).
+ *
+ * Writing and memory-mapping are only declared, for the flash log sources
+ * that the host configuration leaves disabled.
+ */
+
+#pragma once
+
+#include "esp_err.h"
+
+// System includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum
+{
+    ESP_PARTITION_TYPE_APP  = 0x00,
+    ESP_PARTITION_TYPE_DATA = 0x01,
+    ESP_PARTITION_TYPE_ANY  = 0xff
+} esp_partition_type_t;
+
+typedef enum
+{
+    ESP_PARTITION_SUBTYPE_APP_FACTORY    = 0x00,
+    ESP_PARTITION_SUBTYPE_DATA_PHY       = 0x01,
+    ESP_PARTITION_SUBTYPE_DATA_NVS       = 0x02,
+    ESP_PARTITION_SUBTYPE_DATA_UNDEFINED = 0x06,
+    ESP_PARTITION_SUBTYPE_ANY            = 0xff
+} esp_partition_subtype_t;
+
+typedef struct
+{
+    void *flash_chip;
+    esp_partition_type_t type;
+    esp_partition_subtype_t subtype;
+    uint32_t address;
+    uint32_t size;
+    uint32_t erase_size;
+    char label[17];
+    bool encrypted;
+    bool readonly;
+} esp_partition_t;
+
+typedef struct esp_partition_iterator_opaque_ *esp_partition_iterator_t;
+typedef uint32_t esp_partition_mmap_handle_t;
+
+typedef enum
+{
+    ESP_PARTITION_MMAP_DATA,
+    ESP_PARTITION_MMAP_INST
+} esp_partition_mmap_memory_t;
+
+esp_partition_iterator_t esp_partition_find(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                            const char *label);
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char *label);
+const esp_partition_t *esp_partition_get(esp_partition_iterator_t iterator);
+esp_partition_iterator_t esp_partition_next(esp_partition_iterator_t iterator);
+void esp_partition_iterator_release(esp_partition_iterator_t iterator);
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size);
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size);
+esp_err_t esp_partition_mmap(const esp_partition_t *partition, size_t offset, size_t size,
+                             esp_partition_mmap_memory_t memory, const void **out_ptr,
+                             esp_partition_mmap_handle_t *out_handle);
+void esp_partition_munmap(esp_partition_mmap_handle_t handle);
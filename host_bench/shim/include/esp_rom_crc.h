@@ -0,0 +1,11 @@
+/**
+ * @file esp_rom_crc.h
+ * @brief Host shim of the ROM CRC declaration (used by disabled features only).
+ */
+
+#pragma once
+
+// System includes
+#include <stdint.h>
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len);
@@ -0,0 +1,31 @@
+/**
+ * @file esp_system.h
+ * @brief Host shim of the ESP-IDF system API.
+ */
+
+#pragma once
+
+#include "esp_err.h"
+
+// System includes
+#include <stdint.h>
+
+typedef enum
+{
+    ESP_RST_UNKNOWN,
+    ESP_RST_POWERON,
+    ESP_RST_EXT,
+    ESP_RST_SW,
+    ESP_RST_PANIC,
+    ESP_RST_INT_WDT,
+    ESP_RST_TASK_WDT,
+    ESP_RST_WDT,
+    ESP_RST_DEEPSLEEP,
+    ESP_RST_BROWNOUT,
+    ESP_RST_SDIO
+} esp_reset_reason_t;
+
+uint32_t esp_get_free_heap_size(void);
+uint32_t esp_get_minimum_free_heap_size(void);
+esp_reset_reason_t esp_reset_reason(void);
+const char *esp_get_idf_version(void);
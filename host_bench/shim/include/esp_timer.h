@@ -0,0 +1,11 @@
+/**
+ * @file esp_timer.h
+ * @brief Host shim of esp_timer_get_time() (the benchmark's virtual clock).
+ */
+
+#pragma once
+
+// System includes
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
@@ -0,0 +1,21 @@
+/**
+ * @file esp_wifi.h
+ * @brief Host shim of the station AP query (a fixed access point).
+ */
+
+#pragma once
+
+#include "esp_err.h"
+
+// System includes
+#include <stdint.h>
+
+typedef struct
+{
+    uint8_t bssid[6];
+    uint8_t ssid[33];
+    uint8_t primary;
+    int8_t rssi;
+} wifi_ap_record_t;
+
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *ap_info);
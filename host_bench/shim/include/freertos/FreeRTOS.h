@@ -0,0 +1,69 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host shim of the ESP-IDF FreeRTOS base definitions.
+ *
+ * Only the types and macros sysmon uses, with the ESP-IDF (SMP) layout.
+ * Critical sections map to one process-wide recursive mutex.
+ */
+
+#pragma once
+
+#include "sdkconfig.h"
+
+// Pulled in by the ESP-IDF port layer as well
+#include "esp_heap_caps.h"
+#include "esp_system.h"
+
+// System includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint8_t StackType_t;
+
+typedef struct tskTaskControlBlock *TaskHandle_t;
+typedef struct QueueDefinition *QueueHandle_t;
+typedef QueueHandle_t SemaphoreHandle_t;
+
+typedef struct
+{
+    uint32_t owner;
+    uint32_t count;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED { 0, 0 }
+
+#define portNUM_PROCESSORS      CONFIG_FREERTOS_NUMBER_OF_CORES
+#define configNUMBER_OF_CORES   CONFIG_FREERTOS_NUMBER_OF_CORES
+#define configMAX_PRIORITIES    25
+#define configMAX_TASK_NAME_LEN 16
+#define configTICK_RATE_HZ      CONFIG_FREERTOS_HZ
+
+#define portMAX_DELAY           ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS      ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000U))
+#define pdTICKS_TO_MS(ticks)    ((uint32_t)(((uint64_t)(ticks) * 1000U) / configTICK_RATE_HZ))
+
+#define pdFALSE 0
+#define pdTRUE  1
+#define pdFAIL  pdFALSE
+#define pdPASS  pdTRUE
+
+#define tskNO_AFFINITY ((BaseType_t)0x7FFFFFFF)
+
+void vPortEnterCritical(portMUX_TYPE *mux);
+void vPortExitCritical(portMUX_TYPE *mux);
+BaseType_t xPortGetCoreID(void);
+
+#define portENTER_CRITICAL(mux)      vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux)       vPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux)  vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux)   vPortExitCritical(mux)
+#define portENTER_CRITICAL_SAFE(mux) vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_SAFE(mux)  vPortExitCritical(mux)
+
+#define portYIELD_FROM_ISR(...)      do { } while (0)
+#define xPortInIsrContext()          pdFALSE
@@ -0,0 +1,13 @@
+/**
+ * @file semphr.h
+ * @brief Host shim of the FreeRTOS binary semaphore API.
+ */
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
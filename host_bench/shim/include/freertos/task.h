@@ -0,0 +1,64 @@
+/**
+ * @file task.h
+ * @brief Host shim of the ESP-IDF FreeRTOS task API.
+ *
+ * Tasks created with xTaskCreate*() run as POSIX threads. The task list that
+ * uxTaskGetSystemState() reports also holds one idle task per core and the
+ * synthetic workload set up through sysmon_host.h. Ticks and run-time
+ * counters follow the benchmark's virtual clock (see freertos_shim.c).
+ */
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void *);
+
+typedef enum
+{
+    eRunning = 0,
+    eReady,
+    eBlocked,
+    eSuspended,
+    eDeleted,
+    eInvalid
+} eTaskState;
+
+// Same members as ESP-IDF v5 (configTASKLIST_INCLUDE_COREID enabled)
+typedef struct xTASK_STATUS
+{
+    TaskHandle_t xHandle;
+    const char *pcTaskName;
+    UBaseType_t xTaskNumber;
+    eTaskState eCurrentState;
+    UBaseType_t uxCurrentPriority;
+    UBaseType_t uxBasePriority;
+    uint32_t ulRunTimeCounter;
+    StackType_t *pxStackBase;
+    uint32_t usStackHighWaterMark;
+    BaseType_t xCoreID;
+} TaskStatus_t;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task_code, const char *name, uint32_t stack_depth,
+                                   void *parameters, UBaseType_t priority, TaskHandle_t *created_task,
+                                   BaseType_t core_id);
+BaseType_t xTaskCreate(TaskFunction_t task_code, const char *name, uint32_t stack_depth,
+                       void *parameters, UBaseType_t priority, TaskHandle_t *created_task);
+void vTaskDelete(TaskHandle_t task);
+
+void vTaskDelay(TickType_t ticks);
+BaseType_t xTaskDelayUntil(TickType_t *previous_wake, TickType_t increment);
+TickType_t xTaskGetTickCount(void);
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *task_status_array, UBaseType_t array_size, uint32_t *total_run_time);
+UBaseType_t uxTaskGetNumberOfTasks(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+TaskHandle_t xTaskGetCurrentTaskHandleForCore(BaseType_t core_id);
+TaskHandle_t xTaskGetIdleTaskHandleForCore(BaseType_t core_id);
+char *pcTaskGetName(TaskHandle_t task);
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+
+void *pvTaskGetThreadLocalStoragePointer(TaskHandle_t task, BaseType_t index);
+void vTaskSetThreadLocalStoragePointer(TaskHandle_t task, BaseType_t index, void *value);
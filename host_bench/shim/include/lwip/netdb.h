@@ -0,0 +1,11 @@
+/**
+ * @file netdb.h
+ * @brief Host shim of the lwIP resolver header (maps to POSIX).
+ */
+
+#pragma once
+
+#include "lwip/sockets.h"
+
+// System includes
+#include <netdb.h>
@@ -0,0 +1,12 @@
+/**
+ * @file sockets.h
+ * @brief Host shim of the lwIP socket header (maps to POSIX sockets).
+ */
+
+#pragma once
+
+// System includes
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
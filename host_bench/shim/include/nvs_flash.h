@@ -0,0 +1,22 @@
+/**
+ * @file nvs_flash.h
+ * @brief Host shim of nvs_get_stats() (fixed page statistics).
+ */
+
+#pragma once
+
+#include "esp_err.h"
+
+// System includes
+#include <stddef.h>
+
+typedef struct
+{
+    size_t used_entries;
+    size_t free_entries;
+    size_t available_entries;
+    size_t total_entries;
+    size_t namespace_count;
+} nvs_stats_t;
+
+esp_err_t nvs_get_stats(const char *part_name, nvs_stats_t *nvs_stats);
@@ -0,0 +1,11 @@
+/**
+ * @file clk_tree_defs.h
+ * @brief Host shim of the SoC clock identifiers.
+ */
+
+#pragma once
+
+typedef enum
+{
+    SOC_MOD_CLK_CPU = 0
+} soc_module_clk_t;
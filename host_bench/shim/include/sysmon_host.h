@@ -0,0 +1,183 @@
+/**
+ * @file sysmon_host.h
+ * @brief Control API of the sysmon host shims, used by the benchmark driver.
+ *
+ * The shims stand in for ESP-IDF and FreeRTOS so the unmodified sysmon
+ * sources run as a Linux process:
+ *   - Tasks: xTaskCreate*() starts a POSIX thread. uxTaskGetSystemState()
+ *     additionally reports one idle task per core and a synthetic workload
+ *     whose run-time counters advance with a virtual clock.
+ *   - Clock: esp_timer_get_time() and the tick count follow a virtual clock
+ *     that runs in real time while the sampler works and stands still while
+ *     it sleeps. xTaskDelayUntil() parks the sampler until the driver calls
+ *     sysmon_host_step(), then moves the clock to the deadline, so one step
+ *     is one sample regardless of the sampling interval.
+ *   - Heap: every malloc()/free() of the sysmon and cJSON objects is counted
+ *     (the link wraps the allocator); heap_caps_*() shares the same counters.
+ *   - HTTP: handlers registered with httpd_register_uri_handler() are called
+ *     directly by sysmon_host_request(), which measures the response.
+ */
+
+#pragma once
+
+#include "esp_err.h"
+#include "esp_http_server.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Measured response of one sysmon_host_request().
+ *
+ * Members:
+ * - status : HTTP status code (200 unless the handler set another one).
+ * - result : Handler return value.
+ * - bytes  : Body bytes sent (single response or all chunks).
+ * - chunks : Number of non-empty httpd_resp_send_chunk() calls.
+ */
+typedef struct
+{
+    int status;
+    esp_err_t result;
+    size_t bytes;
+    uint32_t chunks;
+} sysmon_host_response_t;
+
+/**
+ * @brief Heap counters since the last sysmon_host_heap_mark().
+ *
+ * Members:
+ * - in_use      : Bytes currently allocated.
+ * - peak        : Highest in_use since the mark.
+ * - alloc_bytes : Bytes allocated since the mark (frees are not subtracted).
+ * - alloc_count : Allocations since the mark.
+ */
+typedef struct
+{
+    size_t in_use;
+    size_t peak;
+    uint64_t alloc_bytes;
+    uint32_t alloc_count;
+} sysmon_host_heap_stats_t;
+
+// ============================================================================
+// Synthetic workload (freertos_shim.c)
+// ============================================================================
+
+/**
+ * @brief Add synthetic application tasks to the reported task list.
+ *
+ * Tasks are pinned round-robin to each core or left unpinned, and together
+ * keep the cores about 60% busy. Their handles can be registered with
+ * sysmon_stack_register() like real tasks (the stack depth is
+ * SYSMON_HOST_TASK_STACK_SIZE bytes).
+ *
+ * @param count Number of tasks to add.
+ * @param handles Output: created task handles (may be NULL, else count entries).
+ * @return Number of tasks added.
+ */
+int sysmon_host_tasks_add(int count, TaskHandle_t *handles);
+
+/**
+ * @brief Remove the oldest synthetic tasks.
+ *
+ * @param count Number of tasks to remove (clamped to the synthetic task count).
+ * @return Number of tasks removed.
+ */
+int sysmon_host_tasks_remove(int count);
+
+// Stack depth, in bytes, of every synthetic task
+#define SYSMON_HOST_TASK_STACK_SIZE 4096
+
+// ============================================================================
+// Sampler clock (freertos_shim.c)
+// ============================================================================
+
+/**
+ * @brief Wait until the sampler is parked in xTaskDelayUntil().
+ *
+ * @return Thread CPU time, in nanoseconds, the sampler used since it was
+ *         last released (for the first call: since it started).
+ */
+uint64_t sysmon_host_wait_sample(void);
+
+/**
+ * @brief Release the parked sampler for one interval and wait until it parks again.
+ *
+ * @return Thread CPU time, in nanoseconds, the sampler used for this sample.
+ */
+uint64_t sysmon_host_step(void);
+
+// ============================================================================
+// Heap accounting (heap_shim.c)
+// ============================================================================
+
+/**
+ * @brief Start a new measurement: reset peak and allocation counters.
+ */
+void sysmon_host_heap_mark(void);
+
+/**
+ * @brief Read the heap counters since the last mark.
+ *
+ * @param stats Output: counters.
+ */
+void sysmon_host_heap_get(sysmon_host_heap_stats_t *stats);
+
+/**
+ * @brief Set the size of the emulated internal heap.
+ *
+ * Allocations beyond it fail, and free/total sizes are reported against it.
+ *
+ * @param total_bytes Heap size in bytes.
+ */
+void sysmon_host_heap_set_size(size_t total_bytes);
+
+// ============================================================================
+// HTTP requests (httpd_shim.c)
+// ============================================================================
+
+/**
+ * @brief Run one request through the registered handler.
+ *
+ * @param method HTTP_GET or HTTP_POST.
+ * @param uri Path with optional '?query'.
+ * @param response Output: measured response.
+ * @return ESP_OK if a handler ran, ESP_ERR_NOT_FOUND if none matches the path.
+ */
+esp_err_t sysmon_host_request(httpd_method_t method, const char *uri, sysmon_host_response_t *response);
+
+/**
+ * @brief Open a WebSocket push subscriber with a '/ws' handshake.
+ *
+ * @return Socket descriptor of the subscriber, or -1 if the handshake failed.
+ */
+int sysmon_host_ws_connect(void);
+
+/**
+ * @brief Close every WebSocket subscriber.
+ */
+void sysmon_host_ws_close_all(void);
+
+/**
+ * @brief Read and reset the WebSocket send counters.
+ *
+ * @param frames Output: frames sent to all subscribers.
+ * @param bytes Output: payload bytes sent to all subscribers.
+ */
+void sysmon_host_ws_take_stats(uint32_t *frames, uint64_t *bytes);
+
+// ============================================================================
+// Logging (esp_shim.c)
+// ============================================================================
+
+/**
+ * @brief Set the highest level esp_log_write() prints.
+ *
+ * @param level Log level (ESP_LOG_ERROR by default).
+ */
+void sysmon_host_set_log_level(esp_log_level_t level);
@@ -33,6 +33,35 @@ extern "C" {
 #define CONFIG_SYSMON_SAMPLE_COUNT 60
 #endif
 
+#ifndef CONFIG_SYSMON_SAMPLE_COUNT_MAX
+#define CONFIG_SYSMON_SAMPLE_COUNT_MAX 1000
+#endif
+
+#if CONFIG_SYSMON_SAMPLE_COUNT > CONFIG_SYSMON_SAMPLE_COUNT_MAX
+#error "CONFIG_SYSMON_SAMPLE_COUNT must not exceed CONFIG_SYSMON_SAMPLE_COUNT_MAX"
+#endif
+
+#ifdef CONFIG_SYSMON_ADAPTIVE_SAMPLING
+#ifndef CONFIG_SYSMON_ADAPTIVE_MAX_FACTOR
+#define CONFIG_SYSMON_ADAPTIVE_MAX_FACTOR          10
+#endif
+#ifndef CONFIG_SYSMON_ADAPTIVE_QUIET_S
+#define CONFIG_SYSMON_ADAPTIVE_QUIET_S             60
+#endif
+#ifndef CONFIG_SYSMON_ADAPTIVE_CPU_DELTA_PERCENT
+#define CONFIG_SYSMON_ADAPTIVE_CPU_DELTA_PERCENT   10
+#endif
+#ifndef CONFIG_SYSMON_ADAPTIVE_DRAM_FREE_MIN
+#define CONFIG_SYSMON_ADAPTIVE_DRAM_FREE_MIN       32768
+#endif
+#if CONFIG_SYSMON_ADAPTIVE_MAX_FACTOR < 2
+#error "CONFIG_SYSMON_ADAPTIVE_MAX_FACTOR must be at least 2"
+#endif
+#if CONFIG_SYSMON_ADAPTIVE_MAX_FACTOR > CONFIG_SYSMON_SAMPLE_COUNT
+#error "CONFIG_SYSMON_ADAPTIVE_MAX_FACTOR must not exceed CONFIG_SYSMON_SAMPLE_COUNT"
+#endif
+#endif
+
 #ifndef CONFIG_SYSMON_HTTPD_SERVER_PORT
 #define CONFIG_SYSMON_HTTPD_SERVER_PORT 8080
 #endif
@@ -41,84 +70,683 @@ extern "C" {
 #define CONFIG_SYSMON_HTTPD_CTRL_PORT   32768
 #endif
 
+#ifndef CONFIG_SYSMON_HARDWARE_REFRESH_MS
+#define CONFIG_SYSMON_HARDWARE_REFRESH_MS 10000
+#endif
+
 
 #define SYSMON_MONITOR_STACK_SIZE  4096
 #define SYSMON_MONITOR_PRIORITY    7
 #define SYSMON_MONITOR_CORE        0
 
 #define SYSMON_MAX_TRACKED_TASKS        256
+
+// Number of CPU cores sampled (1 on single-core targets such as ESP32-C3/C6)
+#define SYSMON_CORE_COUNT               portNUM_PROCESSORS
 #define SYSMON_ZERO_THRESHOLD           0.0001f
 
+// Limits of the runtime sampling configuration (see sysmon_set_sampling())
+#define SYSMON_SAMPLING_INTERVAL_MIN_MS 100
+#define SYSMON_SAMPLING_INTERVAL_MAX_MS 10000
+#define SYSMON_SAMPLE_COUNT_MIN         10
+
+// Ring index of the j-th sample (oldest = 0) in a snapshot's history window
+#define SYSMON_HISTORY_INDEX(snapshot, j) (((snapshot)->oldest_index + (int)(j)) % (snapshot)->history->slots)
+
+// Downsampled history tiers (see sysmon_rollup.h)
+#ifdef CONFIG_SYSMON_ROLLUPS
+#ifndef CONFIG_SYSMON_ROLLUP_MID_SAMPLES
+#define CONFIG_SYSMON_ROLLUP_MID_SAMPLES    10
+#endif
+#ifndef CONFIG_SYSMON_ROLLUP_MID_COUNT
+#define CONFIG_SYSMON_ROLLUP_MID_COUNT      360
+#endif
+#ifndef CONFIG_SYSMON_ROLLUP_COARSE_FACTOR
+#define CONFIG_SYSMON_ROLLUP_COARSE_FACTOR  6
+#endif
+#ifndef CONFIG_SYSMON_ROLLUP_COARSE_COUNT
+#define CONFIG_SYSMON_ROLLUP_COARSE_COUNT   480
+#endif
+#define SYSMON_ROLLUP_TIER_COUNT        2
+// Each tier ring has one spare bucket for the same reason as the raw history rings
+#define SYSMON_ROLLUP_SLOTS             ((CONFIG_SYSMON_ROLLUP_MID_COUNT + 1) + (CONFIG_SYSMON_ROLLUP_COARSE_COUNT + 1))
+#if CONFIG_SYSMON_ROLLUP_MID_SAMPLES > CONFIG_SYSMON_SAMPLE_COUNT
+#error "CONFIG_SYSMON_ROLLUP_MID_SAMPLES must not exceed CONFIG_SYSMON_SAMPLE_COUNT"
+#endif
+#if CONFIG_SYSMON_ROLLUP_COARSE_FACTOR > CONFIG_SYSMON_ROLLUP_MID_COUNT
+#error "CONFIG_SYSMON_ROLLUP_COARSE_FACTOR must not exceed CONFIG_SYSMON_ROLLUP_MID_COUNT"
+#endif
+#else
+#define SYSMON_ROLLUP_TIER_COUNT        0
+#endif
+
+// Per-capability heap region profiling (see sysmon_heap.h)
+#ifdef CONFIG_SYSMON_HEAP_PROFILE
+#ifndef CONFIG_SYSMON_HEAP_PROFILE_SAMPLES
+#define CONFIG_SYSMON_HEAP_PROFILE_SAMPLES  10
+#endif
+#ifndef CONFIG_SYSMON_HEAP_PROFILE_COUNT
+#define CONFIG_SYSMON_HEAP_PROFILE_COUNT    60
+#endif
+#define SYSMON_HEAP_REGION_COUNT        5
+// One spare entry per region ring, as for the raw history rings
+#define SYSMON_HEAP_PROFILE_SLOTS       (CONFIG_SYSMON_HEAP_PROFILE_COUNT + 1)
+#else
+#define SYSMON_HEAP_REGION_COUNT        0
+#endif
+
+// Per-task heap attribution through the heap alloc/free hooks (see sysmon_heap.h)
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+#ifndef CONFIG_HEAP_USE_HOOKS
+    #error "CONFIG_SYSMON_HEAP_TASK_TRACKING requires CONFIG_HEAP_USE_HOOKS to be enabled in sdkconfig."
+#endif
+#ifndef CONFIG_SYSMON_HEAP_TASK_TLS_INDEX
+#define CONFIG_SYSMON_HEAP_TASK_TLS_INDEX   1
+#endif
+#if CONFIG_SYSMON_HEAP_TASK_TLS_INDEX >= CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS
+    #error "CONFIG_SYSMON_HEAP_TASK_TLS_INDEX must be below CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS."
+#endif
+#endif
+
+// Stack overflow early warning (see sysmon_stack.h)
+#ifdef CONFIG_SYSMON_STACK_ALERTS
+#ifndef CONFIG_SYSMON_STACK_ALERT_PERCENT
+#define CONFIG_SYSMON_STACK_ALERT_PERCENT   90
+#endif
+#ifndef CONFIG_SYSMON_STACK_ALERT_WINDOW
+#define CONFIG_SYSMON_STACK_ALERT_WINDOW    30
+#endif
+#ifndef CONFIG_SYSMON_STACK_ALERT_HORIZON_S
+#define CONFIG_SYSMON_STACK_ALERT_HORIZON_S 300
+#endif
+#if CONFIG_SYSMON_STACK_ALERT_WINDOW > CONFIG_SYSMON_SAMPLE_COUNT
+#error "CONFIG_SYSMON_STACK_ALERT_WINDOW must not exceed CONFIG_SYSMON_SAMPLE_COUNT"
+#endif
+#endif
+
+// Scheduler tracing through the FreeRTOS trace macros (see sysmon_trace.h)
+#ifdef CONFIG_SYSMON_TRACE
+#ifndef CONFIG_SYSMON_TRACE_RING_DEPTH
+#define CONFIG_SYSMON_TRACE_RING_DEPTH      512
+#endif
+#if (CONFIG_SYSMON_TRACE_RING_DEPTH & (CONFIG_SYSMON_TRACE_RING_DEPTH - 1)) != 0
+    #error "CONFIG_SYSMON_TRACE_RING_DEPTH must be a power of two."
+#endif
+#define SYSMON_TRACE_LATENCY_BUCKETS    8
+#endif
+
+// Interrupt and critical-section time sampling (see sysmon_irq.h)
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+#ifndef CONFIG_SYSMON_IRQ_SAMPLE_HZ
+#define CONFIG_SYSMON_IRQ_SAMPLE_HZ         1000
+#endif
+#ifndef CONFIG_SYSMON_IRQ_SLACK_US
+#define CONFIG_SYSMON_IRQ_SLACK_US          2
+#endif
+#ifndef CONFIG_SYSMON_IRQ_RING_DEPTH
+#define CONFIG_SYSMON_IRQ_RING_DEPTH        512
+#endif
+#if (CONFIG_SYSMON_IRQ_RING_DEPTH & (CONFIG_SYSMON_IRQ_RING_DEPTH - 1)) != 0
+    #error "CONFIG_SYSMON_IRQ_RING_DEPTH must be a power of two."
+#endif
+#define SYSMON_IRQ_SERIES_COUNT         SYSMON_CORE_COUNT
+#else
+#define SYSMON_IRQ_SERIES_COUNT         0
+#endif
+
+// Crash-surviving flight recorder (see sysmon_recorder.h)
+#ifdef CONFIG_SYSMON_RECORDER
+#ifndef CONFIG_SYSMON_RECORDER_SAMPLES
+#define CONFIG_SYSMON_RECORDER_SAMPLES      30
+#endif
+#ifndef CONFIG_SYSMON_RECORDER_TASKS
+#define CONFIG_SYSMON_RECORDER_TASKS        16
+#endif
+#if defined(CONFIG_SYSMON_RECORDER_STORE_PSRAM) && !defined(CONFIG_SPIRAM_ALLOW_NOINIT_SEG_EXTERNAL_MEMORY)
+    #error "CONFIG_SYSMON_RECORDER_STORE_PSRAM requires CONFIG_SPIRAM_ALLOW_NOINIT_SEG_EXTERNAL_MEMORY to be enabled in sdkconfig."
+#endif
+#endif
+
+// Long-term telemetry log in a flash partition (see sysmon_flashlog.h)
+#ifdef CONFIG_SYSMON_FLASHLOG
+#ifndef CONFIG_SYSMON_FLASHLOG_PARTITION
+#define CONFIG_SYSMON_FLASHLOG_PARTITION    "sysmon"
+#endif
+#ifndef CONFIG_SYSMON_FLASHLOG_SAMPLES
+#define CONFIG_SYSMON_FLASHLOG_SAMPLES      60
+#endif
+#ifndef CONFIG_SYSMON_FLASHLOG_BLOCK_ENTRIES
+#define CONFIG_SYSMON_FLASHLOG_BLOCK_ENTRIES 16
+#endif
+#if CONFIG_SYSMON_FLASHLOG_SAMPLES > CONFIG_SYSMON_SAMPLE_COUNT
+#error "CONFIG_SYSMON_FLASHLOG_SAMPLES must not exceed CONFIG_SYSMON_SAMPLE_COUNT"
+#endif
+#endif
+
+// Batched push exporter (see sysmon_export.h)
+#ifdef CONFIG_SYSMON_EXPORT
+#ifndef CONFIG_SYSMON_EXPORT_HOST
+#define CONFIG_SYSMON_EXPORT_HOST           "collector.local"
+#endif
+#ifndef CONFIG_SYSMON_EXPORT_PORT
+#define CONFIG_SYSMON_EXPORT_PORT           9125
+#endif
+#ifndef CONFIG_SYSMON_EXPORT_BATCH
+#define CONFIG_SYSMON_EXPORT_BATCH          10
+#endif
+#ifndef CONFIG_SYSMON_EXPORT_DATAGRAM_SIZE
+#define CONFIG_SYSMON_EXPORT_DATAGRAM_SIZE  1400
+#endif
+#if CONFIG_SYSMON_EXPORT_BATCH > CONFIG_SYSMON_SAMPLE_COUNT
+#error "CONFIG_SYSMON_EXPORT_BATCH must not exceed CONFIG_SYSMON_SAMPLE_COUNT"
+#endif
+#endif
+
+// Application-defined counters and gauges (see sysmon_custom.h)
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+#ifndef CONFIG_SYSMON_CUSTOM_METRICS_MAX
+#define CONFIG_SYSMON_CUSTOM_METRICS_MAX    8
+#endif
+#define SYSMON_CUSTOM_METRIC_COUNT      CONFIG_SYSMON_CUSTOM_METRICS_MAX
+#else
+#define SYSMON_CUSTOM_METRIC_COUNT      0
+#endif
+
 // Strong reference to the actual embedded symbols present in your build
 // Note that ESP IDF strips the directory names from the final symbol name, no subfolders
-extern const uint8_t _binary_index_html_start[];
-extern const uint8_t _binary_index_html_end[];
-extern const uint8_t _binary_sysmon_theme_color_vars_css_start[];
-extern const uint8_t _binary_sysmon_theme_color_vars_css_end[];
-extern const uint8_t _binary_sysmon_theme_utility_classes_css_start[];
-extern const uint8_t _binary_sysmon_theme_utility_classes_css_end[];
-extern const uint8_t _binary_sysmon_theme_css_start[];
-extern const uint8_t _binary_sysmon_theme_css_end[];
-extern const uint8_t _binary_config_js_start[];
-extern const uint8_t _binary_config_js_end[];
-extern const uint8_t _binary_theme_js_start[];
-extern const uint8_t _binary_theme_js_end[];
-extern const uint8_t _binary_utils_js_start[];
-extern const uint8_t _binary_utils_js_end[];
-extern const uint8_t _binary_charts_js_start[];
-extern const uint8_t _binary_charts_js_end[];
-extern const uint8_t _binary_table_js_start[];
-extern const uint8_t _binary_table_js_end[];
-extern const uint8_t _binary_app_js_start[];
-extern const uint8_t _binary_app_js_end[];
+// Assets are embedded gzip-compressed (see CMakeLists.txt), hence the _gz suffix
+extern const uint8_t _binary_index_html_gz_start[];
+extern const uint8_t _binary_index_html_gz_end[];
+extern const uint8_t _binary_sysmon_theme_color_vars_css_gz_start[];
+extern const uint8_t _binary_sysmon_theme_color_vars_css_gz_end[];
+extern const uint8_t _binary_sysmon_theme_utility_classes_css_gz_start[];
+extern const uint8_t _binary_sysmon_theme_utility_classes_css_gz_end[];
+extern const uint8_t _binary_sysmon_theme_css_gz_start[];
+extern const uint8_t _binary_sysmon_theme_css_gz_end[];
+extern const uint8_t _binary_config_js_gz_start[];
+extern const uint8_t _binary_config_js_gz_end[];
+extern const uint8_t _binary_theme_js_gz_start[];
+extern const uint8_t _binary_theme_js_gz_end[];
+extern const uint8_t _binary_utils_js_gz_start[];
+extern const uint8_t _binary_utils_js_gz_end[];
+extern const uint8_t _binary_charts_js_gz_start[];
+extern const uint8_t _binary_charts_js_gz_end[];
+extern const uint8_t _binary_table_js_gz_start[];
+extern const uint8_t _binary_table_js_gz_end[];
+extern const uint8_t _binary_app_js_gz_start[];
+extern const uint8_t _binary_app_js_gz_end[];
 
 /**
  * @brief Stores usage samples and statistics for a single tracked FreeRTOS task.
  *
- * This struct contains both the time-series history buffers used by the sampler and metadata fields
- * populated from the FreeRTOS TaskStatus_t snapshot during each sampling interval.
+ * This struct holds the hot per-task metadata populated from the FreeRTOS TaskStatus_t snapshot during
+ * each sampling interval. The task's history rings live in the shared SysMonHistoryStore (same slot index).
  * Members are populated and updated by the monitor logic in sysmon.c.
  *
  * Members                       : 
  * - task_name                   : Fixed-length buffer holding the task name (matches t->pcTaskName from TaskStatus_t).
- * - usage_percent_history       : Array of per-sample CPU usage percentages for this task (cyclic buffer).
- * - stack_usage_bytes_history   : Array of per-sample stack usage in bytes (cyclic buffer).
- * - stack_usage_percent_history : Array of per-sample stack usage as a percentage of stack_size_bytes (cyclic buffer).
- * - write_index                 : Index for the next write into the rolling history buffers.
  * - is_active                   : Whether this entry represents a currently observed (alive) task.
  * - consecutive_zero_samples    : Number of consecutive samples this task's usage was zero (used to time out deleted tasks).
- * - task_id                     : RTOS-assigned numeric task ID (from TaskStatus_t.xTaskNumber).
+ * - task_id                     : RTOS-assigned numeric task ID (from TaskStatus_t.xTaskNumber); the slot's identity key.
+ * - task_handle                 : FreeRTOS handle of the task currently owning this slot (from TaskStatus_t.xHandle).
  * - current_priority            : Current FreeRTOS priority of the task (from TaskStatus_t.uxCurrentPriority).
  * - base_priority               : Initial or base FreeRTOS priority for this task (from TaskStatus_t.uxBasePriority).
  * - total_run_time_ticks        : Cumulative run time as counted by FreeRTOS up to the latest sample (from TaskStatus_t.ulRunTimeCounter).
  * - stack_high_water_mark       : Minimum remaining stack (words) observed since task creation (from TaskStatus_t.usStackHighWaterMark).
  * - stack_size_bytes            : Stack size in bytes (as registered, see sysmon_stack API).
+ * - stack_size_handle           : Task handle stack_size_bytes was looked up for (NULL = not cached yet).
+ * - stack_size_generation       : Stack registry generation at that lookup (see sysmon_stack_get_generation()).
+ * - stack_alert_percent         : Alert threshold cached with the stack size (see sysmon_stack_set_alert_threshold()).
+ * - stack_alert_level           : Current sysmon_stack_alert_level_t of the task.
+ * - stack_alert_samples         : Consecutive samples with a constant stack size, up to CONFIG_SYSMON_STACK_ALERT_WINDOW.
  * - core_id                     : The core number this task is running/pinned to (from TaskStatus_t.xCoreID).
  * - prev_run_time_ticks         : Logical copy of previous ulRunTimeCounter for this task since the last sample, used for delta calculations.
+ * - heap_counters_handle        : Task handle the slot's heap counters were attached to (CONFIG_SYSMON_HEAP_TASK_TRACKING only).
+ * - heap_alloc_bytes            : Bytes the task allocated since it was attached, as of the latest sample.
+ * - heap_alloc_count            : Allocations the task made since it was attached.
+ * - heap_free_count             : Frees the task made since it was attached.
+ * - trace_ready_us              : Time the task last became ready, low 32 bits of esp_timer (CONFIG_SYSMON_TRACE only).
+ * - trace_ready_pending         : Set from a ready event until the task is switched in.
+ * - trace_has_run               : Set once the task has been switched in since tracing started.
+ * - trace_interval_switches     : Switch-ins counted in the current interval.
+ * - trace_interval_latency_max_us : Highest ready-to-run latency in the current interval.
+ * - trace_switches              : Switch-ins since the slot was claimed.
+ * - trace_preemptions           : Switch-ins without a preceding ready event (task was preempted).
+ * - trace_switch_rate           : Switch-ins per second over the last interval.
+ * - trace_latency_max_us        : Highest ready-to-run latency of the last interval.
+ * - trace_latency_hist          : Ready-to-run latency histogram (see _trace_latency_bucket_limit_us()).
+ * - irq_row                     : Pseudo-task row holding core_id's interrupt and critical-section time
+ *                                 (CONFIG_SYSMON_IRQ_ACCOUNTING only; no handle, usage from the irq% series).
+ * - irq_percent                 : Interrupt and critical-section time charged to the task in the newest
+ *                                 interval, moved out of its usage into the IRQ row (see sysmon_irq.h).
  *
- * The time series buffers have length = CONFIG_SYSMON_SAMPLE_COUNT and are maintained as circular buffers.
  * This structure is filled, tracked, and used internally by sysmon.c and exposed to JSON and telemetry handlers.
  */
 
 typedef struct
 {
     char task_name[24];
-    float usage_percent_history[CONFIG_SYSMON_SAMPLE_COUNT];
-    uint32_t stack_usage_bytes_history[CONFIG_SYSMON_SAMPLE_COUNT];
-    float stack_usage_percent_history[CONFIG_SYSMON_SAMPLE_COUNT];
-    int write_index;
     bool is_active;
     int consecutive_zero_samples;
     UBaseType_t task_id;
+    TaskHandle_t task_handle;
     UBaseType_t current_priority;
     UBaseType_t base_priority;
     uint32_t total_run_time_ticks;
     uint32_t stack_high_water_mark;
     uint32_t stack_size_bytes;
+    TaskHandle_t stack_size_handle;
+    uint32_t stack_size_generation;
+    uint8_t stack_alert_percent;
+    uint8_t stack_alert_level;
+    uint16_t stack_alert_samples;
     int core_id;
     uint32_t prev_run_time_ticks;
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+    TaskHandle_t heap_counters_handle;
+    uint32_t heap_alloc_bytes;
+    uint32_t heap_alloc_count;
+    uint32_t heap_free_count;
+#endif
+#ifdef CONFIG_SYSMON_TRACE
+    uint32_t trace_ready_us;
+    bool trace_ready_pending;
+    bool trace_has_run;
+    uint32_t trace_interval_switches;
+    uint32_t trace_interval_latency_max_us;
+    uint32_t trace_switches;
+    uint32_t trace_preemptions;
+    float trace_switch_rate;
+    uint32_t trace_latency_max_us;
+    uint32_t trace_latency_hist[SYSMON_TRACE_LATENCY_BUCKETS];
+#endif
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+    bool irq_row;
+    float irq_percent;
+#endif
 } TaskUsageSample;
 
+/**
+ * @brief Min/avg/max of a percentage over one rollup bucket, in hundredths of a percent.
+ */
+typedef struct
+{
+    uint16_t min;
+    uint16_t avg;
+    uint16_t max;
+} SysMonRollupStat;
+
+/**
+ * @brief One downsampled bucket of a task's history.
+ *
+ * Members:
+ * - cpu       : CPU usage statistics.
+ * - stack_max : Highest stack usage in bytes seen in the bucket.
+ */
+typedef struct
+{
+    SysMonRollupStat cpu;
+    uint32_t stack_max;
+} SysMonTaskRollup;
+
+/**
+ * @brief One downsampled bucket of the global CPU and memory series.
+ *
+ * Members:
+ * - cpu_overall        : Overall CPU usage statistics.
+ * - cpu_core           : Per-core CPU usage statistics.
+ * - dram_used_percent  : DRAM usage statistics.
+ * - psram_used_percent : PSRAM usage statistics.
+ * - dram_free_min      : Lowest DRAM free bytes in the bucket.
+ * - dram_largest_min   : Smallest DRAM largest-free-block in the bucket.
+ * - psram_free_min     : Lowest PSRAM free bytes in the bucket.
+ */
+typedef struct
+{
+    SysMonRollupStat cpu_overall;
+    SysMonRollupStat cpu_core[SYSMON_CORE_COUNT];
+    SysMonRollupStat dram_used_percent;
+    SysMonRollupStat psram_used_percent;
+    uint32_t dram_free_min;
+    uint32_t dram_largest_min;
+    uint32_t psram_free_min;
+} SysMonSeriesRollup;
+
+/**
+ * @brief One heap_caps_get_info() pass over a capability region.
+ *
+ * Members:
+ * - free_bytes         : Free bytes in the region.
+ * - largest_free_block : Largest allocatable block in bytes.
+ * - minimum_free_bytes : Lowest free bytes since boot.
+ * - free_blocks        : Number of free blocks (saturates at UINT16_MAX).
+ * - fragmentation      : 1 - largest_free_block / free_bytes, in hundredths of a percent.
+ */
+typedef struct
+{
+    uint32_t free_bytes;
+    uint32_t largest_free_block;
+    uint32_t minimum_free_bytes;
+    uint16_t free_blocks;
+    uint16_t fragmentation;
+} SysMonHeapRegionSample;
+
+/**
+ * @brief Pointer to the profile ring of one heap region (SYSMON_HEAP_PROFILE_SLOTS entries).
+ *
+ * @param samples SysMonState.heap_profile.
+ * @param region Region index (see sysmon_heap.h).
+ */
+#define SYSMON_HEAP_REGION_RING(samples, region) ((samples) + (size_t)(region) * SYSMON_HEAP_PROFILE_SLOTS)
+
+/**
+ * @brief Struct-of-arrays ring storage for the global series and all per-task histories.
+ *
+ * Every ring has slots entries: the history window (sample_count samples) plus one spare
+ * entry, so the sampler writes the next sample outside the window of the published snapshot.
+ * The sampler keeps writing while readers hold a snapshot, so the entries of a pinned window
+ * are reused from its oldest sample on; readers check each entry they read with
+ * _snapshot_sample_intact().
+ * Per-task fields hold capacity rings, slot-major, so a task's ring is contiguous (see
+ * SYSMON_TASK_RING()). All rings share the global write index (series_write_index), so a
+ * snapshot's history indices apply to every ring. The store is allocated in a single block,
+ * in PSRAM when CONFIG_SYSMON_HISTORY_IN_PSRAM is set, and replaced when the task capacity
+ * grows or the sampling configuration changes.
+ *
+ * Members:
+ * - capacity            : Number of task slots.
+ * - slots               : Entries per ring (sample_count + 1).
+ * - sequence            : sample_sequence of the newest sample committed to this store. The
+ *                         sampler publishes it before it writes the next ring entry; a
+ *                         retired store keeps its last value.
+ * - cpu_overall_percent : Overall CPU usage percentages.
+ * - cpu_core_percent    : CPU usage percentages, one ring per core (see SYSMON_CORE_RING()).
+ * - cpu_core_unpinned_percent : Per-core CPU usage not accounted for by tasks pinned to that
+ *                         core (unpinned tasks, plus interrupts charged to them).
+ * - cpu_core_irq_percent : Per-core share of time in interrupts and critical sections, one ring
+ *                         per core (CONFIG_SYSMON_IRQ_ACCOUNTING only, see sysmon_irq.h).
+ * - dram_free           : DRAM free bytes.
+ * - dram_min_free       : DRAM minimum free bytes.
+ * - dram_largest_block  : DRAM largest free block sizes.
+ * - dram_total          : Total DRAM available.
+ * - dram_used_percent   : DRAM usage percent.
+ * - psram_free          : PSRAM free bytes.
+ * - psram_total         : PSRAM total bytes.
+ * - psram_used_percent  : PSRAM usage percent.
+ * - custom_metric_values : Counter increase per interval or gauge value, one ring per custom
+ *                         metric (CONFIG_SYSMON_CUSTOM_METRICS only, see SYSMON_CUSTOM_RING()).
+ * - usage_percent       : Per-sample CPU usage percentages.
+ * - stack_usage_bytes   : Per-sample stack usage in bytes.
+ * - stack_usage_percent : Per-sample stack usage as a percentage of stack_size_bytes.
+ * - rollups             : Downsampled buckets, SYSMON_ROLLUP_SLOTS per slot (CONFIG_SYSMON_ROLLUPS only).
+ * - heap_alloc_bytes    : Per-sample bytes allocated by the task (CONFIG_SYSMON_HEAP_TASK_TRACKING only).
+ * - task_since          : Per slot, sequence of the first sample its rings hold for the current
+ *                         task (the rings are cleared when a new task claims the slot).
+ */
+typedef struct
+{
+    int capacity;
+    int slots;
+    uint32_t sequence;
+    float *cpu_overall_percent;
+    float *cpu_core_percent;
+    float *cpu_core_unpinned_percent;
+    uint32_t *dram_free;
+    uint32_t *dram_min_free;
+    uint32_t *dram_largest_block;
+    uint32_t *dram_total;
+    float *dram_used_percent;
+    uint32_t *psram_free;
+    uint32_t *psram_total;
+    float *psram_used_percent;
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+    float *cpu_core_irq_percent;
+#endif
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+    int32_t *custom_metric_values;
+#endif
+    float *usage_percent;
+    uint32_t *stack_usage_bytes;
+    float *stack_usage_percent;
+#ifdef CONFIG_SYSMON_ROLLUPS
+    SysMonTaskRollup *rollups;
+#endif
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+    uint32_t *heap_alloc_bytes;
+#endif
+    uint32_t *task_since;
+} SysMonHistoryStore;
+
+/**
+ * @brief Pointer to the ring of one history field for a task slot.
+ *
+ * @param store SysMonHistoryStore pointer.
+ * @param field History field (usage_percent, stack_usage_bytes, stack_usage_percent or heap_alloc_bytes).
+ * @param slot Task slot index.
+ */
+#define SYSMON_TASK_RING(store, field, slot) ((store)->field + (size_t)(slot) * (store)->slots)
+
+/**
+ * @brief Pointer to the ring of a per-core series.
+ *
+ * @param store SysMonHistoryStore pointer.
+ * @param field Per-core field (cpu_core_percent, cpu_core_unpinned_percent or cpu_core_irq_percent).
+ * @param core Core index.
+ */
+#define SYSMON_CORE_RING(store, field, core) ((store)->field + (size_t)(core) * (store)->slots)
+
+/**
+ * @brief Pointer to the ring of a custom metric.
+ *
+ * @param store SysMonHistoryStore pointer.
+ * @param metric Metric index (see sysmon_custom.h).
+ */
+#define SYSMON_CUSTOM_RING(store, metric) ((store)->custom_metric_values + (size_t)(metric) * (store)->slots)
+
+/**
+ * @brief Pointer to the rollup buckets of a task slot (all tiers, see sysmon_rollup.h for tier offsets).
+ *
+ * @param store SysMonHistoryStore pointer.
+ * @param slot Task slot index.
+ */
+#define SYSMON_TASK_ROLLUPS(store, slot) ((store)->rollups + (size_t)(slot) * SYSMON_ROLLUP_SLOTS)
+
+/**
+ * @brief Per-task metadata copied into a published snapshot.
+ *
+ * Members:
+ * - slot                  : Index of the task's rings in SysMonSnapshot.history.
+ * - since                 : Sequence of the first sample the slot's rings hold for this task
+ *                           (SysMonHistoryStore.task_since at commit time).
+ * - task_name             : Task name at commit time.
+ * - task_id               : RTOS-assigned numeric task ID.
+ * - current_priority      : Current FreeRTOS priority.
+ * - base_priority         : Base FreeRTOS priority.
+ * - total_run_time_ticks  : Cumulative run time counter.
+ * - stack_high_water_mark : Minimum remaining stack (words).
+ * - stack_size_bytes      : Registered stack size in bytes (0 if unregistered).
+ * - core_id               : Core the task is pinned to.
+ * - usage_percent         : CPU usage of the newest sample.
+ * - stack_usage_bytes     : Stack usage of the newest sample in bytes.
+ * - stack_usage_percent   : Stack usage of the newest sample in percent of stack_size_bytes.
+ * - heap_alloc_bytes      : Bytes allocated since the task was first seen (CONFIG_SYSMON_HEAP_TASK_TRACKING only).
+ * - heap_alloc_count      : Allocations since the task was first seen.
+ * - heap_free_count       : Frees since the task was first seen.
+ * - trace_*               : Scheduler trace statistics (CONFIG_SYSMON_TRACE only, see TaskUsageSample).
+ * - irq_row               : Pseudo-task row of core_id's interrupt time (CONFIG_SYSMON_IRQ_ACCOUNTING only).
+ * - irq_percent           : Interrupt and critical-section time moved out of the task's usage.
+ */
+typedef struct
+{
+    int slot;
+    uint32_t since;
+    char task_name[24];
+    UBaseType_t task_id;
+    UBaseType_t current_priority;
+    UBaseType_t base_priority;
+    uint32_t total_run_time_ticks;
+    uint32_t stack_high_water_mark;
+    uint32_t stack_size_bytes;
+    int core_id;
+    float usage_percent;
+    uint32_t stack_usage_bytes;
+    float stack_usage_percent;
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+    uint32_t heap_alloc_bytes;
+    uint32_t heap_alloc_count;
+    uint32_t heap_free_count;
+#endif
+#ifdef CONFIG_SYSMON_TRACE
+    uint32_t trace_switches;
+    uint32_t trace_preemptions;
+    float trace_switch_rate;
+    uint32_t trace_latency_max_us;
+    uint32_t trace_latency_hist[SYSMON_TRACE_LATENCY_BUCKETS];
+#endif
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+    bool irq_row;
+    float irq_percent;
+#endif
+} SysMonTaskSnapshot;
+
+/**
+ * @brief Global series values of the newest sample, copied into a published snapshot.
+ *
+ * Members match the SysMonHistoryStore rings of the same name.
+ */
+typedef struct
+{
+    float cpu_overall_percent;
+    float cpu_core_percent[SYSMON_CORE_COUNT];
+    float cpu_core_unpinned_percent[SYSMON_CORE_COUNT];
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+    float cpu_core_irq_percent[SYSMON_CORE_COUNT];
+#endif
+    uint32_t dram_free;
+    uint32_t dram_min_free;
+    uint32_t dram_largest_block;
+    uint32_t dram_total;
+    float dram_used_percent;
+    uint32_t psram_free;
+    uint32_t psram_total;
+    float psram_used_percent;
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+    int32_t custom_metric_values[SYSMON_CUSTOM_METRIC_COUNT];
+#endif
+} SysMonSampleValues;
+
+/**
+ * @brief Timing and cost of the sampler itself.
+ *
+ * Times are measured with esp_timer. The schedule is fixed-rate
+ * (xTaskDelayUntil), so the expected period is the active sampling interval
+ * and latency is how late the sampler woke against its schedule (includes up to
+ * one RTOS tick of quantization). Maxima are kept since sysmon_init().
+ *
+ * Members:
+ * - sample_time_us  : esp_timer time the newest sample was taken.
+ * - period_us       : Time between the two newest samples.
+ * - jitter_us       : period_us minus span sampling intervals.
+ * - jitter_max_us   : Largest absolute jitter_us seen.
+ * - latency_us      : Wake-up latency of the newest sample.
+ * - latency_max_us  : Largest latency_us seen.
+ * - work_us         : Processing time of the last completed loop iteration.
+ * - work_avg_us     : Moving average of work_us (1/16 weight per sample).
+ * - work_max_us     : Largest work_us seen.
+ * - cpu_percent     : Sampler task CPU usage over the newest interval (same units as task usage).
+ * - overruns        : Intervals whose processing ran past the next deadline.
+ * - span            : Sampling intervals the newest wake covered; the measurement fills that many
+ *                     ring slots (above 1 only while adaptive sampling backs off).
+ * - adaptive_factor : Sampling intervals the sampler sleeps between wakes (1 = full rate,
+ *                     see CONFIG_SYSMON_ADAPTIVE_SAMPLING).
+ */
+typedef struct
+{
+    int64_t sample_time_us;
+    uint32_t period_us;
+    int32_t jitter_us;
+    uint32_t jitter_max_us;
+    uint32_t latency_us;
+    uint32_t latency_max_us;
+    uint32_t work_us;
+    uint32_t work_avg_us;
+    uint32_t work_max_us;
+    float cpu_percent;
+    uint32_t overruns;
+    uint32_t span;
+    uint32_t adaptive_factor;
+} SysMonSelfMetrics;
+
+/**
+ * @brief Immutable view of the sampler state committed at the end of one interval.
+ *
+ * The sampler keeps two of these and publishes them alternately. Readers pin the
+ * published one with _snapshot_acquire() and never block the sampler: it fills
+ * the other buffer and skips publishing for an interval if that buffer is still pinned.
+ * Metadata and the newest values are copied; the history window is read from the
+ * shared rings and checked with _snapshot_sample_intact().
+ *
+ * Members:
+ * - sequence      : sample_sequence of the newest committed sample (0 = none yet).
+ * - newest_index  : Ring index of the newest committed sample.
+ * - oldest_index  : Ring index of the oldest sample in the sample_count window.
+ * - sample_count  : Samples in the history window (history->slots - 1).
+ * - available     : Samples of the window taken since the sampling configuration last changed
+ *                   (the older entries are zero).
+ * - interval_ms   : Sampling interval of the samples in the window.
+ * - sampling_generation : Number of sampling reconfigurations applied (see sysmon_set_sampling()).
+ * - history       : Ring store the series and task slots refer to (kept alive while pinned;
+ *                   sysmon_init() publishes an empty one, so it is set once sysmon runs).
+ * - newest        : Global series values of the newest sample.
+ * - tasks         : Metadata and newest values of the tasks active at commit time.
+ * - task_count    : Number of entries in tasks.
+ * - task_capacity : Allocated entries in tasks.
+ * - rollup_sequence : Per rollup tier, number of buckets committed (CONFIG_SYSMON_ROLLUPS only).
+ * - heap_profile_sequence : Number of heap region profiles committed (CONFIG_SYSMON_HEAP_PROFILE only).
+ * - trace_events  : Scheduler trace events processed (CONFIG_SYSMON_TRACE only).
+ * - trace_dropped : Scheduler trace events dropped because a ring was full.
+ * - irq_max_us    : Per core, longest interrupt or critical-section stretch sampled in the newest
+ *                   interval (CONFIG_SYSMON_IRQ_ACCOUNTING only).
+ * - custom_metric_count  : Custom metrics registered at commit time (CONFIG_SYSMON_CUSTOM_METRICS only).
+ * - custom_metric_totals : Running total of each custom counter at commit time.
+ * - self_metrics  : Sampler timing and cost at commit time.
+ * - readers       : Number of readers currently pinning this snapshot.
+ */
+typedef struct
+{
+    uint32_t sequence;
+    int newest_index;
+    int oldest_index;
+    int sample_count;
+    int available;
+    uint32_t interval_ms;
+    uint32_t sampling_generation;
+    const SysMonHistoryStore *history;
+    SysMonSampleValues newest;
+    SysMonTaskSnapshot *tasks;
+    int task_count;
+    int task_capacity;
+#ifdef CONFIG_SYSMON_ROLLUPS
+    uint32_t rollup_sequence[SYSMON_ROLLUP_TIER_COUNT];
+#endif
+#ifdef CONFIG_SYSMON_HEAP_PROFILE
+    uint32_t heap_profile_sequence;
+#endif
+#ifdef CONFIG_SYSMON_TRACE
+    uint32_t trace_events;
+    uint32_t trace_dropped;
+#endif
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+    uint32_t irq_max_us[SYSMON_CORE_COUNT];
+#endif
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+    int custom_metric_count;
+    uint64_t custom_metric_totals[SYSMON_CUSTOM_METRIC_COUNT];
+#endif
+    SysMonSelfMetrics self_metrics;
+    uint32_t readers;
+} SysMonSnapshot;
+
 /**
  * @brief Stores global usage and state for the sysmon monitor.
  *
@@ -128,59 +756,522 @@ typedef struct
  *
  * Members:
  * - httpd                : Handle to the HTTP server providing sysmon telemetry endpoints.
- * - tasks                : Array of per-task usage samples (TaskUsageSample), dynamically allocated.
+ * - tasks                : Array of per-task metadata (TaskUsageSample), dynamically allocated in internal RAM.
+ * - history              : Global series and per-task history rings (SysMonHistoryStore), same slot
+ *                          indices as tasks.
  * - task_status          : Array of TaskStatus_t used to query live FreeRTOS task states.
  * - task_capacity        : Capacity of the allocated tasks/task_status arrays (number of slots).
+ * - task_slot_hints      : Per task_status entry, the slot it mapped to on the previous sample (-1 = none).
+ * - tasks_seen           : Per-slot scratch flags for the current sample (task_capacity entries).
+ * - task_capacity_short  : Set when a task could not get a slot; storage grows before the next sample.
+ * - task_index           : Open-addressing hash table from task number to slot (stores slot + 1, 0 = empty).
+ * - task_index_size      : Number of buckets in task_index (power of two, at least four times task_capacity).
+ * - task_index_dirty     : Set when a slot changes identity or is released; the table is rebuilt on the next sample.
  * - prev_total_run_time  : Snapshot of the previous global runtime tick count (for usage delta calculation).
+ * - idle_task_handles    : Idle task handle of each core (looked up when the monitor starts).
+ * - prev_idle_run_time   : Previous runtime counter of each core's idle task.
  * - monitor_task_handle  : RTOS task handle for the main sysmon monitor task.
  *
- * - cpu_overall_percent  : Ring buffer of overall CPU usage percentages.
- * - cpu_core_percent     : Ring buffer of per-core CPU usage percentages.
- * - dram_free            : Ring buffer of DRAM free bytes.
- * - dram_min_free        : Ring buffer of DRAM minimum free bytes.
- * - dram_largest_block   : Ring buffer of DRAM largest free block sizes.
- * - dram_total           : Ring buffer of total DRAM available.
- * - dram_used_percent    : Ring buffer of DRAM usage percent.
- * - psram_free           : Ring buffer of PSRAM free bytes.
- * - psram_total          : Ring buffer of PSRAM total bytes.
- * - psram_used_percent   : Ring buffer of PSRAM usage percent.
- *
+ * - sample_interval_ms   : Active sampling interval (CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS until reconfigured).
+ * - sample_count         : Active history window depth (CONFIG_SYSMON_SAMPLE_COUNT until reconfigured).
+ * - sampling_generation  : Number of sampling reconfigurations applied.
  * - series_write_index   : Ring buffer write head for time-series data.
+ * - series_available     : Samples written since the history window last restarted (capped at sample_count).
+ * - sample_sequence      : Monotonic count of samples committed (sequence number of the newest sample, 0 = none yet).
  * - psram_seen           : True if PSRAM is detected on this platform/session.
  * - log_decimator        : Used for periodic logging throttling.
+ * - series_rollups       : Downsampled global series buckets, SYSMON_ROLLUP_SLOTS (CONFIG_SYSMON_ROLLUPS only).
+ * - rollup_sequence      : Per rollup tier, number of buckets committed; bucket n lives at n % tier slots.
+ * - heap_profile         : Heap region profile rings, SYSMON_HEAP_PROFILE_SLOTS per region (CONFIG_SYSMON_HEAP_PROFILE only).
+ * - heap_profile_sequence : Number of heap region profiles committed; profile n lives at n % slots.
+ * - trace_events         : Scheduler trace events processed since the monitor started (CONFIG_SYSMON_TRACE only).
+ * - trace_dropped        : Scheduler trace events dropped because a per-core ring was full.
+ * - irq_slots            : Slot of each core's IRQ row (-1 = not claimed yet, CONFIG_SYSMON_IRQ_ACCOUNTING only).
+ * - irq_idle_percent     : Per core, interrupt time charged to the idle task in the newest interval.
+ * - irq_max_us           : Per core, longest interrupt or critical-section stretch sampled in the newest interval.
+ * - custom_metric_totals : Running total of each custom counter (CONFIG_SYSMON_CUSTOM_METRICS only).
+ * - custom_metric_count  : Custom metrics folded into the newest sample.
+ * - self_metrics         : Sampler timing and cost (see SysMonSelfMetrics).
+ * - schedule_us          : esp_timer time the current sample was scheduled for.
+ * - slot_time_us         : esp_timer time the newest ring slot stands for (earlier than the wake for
+ *                          the slots filled by a wake that covered several intervals).
+ * - adaptive_quiet_since_us : esp_timer time the current quiet stretch (or the latest back-off step) began
+ *                          (CONFIG_SYSMON_ADAPTIVE_SAMPLING only).
+ * - adaptive_prev_cpu    : Overall CPU usage measured at the previous wake.
+ * - adaptive_prev_min_free : Lowest DRAM free since boot as of the previous wake.
+ *
+ * - snapshots            : Double-buffered published snapshots (see SysMonSnapshot).
+ * - published_snapshot   : Index of the snapshot readers currently pin.
+ * - retired_history      : Previous history store after a capacity change, freed once no snapshot pins it.
  *
  * The structure is owned and manipulated exclusively by sysmon.c, but its
  * reference is provided by extern for certain operations in other modules.
+ * Other modules must read task and series data through _snapshot_acquire().
  */
 typedef struct
 {
     httpd_handle_t httpd;
     TaskUsageSample *tasks;
+    SysMonHistoryStore *history;
     TaskStatus_t *task_status;
     int task_capacity;
+    int16_t *task_slot_hints;
+    bool *tasks_seen;
+    bool task_capacity_short;
+    int16_t *task_index;
+    int task_index_size;
+    bool task_index_dirty;
     uint32_t prev_total_run_time;
+    TaskHandle_t idle_task_handles[SYSMON_CORE_COUNT];
+    uint32_t prev_idle_run_time[SYSMON_CORE_COUNT];
     TaskHandle_t monitor_task_handle;
 
-    // Lightweight time series (length = CONFIG_SYSMON_SAMPLE_COUNT)
-    float cpu_overall_percent[CONFIG_SYSMON_SAMPLE_COUNT];
-    float cpu_core_percent[2][CONFIG_SYSMON_SAMPLE_COUNT];
-    uint32_t dram_free[CONFIG_SYSMON_SAMPLE_COUNT];
-    uint32_t dram_min_free[CONFIG_SYSMON_SAMPLE_COUNT];
-    uint32_t dram_largest_block[CONFIG_SYSMON_SAMPLE_COUNT];
-    uint32_t dram_total[CONFIG_SYSMON_SAMPLE_COUNT];
-    float dram_used_percent[CONFIG_SYSMON_SAMPLE_COUNT];
-    uint32_t psram_free[CONFIG_SYSMON_SAMPLE_COUNT];
-    uint32_t psram_total[CONFIG_SYSMON_SAMPLE_COUNT];
-    float psram_used_percent[CONFIG_SYSMON_SAMPLE_COUNT];
-
+    uint32_t sample_interval_ms;
+    int sample_count;
+    uint32_t sampling_generation;
     int series_write_index;
+    int series_available;
+    uint32_t sample_sequence;
     bool psram_seen;
     int log_decimator;
+#ifdef CONFIG_SYSMON_ROLLUPS
+    SysMonSeriesRollup *series_rollups;
+    uint32_t rollup_sequence[SYSMON_ROLLUP_TIER_COUNT];
+#endif
+#ifdef CONFIG_SYSMON_HEAP_PROFILE
+    SysMonHeapRegionSample *heap_profile;
+    uint32_t heap_profile_sequence;
+#endif
+#ifdef CONFIG_SYSMON_TRACE
+    uint32_t trace_events;
+    uint32_t trace_dropped;
+#endif
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+    int irq_slots[SYSMON_CORE_COUNT];
+    float irq_idle_percent[SYSMON_CORE_COUNT];
+    uint32_t irq_max_us[SYSMON_CORE_COUNT];
+#endif
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+    uint64_t custom_metric_totals[SYSMON_CUSTOM_METRIC_COUNT];
+    int custom_metric_count;
+#endif
+    SysMonSelfMetrics self_metrics;
+    int64_t schedule_us;
+    int64_t slot_time_us;
+#ifdef CONFIG_SYSMON_ADAPTIVE_SAMPLING
+    int64_t adaptive_quiet_since_us;
+    float adaptive_prev_cpu;
+    uint32_t adaptive_prev_min_free;
+#endif
+
+    // Published, reader-facing state
+    SysMonSnapshot snapshots[2];
+    int published_snapshot;
+    SysMonHistoryStore *retired_history;
 } SysMonState;
 
 // Shared module state (defined in sysmon.c)
 extern SysMonState self;
 
+/**
+ * @brief Pin the most recently published snapshot for reading (internal use only).
+ *
+ * Never blocks on the sampler. The snapshot, its task metadata, its newest values and
+ * the ring storage stay valid until _snapshot_release() is called. The ring entries of
+ * its history window do not: the sampler keeps writing, and a snapshot that is held, or
+ * was published, several intervals ago has its oldest entries reused. Readers check
+ * every ring entry with _snapshot_sample_intact().
+ *
+ * @return Pinned snapshot (never NULL; sequence is 0 before the first sample).
+ */
+const SysMonSnapshot *_snapshot_acquire(void);
+
+/**
+ * @brief Check that ring entries read from a pinned snapshot held the sample (internal use only).
+ *
+ * Call after reading the entries. A false result means the sampler has reused
+ * the entry for a newer sample, or cleared the task slot's rings for a new task,
+ * and the values read must not be used.
+ *
+ * @param snapshot Pinned snapshot.
+ * @param task Task whose rings were read (NULL for the global series).
+ * @param sequence Sequence number of the sample read.
+ * @return true if the entries read held that sample.
+ */
+bool _snapshot_sample_intact(const SysMonSnapshot *snapshot, const SysMonTaskSnapshot *task, uint32_t sequence);
+
+/**
+ * @brief Oldest sample of a pinned snapshot's window still in the rings (internal use only).
+ *
+ * Readers that pick a range of samples clamp its start to this before walking
+ * the rings; samples can still be reused during the walk.
+ *
+ * @param snapshot Pinned snapshot.
+ * @return Sequence of the oldest intact sample of the window (sequence + 1 if none is left).
+ */
+uint32_t _snapshot_intact_from(const SysMonSnapshot *snapshot);
+
+/**
+ * @brief Release a snapshot pinned with _snapshot_acquire() (internal use only).
+ *
+ * @param snapshot Snapshot returned by _snapshot_acquire().
+ */
+void _snapshot_release(const SysMonSnapshot *snapshot);
+
+/**
+ * @brief Run the in-process sample subscribers on the snapshot just published (internal use only).
+ *
+ * Called by the sampler after _publish_snapshot(); does nothing if publishing
+ * was skipped for this sample.
+ */
+void _api_notify_subscribers(void);
+
+/**
+ * @brief Check whether fixed-span summaries can use the newest samples (internal use only).
+ *
+ * Rollup buckets, heap region profiles and flash log entries cover a fixed
+ * number of samples taken at CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS. They
+ * pause while sysmon_set_sampling() has selected another interval, and until
+ * the history window restarted by a reconfiguration holds enough samples.
+ *
+ * @param samples Samples the summary reads from the raw rings (0 = none).
+ * @return true if the configured interval is active and enough samples are available.
+ */
+bool _sampling_at_base_interval(int samples);
+
+/**
+ * @brief Report a client request to the sampler (internal use only).
+ *
+ * Called by the HTTP handlers and the push channel. With
+ * CONFIG_SYSMON_ADAPTIVE_SAMPLING, a backed-off sampler wakes at the next
+ * interval boundary and returns to full-rate sampling; otherwise does nothing.
+ */
+void _sampling_note_client(void);
+
+// ============================================================================
+// In-Process Consumer API
+// ============================================================================
+
+// Sample callbacks that can be registered at the same time
+#define SYSMON_MAX_SAMPLE_SUBSCRIBERS   4
+
+/**
+ * @brief Read-only view of one committed sample and its history window.
+ *
+ * Obtained from sysmon_get_snapshot() or passed to a sample callback. Read it
+ * with the sysmon_snapshot_*() and sysmon_series_*() functions; its members
+ * are internal and may change. The newest values are copied into the snapshot;
+ * series are read in place from the history rings and checked as they are read.
+ */
+typedef SysMonSnapshot sysmon_snapshot_t;
+
+/**
+ * @brief Newest values of a snapshot.
+ *
+ * Members:
+ * - sequence           : Sequence number of the newest sample (increments by one per sample).
+ * - sample_count       : Samples in the history window (see sysmon_set_sampling()).
+ * - interval_ms        : Sampling interval.
+ * - cpu_percent        : Overall CPU usage.
+ * - core_percent       : CPU usage per core.
+ * - dram_free          : DRAM free bytes.
+ * - dram_min_free      : Lowest DRAM free bytes since boot.
+ * - dram_largest_block : Largest free DRAM block (the largest allocation that can succeed).
+ * - dram_total         : DRAM heap size.
+ * - psram_free         : PSRAM free bytes (0 without PSRAM).
+ * - psram_total        : PSRAM heap size (0 without PSRAM).
+ * - task_count         : Tasks in the snapshot (valid indices for sysmon_snapshot_get_task()).
+ * - sampler_latency_us : How late the sampler woke for the newest sample.
+ * - sampler_work_us    : Processing time of the sampler's previous loop iteration.
+ * - sampler_cpu_percent : Sampler task CPU usage over the newest interval.
+ */
+typedef struct
+{
+    uint32_t sequence;
+    uint32_t sample_count;
+    uint32_t interval_ms;
+    float cpu_percent;
+    float core_percent[SYSMON_CORE_COUNT];
+    uint32_t dram_free;
+    uint32_t dram_min_free;
+    uint32_t dram_largest_block;
+    uint32_t dram_total;
+    uint32_t psram_free;
+    uint32_t psram_total;
+    int task_count;
+    uint32_t sampler_latency_us;
+    uint32_t sampler_work_us;
+    float sampler_cpu_percent;
+} sysmon_summary_t;
+
+/**
+ * @brief Newest values of one task.
+ *
+ * Members:
+ * - name               : Task name (points into the snapshot; valid until it is released).
+ * - task_number        : FreeRTOS task number (unique, unlike names).
+ * - priority           : Current priority.
+ * - core_id            : Core the task is pinned to (tskNO_AFFINITY if unpinned).
+ * - cpu_percent        : CPU usage over the newest interval.
+ * - run_time_ticks     : Cumulative run time counter.
+ * - stack_used_bytes   : Peak stack usage in bytes.
+ * - stack_size_bytes   : Registered stack size (0 if not registered with sysmon_stack_register()).
+ * - stack_used_percent : Peak stack usage in percent of stack_size_bytes (0 if not registered).
+ */
+typedef struct
+{
+    const char *name;
+    UBaseType_t task_number;
+    UBaseType_t priority;
+    int core_id;
+    float cpu_percent;
+    uint32_t run_time_ticks;
+    uint32_t stack_used_bytes;
+    uint32_t stack_size_bytes;
+    float stack_used_percent;
+} sysmon_task_info_t;
+
+/**
+ * @brief Global series of a snapshot.
+ *
+ * Percentage series yield sysmon_sample_t.percent, byte series sysmon_sample_t.bytes.
+ * Per-core CPU is SYSMON_SERIES_CORE_CPU(core).
+ */
+typedef enum
+{
+    SYSMON_SERIES_CPU = 0,              // Percentage
+    SYSMON_SERIES_DRAM_FREE,            // Bytes
+    SYSMON_SERIES_DRAM_MIN_FREE,        // Bytes
+    SYSMON_SERIES_DRAM_LARGEST_BLOCK,   // Bytes
+    SYSMON_SERIES_DRAM_USED_PERCENT,    // Percentage
+    SYSMON_SERIES_PSRAM_FREE,           // Bytes
+    SYSMON_SERIES_PSRAM_USED_PERCENT,   // Percentage
+    SYSMON_SERIES_CORE_CPU_FIRST,       // Percentage, SYSMON_CORE_COUNT series
+} sysmon_series_t;
+
+#define SYSMON_SERIES_CORE_CPU(core)    ((sysmon_series_t)(SYSMON_SERIES_CORE_CPU_FIRST + (core)))
+
+/**
+ * @brief Per-task series of a snapshot.
+ */
+typedef enum
+{
+    SYSMON_TASK_SERIES_CPU = 0,         // Percentage
+    SYSMON_TASK_SERIES_STACK_BYTES,     // Bytes (peak usage)
+    SYSMON_TASK_SERIES_STACK_PERCENT,   // Percentage (0 if the stack size is not registered)
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+    SYSMON_TASK_SERIES_HEAP_ALLOC,      // Bytes allocated since the task was first seen
+#endif
+} sysmon_task_series_t;
+
+/**
+ * @brief One sample yielded by sysmon_series_next().
+ *
+ * Members:
+ * - sequence : Sequence number of the sample.
+ * - percent  : Value of a percentage series (0 for byte series).
+ * - bytes    : Value of a byte series (0 for percentage series).
+ */
+typedef struct
+{
+    uint32_t sequence;
+    float percent;
+    uint32_t bytes;
+} sysmon_sample_t;
+
+/**
+ * @brief Position in a series, filled by sysmon_snapshot_series() (treat as opaque).
+ */
+typedef struct
+{
+    const SysMonSnapshot *snapshot;
+    const SysMonTaskSnapshot *task;
+    const float *percent_ring;
+    const uint32_t *bytes_ring;
+    int index;
+    int slots;
+    uint32_t remaining;
+    uint32_t sequence;
+    bool overwritten;
+} sysmon_series_iter_t;
+
+/**
+ * @brief Callback run after every committed sample.
+ *
+ * Runs on the sampler task with the new snapshot pinned; it must return
+ * quickly and must not block or call sysmon_unsubscribe().
+ *
+ * @param snapshot Snapshot of the new sample (valid only during the call).
+ * @param arg User argument given to sysmon_subscribe().
+ */
+typedef void (*sysmon_sample_cb_t)(const sysmon_snapshot_t *snapshot, void *arg);
+
+/**
+ * @brief Pin the newest snapshot for reading.
+ *
+ * Never blocks and never allocates. The newest values and task details are
+ * copies and stay valid until sysmon_release_snapshot(). The series are read
+ * from the live history rings, which the sampler keeps writing: once it reuses
+ * a sample of the window, sysmon_series_next() stops and
+ * sysmon_series_overwritten() returns true. Release the snapshot promptly;
+ * while it is pinned the sampler publishes into the other buffer, and after
+ * the next publish it skips publishing rather than wait.
+ *
+ * @return Pinned snapshot, or NULL before the first sample.
+ */
+const sysmon_snapshot_t *sysmon_get_snapshot(void);
+
+/**
+ * @brief Release a snapshot returned by sysmon_get_snapshot().
+ *
+ * @param snapshot Snapshot to release (NULL is ignored).
+ */
+void sysmon_release_snapshot(const sysmon_snapshot_t *snapshot);
+
+/**
+ * @brief Read the newest values of a snapshot.
+ *
+ * @param snapshot Pinned snapshot.
+ * @param summary Output values.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if an argument is NULL.
+ */
+esp_err_t sysmon_snapshot_summary(const sysmon_snapshot_t *snapshot, sysmon_summary_t *summary);
+
+/**
+ * @brief Read the newest values of one task.
+ *
+ * Iterate with `for (int i = 0; sysmon_snapshot_get_task(snapshot, i, &info); i++)`.
+ *
+ * @param snapshot Pinned snapshot.
+ * @param index Task index (0 to task_count - 1).
+ * @param info Output values.
+ * @return true if index is valid.
+ */
+bool sysmon_snapshot_get_task(const sysmon_snapshot_t *snapshot, int index, sysmon_task_info_t *info);
+
+/**
+ * @brief Start iterating the newest samples of a global series, oldest first.
+ *
+ * @param snapshot Pinned snapshot.
+ * @param series Series to read.
+ * @param count Samples to read (0 or more than available = the whole window).
+ * @param iter Output iterator for sysmon_series_next().
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an unknown series or NULL argument.
+ */
+esp_err_t sysmon_snapshot_series(const sysmon_snapshot_t *snapshot, sysmon_series_t series,
+                                 uint32_t count, sysmon_series_iter_t *iter);
+
+/**
+ * @brief Start iterating the newest samples of a task series, oldest first.
+ *
+ * @param snapshot Pinned snapshot.
+ * @param index Task index (as for sysmon_snapshot_get_task()).
+ * @param series Series to read.
+ * @param count Samples to read (0 or more than available = the whole window).
+ * @param iter Output iterator for sysmon_series_next().
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an unknown task or series.
+ */
+esp_err_t sysmon_snapshot_task_series(const sysmon_snapshot_t *snapshot, int index, sysmon_task_series_t series,
+                                      uint32_t count, sysmon_series_iter_t *iter);
+
+/**
+ * @brief Get the next sample of a series.
+ *
+ * The sample is checked after it is read. If the sampler has overwritten it
+ * since the snapshot was published, nothing is produced and the iteration ends.
+ *
+ * @param iter Iterator from sysmon_snapshot_series() or sysmon_snapshot_task_series().
+ * @param sample Output sample.
+ * @return true if a sample was produced, false at the end of the series or once
+ *         the sampler has overwritten the next sample (see sysmon_series_overwritten()).
+ */
+bool sysmon_series_next(sysmon_series_iter_t *iter, sysmon_sample_t *sample);
+
+/**
+ * @brief Tell whether a series ended early because the sampler overwrote it.
+ *
+ * Take a new snapshot to read the rest of the window.
+ *
+ * @param iter Iterator sysmon_series_next() returned false for.
+ * @return true if the remaining samples were overwritten while the snapshot was pinned.
+ */
+bool sysmon_series_overwritten(const sysmon_series_iter_t *iter);
+
+/**
+ * @brief Register a callback run after every committed sample.
+ *
+ * @param callback Callback.
+ * @param arg User argument passed to the callback.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if callback is NULL,
+ *         ESP_ERR_NO_MEM if SYSMON_MAX_SAMPLE_SUBSCRIBERS callbacks are registered.
+ */
+esp_err_t sysmon_subscribe(sysmon_sample_cb_t callback, void *arg);
+
+/**
+ * @brief Remove a callback registered with sysmon_subscribe().
+ *
+ * When this returns the callback is no longer running, unless it is called
+ * from the sampler task itself (i.e. from a callback), which is not allowed.
+ *
+ * @param callback Callback.
+ * @param arg User argument it was registered with.
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if it was not registered.
+ */
+esp_err_t sysmon_unsubscribe(sysmon_sample_cb_t callback, void *arg);
+
+// ============================================================================
+// Runtime Sampling Configuration
+// ============================================================================
+
+/**
+ * @brief Change the sampling interval and history depth without rebuilding.
+ *
+ * The sampler applies the change before its next sample, i.e. within one
+ * interval of the previous setting. Applying it starts a new history window:
+ * the rings are reallocated for the new depth (the previous ones are freed
+ * once no reader pins them) and every window holds samples of one interval
+ * only. Sequence numbers continue, so '/history?since=' clients and the
+ * exporter see the gap as their cursor falling behind the window.
+ *
+ * Rollups, heap region profiles and the flash log keep their spans in
+ * samples of CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS and pause while another
+ * interval is active. Called before sysmon_init(), the values apply from the
+ * first sample; sysmon_deinit() returns to the Kconfig defaults. Adaptive
+ * sampling (CONFIG_SYSMON_ADAPTIVE_SAMPLING) backs off from the interval set
+ * here and never changes it.
+ *
+ * @param interval_ms Sampling interval, SYSMON_SAMPLING_INTERVAL_MIN_MS to
+ *                    SYSMON_SAMPLING_INTERVAL_MAX_MS (0 = keep the current one).
+ * @param sample_count History window depth, sysmon_get_min_sample_count()
+ *                     to CONFIG_SYSMON_SAMPLE_COUNT_MAX (0 = keep the current one).
+ * @return ESP_OK if the change was queued, ESP_ERR_INVALID_ARG if a value is out of range.
+ *
+ * @note If the rings for the new depth cannot be allocated, the sampler logs a
+ *       warning and keeps the previous configuration.
+ */
+esp_err_t sysmon_set_sampling(uint32_t interval_ms, uint32_t sample_count);
+
+/**
+ * @brief Get the sampling interval and history depth in effect.
+ *
+ * A change queued with sysmon_set_sampling() is reported once the sampler has applied it.
+ *
+ * @param interval_ms Output: sampling interval (may be NULL).
+ * @param sample_count Output: history window depth (may be NULL).
+ * @return true if a queued change has not been applied yet.
+ */
+bool sysmon_get_sampling(uint32_t *interval_ms, uint32_t *sample_count);
+
+/**
+ * @brief Get the smallest history depth sysmon_set_sampling() accepts.
+ *
+ * At least SYSMON_SAMPLE_COUNT_MIN, raised by the enabled features that read a
+ * fixed number of raw samples (rollups, stack alerts, flash log, exporter batch).
+ *
+ * @return Minimum sample_count.
+ */
+uint32_t sysmon_get_min_sample_count(void);
+
 /**
  * @brief Initialize System Monitor: start HTTP server on port 81 and task monitor.
  *
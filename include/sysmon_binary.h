@@ -0,0 +1,99 @@
+/**
+ * @file sysmon_binary.h
+ * @brief Compact binary encoders for sysmon HTTP endpoints.
+ *
+ * This header declares the packed little-endian encoders served on
+ * '/telemetry.bin' and '/history.bin' (the telemetry payload is also pushed
+ * over the '/ws' WebSocket). They carry the same data as the JSON
+ * endpoints with percentages quantized to uint16 (hundredths of a percent),
+ * avoiding decimal text formatting on the device and roughly quartering the
+ * payload size.
+ *
+ * Layout (version 3, all integers little-endian, no padding):
+ *
+ *   Header (8 bytes):
+ *     u8[4] magic "SYSM", u8 version, u8 kind (1 = telemetry, 2 = history), u16 reserved
+ *
+ *   Telemetry body:
+ *     u8 core_count, u8 flags (bit0 psram present, bit1 rssi valid), i8 rssi,
+ *     u8 sampling_generation (low byte, changes when sysmon_set_sampling() is applied)
+ *     u16 cpu_overall, u16 cpu_core[core_count]
+ *     u32 dram_free, u32 dram_largest, u32 dram_total, u16 dram_used_pct
+ *     u32 psram_free, u32 psram_total, u16 psram_used_pct
+ *     task records until name_len == 0xFF:
+ *       u8 name_len, char name[name_len], u16 cpu_pct, u32 stack_bytes, u16 stack_pct,
+ *       u32 stack_remaining (0 when not applicable)
+ *     u8 metric_count, then per custom metric (see sysmon_custom.h):
+ *       u8 name_len, char name[name_len], u8 type (0 = counter, 1 = gauge), i32 value
+ *
+ *   History body:
+ *     u16 sample_count, u8 core_count, u8 flags (bit0 psram present)
+ *     u32 dram_total, u32 psram_total
+ *     series arrays, oldest to newest, each sample_count long:
+ *       u16 cpu_overall[], u16 cpu_core[core_count][], u32 dram_free[], u32 dram_min_free[],
+ *       u32 dram_largest[], u16 dram_used_pct[], u32 psram_free[], u16 psram_used_pct[]
+ *     task records until name_len == 0xFF (only the tasks selected by the request's
+ *     task query, see sysmon_query.h):
+ *       u8 name_len, char name[name_len], u8 flags (bit0 stack registered), u32 stack_size,
+ *       u16 cpu_pct[sample_count], u32 stack_bytes[sample_count] (registered tasks only)
+ *     u8 metric_count, then per custom metric:
+ *       u8 name_len, char name[name_len], u8 type, i32 values[sample_count]
+ *
+ * Custom metric values are counter increases per interval or gauge values;
+ * metric_count is 0 without CONFIG_SYSMON_CUSTOM_METRICS. Version 2 added the
+ * custom metric sections.
+ *
+ * History samples the sampler overwrote while the response was being sent are
+ * written as "no value": 0xFFFF for percentages, 0xFFFFFFFF for byte counts and
+ * INT32_MIN for custom metric values. Task samples from before the task took
+ * its history slot are marked the same way. Version 3 added these markers.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon_stream.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SYSMON_BINARY_VERSION         3
+#define SYSMON_BINARY_KIND_TELEMETRY  1
+#define SYSMON_BINARY_KIND_HISTORY    2
+#define SYSMON_BINARY_KIND_EXPORT     3
+#define SYSMON_BINARY_END_OF_TASKS    0xFF
+#define SYSMON_BINARY_NO_PERCENT      0xFFFF
+#define SYSMON_BINARY_NO_U32          0xFFFFFFFFU
+#define SYSMON_BINARY_NO_I32          0x80000000U
+
+/**
+ * @brief Encode the packed binary telemetry snapshot into a stream (not terminated).
+ *
+ * @param stream Initialized stream writer.
+ */
+void _encode_telemetry_binary(sysmon_stream_t *stream);
+
+/**
+ * @brief Stream the packed binary telemetry snapshot as a chunked response.
+ *
+ * @param request HTTP request to stream the response on.
+ * @return ESP_OK on success, error code otherwise.
+ */
+esp_err_t _stream_telemetry_binary(httpd_req_t *request);
+
+/**
+ * @brief Stream the packed binary series and task history as a chunked response.
+ *
+ * @param request HTTP request to stream the response on.
+ * @return ESP_OK on success, error code otherwise.
+ */
+esp_err_t _stream_history_binary(httpd_req_t *request);
+
+#ifdef __cplusplus
+}
+#endif
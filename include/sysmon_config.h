@@ -3,14 +3,16 @@
  * @brief Configuration structures and macros for HTTP server route handlers.
  *
  * This header defines the configuration structures and helper macros used to
- * configure static file handlers and JSON endpoint handlers in the sysmon
- * HTTP server.
+ * configure static file handlers and API (JSON and binary) endpoint handlers
+ * in the sysmon HTTP server.
  */
 
 #pragma once
 
 // ESP-IDF includes
 #include "cJSON.h"
+#include "esp_err.h"
+#include "esp_http_server.h"
 
 // System includes
 #include <stdint.h>
@@ -19,38 +21,61 @@
 extern "C" {
 #endif
 
+// Cache policy for static assets: browsers keep them but revalidate with If-None-Match
+#ifndef SYSMON_STATIC_CACHE_CONTROL
+#define SYSMON_STATIC_CACHE_CONTROL "no-cache"
+#endif
+
 /**
  * @brief Configuration structure for static file handlers.
+ *
+ * start/end delimit the gzip-compressed asset; etag is its quoted, build-time ETag.
  */
 typedef struct
 {
     const char *uri;
     const uint8_t *start;
     const uint8_t *end;
+    const char *etag;
 } static_file_config_t;
 
 /**
- * @brief Configuration structure for JSON endpoint handlers.
+ * @brief Configuration structure for API endpoint handlers.
+ *
+ * Each route carries its own encoder. Exactly one of create_json or stream is
+ * set: create_json builds a cJSON tree that the handler serializes, while
+ * stream writes the response itself as a chunked stream (used for endpoints
+ * whose size scales with tasks x samples, and for binary encodings).
  */
 typedef struct
 {
     const char *uri;
+    const char *content_type;
     cJSON *(*create_json)(void);
-} json_handler_config_t;
+    esp_err_t (*stream)(httpd_req_t *request);
+} api_handler_config_t;
 
 /**
  * @brief Macro to simplify binary file entry configuration.
  *
+ * Requires the generated sysmon_www_assets.h for the SYSMON_WWW_ETAG_* definitions.
+ *
  * @param uri_path URI path for the static file
- * @param name Base name of the binary symbol (e.g., "index_html" for _binary_index_html_start)
+ * @param name Base name of the asset (e.g., "index_html" for _binary_index_html_gz_start)
  */
 #define STATIC_FILE_ENTRY(uri_path, name) \
     { \
         .uri   = uri_path, \
-        .start = _binary_##name##_start, \
-        .end   = _binary_##name##_end \
+        .start = _binary_##name##_gz_start, \
+        .end   = _binary_##name##_gz_end, \
+        .etag  = SYSMON_WWW_ETAG_##name \
     }
 
+// Content types served by API endpoints
+#define API_CONTENT_TYPE_JSON    "application/json; charset=utf-8"
+#define API_CONTENT_TYPE_BINARY  "application/octet-stream"
+#define API_CONTENT_TYPE_METRICS "text/plain; version=0.0.4; charset=utf-8"
+
 /**
  * @brief Macro to simplify JSON endpoint entry configuration.
  *
@@ -59,8 +84,52 @@ typedef struct
  */
 #define JSON_ENDPOINT_ENTRY(uri_path, create_json_func) \
     { \
-        .uri         = uri_path, \
-        .create_json = create_json_func \
+        .uri          = uri_path, \
+        .content_type = API_CONTENT_TYPE_JSON, \
+        .create_json  = create_json_func, \
+        .stream       = NULL \
+    }
+
+/**
+ * @brief Macro to simplify streamed JSON endpoint entry configuration.
+ *
+ * @param uri_path URI path for the JSON endpoint
+ * @param stream_func Function pointer to chunked JSON writer function
+ */
+#define JSON_STREAM_ENDPOINT_ENTRY(uri_path, stream_func) \
+    { \
+        .uri          = uri_path, \
+        .content_type = API_CONTENT_TYPE_JSON, \
+        .create_json  = NULL, \
+        .stream       = stream_func \
+    }
+
+/**
+ * @brief Macro to simplify binary endpoint entry configuration.
+ *
+ * @param uri_path URI path for the binary endpoint
+ * @param stream_func Function pointer to chunked binary encoder function
+ */
+#define BINARY_ENDPOINT_ENTRY(uri_path, stream_func) \
+    { \
+        .uri          = uri_path, \
+        .content_type = API_CONTENT_TYPE_BINARY, \
+        .create_json  = NULL, \
+        .stream       = stream_func \
+    }
+
+/**
+ * @brief Macro to simplify Prometheus text endpoint entry configuration.
+ *
+ * @param uri_path URI path for the metrics endpoint
+ * @param stream_func Function pointer to chunked text encoder function
+ */
+#define METRICS_ENDPOINT_ENTRY(uri_path, stream_func) \
+    { \
+        .uri          = uri_path, \
+        .content_type = API_CONTENT_TYPE_METRICS, \
+        .create_json  = NULL, \
+        .stream       = stream_func \
     }
 
 #ifdef __cplusplus
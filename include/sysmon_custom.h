@@ -0,0 +1,108 @@
+/**
+ * @file sysmon_custom.h
+ * @brief Application-defined counters and gauges sampled next to the built-in series.
+ *
+ * This header declares the custom metric registry (CONFIG_SYSMON_CUSTOM_METRICS).
+ * An application registers up to CONFIG_SYSMON_CUSTOM_METRICS_MAX named
+ * metrics once, then updates them from any context, including ISRs:
+ *
+ * - Counters (SYSMON_METRIC_COUNTER) count events, e.g. frames or interrupts.
+ *   sysmon_metric_add() adds to a per-core counter with one relaxed atomic
+ *   add, so cores never contend for the same word. Each sample records the
+ *   amount added during the interval; the running total is kept as well.
+ * - Gauges (SYSMON_METRIC_GAUGE) hold a level, e.g. a queue depth.
+ *   sysmon_metric_set() stores the value, sysmon_metric_add() moves it up or
+ *   down atomically. Each sample records the value at sampling time.
+ *
+ * The sampler folds every metric into a ring of the history window after the
+ * CPU and memory series, and the values are served by '/telemetry',
+ * '/history?since=', '/metrics', the binary endpoints, the WebSocket push
+ * channel and the exporter. Metrics cannot be removed once registered.
+ */
+
+#pragma once
+
+// ESP-IDF includes
+#include "esp_attr.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Longest metric name kept (longer names are truncated)
+#define SYSMON_METRIC_NAME_MAX_LEN  23
+
+/**
+ * @brief Kind of a custom metric.
+ */
+typedef enum
+{
+    SYSMON_METRIC_COUNTER = 0,   // Events per sampling interval, plus a running total
+    SYSMON_METRIC_GAUGE   = 1,   // Value at sampling time
+} sysmon_metric_type_t;
+
+/**
+ * @brief Handle of a registered metric (NULL = not registered, updates are ignored).
+ */
+typedef struct sysmon_metric *sysmon_metric_handle_t;
+
+/**
+ * @brief Register a custom metric, or look up an existing one.
+ *
+ * Registering a name that already exists with the same type returns the
+ * existing handle, so components can register on demand. Call from task
+ * context; the handle is then usable from any context.
+ *
+ * @param name Metric name (up to SYSMON_METRIC_NAME_MAX_LEN characters are kept).
+ * @param type Counter or gauge.
+ * @return Metric handle, or NULL if name is empty, already registered with the
+ *         other type, the registry is full, or CONFIG_SYSMON_CUSTOM_METRICS is disabled.
+ */
+sysmon_metric_handle_t sysmon_metric_register(const char *name, sysmon_metric_type_t type);
+
+/**
+ * @brief Add to a counter, or move a gauge up or down.
+ *
+ * Lock-free and safe to call from ISRs (placed in IRAM).
+ *
+ * @param metric Metric handle (NULL is ignored).
+ * @param delta Amount to add.
+ */
+void sysmon_metric_add(sysmon_metric_handle_t metric, int32_t delta);
+
+/**
+ * @brief Set the value of a gauge.
+ *
+ * Lock-free and safe to call from ISRs (placed in IRAM). Ignored for counters.
+ *
+ * @param metric Metric handle (NULL is ignored).
+ * @param value New value.
+ */
+void sysmon_metric_set(sysmon_metric_handle_t metric, int32_t value);
+
+/**
+ * @brief Get the name and type of a registered metric (internal use only).
+ *
+ * Registered metrics never change, so this needs no lock for indices below a
+ * snapshot's custom_metric_count.
+ *
+ * @param index Metric index.
+ * @param type Output: metric type (may be NULL).
+ * @return Metric name, or NULL if index is not registered.
+ */
+const char *_custom_get_metric(int index, sysmon_metric_type_t *type);
+
+/**
+ * @brief Fold the metrics into the newest sample (internal use only).
+ *
+ * Called by the sampler after the series buffers are updated.
+ */
+void _custom_commit_sample(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,139 @@
+/**
+ * @file sysmon_export.h
+ * @brief Batched push exporter for sending sysmon telemetry to a collector.
+ *
+ * This header declares the optional exporter task (CONFIG_SYSMON_EXPORT). The
+ * sampler wakes it after every committed sample; once
+ * CONFIG_SYSMON_EXPORT_BATCH new samples are available it reads them from the
+ * history rings of the pinned snapshot and sends them as one batch, by default
+ * as UDP datagrams to CONFIG_SYSMON_EXPORT_HOST:CONFIG_SYSMON_EXPORT_PORT.
+ * sysmon_export_set_sink() replaces the UDP transport, e.g. to hand each
+ * datagram to an MQTT client the application already runs. The exporter does
+ * not need the HTTP server and keeps working with CONFIG_SYSMON_HEADLESS.
+ *
+ * Backpressure: if sending falls behind and more than one batch of samples is
+ * pending, the exporter either drops the oldest pending samples
+ * (CONFIG_SYSMON_EXPORT_BACKPRESSURE_DROP) or averages all pending samples
+ * into one batch of at most CONFIG_SYSMON_EXPORT_BATCH entries
+ * (CONFIG_SYSMON_EXPORT_BACKPRESSURE_DOWNSAMPLE). An entry averages at most
+ * 255 samples; older pending samples beyond that are dropped. Either way the batch
+ * sequence and first sample sequence in every datagram let the collector
+ * detect gaps. The UDP transport never blocks; a datagram the stack cannot
+ * queue is dropped and counted.
+ *
+ * Datagram layout (version 3, little-endian, no padding). A batch is split
+ * into parts of at most CONFIG_SYSMON_EXPORT_DATAGRAM_SIZE bytes at task
+ * record boundaries:
+ *
+ *   Header (8 bytes): u8[4] magic "SYSM", u8 version, u8 kind (3 = export), u16 reserved
+ *   Batch header (20 bytes):
+ *     u32 batch_seq, u32 first_sample_seq, u16 entry_count, u8 stride,
+ *     u8 core_count, u8 part, u8 flags (bit0 last part, bit1 psram present,
+ *     bit2 downsampled), u8 sampling_generation (low byte, changes when
+ *     sysmon_set_sampling() is applied), u8 reserved, u32 interval_ms
+ *   Part 0 only, series arrays, oldest to newest, entry_count long (each entry
+ *   covers `stride` consecutive samples starting at first_sample_seq):
+ *     u16 cpu_overall[], u16 cpu_core[core_count][], u32 dram_free[],
+ *     u32 dram_min_free[], u32 psram_free[]
+ *   Part 0 only, custom metrics (see sysmon_custom.h): u8 metric_count, then per metric
+ *     u8 name_len, char name[name_len], u8 type (0 = counter, 1 = gauge),
+ *     i32 value[entry_count] (counters: sum over the entry, gauges: mean)
+ *   Task records until the end of the datagram:
+ *     u8 name_len, char name[name_len], u16 cpu_pct[entry_count],
+ *     u32 stack_bytes (newest peak usage), u32 stack_size (0 = unregistered)
+ *
+ * Percentages are in hundredths of a percent, as in the binary endpoints.
+ * Consecutive samples are interval_ms apart, and a new sampling_generation
+ * means the interval may have changed since the previous batch. Samples the sampler overwrote before they could
+ * be sent are never exported: a batch whose oldest sample is reused while it
+ * is being sent stops at that datagram (its last part never arrives) and its
+ * samples count as dropped. Version 3 added sampling_generation and interval_ms.
+ */
+
+#pragma once
+
+// ESP-IDF includes
+#include "esp_err.h"
+
+// System includes
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SYSMON_EXPORT_HEADER_SIZE       28
+#define SYSMON_EXPORT_FLAG_LAST_PART    0x01
+#define SYSMON_EXPORT_FLAG_PSRAM        0x02
+#define SYSMON_EXPORT_FLAG_DOWNSAMPLED  0x04
+
+/**
+ * @brief Transport for exporter datagrams.
+ *
+ * Runs on the exporter task while the batch's snapshot is pinned, so it must
+ * not block: queue the datagram (e.g. esp_mqtt_client_enqueue()) and return.
+ *
+ * @param data Datagram bytes (only valid during the call).
+ * @param len Datagram length.
+ * @param arg User argument given to sysmon_export_set_sink().
+ * @return ESP_OK if the datagram was accepted, error code to count it as dropped.
+ */
+typedef esp_err_t (*sysmon_export_sink_t)(const uint8_t *data, size_t len, void *arg);
+
+/**
+ * @brief Exporter counters since sysmon_init().
+ *
+ * Members:
+ * - batches_sent      : Batches whose datagrams were all accepted by the transport.
+ * - datagrams_sent    : Datagrams accepted by the transport.
+ * - datagrams_dropped : Datagrams the transport rejected (link busy, no route, sink error).
+ * - samples_dropped   : Samples never exported because sending fell behind.
+ * - last_batch_seq    : Sequence number of the newest batch.
+ */
+typedef struct
+{
+    uint32_t batches_sent;
+    uint32_t datagrams_sent;
+    uint32_t datagrams_dropped;
+    uint32_t samples_dropped;
+    uint32_t last_batch_seq;
+} sysmon_export_stats_t;
+
+/**
+ * @brief Replace the built-in UDP transport.
+ *
+ * @param sink Transport function, or NULL to restore UDP.
+ * @param arg User argument passed to the sink.
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED without CONFIG_SYSMON_EXPORT.
+ */
+esp_err_t sysmon_export_set_sink(sysmon_export_sink_t sink, void *arg);
+
+/**
+ * @brief Read the exporter counters.
+ *
+ * @param stats Output counters.
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED without CONFIG_SYSMON_EXPORT.
+ */
+esp_err_t sysmon_export_get_stats(sysmon_export_stats_t *stats);
+
+/**
+ * @brief Start the exporter task (called by sysmon_init()).
+ *
+ * @return ESP_OK on success (or when the exporter is disabled), error code otherwise.
+ */
+esp_err_t _export_start(void);
+
+/**
+ * @brief Stop the exporter task and close its socket (called by sysmon_deinit()).
+ */
+void _export_stop(void);
+
+/**
+ * @brief Wake the exporter after a sample was committed (called by the sampler).
+ */
+void _export_notify(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,97 @@
+/**
+ * @file sysmon_flashlog.h
+ * @brief Long-term telemetry log in a dedicated flash partition.
+ *
+ * This header declares the optional flash log (CONFIG_SYSMON_FLASHLOG). Every
+ * CONFIG_SYSMON_FLASHLOG_SAMPLES raw samples (one minute by default) the
+ * sampler summarizes the newest samples, still in the raw rings, into one log
+ * entry: mean and peak overall CPU, mean CPU per core, and the lowest DRAM
+ * free, DRAM largest block and PSRAM free. CONFIG_SYSMON_FLASHLOG_BLOCK_ENTRIES
+ * entries are collected in RAM and written as one compressed block. Entries
+ * are one entry interval apart, so while sysmon_set_sampling() has another
+ * sampling interval active the log pauses and the block collected so far is
+ * written out.
+ *
+ * Flash layout: the data partition labelled CONFIG_SYSMON_FLASHLOG_PARTITION
+ * is a circular sequence of 4 KB sectors, each starting with a sector header
+ * (magic, sector sequence, entry interval, CRC32). Sectors are filled in
+ * order and erased just before reuse, so every sector is erased once per lap
+ * and wear is spread evenly. A block is a header (magic, payload length, entry
+ * count, first entry sequence, wall-clock time if known, CRC32 of the payload)
+ * followed by the payload: per entry and field, the difference to the previous
+ * entry as a zigzag varint (the first entry against zero). The payload is
+ * written before the header, so a block whose header is intact is complete.
+ * After a reboot the log continues in a fresh sector.
+ *
+ * Readback: the partition is memory-mapped once with esp_partition_mmap(), and
+ * '/history?range=<seconds>' decodes the blocks straight from mapped flash into
+ * the chunked response, with no heap copy of the log. Readers never look at
+ * the sector that will be erased next.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+#include "esp_http_server.h"
+#include "esp_partition.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Find and map the log partition and locate the newest entries.
+ *
+ * Called by sysmon_init() before the sampler starts. A missing, encrypted or
+ * too small partition disables the log with a warning.
+ *
+ * @return ESP_OK if the log is active, error code otherwise (not fatal).
+ */
+esp_err_t _flashlog_init(void);
+
+/**
+ * @brief Write the entries collected so far and unmap the partition.
+ *
+ * Called by sysmon_deinit() after the sampler has stopped.
+ */
+void _flashlog_deinit(void);
+
+/**
+ * @brief Add a log entry when the newest raw sample completes an entry interval.
+ *
+ * Called by the sampler after the series buffers are updated. Writes a block
+ * (and erases the next sector when the current one is full) every
+ * CONFIG_SYSMON_FLASHLOG_BLOCK_ENTRIES entries.
+ */
+void _flashlog_commit_sample(void);
+
+/**
+ * @brief Report how much of the log partition holds entries.
+ *
+ * @param part Partition to check.
+ * @param used_bytes Output: bytes in sectors holding log data.
+ * @param free_bytes Output: remaining bytes of the partition.
+ * @return true if part is the active log partition.
+ */
+bool _flashlog_get_usage(const esp_partition_t *part, uint32_t *used_bytes, uint32_t *free_bytes);
+
+/**
+ * @brief Stream the most recent entries of the log as a chunked JSON response.
+ *
+ * @param request HTTP request to send the response on.
+ * @param range_s Time span to return in seconds (0 = the whole log).
+ * @return ESP_OK on success, error code otherwise (404 if the log is not active).
+ */
+esp_err_t _stream_flashlog_json(httpd_req_t *request, uint32_t range_s);
+
+#ifdef __cplusplus
+}
+#endif
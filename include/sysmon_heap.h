@@ -0,0 +1,130 @@
+/**
+ * @file sysmon_heap.h
+ * @brief Per-capability heap region profiler for sysmon.
+ *
+ * This header declares the heap region profile behind '/heap'. Every
+ * CONFIG_SYSMON_HEAP_PROFILE_SAMPLES samples the sampler runs one
+ * heap_caps_get_info() pass per capability region (IRAM, DMA-capable,
+ * byte-addressable internal RAM, RTC RAM and PSRAM) and records free bytes,
+ * largest free block, minimum free bytes, free-block count and a fragmentation
+ * index. The last CONFIG_SYSMON_HEAP_PROFILE_COUNT profiles are kept, so a pool
+ * drifting toward an allocation failure shows up before allocations fail.
+ *
+ * heap_caps_get_info() walks every block of every matching heap while holding
+ * that heap's lock, which is why it runs on a slower cadence than the sampler.
+ * The cadence counts samples of CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS, so
+ * profiling pauses while sysmon_set_sampling() has another interval active.
+ * Requires CONFIG_SYSMON_HEAP_PROFILE; when disabled '/heap' is not registered.
+ *
+ * With CONFIG_SYSMON_HEAP_TASK_TRACKING the heap alloc/free hooks
+ * (CONFIG_HEAP_USE_HOOKS) also count bytes allocated, allocations and frees per
+ * task. Each tracked task gets a counter block through its thread-local storage
+ * pointer CONFIG_SYSMON_HEAP_TASK_TLS_INDEX, so only the task itself writes its
+ * counters and the hooks need no lock. Allocations made before the sampler has
+ * seen a task (or from an ISR) go to per-core unattributed counters instead.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon.h"
+
+// System includes
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Static description of one heap capability region.
+ *
+ * Members:
+ * - name : Region key used in '/heap'.
+ * - caps : MALLOC_CAP_* flags selecting the heaps of the region.
+ */
+typedef struct
+{
+    const char *name;
+    uint32_t caps;
+} SysMonHeapRegion;
+
+/**
+ * @brief Get the description of a heap region.
+ *
+ * @param region Region index (0 to SYSMON_HEAP_REGION_COUNT - 1).
+ * @return Region description, or NULL if the region does not exist.
+ */
+const SysMonHeapRegion *_heap_get_region(int region);
+
+/**
+ * @brief Get the time between two heap region profiles.
+ *
+ * @return Profile interval in milliseconds (0 when profiling is disabled).
+ */
+uint32_t _heap_profile_interval_ms(void);
+
+/**
+ * @brief Profile every heap region when the newest raw sample reaches a profile boundary.
+ *
+ * Called by the sampler after the series buffers are updated and before the
+ * snapshot is published. Does nothing on samples between profile boundaries.
+ */
+void _heap_profile_commit_sample(void);
+
+/**
+ * @brief Cumulative heap activity of one task (or the unattributed remainder).
+ *
+ * Members:
+ * - alloc_bytes : Bytes allocated (wraps at 4 GiB; deltas stay exact).
+ * - alloc_count : Successful allocations.
+ * - free_count  : Frees (the free hook does not report sizes, so only counts are known).
+ */
+typedef struct
+{
+    uint32_t alloc_bytes;
+    uint32_t alloc_count;
+    uint32_t free_count;
+} SysMonTaskHeapCounters;
+
+/**
+ * @brief Enable per-task heap attribution in the alloc/free hooks.
+ *
+ * Called by the sampler when it starts (the scheduler must be running).
+ */
+void _heap_task_tracking_start(void);
+
+/**
+ * @brief Disable per-task heap attribution; the hooks return immediately afterwards.
+ */
+void _heap_task_tracking_stop(void);
+
+/**
+ * @brief Give a task slot's counter block to a task.
+ *
+ * Resets the slot's counters and points the task's thread-local storage
+ * pointer at them; subsequent allocations by the task are counted there.
+ *
+ * @param slot Task slot index (below SYSMON_MAX_TRACKED_TASKS).
+ * @param handle Task now owning the slot.
+ */
+void _heap_task_attach(int slot, TaskHandle_t handle);
+
+/**
+ * @brief Read a task slot's cumulative counters.
+ *
+ * @param slot Task slot index.
+ * @param counters Output counters (zero when tracking is disabled).
+ */
+void _heap_task_read(int slot, SysMonTaskHeapCounters *counters);
+
+/**
+ * @brief Read the counters of allocations that could not be attributed to a tracked task.
+ *
+ * @param counters Output counters, summed over all cores.
+ */
+void _heap_task_read_unattributed(SysMonTaskHeapCounters *counters);
+
+#ifdef __cplusplus
+}
+#endif
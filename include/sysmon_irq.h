@@ -0,0 +1,91 @@
+/**
+ * @file sysmon_irq.h
+ * @brief Interrupt and critical-section time accounting for sysmon.
+ *
+ * This header declares the optional IRQ accounting (CONFIG_SYSMON_IRQ_ACCOUNTING).
+ * FreeRTOS charges the time spent in interrupt handlers, and in critical
+ * sections, to whichever task was running, so a driver ISR or a long
+ * portENTER_CRITICAL() shows up as CPU usage of an unrelated task. ESP-IDF
+ * offers no interrupt entry/exit hooks outside of SystemView, so the time is
+ * sampled instead: one general-purpose timer per core raises a low-priority
+ * interrupt CONFIG_SYSMON_IRQ_SAMPLE_HZ times per second. The hardware
+ * restarts the timer at every alarm, so the count the handler reads is how
+ * late it ran. A sample that runs more than CONFIG_SYSMON_IRQ_SLACK_US later
+ * than the quickest one seen hit a stretch in which the core could not take
+ * the interrupt: it was serving another interrupt or held interrupts masked
+ * in a critical section. Each such sample records the task that was running.
+ *
+ * Once per sample the sampler turns the counts into, per core, the share of
+ * time in interrupts and critical sections (the "irq%" series) and the
+ * longest stretch sampled, and per task, the share of its usage that was
+ * spent there. That share is moved out of the task's usage into one
+ * pseudo-task row per core ("IRQ/crit core N"), so the rows still add up to
+ * the core's usage and the time shows up where it was actually spent.
+ *
+ * Limits:
+ *   - The two causes cannot be told apart: both hold the sampling interrupt
+ *     off the same way. Interrupts above the sampling interrupt's level
+ *     (level 4 and up on Xtensa) are not seen.
+ *   - Stretches shorter than the slack, and the cost of taking an interrupt
+ *     that was not held off, are missed. The sampling interrupt itself costs
+ *     a few microseconds per sample.
+ *   - Samples are attributed statistically: at the default rate an interval
+ *     of one second has 1000 samples per core, so shares resolve to about 0.1%.
+ */
+
+#pragma once
+
+// ESP-IDF includes
+#include "esp_err.h"
+
+// System includes
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Figures of one drained interval for one core.
+ *
+ * Members:
+ * - irq_percent  : Share of the interval spent in interrupts and critical sections.
+ * - idle_percent : Part of irq_percent charged to the core's idle task (busy time
+ *                  the idle-based core usage misses).
+ * - max_us       : Longest stretch sampled in the interval (a lower bound of its length).
+ */
+typedef struct
+{
+    float irq_percent;
+    float idle_percent;
+    uint32_t max_us;
+} SysMonIrqCoreSample;
+
+/**
+ * @brief Start the sampling timers (called by the sampler when it starts).
+ *
+ * Each core's timer is created from a short-lived task pinned to that core,
+ * so its interrupt is allocated there.
+ *
+ * @return ESP_OK on success, otherwise the timer driver error (sampling stays off).
+ */
+esp_err_t _irq_start(void);
+
+/**
+ * @brief Stop and release the sampling timers.
+ */
+void _irq_stop(void);
+
+/**
+ * @brief Drain the per-core counters into per-core figures and per-task shares.
+ *
+ * Sets TaskUsageSample.irq_percent of every active task slot. Called by the
+ * sampler after the task slots are updated for the sample.
+ *
+ * @param cores Output: one entry per core (SYSMON_CORE_COUNT entries, zero while sampling is off).
+ */
+void _irq_drain(SysMonIrqCoreSample *cores);
+
+#ifdef __cplusplus
+}
+#endif
@@ -3,38 +3,77 @@
  * @brief JSON creation functions for sysmon HTTP endpoints.
  *
  * This header declares all JSON builder functions used to generate responses
- * for the sysmon HTTP API endpoints.
+ * for the sysmon HTTP API endpoints. Small responses are built as cJSON trees;
+ * large ones are streamed directly to the client in fixed-size chunks.
  */
 
 #pragma once
 
 // ESP-IDF includes
 #include "cJSON.h"
+#include "esp_err.h"
+#include "esp_http_server.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /**
- * @brief Build task metadata JSON object for all monitored tasks.
+ * @brief Stream task metadata JSON for the monitored tasks as a chunked response.
  *
- * @return Pointer to root cJSON object (must be freed by caller), or NULL on oom.
+ * Honors the task query parameters (see sysmon_query.h).
+ *
+ * @param request HTTP request to stream the response on.
+ * @return ESP_OK on success, error code otherwise.
  */
-cJSON *_create_tasks_json(void);
+esp_err_t _stream_tasks_json(httpd_req_t *request);
 
 /**
- * @brief Build JSON object tracing task usage history for all monitored tasks.
+ * @brief Stream task usage history JSON for all monitored tasks as a chunked response.
  *
- * @return Root cJSON object, or NULL on allocation failure.
+ * Honors the task query parameters (see sysmon_query.h).
+ *
+ * @param request HTTP request to stream the response on.
+ * @return ESP_OK on success, error code otherwise.
+ */
+esp_err_t _stream_history_json(httpd_req_t *request);
+
+/**
+ * @brief Build and serialize the cached '/hardware' document.
+ *
+ * Reads the partition table and app image headers from flash once; requests
+ * are then served from the cached bytes.
+ *
+ * @return ESP_OK on success (or if already built), ESP_ERR_NO_MEM on allocation failure.
+ */
+esp_err_t _hardware_cache_init(void);
+
+/**
+ * @brief Free the cached '/hardware' document.
+ */
+void _hardware_cache_deinit(void);
+
+/**
+ * @brief Send the cached hardware information document (chip, memory, partitions, WiFi, config).
+ *
+ * Volatile members (NVS usage, WiFi info, boot time) are refreshed at most
+ * every CONFIG_SYSMON_HARDWARE_REFRESH_MS.
+ *
+ * @param request HTTP request to send the response on.
+ * @return ESP_OK on success, error code otherwise.
  */
-cJSON *_create_history_json(void);
+esp_err_t _stream_hardware_json(httpd_req_t *request);
 
 /**
- * @brief Create hardware information JSON object with static chip and system info.
+ * @brief Stream the heap region profile history as a chunked response.
+ *
+ * Supports '?since=<seq>' to receive only profiles newer than a cursor.
+ * Only registered when CONFIG_SYSMON_HEAP_PROFILE is enabled.
  *
- * @return Hardware info JSON object, or NULL on allocation failure.
+ * @param request HTTP request to send the response on.
+ * @return ESP_OK on success, error code otherwise.
  */
-cJSON *_create_hardware_json(void);
+esp_err_t _stream_heap_json(httpd_req_t *request);
 
 /**
  * @brief Build a complete telemetry JSON object summarizing CPU/memory and current registered task usage.
@@ -43,6 +82,22 @@ cJSON *_create_hardware_json(void);
  */
 cJSON *_create_telemetry_json(void);
 
+/**
+ * @brief Build the sampling configuration JSON object (interval, depth, limits, pending change).
+ *
+ * @return Root cJSON object (must be freed by caller), or NULL on oom.
+ */
+cJSON *_create_sampling_json(void);
+
+/**
+ * @brief Build the scheduler trace JSON object (context switches and ready-to-run latency per task).
+ *
+ * Only registered when CONFIG_SYSMON_TRACE is enabled.
+ *
+ * @return Root cJSON object (must be freed by caller), or NULL on oom.
+ */
+cJSON *_create_trace_json(void);
+
 #ifdef __cplusplus
 }
 #endif
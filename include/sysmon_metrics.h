@@ -0,0 +1,35 @@
+/**
+ * @file sysmon_metrics.h
+ * @brief Prometheus text exposition encoder for sysmon HTTP endpoints.
+ *
+ * This header declares the encoder served on '/metrics'. It writes the
+ * Prometheus text format (version 0.0.4, also accepted by OpenMetrics
+ * scrapers) straight from the pinned snapshot through the chunked stream
+ * writer: per-core and overall CPU, memory gauges, per-task CPU and stack
+ * gauges, and monotonic counters such as task run time and sample count.
+ * No cJSON tree is built, so a scrape uses the same memory for 10 tasks as
+ * for 100. Requires CONFIG_SYSMON_METRICS; when disabled '/metrics' is not
+ * registered.
+ */
+
+#pragma once
+
+// ESP-IDF includes
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Stream all metrics in the Prometheus text format as a chunked response.
+ *
+ * @param request HTTP request to stream the response on.
+ * @return ESP_OK on success, or the first chunk send error.
+ */
+esp_err_t _stream_metrics_text(httpd_req_t *request);
+
+#ifdef __cplusplus
+}
+#endif
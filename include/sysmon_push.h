@@ -0,0 +1,76 @@
+/**
+ * @file sysmon_push.h
+ * @brief WebSocket push channel for live sysmon telemetry.
+ *
+ * This header declares the '/ws' push channel. Dashboards that open a
+ * WebSocket on '/ws' receive one binary telemetry frame (the '/telemetry.bin'
+ * layout, see sysmon_binary.h) per sample instead of polling. Each sample is
+ * encoded once by the sampler and fanned out to every subscriber from the
+ * HTTP server task, so encoding cost is independent of the client count.
+ *
+ * Requires CONFIG_HTTPD_WS_SUPPORT and CONFIG_SYSMON_WEBSOCKET_PUSH; when
+ * disabled the functions below are no-ops and '/ws' is not registered.
+ */
+
+#pragma once
+
+// ESP-IDF includes
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+// System includes
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum number of simultaneously connected push subscribers
+#ifndef SYSMON_PUSH_MAX_SUBSCRIBERS
+#define SYSMON_PUSH_MAX_SUBSCRIBERS 4
+#endif
+
+/**
+ * @brief Number of URI handlers sysmon_push_register() adds (0 when push is disabled).
+ */
+#ifdef CONFIG_SYSMON_WEBSOCKET_PUSH
+#define SYSMON_PUSH_URI_HANDLER_COUNT 1
+#else
+#define SYSMON_PUSH_URI_HANDLER_COUNT 0
+#endif
+
+/**
+ * @brief Register the '/ws' WebSocket endpoint on the sysmon HTTP server.
+ *
+ * @param server HTTP server handle.
+ * @return ESP_OK on success (or when push is disabled), error code otherwise.
+ */
+esp_err_t sysmon_push_register(httpd_handle_t server);
+
+/**
+ * @brief Drop all subscribers and any pending message state.
+ *
+ * Called after the HTTP server has been stopped. Also frees the message
+ * buffers, so the sampler must no longer be running sysmon_push_publish().
+ */
+void sysmon_push_reset(void);
+
+/**
+ * @brief Encode the newest sample once and queue it for every subscriber.
+ *
+ * Called by the sampler after each sample is committed. Does nothing when no
+ * client is subscribed. If the previous sample is still being sent, the new
+ * one is dropped so slow clients cannot build up a backlog.
+ */
+void sysmon_push_publish(void);
+
+/**
+ * @brief Get the number of connected push subscribers.
+ *
+ * @return Subscriber count.
+ */
+size_t sysmon_push_subscriber_count(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,122 @@
+/**
+ * @file sysmon_query.h
+ * @brief Task selection for '/tasks' and '/history' evaluated on the device.
+ *
+ * This header declares the task query shared by the task and history
+ * encoders. A request narrows the tasks it receives with query parameters:
+ *
+ * - top=<n>           : Only the n highest-ranked tasks.
+ * - by=cpu|stack      : Rank by CPU usage or peak stack usage of the newest
+ *                       sample (default cpu). Ranked output is highest first.
+ * - include=<pattern> : Only tasks whose name matches one of the patterns.
+ * - exclude=<pattern> : No task whose name matches one of the patterns.
+ * - core=<n>|unpinned : Only tasks pinned to core n, or only unpinned tasks.
+ *
+ * Patterns are comma-separated task names in which '*' matches any run of
+ * characters (e.g. 'include=wifi*,tiT'). They are compared case-sensitively
+ * with both the FreeRTOS name and the display name ('app_main' for 'main').
+ *
+ * The selection is computed once per response from the pinned snapshot. A
+ * top-n query keeps a min-heap of n candidates while scanning the tasks, so
+ * only the requested rows are ranked in full, and the encoders then walk the
+ * selected tasks only: the rows and histories of the other tasks are never
+ * formatted or sent.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_http_server.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Longest include= or exclude= value accepted
+#define SYSMON_QUERY_PATTERNS_MAX_LEN   127
+
+// core= values other than a core index
+#define SYSMON_QUERY_CORE_ANY           (-1)
+#define SYSMON_QUERY_CORE_UNPINNED      (-2)
+
+/**
+ * @brief Ranking of a task query.
+ */
+typedef enum
+{
+    SYSMON_TASK_RANK_NONE = 0,   // Snapshot order
+    SYSMON_TASK_RANK_CPU,        // CPU usage of the newest sample
+    SYSMON_TASK_RANK_STACK,      // Peak stack usage in percent (registered tasks first), then bytes
+} sysmon_task_rank_t;
+
+/**
+ * @brief Task query parsed from a request.
+ *
+ * Members:
+ * - top     : Largest number of tasks returned (0 = no limit).
+ * - by      : Ranking (SYSMON_TASK_RANK_NONE keeps snapshot order).
+ * - core    : Core index, SYSMON_QUERY_CORE_ANY or SYSMON_QUERY_CORE_UNPINNED.
+ * - include : Comma-separated name patterns a task must match one of ("" = all).
+ * - exclude : Comma-separated name patterns a task must match none of.
+ */
+typedef struct
+{
+    uint32_t top;
+    sysmon_task_rank_t by;
+    int core;
+    char include[SYSMON_QUERY_PATTERNS_MAX_LEN + 1];
+    char exclude[SYSMON_QUERY_PATTERNS_MAX_LEN + 1];
+} SysMonTaskQuery;
+
+/**
+ * @brief Tasks selected by a query, in output order.
+ *
+ * Members:
+ * - index : Indices into the snapshot's tasks array.
+ * - count : Number of entries in index.
+ */
+typedef struct
+{
+    int16_t *index;
+    int count;
+} SysMonTaskSelection;
+
+/**
+ * @brief Parse the task query parameters of a request.
+ *
+ * @param request HTTP request object.
+ * @param query Output: parsed query (all tasks in snapshot order if no parameter is present).
+ * @param error Output: message for a 400 Bad Request response (set with ESP_ERR_INVALID_ARG).
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an invalid parameter,
+ *         ESP_ERR_NO_MEM if the query could not be read.
+ */
+esp_err_t _task_query_parse(httpd_req_t *request, SysMonTaskQuery *query, const char **error);
+
+/**
+ * @brief Select the tasks of a snapshot matching a query.
+ *
+ * @param query Parsed query.
+ * @param snapshot Pinned snapshot to select from.
+ * @param selection Output: selected tasks (release with _task_selection_free()).
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the index cannot be allocated.
+ */
+esp_err_t _task_query_select(const SysMonTaskQuery *query, const SysMonSnapshot *snapshot,
+                             SysMonTaskSelection *selection);
+
+/**
+ * @brief Release a selection filled by _task_query_select().
+ *
+ * @param selection Selection to release (may be empty).
+ */
+void _task_selection_free(SysMonTaskSelection *selection);
+
+#ifdef __cplusplus
+}
+#endif
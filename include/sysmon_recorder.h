@@ -0,0 +1,68 @@
+/**
+ * @file sysmon_recorder.h
+ * @brief Crash-surviving flight recorder of recent sysmon samples.
+ *
+ * This header declares the optional flight recorder (CONFIG_SYSMON_RECORDER).
+ * After every sample the sampler appends one fixed-size record (overall and
+ * per-core CPU, DRAM/PSRAM free, and CPU and stack usage of up to
+ * CONFIG_SYSMON_RECORDER_TASKS tasks) to a ring of
+ * CONFIG_SYSMON_RECORDER_SAMPLES records in memory that survives a software
+ * reset: RTC_NOINIT memory by default, or the PSRAM no-init segment. Nothing
+ * is written to flash.
+ *
+ * A watchdog, panic or brownout reset keeps the region's contents. At the next
+ * sysmon_init() the recording is validated and copied to the heap, then the
+ * region is reset for the new boot; '/history?boot=previous' serves the copy.
+ *
+ * Integrity: the header (layout and boot count) carries a CRC32 over its
+ * fields and is written once per boot. Records are only ever appended, each
+ * with its own CRC32, so a record torn by a reset while it was being written
+ * is dropped instead of invalidating the recording. A task column names its
+ * task in a table entry (also CRC-protected) together with the first sample
+ * recorded for it, so samples of an earlier owner of a reused column are
+ * reported as missing rather than attributed to the wrong task.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+// System includes
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Validate and keep the previous boot's recording, then start a new one.
+ *
+ * Called by sysmon_init() before the sampler starts. The previous recording is
+ * only taken over on the first call after a reset; a later sysmon_init() in
+ * the same boot keeps it and just restarts the current recording.
+ */
+void _recorder_init(void);
+
+/**
+ * @brief Append the newest committed sample to the recording.
+ *
+ * Called by the sampler after the series buffers are updated.
+ */
+void _recorder_commit_sample(void);
+
+/**
+ * @brief Stream the previous boot's recording as a chunked JSON response.
+ *
+ * @param request HTTP request to send the response on.
+ * @return ESP_OK on success, error code otherwise (404 if there is no recording).
+ */
+esp_err_t _stream_recorder_json(httpd_req_t *request);
+
+#ifdef __cplusplus
+}
+#endif
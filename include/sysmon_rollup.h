@@ -0,0 +1,89 @@
+/**
+ * @file sysmon_rollup.h
+ * @brief Downsampled history tiers for sysmon.
+ *
+ * This header declares the rollup tiers that extend the raw history window.
+ * The medium tier summarizes every CONFIG_SYSMON_ROLLUP_MID_SAMPLES raw samples
+ * into one min/avg/max bucket; the coarse tier summarizes every
+ * CONFIG_SYSMON_ROLLUP_COARSE_FACTOR medium buckets. With the defaults and a
+ * 1 s sampling interval that is 10 s buckets for an hour and 60 s buckets for
+ * eight hours. Buckets are computed incrementally by the sampler from the raw
+ * rings (and the medium ring), so no separate accumulators are kept.
+ *
+ * Bucket spans are counted in samples of CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS.
+ * While sysmon_set_sampling() has another interval active, no buckets are
+ * committed, and after a change back the tiers resume once the restarted
+ * window holds a full medium bucket.
+ *
+ * '/history?resolution=<seconds>' serves a tier (see _stream_history_json()).
+ * Requires CONFIG_SYSMON_ROLLUPS; when disabled only the raw tier exists.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon.h"
+
+// System includes
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Static description of one rollup tier.
+ *
+ * Members:
+ * - span_samples : Raw samples summarized by one bucket.
+ * - bucket_count : Buckets kept in the tier window.
+ * - slots        : Ring length (bucket_count plus one spare bucket).
+ * - offset       : Index of the tier's first bucket within a SYSMON_ROLLUP_SLOTS block.
+ */
+typedef struct
+{
+    uint32_t span_samples;
+    int bucket_count;
+    int slots;
+    int offset;
+} SysMonRollupTier;
+
+/**
+ * @brief Get the description of a rollup tier.
+ *
+ * @param tier Tier index (0 = medium, 1 = coarse).
+ * @return Tier description, or NULL if the tier does not exist.
+ */
+const SysMonRollupTier *_rollup_get_tier(int tier);
+
+/**
+ * @brief Get the duration one bucket of a rollup tier covers.
+ *
+ * @param tier Tier index.
+ * @return Bucket duration in milliseconds (0 if the tier does not exist).
+ */
+uint32_t _rollup_tier_resolution_ms(int tier);
+
+/**
+ * @brief Pick the tier serving a requested resolution.
+ *
+ * Chooses the finest tier whose bucket duration is at least the requested
+ * resolution, or the coarsest tier if none is.
+ *
+ * @param resolution_ms Requested resolution in milliseconds.
+ * @return Tier index, or -1 when the raw samples already satisfy the request
+ *         (or no rollups are available).
+ */
+int _rollup_find_tier(uint32_t resolution_ms);
+
+/**
+ * @brief Commit rollup buckets that completed with the newest raw sample.
+ *
+ * Called by the sampler after the series buffers are updated and before the
+ * snapshot is published. Does nothing unless a bucket boundary was reached.
+ */
+void _rollup_commit_sample(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,15 +1,89 @@
 #pragma once
 
 // ESP-IDF includes
+#include "esp_err.h"
+#include "esp_event.h"
 #include "freertos/FreeRTOS.h"
 
 // System includes
+#include <stdbool.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Per-task alert threshold values with a special meaning (see sysmon_stack_set_alert_threshold())
+#define SYSMON_STACK_ALERT_DEFAULT  0       // Use CONFIG_SYSMON_STACK_ALERT_PERCENT
+#define SYSMON_STACK_ALERT_OFF      0xFF    // Never alert for this task
+
+/**
+ * @brief Event base of the events posted by sysmon to the default event loop.
+ */
+ESP_EVENT_DECLARE_BASE(SYSMON_EVENT);
+
+/**
+ * @brief Event IDs of SYSMON_EVENT.
+ */
+typedef enum
+{
+    SYSMON_EVENT_STACK_ALERT,   // Event data: sysmon_stack_alert_t
+} sysmon_event_id_t;
+
+/**
+ * @brief Stack alert severity, in escalating order.
+ *
+ * Values:
+ * - SYSMON_STACK_ALERT_NONE      : Usage below the threshold and not trending toward overflow.
+ * - SYSMON_STACK_ALERT_TREND     : Usage below the threshold, but at the rate observed over the
+ *                                  last CONFIG_SYSMON_STACK_ALERT_WINDOW samples the stack
+ *                                  overflows within CONFIG_SYSMON_STACK_ALERT_HORIZON_S.
+ * - SYSMON_STACK_ALERT_THRESHOLD : Usage reached the task's threshold.
+ */
+typedef enum
+{
+    SYSMON_STACK_ALERT_NONE = 0,
+    SYSMON_STACK_ALERT_TREND,
+    SYSMON_STACK_ALERT_THRESHOLD,
+} sysmon_stack_alert_level_t;
+
+/**
+ * @brief Stack alert passed to the alert callback and posted as SYSMON_EVENT_STACK_ALERT.
+ *
+ * Members:
+ * - task_handle           : Task the alert is about.
+ * - task_name             : Task name at the time of the alert.
+ * - level                 : New alert level (alerts only fire when the level rises).
+ * - threshold_percent     : Threshold in effect for the task.
+ * - usage_percent         : Peak stack usage (from the high water mark) in percent.
+ * - used_bytes            : Peak stack usage in bytes.
+ * - stack_size_bytes      : Registered stack size in bytes.
+ * - seconds_to_overflow   : Predicted time until the stack is exhausted at the current
+ *                           growth rate (UINT32_MAX when usage is not growing).
+ */
+typedef struct
+{
+    TaskHandle_t task_handle;
+    char task_name[24];
+    sysmon_stack_alert_level_t level;
+    uint8_t threshold_percent;
+    float usage_percent;
+    uint32_t used_bytes;
+    uint32_t stack_size_bytes;
+    uint32_t seconds_to_overflow;
+} sysmon_stack_alert_t;
+
+/**
+ * @brief Stack alert callback.
+ *
+ * Runs on the sysmon monitor task (stack SYSMON_MONITOR_STACK_SIZE) while it
+ * processes a sample, so it must be short and must not block.
+ *
+ * @param alert Alert details (only valid during the call).
+ * @param arg User argument given to sysmon_stack_set_alert_callback().
+ */
+typedef void (*sysmon_stack_alert_cb_t)(const sysmon_stack_alert_t *alert, void *arg);
+
 /**
  * @brief Register a task's stack size for accurate monitoring.
  *
@@ -25,12 +99,72 @@ void sysmon_stack_register(TaskHandle_t task_handle, uint32_t stack_size_bytes);
 /**
  * @brief Get registered stack size for a task.
  *
+ * Lock-free hash lookup keyed by the task handle; safe to call from any task
+ * while other tasks register stacks.
  * @param task_handle Handle of the task.
  * @param stack_size_bytes Output: stack size in bytes (0 if not registered).
  * @return true if task is registered, false otherwise.
  */
 bool sysmon_stack_get_size(TaskHandle_t task_handle, uint32_t *stack_size_bytes);
 
+/**
+ * @brief Get the registry generation, which changes whenever a registration is added or updated.
+ *
+ * Callers caching stack sizes (the sampler caches them per task slot) re-query
+ * sysmon_stack_get_size() when it changes.
+ *
+ * @return Current registry generation.
+ */
+uint32_t sysmon_stack_get_generation(void);
+
+/**
+ * @brief Set the stack alert threshold of a registered task.
+ *
+ * Call after sysmon_stack_register(). Registered tasks without an explicit
+ * threshold use CONFIG_SYSMON_STACK_ALERT_PERCENT; re-registering a task
+ * keeps its threshold.
+ *
+ * @param task_handle Handle of a registered task.
+ * @param threshold_percent Peak usage percentage (1-100) that raises an alert,
+ *                          SYSMON_STACK_ALERT_DEFAULT or SYSMON_STACK_ALERT_OFF.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a bad threshold,
+ *         ESP_ERR_NOT_FOUND if the task is not registered.
+ */
+esp_err_t sysmon_stack_set_alert_threshold(TaskHandle_t task_handle, uint8_t threshold_percent);
+
+/**
+ * @brief Set the function called when a task's stack alert level rises.
+ *
+ * Alerts are also posted to the default event loop as SYSMON_EVENT_STACK_ALERT
+ * when CONFIG_SYSMON_STACK_ALERT_EVENT is enabled.
+ *
+ * @param callback Callback, or NULL to remove it.
+ * @param arg User argument passed to the callback.
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED without CONFIG_SYSMON_STACK_ALERTS.
+ */
+esp_err_t sysmon_stack_set_alert_callback(sysmon_stack_alert_cb_t callback, void *arg);
+
+/**
+ * @brief Look up a task's registered stack size and alert threshold (used by the sampler).
+ *
+ * @param task_handle Handle of the task.
+ * @param stack_size_bytes Output: stack size in bytes (0 if not registered).
+ * @param threshold_percent Output: alert threshold (SYSMON_STACK_ALERT_DEFAULT if not set).
+ * @return true if task is registered, false otherwise.
+ */
+bool _stack_get_record(TaskHandle_t task_handle, uint32_t *stack_size_bytes, uint8_t *threshold_percent);
+
+/**
+ * @brief Check one task's stack usage against its threshold and growth trend.
+ *
+ * Called by the sampler after the task's stack usage was stored at write_index.
+ * Reads one older ring entry, so it costs O(1) per task and sample.
+ *
+ * @param idx Task slot index.
+ * @param write_index Ring index of the current sample.
+ */
+void _stack_alert_check(int idx, int write_index);
+
 /**
  * @brief Clean up stack records (called during sysmon_deinit).
  */
@@ -0,0 +1,124 @@
+/**
+ * @file sysmon_stream.h
+ * @brief Fixed-size chunked response writer for sysmon HTTP endpoints.
+ *
+ * This header declares a small streaming writer that accumulates output in a
+ * fixed buffer and flushes it to a sink whenever it fills. The default sink is
+ * httpd_resp_send_chunk(); other sinks (e.g. push message buffers) can be
+ * plugged in with _stream_begin_sink(). Endpoints that would otherwise build
+ * large cJSON trees use it so that peak memory stays constant regardless of
+ * task count or history depth.
+ */
+
+#pragma once
+
+// ESP-IDF includes
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+// System includes
+#include <stdarg.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Size of the chunk buffer used by streamed responses
+#ifndef SYSMON_STREAM_CHUNK_SIZE
+#define SYSMON_STREAM_CHUNK_SIZE 1024
+#endif
+
+/**
+ * @brief Sink receiving flushed chunks.
+ *
+ * Called with data == NULL and len == 0 once by _stream_end() to terminate the output.
+ *
+ * @param ctx Sink context passed to _stream_begin_sink().
+ * @param data Chunk bytes.
+ * @param len Number of bytes.
+ * @return ESP_OK on success, error code to abort the stream.
+ */
+typedef esp_err_t (*sysmon_stream_sink_t)(void *ctx, const char *data, size_t len);
+
+/**
+ * @brief Streaming writer state for a single chunked output.
+ *
+ * Members:
+ * - sink     : Function receiving each flushed chunk.
+ * - sink_ctx : Context passed to the sink (the httpd request for HTTP responses).
+ * - length   : Number of bytes currently buffered.
+ * - error    : First send error encountered; later writes are dropped once set.
+ * - buffer   : Fixed-size chunk buffer.
+ */
+typedef struct
+{
+    sysmon_stream_sink_t sink;
+    void *sink_ctx;
+    size_t length;
+    esp_err_t error;
+    char buffer[SYSMON_STREAM_CHUNK_SIZE];
+} sysmon_stream_t;
+
+/**
+ * @brief Initialize a stream writer for a request.
+ *
+ * @param stream Stream writer to initialize.
+ * @param request HTTP request to send chunks on.
+ */
+void _stream_begin(sysmon_stream_t *stream, httpd_req_t *request);
+
+/**
+ * @brief Initialize a stream writer that flushes into a custom sink.
+ *
+ * @param stream Stream writer to initialize.
+ * @param sink Function receiving each flushed chunk.
+ * @param sink_ctx Context passed to the sink.
+ */
+void _stream_begin_sink(sysmon_stream_t *stream, sysmon_stream_sink_t sink, void *sink_ctx);
+
+/**
+ * @brief Append raw bytes to the stream, flushing full chunks as needed.
+ *
+ * @param stream Stream writer.
+ * @param data Bytes to append.
+ * @param len Number of bytes to append.
+ */
+void _stream_write(sysmon_stream_t *stream, const char *data, size_t len);
+
+/**
+ * @brief Append a NUL-terminated string to the stream.
+ *
+ * @param stream Stream writer.
+ * @param str String to append.
+ */
+void _stream_puts(sysmon_stream_t *stream, const char *str);
+
+/**
+ * @brief Append printf-style formatted text to the stream.
+ *
+ * @param stream Stream writer.
+ * @param format printf-style format string.
+ * @param ... Format arguments.
+ */
+void _stream_printf(sysmon_stream_t *stream, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Append a quoted, escaped JSON string to the stream.
+ *
+ * @param stream Stream writer.
+ * @param str String to encode (NULL is written as an empty string).
+ */
+void _stream_json_string(sysmon_stream_t *stream, const char *str);
+
+/**
+ * @brief Flush any buffered bytes and terminate the output (final empty chunk for HTTP).
+ *
+ * @param stream Stream writer.
+ * @return ESP_OK on success, or the first send error encountered.
+ */
+esp_err_t _stream_end(sysmon_stream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,60 @@
+/**
+ * @file sysmon_trace.h
+ * @brief Context-switch and scheduling latency tracing for sysmon.
+ *
+ * This header declares the tracer behind '/trace'. With CONFIG_SYSMON_TRACE
+ * and sysmon_trace_hooks.h force-included into the build, the FreeRTOS trace
+ * macros traceTASK_SWITCHED_IN and traceMOVED_TASK_TO_READY_STATE record
+ * fixed-size events into one lock-free ring per core. The sampler drains the
+ * rings once per sample and derives, per task:
+ *   - context switches (total and per second over the last interval),
+ *   - ready-to-run latency: the time from becoming ready to being switched in,
+ *     as a histogram and as the maximum of the last interval,
+ *   - preemptions: switch-ins of a task that was not readied again since it
+ *     last ran, i.e. it was switched out while still ready.
+ *
+ * Events recorded while a ring is full are dropped and counted; use a larger
+ * CONFIG_SYSMON_TRACE_RING_DEPTH if '/trace' reports drops.
+ */
+
+#pragma once
+
+// Project-specific includes
+#include "sysmon.h"
+
+// System includes
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get the upper bound of a ready-latency histogram bucket.
+ *
+ * @param bucket Bucket index (0 to SYSMON_TRACE_LATENCY_BUCKETS - 1).
+ * @return Exclusive upper bound in microseconds (UINT32_MAX for the last, open bucket).
+ */
+uint32_t _trace_latency_bucket_limit_us(int bucket);
+
+/**
+ * @brief Start recording trace events (called by the sampler when it starts).
+ */
+void _trace_start(void);
+
+/**
+ * @brief Stop recording trace events and release the drain scratch space.
+ */
+void _trace_stop(void);
+
+/**
+ * @brief Drain the per-core event rings into the per-task trace statistics.
+ *
+ * Called by the sampler after the task slots are updated for the sample and
+ * before the snapshot is published.
+ */
+void _trace_drain_events(void);
+
+#ifdef __cplusplus
+}
+#endif
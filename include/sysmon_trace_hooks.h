@@ -0,0 +1,47 @@
+/**
+ * @file sysmon_trace_hooks.h
+ * @brief FreeRTOS trace macro definitions for the sysmon scheduler tracer.
+ *
+ * FreeRTOS only sees trace macros that are defined before FreeRTOS.h is
+ * included, so this header has to be force-included into every translation
+ * unit, including the kernel itself. Add it to the project-wide compile
+ * options in the top-level CMakeLists.txt, between including project.cmake
+ * and calling project():
+ *
+ *     idf_build_set_property(COMPILE_OPTIONS
+ *         "-include;${CMAKE_CURRENT_LIST_DIR}/components/sysmon/include/sysmon_trace_hooks.h" APPEND)
+ *
+ * The header only depends on sdkconfig.h and is empty unless CONFIG_SYSMON_TRACE
+ * is enabled, so it can stay included when tracing is turned off.
+ */
+
+#pragma once
+
+#include "sdkconfig.h"
+
+#if defined(CONFIG_SYSMON_TRACE) && !defined(__ASSEMBLER__)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Record that the scheduler switched the current core to a new task.
+ */
+void sysmon_trace_task_switched_in(void);
+
+/**
+ * @brief Record that a task was moved to the ready list.
+ *
+ * @param task TCB of the task (its TaskHandle_t).
+ */
+void sysmon_trace_task_ready(void *task);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define traceTASK_SWITCHED_IN()                 sysmon_trace_task_switched_in()
+#define traceMOVED_TASK_TO_READY_STATE(pxTCB)   sysmon_trace_task_ready((void *)(pxTCB))
+
+#endif // CONFIG_SYSMON_TRACE && !__ASSEMBLER__
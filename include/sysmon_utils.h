@@ -3,8 +3,8 @@
  * @brief Utility functions for sysmon HTTP module.
  *
  * This header declares utility functions used across the sysmon HTTP
- * subsystem for content type detection, task name formatting, and JSON
- * cleanup operations.
+ * subsystem for content type detection, task name formatting, query string
+ * parsing, and JSON cleanup operations.
  */
 
 #pragma once
@@ -12,6 +12,7 @@
 // ESP-IDF includes
 #include "cJSON.h"
 #include "esp_err.h"
+#include "esp_http_server.h"
 
 // System includes
 #include <stdarg.h>
@@ -30,6 +31,17 @@ extern "C" {
  */
 const char *_get_task_display_name(const char *task_name);
 
+/**
+ * @brief Quantize a percentage to hundredths of a percent in a uint16.
+ *
+ * Shared by the binary encoders and the history rollups. 0xFFFF is never
+ * returned, so encoders can use it as a no-value marker.
+ *
+ * @param percent Percentage value (clamped to 0..655.34).
+ * @return Quantized value (percent * 100, rounded).
+ */
+uint16_t _quantize_percent(float percent);
+
 /**
  * @brief Determine content type from URI path.
  *
@@ -38,6 +50,30 @@ const char *_get_task_display_name(const char *task_name);
  */
 const char *_get_content_type_from_uri(const char *uri);
 
+/**
+ * @brief Get the value of a URL query parameter.
+ *
+ * @param request HTTP request object.
+ * @param key Query parameter name.
+ * @param value_buffer Buffer to store the (NUL-terminated) value.
+ * @param buffer_size Size of the buffer.
+ * @return ESP_OK if found, ESP_ERR_NOT_FOUND if the request has no such parameter,
+ *         ESP_ERR_NO_MEM on allocation failure, or another httpd error code.
+ */
+esp_err_t _get_query_value(httpd_req_t *request, const char *key, char *value_buffer, size_t buffer_size);
+
+/**
+ * @brief Get a URL query parameter parsed as an unsigned 32-bit decimal.
+ *
+ * @param request HTTP request object.
+ * @param key Query parameter name.
+ * @param value Output: parsed value (unchanged unless ESP_OK is returned).
+ * @return ESP_OK if found and valid, ESP_ERR_NOT_FOUND if absent,
+ *         ESP_ERR_NO_MEM if the query could not be copied,
+ *         ESP_ERR_INVALID_ARG if present but not a valid unsigned number.
+ */
+esp_err_t _get_query_uint32(httpd_req_t *request, const char *key, uint32_t *value);
+
 /**
  * @brief Clean up multiple cJSON objects.
  *
@@ -27,8 +27,18 @@
 
 // Project-specific includes
 #include "sysmon.h"
+#include "sysmon_custom.h"
+#include "sysmon_export.h"
+#include "sysmon_flashlog.h"
 #include "sysmon_http.h"
+#include "sysmon_irq.h"
+#include "sysmon_json.h"
+#include "sysmon_push.h"
+#include "sysmon_recorder.h"
+#include "sysmon_heap.h"
+#include "sysmon_rollup.h"
 #include "sysmon_stack.h"
+#include "sysmon_trace.h"
 #include "sysmon_utils.h"
 
 // ESP-IDF includes
@@ -36,8 +46,11 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_heap_caps.h"
+#include "esp_timer.h"
 
 // System includes
+#include <inttypes.h>
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdint.h>
@@ -49,43 +62,529 @@ static const char *LOG_TAG = "sysmon";
 // Stores current task info, stats buffers, task handle, and ringbuffer pointers.
 SysMonState self = { 0 };
 
+// Guards snapshot pin counts and the published snapshot index (held for a few instructions only)
+static portMUX_TYPE s_snapshot_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Sampling change queued by sysmon_set_sampling() for the sampler (0 = keep the current value)
+static portMUX_TYPE s_sampling_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool s_sampling_pending = false;
+static uint32_t s_requested_interval_ms = 0;
+static uint32_t s_requested_sample_count = 0;
+
+#ifdef CONFIG_SYSMON_ADAPTIVE_SAMPLING
+// Set by _sampling_note_client() when a client request arrives, cleared by the sampler
+static bool s_client_seen = false;
+#endif
+
+// ============================================================================
+// Snapshot Publishing
+// ============================================================================
+
+/**
+ * @brief Check whether the retired history store can still be reached by a reader.
+ *
+ * @return true if a pinned or published snapshot still refers to self.retired_history.
+ */
+static bool _retired_history_in_use(void)
+{
+    bool in_use = false;
+    portENTER_CRITICAL(&s_snapshot_lock);
+    for (int i = 0; i < 2; i++)
+    {
+        const SysMonSnapshot *snapshot = &self.snapshots[i];
+        if (snapshot->history == self.retired_history &&
+            (snapshot->readers > 0 || i == self.published_snapshot))
+        {
+            in_use = true;
+        }
+    }
+    portEXIT_CRITICAL(&s_snapshot_lock);
+    return in_use;
+}
+
+/**
+ * @brief Free the retired history store once no snapshot reader can reach it.
+ */
+static void _release_retired_history(void)
+{
+    if (self.retired_history == NULL || _retired_history_in_use())
+    {
+        return;
+    }
+
+    // Only the unpublished, unpinned snapshot can still hold the pointer; readers cannot pin it
+    for (int i = 0; i < 2; i++)
+    {
+        if (self.snapshots[i].history == self.retired_history)
+        {
+            self.snapshots[i].history    = NULL;
+            self.snapshots[i].task_count = 0;
+        }
+    }
+    heap_caps_free(self.retired_history);
+    self.retired_history = NULL;
+}
+
+/**
+ * @brief Commit the current sampler state as the new published snapshot.
+ *
+ * Fills the snapshot buffer that is not currently published and then flips the
+ * published index. If that buffer is still pinned by a slow reader, publishing is
+ * skipped for this interval and readers keep the previous snapshot; the sampler never waits.
+ * Its window then ages in the shared rings, which readers check with _snapshot_intact_from()
+ * and _snapshot_sample_intact().
+ */
+static void _publish_snapshot(void)
+{
+    int next = 1 - self.published_snapshot;
+    SysMonSnapshot *snapshot = &self.snapshots[next];
+
+    portENTER_CRITICAL(&s_snapshot_lock);
+    bool pinned = (snapshot->readers > 0);
+    portEXIT_CRITICAL(&s_snapshot_lock);
+    if (pinned)
+    {
+        ESP_LOGD(LOG_TAG, "Snapshot %d still pinned, skipping publish of sample %" PRIu32, next, self.sample_sequence);
+        return;
+    }
+
+    if (snapshot->task_capacity < self.task_capacity)
+    {
+        SysMonTaskSnapshot *tasks = (SysMonTaskSnapshot *)realloc(snapshot->tasks,
+                                                                  sizeof(SysMonTaskSnapshot) * self.task_capacity);
+        if (tasks == NULL)
+        {
+            // Keep the previous snapshot published
+            return;
+        }
+        snapshot->tasks = tasks;
+        snapshot->task_capacity = self.task_capacity;
+    }
+
+    const SysMonHistoryStore *history = self.history;
+    int newest = (self.series_write_index - 1 + history->slots) % history->slots;
+    int task_count = 0;
+    for (int j = 0; j < self.task_capacity; j++)
+    {
+        const TaskUsageSample *task = &self.tasks[j];
+        if (!task->is_active)
+        {
+            continue;
+        }
+
+        SysMonTaskSnapshot *entry = &snapshot->tasks[task_count++];
+        entry->slot                  = j;
+        entry->since                 = self.history->task_since[j];
+        memcpy(entry->task_name, task->task_name, sizeof(entry->task_name));
+        entry->task_id               = task->task_id;
+        entry->current_priority      = task->current_priority;
+        entry->base_priority         = task->base_priority;
+        entry->total_run_time_ticks  = task->total_run_time_ticks;
+        entry->stack_high_water_mark = task->stack_high_water_mark;
+        entry->stack_size_bytes      = task->stack_size_bytes;
+        entry->core_id               = task->core_id;
+        entry->usage_percent         = SYSMON_TASK_RING(self.history, usage_percent, j)[newest];
+        entry->stack_usage_bytes     = SYSMON_TASK_RING(self.history, stack_usage_bytes, j)[newest];
+        entry->stack_usage_percent   = SYSMON_TASK_RING(self.history, stack_usage_percent, j)[newest];
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+        entry->heap_alloc_bytes      = task->heap_alloc_bytes;
+        entry->heap_alloc_count      = task->heap_alloc_count;
+        entry->heap_free_count       = task->heap_free_count;
+#endif
+#ifdef CONFIG_SYSMON_TRACE
+        entry->trace_switches        = task->trace_switches;
+        entry->trace_preemptions     = task->trace_preemptions;
+        entry->trace_switch_rate     = task->trace_switch_rate;
+        entry->trace_latency_max_us  = task->trace_latency_max_us;
+        memcpy(entry->trace_latency_hist, task->trace_latency_hist, sizeof(entry->trace_latency_hist));
+#endif
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+        entry->irq_row               = task->irq_row;
+        entry->irq_percent           = task->irq_percent;
+#endif
+    }
+
+    SysMonSampleValues *values = &snapshot->newest;
+    values->cpu_overall_percent = history->cpu_overall_percent[newest];
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        values->cpu_core_percent[core]          = SYSMON_CORE_RING(history, cpu_core_percent, core)[newest];
+        values->cpu_core_unpinned_percent[core] = SYSMON_CORE_RING(history, cpu_core_unpinned_percent, core)[newest];
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+        values->cpu_core_irq_percent[core]      = SYSMON_CORE_RING(history, cpu_core_irq_percent, core)[newest];
+#endif
+    }
+    values->dram_free          = history->dram_free[newest];
+    values->dram_min_free      = history->dram_min_free[newest];
+    values->dram_largest_block = history->dram_largest_block[newest];
+    values->dram_total         = history->dram_total[newest];
+    values->dram_used_percent  = history->dram_used_percent[newest];
+    values->psram_free         = history->psram_free[newest];
+    values->psram_total        = history->psram_total[newest];
+    values->psram_used_percent = history->psram_used_percent[newest];
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+    for (int i = 0; i < self.custom_metric_count; i++)
+    {
+        values->custom_metric_values[i] = SYSMON_CUSTOM_RING(history, i)[newest];
+    }
+#endif
+
+    snapshot->task_count   = task_count;
+    snapshot->history      = history;
+    snapshot->sequence     = self.sample_sequence;
+    snapshot->newest_index = newest;
+    snapshot->oldest_index = (self.series_write_index + 1) % history->slots;
+    snapshot->sample_count = self.sample_count;
+    snapshot->available    = self.series_available;
+    snapshot->interval_ms  = self.sample_interval_ms;
+    snapshot->sampling_generation = self.sampling_generation;
+#ifdef CONFIG_SYSMON_ROLLUPS
+    memcpy(snapshot->rollup_sequence, self.rollup_sequence, sizeof(snapshot->rollup_sequence));
+#endif
+#ifdef CONFIG_SYSMON_HEAP_PROFILE
+    snapshot->heap_profile_sequence = self.heap_profile_sequence;
+#endif
+#ifdef CONFIG_SYSMON_TRACE
+    snapshot->trace_events  = self.trace_events;
+    snapshot->trace_dropped = self.trace_dropped;
+#endif
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+    memcpy(snapshot->irq_max_us, self.irq_max_us, sizeof(snapshot->irq_max_us));
+#endif
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+    snapshot->custom_metric_count = self.custom_metric_count;
+    memcpy(snapshot->custom_metric_totals, self.custom_metric_totals, sizeof(snapshot->custom_metric_totals));
+#endif
+    snapshot->self_metrics = self.self_metrics;
+
+    portENTER_CRITICAL(&s_snapshot_lock);
+    self.published_snapshot = next;
+    portEXIT_CRITICAL(&s_snapshot_lock);
+}
+
+/**
+ * @brief Pin the most recently published snapshot for reading.
+ *
+ * @return Pinned snapshot (never NULL; sequence is 0 before the first sample).
+ */
+const SysMonSnapshot *_snapshot_acquire(void)
+{
+    portENTER_CRITICAL(&s_snapshot_lock);
+    SysMonSnapshot *snapshot = &self.snapshots[self.published_snapshot];
+    snapshot->readers++;
+    portEXIT_CRITICAL(&s_snapshot_lock);
+    return snapshot;
+}
+
+/**
+ * @brief Check that ring entries read from a pinned snapshot held the sample.
+ *
+ * Works like a sequence lock. The sampler publishes the store's sequence, and a
+ * slot's start, before it writes the entries they guard; the reader loads them
+ * after reading the entries. An entry read before the sampler started the sample
+ * that reuses it therefore passes, and any later read fails.
+ *
+ * @param snapshot Pinned snapshot.
+ * @param task Task whose rings were read (NULL for the global series).
+ * @param sequence Sequence number of the sample read.
+ * @return true if the entries read held that sample.
+ */
+bool _snapshot_sample_intact(const SysMonSnapshot *snapshot, const SysMonTaskSnapshot *task, uint32_t sequence)
+{
+    const SysMonHistoryStore *history = snapshot->history;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (task != NULL && __atomic_load_n(&history->task_since[task->slot], __ATOMIC_RELAXED) != task->since)
+    {
+        return false;
+    }
+
+    // The sampler may be writing the sample after the committed one, over the entry
+    // of the sample slots - 1 before it
+    uint32_t committed = __atomic_load_n(&history->sequence, __ATOMIC_RELAXED);
+    return (int32_t)(sequence - (committed + 2U - (uint32_t)history->slots)) >= 0;
+}
+
+/**
+ * @brief Oldest sample of a pinned snapshot's window still in the rings.
+ *
+ * @param snapshot Pinned snapshot.
+ * @return Sequence of the oldest intact sample of the window (sequence + 1 if none is left).
+ */
+uint32_t _snapshot_intact_from(const SysMonSnapshot *snapshot)
+{
+    const SysMonHistoryStore *history = snapshot->history;
+    uint32_t from = snapshot->sequence - (uint32_t)snapshot->available + 1U;
+    uint32_t committed = __atomic_load_n(&history->sequence, __ATOMIC_ACQUIRE);
+    uint32_t reused_before = committed + 2U - (uint32_t)history->slots;
+    if ((int32_t)(reused_before - from) > 0)
+    {
+        from = reused_before;
+    }
+    if ((int32_t)(from - snapshot->sequence) > 1)
+    {
+        from = snapshot->sequence + 1U;
+    }
+    return from;
+}
+
+/**
+ * @brief Release a snapshot pinned with _snapshot_acquire().
+ *
+ * @param snapshot Snapshot returned by _snapshot_acquire().
+ */
+void _snapshot_release(const SysMonSnapshot *snapshot)
+{
+    if (snapshot == NULL)
+    {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_snapshot_lock);
+    SysMonSnapshot *pinned = &self.snapshots[snapshot - self.snapshots];
+    if (pinned->readers > 0)
+    {
+        pinned->readers--;
+    }
+    portEXIT_CRITICAL(&s_snapshot_lock);
+}
+
 // ============================================================================
 // Monitor Task Helper Functions
 // ============================================================================
 
 /**
- * @brief Ensure task storage capacity is sufficient for all active tasks.
- * 
- * Uses dynamic calculation based on actual task count with percentage-based growth buffer.
- * 
- * @return true if capacity is adequate, false on allocation failure.
+ * @brief Hash a task number into the task index.
+ *
+ * @param task_number TaskStatus_t.xTaskNumber.
+ * @return Bucket index (already masked to task_index_size).
+ */
+static int _task_index_bucket(UBaseType_t task_number)
+{
+    // Fibonacci hashing spreads sequential task numbers across buckets
+    return (int)(((uint32_t)task_number * 2654435761U) & (uint32_t)(self.task_index_size - 1));
+}
+
+/**
+ * @brief Insert a slot into the task index under its current task number.
+ *
+ * @param slot Slot index in self.tasks.
  */
-static bool _ensure_task_storage_capacity(void)
+static void _task_index_insert(int slot)
 {
-    // If we have existing capacity, try to get actual task count
-    int actual_task_count = 0;
-    bool buffer_was_full = false;
-    if (self.task_capacity > 0 && self.task_status != NULL)
+    int bucket = _task_index_bucket(self.tasks[slot].task_id);
+    while (self.task_index[bucket] != 0)
     {
-        uint32_t total_run_time = 0;
-        UBaseType_t num = uxTaskGetSystemState(self.task_status, self.task_capacity, &total_run_time);
-        actual_task_count = (int)num;
-        
-        // If we got fewer tasks than capacity, we have enough space
-        if (actual_task_count < self.task_capacity)
+        bucket = (bucket + 1) & (self.task_index_size - 1);
+    }
+    self.task_index[bucket] = (int16_t)(slot + 1);
+}
+
+/**
+ * @brief Rebuild the task index from the active slots, growing it if needed.
+ *
+ * @return true on success, false on allocation failure.
+ */
+static bool _rebuild_task_index(void)
+{
+    // Four buckets per slot keep the load factor at or below 50%, even with the
+    // stale entries name-fallback claims leave behind until the next rebuild
+    int required_size = 16;
+    while (required_size < self.task_capacity * 4)
+    {
+        required_size *= 2;
+    }
+
+    if (required_size != self.task_index_size)
+    {
+        int16_t *new_index = (int16_t *)malloc(sizeof(int16_t) * required_size);
+        if (new_index == NULL)
         {
-            return true;
+            return false;
         }
-        
-        // If we got exactly capacity, buffer was full - might have more tasks
-        buffer_was_full = (actual_task_count == self.task_capacity);
+        free(self.task_index);
+        self.task_index      = new_index;
+        self.task_index_size = required_size;
     }
-    else
+
+    memset(self.task_index, 0, sizeof(int16_t) * self.task_index_size);
+    for (int j = 0; j < self.task_capacity; j++)
     {
-        // No existing buffer, use uxTaskGetNumberOfTasks() as initial estimate
-        actual_task_count = (int)uxTaskGetNumberOfTasks();
+        if (self.tasks[j].is_active)
+        {
+            _task_index_insert(j);
+        }
     }
-    
+    self.task_index_dirty = false;
+    return true;
+}
+
+/**
+ * @brief Allocate zeroed history memory.
+ *
+ * Placed in PSRAM when CONFIG_SYSMON_HISTORY_IN_PSRAM is enabled (falling back to internal RAM).
+ *
+ * @param size Number of bytes.
+ * @return Allocated block, or NULL on allocation failure.
+ */
+static void *_history_calloc(size_t size)
+{
+    void *block = NULL;
+#ifdef CONFIG_SYSMON_HISTORY_IN_PSRAM
+    block = heap_caps_calloc(1, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (block == NULL)
+    {
+        ESP_LOGW(LOG_TAG, "PSRAM allocation of %u byte history failed, using internal RAM", (unsigned)size);
+    }
+#endif
+    if (block == NULL)
+    {
+        block = heap_caps_calloc(1, size, MALLOC_CAP_DEFAULT);
+    }
+    return block;
+}
+
+// Global series rings in a history store (all of them have 4-byte entries)
+#define SYSMON_SERIES_RING_COUNT    (9 + 2 * SYSMON_CORE_COUNT + SYSMON_IRQ_SERIES_COUNT + SYSMON_CUSTOM_METRIC_COUNT)
+
+/**
+ * @brief Allocate a zeroed history store for a number of task slots.
+ *
+ * The header and all rings share one block (see _history_calloc()).
+ *
+ * @param capacity Number of task slots.
+ * @param sample_count History window depth (each ring has one more entry).
+ * @return New store, or NULL on allocation failure.
+ */
+static SysMonHistoryStore *_history_store_create(int capacity, int sample_count)
+{
+    int slots = sample_count + 1;
+    size_t ring_entries = (size_t)capacity * slots;
+    size_t size = sizeof(SysMonHistoryStore) +
+                  (size_t)SYSMON_SERIES_RING_COUNT * slots * sizeof(uint32_t) +
+                  ring_entries * (sizeof(float) + sizeof(uint32_t) + sizeof(float));
+#ifdef CONFIG_SYSMON_ROLLUPS
+    size_t rollup_entries = (size_t)capacity * SYSMON_ROLLUP_SLOTS;
+    size += rollup_entries * sizeof(SysMonTaskRollup);
+#endif
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+    size += ring_entries * sizeof(uint32_t);
+#endif
+    size += (size_t)capacity * sizeof(uint32_t);
+
+    SysMonHistoryStore *store = (SysMonHistoryStore *)_history_calloc(size);
+    if (store == NULL)
+    {
+        return NULL;
+    }
+
+    store->capacity            = capacity;
+    store->slots               = slots;
+    store->sequence            = self.sample_sequence;
+    store->cpu_overall_percent = (float *)(store + 1);
+    store->cpu_core_percent    = store->cpu_overall_percent + slots;
+    store->cpu_core_unpinned_percent = store->cpu_core_percent + (size_t)SYSMON_CORE_COUNT * slots;
+    store->dram_free           = (uint32_t *)(store->cpu_core_unpinned_percent + (size_t)SYSMON_CORE_COUNT * slots);
+    store->dram_min_free       = store->dram_free + slots;
+    store->dram_largest_block  = store->dram_min_free + slots;
+    store->dram_total          = store->dram_largest_block + slots;
+    store->dram_used_percent   = (float *)(store->dram_total + slots);
+    store->psram_free          = (uint32_t *)(store->dram_used_percent + slots);
+    store->psram_total         = store->psram_free + slots;
+    store->psram_used_percent  = (float *)(store->psram_total + slots);
+    void *task_fields = store->psram_used_percent + slots;
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+    store->cpu_core_irq_percent = (float *)task_fields;
+    task_fields = store->cpu_core_irq_percent + (size_t)SYSMON_CORE_COUNT * slots;
+#endif
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+    store->custom_metric_values = (int32_t *)task_fields;
+    task_fields = store->custom_metric_values + (size_t)SYSMON_CUSTOM_METRIC_COUNT * slots;
+#endif
+    store->usage_percent       = (float *)task_fields;
+    store->stack_usage_bytes   = (uint32_t *)(store->usage_percent + ring_entries);
+    store->stack_usage_percent = (float *)(store->stack_usage_bytes + ring_entries);
+    void *next_field = store->stack_usage_percent + ring_entries;
+#ifdef CONFIG_SYSMON_ROLLUPS
+    store->rollups             = (SysMonTaskRollup *)next_field;
+    next_field = store->rollups + rollup_entries;
+#endif
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+    store->heap_alloc_bytes    = (uint32_t *)next_field;
+    next_field = store->heap_alloc_bytes + ring_entries;
+#endif
+    store->task_since          = (uint32_t *)next_field;
+    return store;
+}
+
+/**
+ * @brief Publish an empty history window before the first sample.
+ *
+ * Readers started by sysmon_init() then always find a history store in the
+ * published snapshot. The store has no task slots; the first sample replaces
+ * it like any capacity change does.
+ *
+ * @return ESP_OK on success (or if a store exists), ESP_ERR_NO_MEM on allocation failure.
+ */
+static esp_err_t _history_init(void)
+{
+    if (self.history != NULL)
+    {
+        return ESP_OK;
+    }
+
+    // Kconfig defaults; values queued by sysmon_set_sampling() apply at the first sample
+    self.sample_interval_ms = CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS;
+    self.sample_count       = CONFIG_SYSMON_SAMPLE_COUNT;
+    self.history = _history_store_create(0, self.sample_count);
+    if (self.history == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    SysMonSnapshot *snapshot = &self.snapshots[self.published_snapshot];
+    snapshot->history      = self.history;
+    snapshot->newest_index = self.history->slots - 1;
+    snapshot->oldest_index = 1;
+    snapshot->sample_count = self.sample_count;
+    snapshot->interval_ms  = self.sample_interval_ms;
+    return ESP_OK;
+}
+
+/**
+ * @brief Reset a slot's history rings to zero (slot taken by a new task).
+ *
+ * @param slot Task slot index.
+ */
+static void _history_store_clear_slot(int slot)
+{
+    size_t slots = (size_t)self.history->slots;
+    // Readers holding the previous task's samples see the new start before the rings change
+    __atomic_store_n(&self.history->task_since[slot], self.sample_sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memset(SYSMON_TASK_RING(self.history, usage_percent, slot), 0, sizeof(float) * slots);
+    memset(SYSMON_TASK_RING(self.history, stack_usage_bytes, slot), 0, sizeof(uint32_t) * slots);
+    memset(SYSMON_TASK_RING(self.history, stack_usage_percent, slot), 0, sizeof(float) * slots);
+#ifdef CONFIG_SYSMON_ROLLUPS
+    memset(SYSMON_TASK_ROLLUPS(self.history, slot), 0, sizeof(SysMonTaskRollup) * SYSMON_ROLLUP_SLOTS);
+#endif
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+    memset(SYSMON_TASK_RING(self.history, heap_alloc_bytes, slot), 0, sizeof(uint32_t) * slots);
+#endif
+}
+
+/**
+ * @brief Grow task storage so it can hold a given number of tasks.
+ * 
+ * Uses dynamic calculation based on the task count with percentage-based growth buffer.
+ * This is the only place the sampler allocates scratch space; the steady-state loop
+ * runs entirely in the buffers sized here.
+ * 
+ * @param actual_task_count Number of tasks that must fit.
+ * @param buffer_was_full True if the current buffers proved too small (grows more aggressively).
+ * @return true if capacity is adequate (or growth is deferred), false on allocation failure.
+ */
+static bool _grow_task_storage(int actual_task_count, bool buffer_was_full)
+{
     // Calculate required capacity with dynamic growth buffer
     // If buffer was full, grow more aggressively (50%) to avoid multiple iterations
     // Otherwise, use smaller growth (20%) for normal scaling
@@ -108,9 +607,23 @@ static bool _ensure_task_storage_capacity(void)
         return true;
     }
     
+    // The previous history store is still pinned by a snapshot reader; grow on a later sample
+    _release_retired_history();
+    if (self.retired_history != NULL)
+    {
+        return true;
+    }
+    
+    SysMonHistoryStore *new_history = _history_store_create(required_capacity, self.sample_count);
+    if (new_history == NULL)
+    {
+        return false;
+    }
+    
     TaskUsageSample *new_tasks = (TaskUsageSample *)calloc(required_capacity, sizeof(TaskUsageSample));
     if (new_tasks == NULL)
     {
+        heap_caps_free(new_history);
         return false;
     }
     
@@ -118,46 +631,122 @@ static bool _ensure_task_storage_capacity(void)
     if (new_status == NULL)
     {
         free(new_tasks);
+        heap_caps_free(new_history);
+        return false;
+    }
+    
+    int16_t *new_hints = (int16_t *)malloc(sizeof(int16_t) * required_capacity);
+    if (new_hints == NULL)
+    {
+        free(new_status);
+        free(new_tasks);
+        heap_caps_free(new_history);
+        return false;
+    }
+    
+    bool *new_seen = (bool *)malloc(sizeof(bool) * required_capacity);
+    if (new_seen == NULL)
+    {
+        free(new_hints);
+        free(new_status);
+        free(new_tasks);
+        heap_caps_free(new_history);
         return false;
     }
+    for (int j = 0; j < required_capacity; j++)
+    {
+        new_hints[j] = -1;
+    }
     
-    // Copy existing active tasks
+    // Copy the global series (contiguous after the header) and existing active tasks
     if (self.tasks != NULL)
     {
+        size_t slots = (size_t)new_history->slots;
+        memcpy(new_history->cpu_overall_percent, self.history->cpu_overall_percent,
+               sizeof(uint32_t) * SYSMON_SERIES_RING_COUNT * slots);
         for (int j = 0; j < self.task_capacity; j++)
         {
             if (self.tasks[j].is_active)
             {
                 new_tasks[j] = self.tasks[j];
+                new_history->task_since[j] = self.history->task_since[j];
+                memcpy(SYSMON_TASK_RING(new_history, usage_percent, j),
+                       SYSMON_TASK_RING(self.history, usage_percent, j), sizeof(float) * slots);
+                memcpy(SYSMON_TASK_RING(new_history, stack_usage_bytes, j),
+                       SYSMON_TASK_RING(self.history, stack_usage_bytes, j), sizeof(uint32_t) * slots);
+                memcpy(SYSMON_TASK_RING(new_history, stack_usage_percent, j),
+                       SYSMON_TASK_RING(self.history, stack_usage_percent, j), sizeof(float) * slots);
+#ifdef CONFIG_SYSMON_ROLLUPS
+                memcpy(SYSMON_TASK_ROLLUPS(new_history, j),
+                       SYSMON_TASK_ROLLUPS(self.history, j), sizeof(SysMonTaskRollup) * SYSMON_ROLLUP_SLOTS);
+#endif
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+                memcpy(SYSMON_TASK_RING(new_history, heap_alloc_bytes, j),
+                       SYSMON_TASK_RING(self.history, heap_alloc_bytes, j), sizeof(uint32_t) * slots);
+#endif
             }
         }
     }
     
-    // Ownership hand-off
+    // Ownership hand-off (the old history store may still be pinned by snapshot readers;
+    // snapshots copy task metadata, so the old tasks array can go right away)
+    self.retired_history = self.history;
     free(self.tasks);
     free(self.task_status);
-    self.tasks         = new_tasks;
-    self.task_status   = new_status;
-    self.task_capacity = required_capacity;
+    free(self.task_slot_hints);
+    free(self.tasks_seen);
+    self.history          = new_history;
+    self.tasks            = new_tasks;
+    self.task_status      = new_status;
+    self.task_slot_hints  = new_hints;
+    self.tasks_seen       = new_seen;
+    self.task_capacity    = required_capacity;
     
-    return true;
+    // Resize the task number index for the new capacity
+    self.task_index_dirty = true;
+    return _rebuild_task_index();
 }
 
 /**
  * @brief Sample current task states and calculate total runtime delta.
  * 
+ * Takes one uxTaskGetSystemState() snapshot per interval. uxTaskGetSystemState()
+ * returns 0 when the buffer is smaller than the task list; only then (or when a
+ * slot could not be claimed on the previous sample) is storage grown, and the
+ * snapshot retaken once.
+ * 
  * @param num_returned Output: number of tasks returned by uxTaskGetSystemState.
  * @param delta_total Output: calculated delta for total runtime.
  * @return true on success, false if sampling failed.
  */
 static bool _sample_task_states(UBaseType_t *num_returned, uint32_t *delta_total)
 {
-    uint32_t total_run_time = 0;
-    UBaseType_t num = uxTaskGetSystemState(self.task_status, self.task_capacity, &total_run_time);
+    // Slots ran out last sample (tasks waiting out their zero samples hold slots too)
+    if (self.task_capacity_short)
+    {
+        int previous_capacity = self.task_capacity;
+        if (!_grow_task_storage(self.task_capacity, true))
+        {
+            return false;
+        }
+        self.task_capacity_short = (self.task_capacity == previous_capacity);
+    }
     
+    uint32_t total_run_time = 0;
+    UBaseType_t num = (self.task_status != NULL)
+                      ? uxTaskGetSystemState(self.task_status, self.task_capacity, &total_run_time) : 0;
     if (num == 0)
     {
-        return false;
+        // Buffer too small for the task list (or not allocated yet): grow and retake the snapshot
+        if (!_grow_task_storage((int)uxTaskGetNumberOfTasks(), self.task_status != NULL))
+        {
+            return false;
+        }
+        num = uxTaskGetSystemState(self.task_status, self.task_capacity, &total_run_time);
+        if (num == 0)
+        {
+            return false;
+        }
     }
     
     *num_returned = num;
@@ -179,33 +768,85 @@ static bool _sample_task_states(UBaseType_t *num_returned, uint32_t *delta_total
 }
 
 /**
- * @brief Find or create task entry index for a given task name.
- * 
- * @param task_name Task name to find.
- * @return Task index on success, -1 if no slot available.
+ * @brief Look up the slot tracking a task by identity (task number and handle).
+ *
+ * Tries the slot this status entry mapped to on the previous sample first, then
+ * the task number hash index. O(1) on average.
+ *
+ * @param status_index Index of the task in self.task_status.
+ * @param task_status Task status from uxTaskGetSystemState.
+ * @return Slot index, or -1 if the task is not tracked yet.
+ */
+static int _find_task_slot(UBaseType_t status_index, const TaskStatus_t *task_status)
+{
+    int hint = self.task_slot_hints[status_index];
+    if (hint >= 0 && hint < self.task_capacity &&
+        self.tasks[hint].is_active &&
+        self.tasks[hint].task_id == task_status->xTaskNumber &&
+        self.tasks[hint].task_handle == task_status->xHandle)
+    {
+        return hint;
+    }
+
+    int bucket = _task_index_bucket(task_status->xTaskNumber);
+    while (self.task_index[bucket] != 0)
+    {
+        // Entries may be stale until the next rebuild, so verify the slot's identity
+        int slot = self.task_index[bucket] - 1;
+        if (self.tasks[slot].is_active &&
+            self.tasks[slot].task_id == task_status->xTaskNumber &&
+            self.tasks[slot].task_handle == task_status->xHandle)
+        {
+            return slot;
+        }
+        bucket = (bucket + 1) & (self.task_index_size - 1);
+    }
+    return -1;
+}
+
+/**
+ * @brief Claim a slot for a task that has no slot under its identity yet.
+ *
+ * Falls back to the name: a slot with the same name whose previous owner was not
+ * seen in this sample (the task was deleted and recreated) keeps its history.
+ * Otherwise a free slot is allocated. Two live tasks with the same name always
+ * get separate slots.
+ *
+ * @param task_status Task status from uxTaskGetSystemState.
+ * @param tasks_seen Slots already matched in this sample.
+ * @return Slot index on success, -1 if no slot available.
  */
-static int _find_or_create_task_index(const char *task_name)
+static int _claim_task_slot(const TaskStatus_t *task_status, const bool *tasks_seen)
 {
-    // Try to find existing task entry
+    // Name fallback for recreated tasks
     for (int j = 0; j < self.task_capacity; j++)
     {
-        if (self.tasks[j].is_active && 
-            strncmp(self.tasks[j].task_name, task_name, sizeof(self.tasks[j].task_name)) == 0)
+        if (self.tasks[j].is_active && !tasks_seen[j] &&
+            strncmp(self.tasks[j].task_name, task_status->pcTaskName, sizeof(self.tasks[j].task_name)) == 0)
         {
+            self.tasks[j].task_id             = task_status->xTaskNumber;
+            self.tasks[j].task_handle         = task_status->xHandle;
+            self.tasks[j].prev_run_time_ticks = 0;  // New task's counter starts at its creation
+            self.task_index_dirty = true;
+            _task_index_insert(j);
             return j;
         }
     }
-    
+
     // Allocate slot for new task
     for (int j = 0; j < self.task_capacity; j++)
     {
         if (!self.tasks[j].is_active)
         {
             memset(&self.tasks[j], 0, sizeof(TaskUsageSample));
-            strncpy(self.tasks[j].task_name, task_name, sizeof(self.tasks[j].task_name) - 1);
+            _history_store_clear_slot(j);
+            strncpy(self.tasks[j].task_name, task_status->pcTaskName, sizeof(self.tasks[j].task_name) - 1);
             self.tasks[j].is_active = true;
             self.tasks[j].consecutive_zero_samples = 0;
-            ESP_LOGI(LOG_TAG, "Discovered new task: '%s'", task_name);
+            self.tasks[j].task_id = task_status->xTaskNumber;
+            self.tasks[j].task_handle = task_status->xHandle;
+            _task_index_insert(j);
+            ESP_LOGI(LOG_TAG, "Discovered new task: '%s'", task_status->pcTaskName);
             return j;
         }
     }
@@ -213,6 +854,41 @@ static int _find_or_create_task_index(const char *task_name)
     return -1;
 }
 
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+/**
+ * @brief Merge a task's heap hook counters into its slot.
+ *
+ * Attaches the slot's counter block when the slot changed owner, then records
+ * the bytes allocated since the previous sample, per interval covered, in the
+ * task's history ring.
+ *
+ * @param idx Task index.
+ * @param handle Task handle currently owning the slot.
+ * @param write_index Ring index of the sample being written.
+ */
+static void _update_task_heap(int idx, TaskHandle_t handle, int write_index)
+{
+    TaskUsageSample *task = &self.tasks[idx];
+    if (task->heap_counters_handle != handle)
+    {
+        _heap_task_attach(idx, handle);
+        task->heap_counters_handle = handle;
+        task->heap_alloc_bytes     = 0;
+        task->heap_alloc_count     = 0;
+        task->heap_free_count      = 0;
+    }
+
+    SysMonTaskHeapCounters counters;
+    _heap_task_read(idx, &counters);
+    // Spread evenly over the intervals this sample covers
+    SYSMON_TASK_RING(self.history, heap_alloc_bytes, idx)[write_index] =
+        (counters.alloc_bytes - task->heap_alloc_bytes) / self.self_metrics.span;
+    task->heap_alloc_bytes = counters.alloc_bytes;
+    task->heap_alloc_count = counters.alloc_count;
+    task->heap_free_count  = counters.free_count;
+}
+#endif
+
 /**
  * @brief Update task usage history for a single task.
  * 
@@ -233,17 +909,32 @@ static void _update_task_history(int idx, const TaskStatus_t *task_status, uint3
     // Calculate CPU usage
     float usage = (delta_total > 0) ? ((float)delta_task / (float)delta_total) * 100.0f : 0.0f;
     self.tasks[idx].consecutive_zero_samples = 0;  // Task is present, reset counter
-    self.tasks[idx].usage_percent_history[self.tasks[idx].write_index] = usage;
+    int write_index = self.series_write_index;
+    SYSMON_TASK_RING(self.history, usage_percent, idx)[write_index] = usage;
     
     // Calculate stack usage
     self.tasks[idx].stack_high_water_mark = task_status->usStackHighWaterMark;
     uint32_t stack_hwm_bytes = task_status->usStackHighWaterMark * sizeof(StackType_t);
     
-    // Lookup registered stack size
-    uint32_t stack_size_bytes = 0U;
-    sysmon_stack_get_size(task_status->xHandle, &stack_size_bytes);
-    
-    self.tasks[idx].stack_size_bytes = stack_size_bytes;
+    // Lookup registered stack size only when the handle or the registry changed
+    uint32_t stack_generation = sysmon_stack_get_generation();
+    if (self.tasks[idx].stack_size_handle != task_status->xHandle ||
+        self.tasks[idx].stack_size_generation != stack_generation)
+    {
+        uint32_t registered_bytes = 0U;
+        uint8_t alert_percent = SYSMON_STACK_ALERT_DEFAULT;
+        _stack_get_record(task_status->xHandle, &registered_bytes, &alert_percent);
+        if (registered_bytes != self.tasks[idx].stack_size_bytes)
+        {
+            // Usage in bytes is not comparable across sizes; restart the growth window
+            self.tasks[idx].stack_alert_samples = 0;
+        }
+        self.tasks[idx].stack_alert_percent   = alert_percent;
+        self.tasks[idx].stack_size_bytes      = registered_bytes;
+        self.tasks[idx].stack_size_handle     = task_status->xHandle;
+        self.tasks[idx].stack_size_generation = stack_generation;
+    }
+    uint32_t stack_size_bytes = self.tasks[idx].stack_size_bytes;
     
     uint32_t stack_used_bytes = 0U;
     float stack_usage_percent = 0.0f;
@@ -257,11 +948,16 @@ static void _update_task_history(int idx, const TaskStatus_t *task_status, uint3
     }
     
     // Store stack usage history
-    self.tasks[idx].stack_usage_bytes_history[self.tasks[idx].write_index] = stack_used_bytes;
-    self.tasks[idx].stack_usage_percent_history[self.tasks[idx].write_index] = stack_usage_percent;
+    SYSMON_TASK_RING(self.history, stack_usage_bytes, idx)[write_index] = stack_used_bytes;
+    SYSMON_TASK_RING(self.history, stack_usage_percent, idx)[write_index] = stack_usage_percent;
+#ifdef CONFIG_SYSMON_STACK_ALERTS
+    _stack_alert_check(idx, write_index);
+#endif
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+    _update_task_heap(idx, task_status->xHandle, write_index);
+#endif
     
     // Update task metadata
-    self.tasks[idx].write_index = (self.tasks[idx].write_index + 1) % CONFIG_SYSMON_SAMPLE_COUNT;
     self.tasks[idx].task_id = task_status->xTaskNumber;
     self.tasks[idx].current_priority = task_status->uxCurrentPriority;
     self.tasks[idx].base_priority = task_status->uxBasePriority;
@@ -283,83 +979,184 @@ static void _process_deleted_tasks(const bool *tasks_seen)
             self.tasks[j].consecutive_zero_samples++;
             
             // Record zero values
-            self.tasks[j].usage_percent_history[self.tasks[j].write_index] = 0.0f;
-            self.tasks[j].stack_usage_bytes_history[self.tasks[j].write_index] = 0U;
-            self.tasks[j].stack_usage_percent_history[self.tasks[j].write_index] = 0.0f;
-            self.tasks[j].write_index = (self.tasks[j].write_index + 1) % CONFIG_SYSMON_SAMPLE_COUNT;
+            SYSMON_TASK_RING(self.history, usage_percent, j)[self.series_write_index] = 0.0f;
+            SYSMON_TASK_RING(self.history, stack_usage_bytes, j)[self.series_write_index] = 0U;
+            SYSMON_TASK_RING(self.history, stack_usage_percent, j)[self.series_write_index] = 0.0f;
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+            SYSMON_TASK_RING(self.history, heap_alloc_bytes, j)[self.series_write_index] = 0U;
+#endif
+            // The zero entries would read as growth once the task is seen again
+            self.tasks[j].stack_alert_samples = 0;
             
-            // Mark inactive after CONFIG_SYSMON_SAMPLE_COUNT consecutive zeros
-            if (self.tasks[j].consecutive_zero_samples >= CONFIG_SYSMON_SAMPLE_COUNT)
+            // Mark inactive after a whole history window of consecutive zeros
+            if (self.tasks[j].consecutive_zero_samples >= self.sample_count)
             {
                 self.tasks[j].is_active = false;
                 self.tasks[j].consecutive_zero_samples = 0;
+                self.task_index_dirty = true;
                 ESP_LOGI(LOG_TAG, "Task removed after %d consecutive zero samples: '%s'", 
-                         CONFIG_SYSMON_SAMPLE_COUNT, self.tasks[j].task_name);
+                         self.sample_count, self.tasks[j].task_name);
             }
             else if (self.tasks[j].consecutive_zero_samples % 10 == 0)
             {
                 ESP_LOGI(LOG_TAG, "Task not detected; logging zero for inactivity (sample %d of %d): '%s'", 
-                         self.tasks[j].consecutive_zero_samples, CONFIG_SYSMON_SAMPLE_COUNT, 
+                         self.tasks[j].consecutive_zero_samples, self.sample_count, 
                          self.tasks[j].task_name);
             }
         }
     }
 }
 
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+/**
+ * @brief Get the slot of a core's IRQ row, claiming a free slot on first use.
+ *
+ * @param core Core index.
+ * @return Slot index, or -1 if no slot is free (storage grows before the next sample).
+ */
+static int _claim_irq_slot(int core)
+{
+    int slot = self.irq_slots[core];
+    if (slot >= 0 && slot < self.task_capacity && self.tasks[slot].is_active &&
+        self.tasks[slot].irq_row && self.tasks[slot].core_id == core)
+    {
+        return slot;
+    }
+
+    for (int j = 0; j < self.task_capacity; j++)
+    {
+        if (!self.tasks[j].is_active)
+        {
+            memset(&self.tasks[j], 0, sizeof(TaskUsageSample));
+            _history_store_clear_slot(j);
+            snprintf(self.tasks[j].task_name, sizeof(self.tasks[j].task_name), "IRQ/crit core %d", core);
+            self.tasks[j].is_active = true;
+            self.tasks[j].irq_row   = true;
+            self.tasks[j].core_id   = core;
+            self.irq_slots[core]    = j;
+            return j;
+        }
+    }
+    self.task_capacity_short = true;
+    return -1;
+}
+
+/**
+ * @brief Move interrupt and critical-section time out of the task rows into one row per core.
+ *
+ * Drains the IRQ sampler, subtracts each task's share from its usage, writes
+ * the per-core irq% series and the IRQ rows' usage. Must run after the
+ * per-task histories are updated and before deleted tasks are processed.
+ *
+ * @param tasks_seen Slots seen in this sample (the IRQ rows are marked as well).
+ */
+static void _update_irq_rows(bool *tasks_seen)
+{
+    SysMonIrqCoreSample cores[SYSMON_CORE_COUNT];
+    _irq_drain(cores);
+    int write_index = self.series_write_index;
+
+    for (int j = 0; j < self.task_capacity; j++)
+    {
+        const TaskUsageSample *task = &self.tasks[j];
+        if (!tasks_seen[j] || task->irq_row || task->irq_percent <= 0.0f)
+        {
+            continue;
+        }
+        float *usage = &SYSMON_TASK_RING(self.history, usage_percent, j)[write_index];
+        *usage = (*usage > task->irq_percent) ? *usage - task->irq_percent : 0.0f;
+    }
+
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        SYSMON_CORE_RING(self.history, cpu_core_irq_percent, core)[write_index] = cores[core].irq_percent;
+        self.irq_idle_percent[core] = cores[core].idle_percent;
+        self.irq_max_us[core]       = cores[core].max_us;
+
+        int slot = _claim_irq_slot(core);
+        if (slot < 0)
+        {
+            continue;
+        }
+        SYSMON_TASK_RING(self.history, usage_percent, slot)[write_index] = cores[core].irq_percent;
+        SYSMON_TASK_RING(self.history, stack_usage_bytes, slot)[write_index] = 0U;
+        SYSMON_TASK_RING(self.history, stack_usage_percent, slot)[write_index] = 0.0f;
+        tasks_seen[slot] = true;
+    }
+}
+#endif
+
 /**
  * @brief Calculate per-core CPU usage from idle task deltas.
- * 
+ *
+ * Core usage is 100% minus the share of the interval its idle task ran.
+ * FreeRTOS does not record which core an unpinned task ran on, so the part
+ * of a core's usage not explained by the tasks pinned to it is attributed to
+ * unpinned tasks. Must run after the per-task histories are updated.
+ *
  * @param num_returned Number of tasks returned by uxTaskGetSystemState.
  * @param delta_total Total runtime delta.
- * @param core_usage_0 Output: CPU usage for core 0.
- * @param core_usage_1 Output: CPU usage for core 1.
- * @param overall_usage Output: Overall CPU usage.
+ * @param core_usage Output: CPU usage per core (SYSMON_CORE_COUNT entries).
+ * @param core_unpinned Output: CPU usage per core attributed to unpinned tasks.
+ * @param overall_usage Output: Overall CPU usage (mean of all cores).
  */
 static void _calculate_cpu_metrics(UBaseType_t num_returned, uint32_t delta_total,
-                                    float *core_usage_0, float *core_usage_1, float *overall_usage)
+                                    float *core_usage, float *core_unpinned, float *overall_usage)
 {
-    TaskHandle_t idle_handle_0 = xTaskGetIdleTaskHandleForCore(0);
-    TaskHandle_t idle_handle_1 = xTaskGetIdleTaskHandleForCore(1);
-    
-    uint32_t idle_ticks_0 = 0;
-    uint32_t idle_ticks_1 = 0;
+    uint32_t idle_ticks[SYSMON_CORE_COUNT] = { 0 };
+    float pinned_usage[SYSMON_CORE_COUNT] = { 0 };
     for (UBaseType_t i = 0; i < num_returned; i++)
     {
         TaskStatus_t *t = &self.task_status[i];
-        if (t->xHandle == idle_handle_0)
+        bool is_idle = false;
+        for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+        {
+            if (t->xHandle == self.idle_task_handles[core])
+            {
+                idle_ticks[core] = t->ulRunTimeCounter;
+                is_idle = true;
+            }
+        }
+
+        int slot = self.task_slot_hints[i];
+        if (!is_idle && slot >= 0 && t->xCoreID >= 0 && t->xCoreID < SYSMON_CORE_COUNT)
         {
-            idle_ticks_0 = t->ulRunTimeCounter;
+            pinned_usage[t->xCoreID] += SYSMON_TASK_RING(self.history, usage_percent, slot)[self.series_write_index];
         }
-        else if (t->xHandle == idle_handle_1)
+    }
+
+    float usage_sum = 0.0f;
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+        // The core's IRQ row is pinned to it
+        pinned_usage[core] += SYSMON_CORE_RING(self.history, cpu_core_irq_percent, core)[self.series_write_index];
+#endif
+        uint32_t delta_idle = (idle_ticks[core] >= self.prev_idle_run_time[core])
+                              ? (idle_ticks[core] - self.prev_idle_run_time[core]) : 0;
+        self.prev_idle_run_time[core] = idle_ticks[core];
+
+        core_usage[core] = 0.0f;
+        core_unpinned[core] = 0.0f;
+        if (delta_total > 0U)
         {
-            idle_ticks_1 = t->ulRunTimeCounter;
+            float idle_percent = ((float)delta_idle / (float)delta_total) * 100.0f;
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+            // Interrupts taken while idle were charged to the idle task but kept the core busy
+            idle_percent -= self.irq_idle_percent[core];
+#endif
+            core_usage[core] = 100.0f - idle_percent;
+
+            // Clamp to valid range
+            if (core_usage[core] < 0.0f) { core_usage[core] = 0.0f; }
+            if (core_usage[core] > 100.0f) { core_usage[core] = 100.0f; }
+
+            core_unpinned[core] = core_usage[core] - pinned_usage[core];
+            if (core_unpinned[core] < 0.0f) { core_unpinned[core] = 0.0f; }
         }
+        usage_sum += core_usage[core];
     }
-    
-    // Maintain state between iterations
-    static uint32_t prev_idle_ticks_0 = 0;
-    static uint32_t prev_idle_ticks_1 = 0;
-    uint32_t delta_idle_0 = (idle_ticks_0 >= prev_idle_ticks_0) ? (idle_ticks_0 - prev_idle_ticks_0) : 0;
-    uint32_t delta_idle_1 = (idle_ticks_1 >= prev_idle_ticks_1) ? (idle_ticks_1 - prev_idle_ticks_1) : 0;
-    prev_idle_ticks_0 = idle_ticks_0;
-    prev_idle_ticks_1 = idle_ticks_1;
-    
-    *core_usage_0 = 0.0f;
-    *core_usage_1 = 0.0f;
-    if (delta_total > 0U)
-    {
-        float idle_percent_0 = ((float)delta_idle_0 / (float)delta_total) * 100.0f;
-        float idle_percent_1 = ((float)delta_idle_1 / (float)delta_total) * 100.0f;
-        *core_usage_0 = 100.0f - idle_percent_0;
-        *core_usage_1 = 100.0f - idle_percent_1;
-        
-        // Clamp to valid range
-        if (*core_usage_0 < 0.0f) { *core_usage_0 = 0.0f; }
-        if (*core_usage_0 > 100.0f) { *core_usage_0 = 100.0f; }
-        if (*core_usage_1 < 0.0f) { *core_usage_1 = 0.0f; }
-        if (*core_usage_1 > 100.0f) { *core_usage_1 = 100.0f; }
-    }
-    *overall_usage = (*core_usage_0 + *core_usage_1) * 0.5f;
+    *overall_usage = usage_sum / (float)SYSMON_CORE_COUNT;
 }
 
 /**
@@ -396,11 +1193,28 @@ static void _collect_memory_stats(uint32_t *dram_free, uint32_t *dram_min_free,
 }
 
 /**
- * @brief Store sampled metrics in cyclic ringbuffer.
+ * @brief Advance the ring write head and the sample sequence number past the slot just written.
+ */
+static void _advance_series(void)
+{
+    self.series_write_index = (self.series_write_index + 1) % self.history->slots;
+    if (self.series_available < self.sample_count)
+    {
+        self.series_available++;
+    }
+    self.sample_sequence++;
+
+    // Readers see the new sequence before any write to the next entry (see _snapshot_sample_intact())
+    __atomic_store_n(&self.history->sequence, self.sample_sequence, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Store sampled metrics in the cyclic history rings and advance the sample sequence number.
  * 
  * @param overall_usage Overall CPU usage.
- * @param core_usage_0 CPU usage for core 0.
- * @param core_usage_1 CPU usage for core 1.
+ * @param core_usage CPU usage per core (SYSMON_CORE_COUNT entries).
+ * @param core_unpinned CPU usage per core attributed to unpinned tasks.
  * @param dram_free DRAM free bytes.
  * @param dram_min_free DRAM minimum free bytes.
  * @param dram_largest DRAM largest free block.
@@ -410,37 +1224,519 @@ static void _collect_memory_stats(uint32_t *dram_free, uint32_t *dram_min_free,
  * @param psram_total PSRAM total bytes.
  * @param psram_used_percent PSRAM used percentage.
  */
-static void _update_series_buffers(float overall_usage, float core_usage_0, float core_usage_1,
+static void _update_series_buffers(float overall_usage, const float *core_usage, const float *core_unpinned,
                                    uint32_t dram_free, uint32_t dram_min_free, uint32_t dram_largest,
                                    uint32_t dram_total, float dram_used_percent,
                                    uint32_t psram_free, uint32_t psram_total, float psram_used_percent)
 {
+    SysMonHistoryStore *history = self.history;
     int write_index = self.series_write_index;
-    self.cpu_overall_percent[write_index] = overall_usage;
-    self.cpu_core_percent[0][write_index] = core_usage_0;
-    self.cpu_core_percent[1][write_index] = core_usage_1;
-    self.dram_free[write_index] = dram_free;
-    self.dram_min_free[write_index] = dram_min_free;
-    self.dram_largest_block[write_index] = dram_largest;
-    self.dram_total[write_index] = dram_total;
-    self.dram_used_percent[write_index] = dram_used_percent;
-    self.psram_free[write_index] = psram_free;
-    self.psram_total[write_index] = psram_total;
-    self.psram_used_percent[write_index] = psram_used_percent;
-    self.series_write_index = (write_index + 1) % CONFIG_SYSMON_SAMPLE_COUNT;
+    history->cpu_overall_percent[write_index] = overall_usage;
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        SYSMON_CORE_RING(history, cpu_core_percent, core)[write_index] = core_usage[core];
+        SYSMON_CORE_RING(history, cpu_core_unpinned_percent, core)[write_index] = core_unpinned[core];
+    }
+    history->dram_free[write_index] = dram_free;
+    history->dram_min_free[write_index] = dram_min_free;
+    history->dram_largest_block[write_index] = dram_largest;
+    history->dram_total[write_index] = dram_total;
+    history->dram_used_percent[write_index] = dram_used_percent;
+    history->psram_free[write_index] = psram_free;
+    history->psram_total[write_index] = psram_total;
+    history->psram_used_percent[write_index] = psram_used_percent;
+    _advance_series();
+}
+
+/**
+ * @brief Record the timing of a sample that is about to be taken.
+ *
+ * @param wake_us esp_timer time the sampler woke for this sample.
+ */
+static void _record_sample_timing(int64_t wake_us)
+{
+    SysMonSelfMetrics *metrics = &self.self_metrics;
+
+    if (metrics->sample_time_us != 0)
+    {
+        metrics->period_us = (uint32_t)(wake_us - metrics->sample_time_us);
+        metrics->jitter_us = (int32_t)metrics->period_us - (int32_t)(self.sample_interval_ms * 1000 * metrics->span);
+        uint32_t jitter_abs = (uint32_t)((metrics->jitter_us < 0) ? -metrics->jitter_us : metrics->jitter_us);
+        if (jitter_abs > metrics->jitter_max_us)
+        {
+            metrics->jitter_max_us = jitter_abs;
+        }
+    }
+    metrics->sample_time_us = wake_us;
+
+    // The tick-based schedule can wake slightly before the microsecond schedule
+    int64_t latency_us = wake_us - self.schedule_us;
+    metrics->latency_us = (latency_us > 0) ? (uint32_t)latency_us : 0;
+    if (metrics->latency_us > metrics->latency_max_us)
+    {
+        metrics->latency_max_us = metrics->latency_us;
+    }
+}
+
+/**
+ * @brief Record the sampler task's own CPU usage from the newest sample.
+ *
+ * Must run after the per-task histories are updated and before the series
+ * write index advances.
+ *
+ * @param num_returned Number of entries in self.task_status.
+ */
+static void _record_sampler_cpu(UBaseType_t num_returned)
+{
+    for (UBaseType_t i = 0; i < num_returned; i++)
+    {
+        if (self.task_status[i].xHandle == self.monitor_task_handle)
+        {
+            int slot = self.task_slot_hints[i];
+            if (slot >= 0)
+            {
+                self.self_metrics.cpu_percent = SYSMON_TASK_RING(self.history, usage_percent, slot)[self.series_write_index];
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Record the processing time of a completed loop iteration.
+ *
+ * @param wake_us esp_timer time the iteration started.
+ */
+static void _record_sample_work(int64_t wake_us)
+{
+    SysMonSelfMetrics *metrics = &self.self_metrics;
+    uint32_t work_us = (uint32_t)(esp_timer_get_time() - wake_us);
+
+    metrics->work_us = work_us;
+    metrics->work_avg_us = (metrics->work_avg_us == 0) ? work_us
+                           : metrics->work_avg_us - (metrics->work_avg_us >> 4) + (work_us >> 4);
+    if (work_us > metrics->work_max_us)
+    {
+        metrics->work_max_us = work_us;
+    }
+}
+
+#ifdef CONFIG_SYSMON_ADAPTIVE_SAMPLING
+/**
+ * @brief Repeat the newest sample in the next ring slot and commit it.
+ *
+ * Fills the intervals a backed-off wake slept through, so ring slots stay one
+ * sampling interval apart and the rollups, heap profile, recorder and flash
+ * log see one sample per interval. The newest values already are means over
+ * the whole span (per-interval counts are spread evenly), so repeating them
+ * keeps sums and averages right. The caller publishes a snapshot before each
+ * call, so the slot written is always the spare one outside the published window.
+ */
+static void _hold_sample(void)
+{
+    SysMonHistoryStore *history = self.history;
+    int from = (self.series_write_index - 1 + history->slots) % history->slots;
+    int to = self.series_write_index;
+
+    history->cpu_overall_percent[to] = history->cpu_overall_percent[from];
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        SYSMON_CORE_RING(history, cpu_core_percent, core)[to] = SYSMON_CORE_RING(history, cpu_core_percent, core)[from];
+        SYSMON_CORE_RING(history, cpu_core_unpinned_percent, core)[to] =
+            SYSMON_CORE_RING(history, cpu_core_unpinned_percent, core)[from];
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+        SYSMON_CORE_RING(history, cpu_core_irq_percent, core)[to] = SYSMON_CORE_RING(history, cpu_core_irq_percent, core)[from];
+#endif
+    }
+    history->dram_free[to]          = history->dram_free[from];
+    history->dram_min_free[to]      = history->dram_min_free[from];
+    history->dram_largest_block[to] = history->dram_largest_block[from];
+    history->dram_total[to]         = history->dram_total[from];
+    history->dram_used_percent[to]  = history->dram_used_percent[from];
+    history->psram_free[to]         = history->psram_free[from];
+    history->psram_total[to]        = history->psram_total[from];
+    history->psram_used_percent[to] = history->psram_used_percent[from];
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+    for (int i = 0; i < self.custom_metric_count; i++)
+    {
+        SYSMON_CUSTOM_RING(history, i)[to] = SYSMON_CUSTOM_RING(history, i)[from];
+    }
+#endif
+    for (int j = 0; j < self.task_capacity; j++)
+    {
+        SYSMON_TASK_RING(history, usage_percent, j)[to]       = SYSMON_TASK_RING(history, usage_percent, j)[from];
+        SYSMON_TASK_RING(history, stack_usage_bytes, j)[to]   = SYSMON_TASK_RING(history, stack_usage_bytes, j)[from];
+        SYSMON_TASK_RING(history, stack_usage_percent, j)[to] = SYSMON_TASK_RING(history, stack_usage_percent, j)[from];
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+        SYSMON_TASK_RING(history, heap_alloc_bytes, j)[to]    = SYSMON_TASK_RING(history, heap_alloc_bytes, j)[from];
+#endif
+    }
+    _advance_series();
+    self.slot_time_us += (int64_t)self.sample_interval_ms * 1000;
+
+    _rollup_commit_sample();
+    _heap_profile_commit_sample();
+    _recorder_commit_sample();
+    _flashlog_commit_sample();
+}
+
+/**
+ * @brief Choose how many sampling intervals the sampler sleeps before its next wake.
+ *
+ * Full rate while a client is around (a request since the previous wake or a
+ * push subscriber), after an overall CPU swing of at least
+ * CONFIG_SYSMON_ADAPTIVE_CPU_DELTA_PERCENT, and while DRAM free is, or since
+ * the previous wake dipped, below CONFIG_SYSMON_ADAPTIVE_DRAM_FREE_MIN. Every
+ * CONFIG_SYSMON_ADAPTIVE_QUIET_S seconds without any of these the sleep
+ * doubles, up to CONFIG_SYSMON_ADAPTIVE_MAX_FACTOR intervals.
+ *
+ * @param overall_usage Overall CPU usage of the newest sample.
+ * @param dram_free DRAM free bytes of the newest sample.
+ * @param dram_min_free Lowest DRAM free bytes since boot.
+ * @param now_us esp_timer time of the wake.
+ */
+static void _adaptive_update(float overall_usage, uint32_t dram_free, uint32_t dram_min_free, int64_t now_us)
+{
+    uint32_t factor = self.self_metrics.adaptive_factor;
+    float cpu_delta = overall_usage - self.adaptive_prev_cpu;
+    cpu_delta = (cpu_delta < 0.0f) ? -cpu_delta : cpu_delta;
+    bool new_low = (dram_min_free < self.adaptive_prev_min_free);
+    self.adaptive_prev_cpu      = overall_usage;
+    self.adaptive_prev_min_free = dram_min_free;
+
+    const char *reason = NULL;
+    if (__atomic_exchange_n(&s_client_seen, false, __ATOMIC_RELAXED) || sysmon_push_subscriber_count() > 0)
+    {
+        reason = "client connected";
+    }
+    else if (cpu_delta >= (float)CONFIG_SYSMON_ADAPTIVE_CPU_DELTA_PERCENT)
+    {
+        reason = "CPU usage changed";
+    }
+    else if (dram_free < CONFIG_SYSMON_ADAPTIVE_DRAM_FREE_MIN ||
+             (new_low && dram_min_free < CONFIG_SYSMON_ADAPTIVE_DRAM_FREE_MIN))
+    {
+        reason = "DRAM low";
+    }
+
+    if (reason != NULL)
+    {
+        if (factor > 1)
+        {
+            ESP_LOGI(LOG_TAG, "Sampling at full rate again (%s)", reason);
+        }
+        factor = 1;
+        self.adaptive_quiet_since_us = now_us;
+        // A wake-up requested meanwhile is no longer needed
+        ulTaskNotifyTake(pdTRUE, 0);
+    }
+    else if (factor < CONFIG_SYSMON_ADAPTIVE_MAX_FACTOR &&
+             now_us - self.adaptive_quiet_since_us >= (int64_t)CONFIG_SYSMON_ADAPTIVE_QUIET_S * 1000000)
+    {
+        factor = (factor * 2 < CONFIG_SYSMON_ADAPTIVE_MAX_FACTOR) ? factor * 2 : CONFIG_SYSMON_ADAPTIVE_MAX_FACTOR;
+        self.adaptive_quiet_since_us = now_us;
+        ESP_LOGI(LOG_TAG, "Idle and unwatched, sampling every %" PRIu32 " ms", factor * self.sample_interval_ms);
+    }
+    __atomic_store_n(&self.self_metrics.adaptive_factor, factor, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Sleep through the intervals of a backed-off wait, or until a client shows up.
+ *
+ * Blocks on the task notification sent by _sampling_note_client() for up to
+ * adaptive_factor intervals after last_wake. A client cuts the sleep short at
+ * the end of the interval in progress, so wakes stay on the sampling grid.
+ *
+ * @param last_wake Tick the previous sample was scheduled for.
+ * @param period Sampling interval in ticks.
+ * @return Sampling intervals from last_wake to the next wake.
+ */
+static uint32_t _adaptive_sleep_span(TickType_t last_wake, TickType_t period)
+{
+    uint32_t factor = self.self_metrics.adaptive_factor;
+    if (factor <= 1 || period == 0)
+    {
+        return 1;
+    }
+
+    TickType_t elapsed = xTaskGetTickCount() - last_wake;
+    TickType_t sleep = period * factor;
+    if (elapsed >= sleep || ulTaskNotifyTake(pdTRUE, sleep - elapsed) == 0)
+    {
+        return factor;
+    }
+    elapsed = xTaskGetTickCount() - last_wake;
+    uint32_t span = (uint32_t)(elapsed / period) + 1;
+    return (span < factor) ? span : factor;
+}
+#endif // CONFIG_SYSMON_ADAPTIVE_SAMPLING
+
+/**
+ * @brief Sleep until the next fixed-rate sampling deadline.
+ *
+ * Uses xTaskDelayUntil() so processing time does not stretch the period. If
+ * the deadline has already passed, the overrun is counted and the schedule
+ * restarts from now instead of firing back-to-back samples to catch up.
+ * While adaptive sampling backs off, the deadline is several intervals out
+ * and the intervals covered are recorded in self_metrics.span.
+ *
+ * @param last_wake Tick the previous sample was scheduled for (updated).
+ */
+static void _wait_for_next_sample(TickType_t *last_wake)
+{
+    const TickType_t period = pdMS_TO_TICKS(self.sample_interval_ms);
+    uint32_t span = 1;
+#ifdef CONFIG_SYSMON_ADAPTIVE_SAMPLING
+    span = _adaptive_sleep_span(*last_wake, period);
+#endif
+    self.self_metrics.span = span;
+
+    if (xTaskDelayUntil(last_wake, period * span) == pdFALSE)
+    {
+        self.self_metrics.overruns++;
+        *last_wake = xTaskGetTickCount();
+        self.schedule_us = esp_timer_get_time();
+        return;
+    }
+    self.schedule_us += (int64_t)self.sample_interval_ms * 1000 * span;
+}
+
+// ============================================================================
+// Sampling Configuration
+// ============================================================================
+
+/**
+ * @brief Get the smallest history depth the enabled features work with.
+ *
+ * @return Minimum sample_count.
+ */
+uint32_t sysmon_get_min_sample_count(void)
+{
+    uint32_t minimum = SYSMON_SAMPLE_COUNT_MIN;
+#ifdef CONFIG_SYSMON_ROLLUPS
+    minimum = (CONFIG_SYSMON_ROLLUP_MID_SAMPLES > minimum) ? CONFIG_SYSMON_ROLLUP_MID_SAMPLES : minimum;
+#endif
+#ifdef CONFIG_SYSMON_STACK_ALERTS
+    minimum = (CONFIG_SYSMON_STACK_ALERT_WINDOW > minimum) ? CONFIG_SYSMON_STACK_ALERT_WINDOW : minimum;
+#endif
+#ifdef CONFIG_SYSMON_FLASHLOG
+    minimum = (CONFIG_SYSMON_FLASHLOG_SAMPLES > minimum) ? CONFIG_SYSMON_FLASHLOG_SAMPLES : minimum;
+#endif
+#ifdef CONFIG_SYSMON_EXPORT
+    minimum = (CONFIG_SYSMON_EXPORT_BATCH > minimum) ? CONFIG_SYSMON_EXPORT_BATCH : minimum;
+#endif
+#ifdef CONFIG_SYSMON_ADAPTIVE_SAMPLING
+    // A backed-off wake fills up to this many slots at once
+    minimum = (CONFIG_SYSMON_ADAPTIVE_MAX_FACTOR > minimum) ? CONFIG_SYSMON_ADAPTIVE_MAX_FACTOR : minimum;
+#endif
+    return minimum;
+}
+
+/**
+ * @brief Queue a change of the sampling interval and history depth.
+ *
+ * @param interval_ms Sampling interval (0 = keep the current one).
+ * @param sample_count History window depth (0 = keep the current one).
+ * @return ESP_OK if the change was queued, ESP_ERR_INVALID_ARG if a value is out of range.
+ */
+esp_err_t sysmon_set_sampling(uint32_t interval_ms, uint32_t sample_count)
+{
+    if (interval_ms != 0 &&
+        (interval_ms < SYSMON_SAMPLING_INTERVAL_MIN_MS || interval_ms > SYSMON_SAMPLING_INTERVAL_MAX_MS))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (sample_count != 0 &&
+        (sample_count < sysmon_get_min_sample_count() || sample_count > CONFIG_SYSMON_SAMPLE_COUNT_MAX))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (interval_ms == 0 && sample_count == 0)
+    {
+        return ESP_OK;
+    }
+
+    // Calls before the sampler applies a change add to it
+    portENTER_CRITICAL(&s_sampling_lock);
+    if (interval_ms != 0)
+    {
+        s_requested_interval_ms = interval_ms;
+    }
+    if (sample_count != 0)
+    {
+        s_requested_sample_count = sample_count;
+    }
+    s_sampling_pending = true;
+    portEXIT_CRITICAL(&s_sampling_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Get the sampling interval and history depth in effect.
+ *
+ * @param interval_ms Output: sampling interval (may be NULL).
+ * @param sample_count Output: history window depth (may be NULL).
+ * @return true if a queued change has not been applied yet.
+ */
+bool sysmon_get_sampling(uint32_t *interval_ms, uint32_t *sample_count)
+{
+    portENTER_CRITICAL(&s_sampling_lock);
+    uint32_t active_interval_ms = (self.sample_interval_ms != 0) ? self.sample_interval_ms
+                                                                 : CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS;
+    uint32_t active_sample_count = (self.sample_count != 0) ? (uint32_t)self.sample_count
+                                                            : CONFIG_SYSMON_SAMPLE_COUNT;
+    bool pending = s_sampling_pending;
+    portEXIT_CRITICAL(&s_sampling_lock);
+
+    if (interval_ms != NULL)
+    {
+        *interval_ms = active_interval_ms;
+    }
+    if (sample_count != NULL)
+    {
+        *sample_count = active_sample_count;
+    }
+    return pending;
+}
+
+/**
+ * @brief Check whether fixed-span summaries can use the newest samples.
+ *
+ * @param samples Samples the summary reads from the raw rings (0 = none).
+ * @return true if the configured interval is active and enough samples are available.
+ */
+bool _sampling_at_base_interval(int samples)
+{
+    return self.sample_interval_ms == CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS && self.series_available >= samples;
+}
+
+/**
+ * @brief Report a client request to the sampler.
+ *
+ * Wakes a backed-off sampler at the next interval boundary; it samples at
+ * full rate from then on until the system is quiet again.
+ */
+void _sampling_note_client(void)
+{
+#ifdef CONFIG_SYSMON_ADAPTIVE_SAMPLING
+    __atomic_store_n(&s_client_seen, true, __ATOMIC_RELAXED);
+    TaskHandle_t monitor = self.monitor_task_handle;
+    if (monitor != NULL && __atomic_load_n(&self.self_metrics.adaptive_factor, __ATOMIC_RELAXED) > 1)
+    {
+        xTaskNotifyGive(monitor);
+    }
+#endif
+}
+
+/**
+ * @brief Apply a change queued by sysmon_set_sampling() before the next sample.
+ *
+ * A new depth needs new rings: the store is recreated empty (per-task rollup
+ * buckets are carried over) and the old one is retired like after a capacity
+ * change. If the previous retired store is still pinned, the change waits for
+ * a later sample. Any change restarts the history window.
+ */
+static void _apply_sampling_change(void)
+{
+    portENTER_CRITICAL(&s_sampling_lock);
+    bool pending = s_sampling_pending;
+    uint32_t requested_interval_ms = s_requested_interval_ms;
+    uint32_t requested_sample_count = s_requested_sample_count;
+    portEXIT_CRITICAL(&s_sampling_lock);
+    if (!pending)
+    {
+        return;
+    }
+
+    uint32_t interval_ms = (requested_interval_ms != 0) ? requested_interval_ms : self.sample_interval_ms;
+    int depth = (requested_sample_count != 0) ? (int)requested_sample_count : self.sample_count;
+    bool changed = (interval_ms != self.sample_interval_ms || depth != self.sample_count);
+
+    if (changed && self.history != NULL)
+    {
+        _release_retired_history();
+        if (self.retired_history != NULL)
+        {
+            return;
+        }
+
+        SysMonHistoryStore *new_history = _history_store_create(self.task_capacity, depth);
+        if (new_history == NULL)
+        {
+            ESP_LOGW(LOG_TAG, "No memory for a %d sample history, keeping %d samples at %" PRIu32 " ms",
+                     depth, self.sample_count, self.sample_interval_ms);
+            changed = false;
+        }
+        else
+        {
+#ifdef CONFIG_SYSMON_ROLLUPS
+            for (int j = 0; j < self.task_capacity; j++)
+            {
+                if (self.tasks[j].is_active)
+                {
+                    memcpy(SYSMON_TASK_ROLLUPS(new_history, j),
+                           SYSMON_TASK_ROLLUPS(self.history, j), sizeof(SysMonTaskRollup) * SYSMON_ROLLUP_SLOTS);
+                }
+            }
+#endif
+            memcpy(new_history->task_since, self.history->task_since, sizeof(uint32_t) * self.task_capacity);
+            self.retired_history = self.history;
+            self.history = new_history;
+        }
+    }
+
+    if (changed)
+    {
+        self.sample_interval_ms = interval_ms;
+        self.sample_count       = depth;
+        self.series_write_index = 0;
+        self.series_available   = 0;
+        self.sampling_generation++;
+        for (int j = 0; j < self.task_capacity; j++)
+        {
+            // Stack growth is measured across the window, which starts over
+            self.tasks[j].stack_alert_samples = 0;
+        }
+        // The period across the change is not a jitter sample, and its
+        // measurement fills a single slot of the new window
+        self.self_metrics.sample_time_us = 0;
+        self.self_metrics.span = 1;
+        ESP_LOGI(LOG_TAG, "Sampling every %" PRIu32 " ms, %d sample history", interval_ms, depth);
+    }
+
+    // A different value queued meanwhile stays queued for the next sample
+    portENTER_CRITICAL(&s_sampling_lock);
+    if (s_requested_interval_ms == requested_interval_ms)
+    {
+        s_requested_interval_ms = 0;
+    }
+    if (s_requested_sample_count == requested_sample_count)
+    {
+        s_requested_sample_count = 0;
+    }
+    s_sampling_pending = (s_requested_interval_ms != 0 || s_requested_sample_count != 0);
+    portEXIT_CRITICAL(&s_sampling_lock);
 }
 
 /**
  * @brief FreeRTOS-RTOS task to sample per-task CPU usage and memory stats at fixed intervals.
  *
  * This function is executed as a pinned FreeRTOS task and performs the following loop:
- *   1. Allocates and right-sizes memory to track all active tasks if the count grows.
- *   2. Samples all tasks' runtime counters and global total counters using uxTaskGetSystemState().
+ *   1-2. Samples all tasks' runtime counters and global total counters with a single
+ *      uxTaskGetSystemState() call, growing task storage only when it doesn't fit.
+ *      The steady-state loop performs no heap allocation.
  *   3. Updates or creates per-task usage history entries, calculating deltas and utilization percent.
  *   4. Identifies idle tasks per core, computes per-core idle, and derives CPU workload metrics.
  *   5. Collects DRAM and PSRAM heap statistics for memory diagnostics.
- *   6. Records all observations into cyclic ringbuffers for overview and UI reporting.
- *   7. Sleeps for a configured interval before next sample.
+ *   6. Records all observations into cyclic ringbuffers for overview and UI reporting,
+ *      commits downsampled rollup buckets when a bucket boundary is reached, and
+ *      profiles every heap capability region on the slower heap profile cadence.
+ *   7. Publishes an immutable snapshot for HTTP readers (double-buffered, readers never block the sampler).
+ *   8. Publishes the new sample to WebSocket push subscribers (encoded once for all clients).
+ *   9. Sleeps until the next fixed-rate deadline (xTaskDelayUntil), recording its own
+ *      timing and processing cost as self-metrics. With CONFIG_SYSMON_ADAPTIVE_SAMPLING
+ *      the deadline moves several intervals out while the system is idle and
+ *      unwatched; the next wake then fills every interval slept through.
  * Loop continues until task is deleted by external shutdown.
  *
  * Thread-unsafe: This runs as a single RTOS sampler and should not be invoked directly.
@@ -455,23 +1751,74 @@ static void sysmon_monitor(void *param)
     
     static int log_counter = 0;
     
-    for (;;)
+#ifdef CONFIG_SYSMON_ROLLUPS
+    // Global rollup buckets never resize; per-task buckets live in the history store
+    if (self.series_rollups == NULL)
     {
-        // 1. Ensure task storage capacity
-        if (!_ensure_task_storage_capacity())
+        self.series_rollups = (SysMonSeriesRollup *)_history_calloc(sizeof(SysMonSeriesRollup) * SYSMON_ROLLUP_SLOTS);
+        if (self.series_rollups == NULL)
         {
-            vTaskDelay(pdMS_TO_TICKS(CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS));
-            continue;
+            ESP_LOGW(LOG_TAG, "Failed to allocate history rollups, only raw history is available");
+        }
+    }
+#endif
+    
+#ifdef CONFIG_SYSMON_HEAP_PROFILE
+    if (self.heap_profile == NULL)
+    {
+        self.heap_profile = (SysMonHeapRegionSample *)_history_calloc(
+            sizeof(SysMonHeapRegionSample) * SYSMON_HEAP_REGION_COUNT * SYSMON_HEAP_PROFILE_SLOTS);
+        if (self.heap_profile == NULL)
+        {
+            ESP_LOGW(LOG_TAG, "Failed to allocate heap region profile, /heap stays empty");
         }
+    }
+#endif
+    
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        self.idle_task_handles[core] = xTaskGetIdleTaskHandleForCore(core);
+    }
+    _heap_task_tracking_start();
+    _trace_start();
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        self.irq_slots[core] = -1;
+    }
+#endif
+    _irq_start();
+    
+    TickType_t last_wake = xTaskGetTickCount();
+    self.schedule_us = esp_timer_get_time();
+    self.self_metrics.span = 1;
+    self.self_metrics.adaptive_factor = 1;
+#ifdef CONFIG_SYSMON_ADAPTIVE_SAMPLING
+    self.adaptive_quiet_since_us = self.schedule_us;
+    self.adaptive_prev_min_free  = esp_get_minimum_free_heap_size();
+#endif
+    
+    for (;;)
+    {
+        int64_t wake_us = esp_timer_get_time();
+        _apply_sampling_change();
         
-        // 2. Sample task states
+        // 1-2. Sample task states (grows task storage only when the snapshot doesn't fit)
         UBaseType_t num_returned = 0;
         uint32_t delta_total = 0;
         if (!_sample_task_states(&num_returned, &delta_total))
         {
-            vTaskDelay(pdMS_TO_TICKS(CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS));
+            // A window swapped in by _apply_sampling_change() stays pinned by the
+            // published snapshot until the next publish, and the task storage
+            // cannot grow before it is released
+            if (self.retired_history != NULL)
+            {
+                _publish_snapshot();
+            }
+            _wait_for_next_sample(&last_wake);
             continue;
         }
+        _record_sample_timing(wake_us);
         
         // Debug logging
         if (log_counter++ % 10 == 0)
@@ -479,42 +1826,65 @@ static void sysmon_monitor(void *param)
             ESP_LOGI(LOG_TAG, "Sampling %u tasks", num_returned);
         }
         
-        // Track which tasks were seen
-        bool *tasks_seen = (bool *)calloc(self.task_capacity, sizeof(bool));
-        if (tasks_seen == NULL)
+        // Track which tasks were seen (scratch buffer sized with the task storage)
+        bool *tasks_seen = self.tasks_seen;
+        memset(tasks_seen, 0, sizeof(bool) * self.task_capacity);
+        
+        // 3. Update per-task histories: match by identity first, then claim slots for the rest
+        if (self.task_index_dirty && !_rebuild_task_index())
         {
-            vTaskDelay(pdMS_TO_TICKS(CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS));
+            _wait_for_next_sample(&last_wake);
             continue;
         }
-        
-        // 3. Update per-task histories
         for (UBaseType_t i = 0; i < num_returned; i++)
         {
             TaskStatus_t *t = &self.task_status[i];
-            if (t->pcTaskName == NULL)
+            int idx = (t->pcTaskName != NULL) ? _find_task_slot(i, t) : -1;
+            self.task_slot_hints[i] = (int16_t)idx;
+            if (idx == -1)
+            {
+                continue;
+            }
+            
+            _update_task_history(idx, t, delta_total);
+            tasks_seen[idx] = true;
+        }
+        for (UBaseType_t i = 0; i < num_returned; i++)
+        {
+            TaskStatus_t *t = &self.task_status[i];
+            if (self.task_slot_hints[i] != -1 || t->pcTaskName == NULL)
             {
                 continue;
             }
             
-            int idx = _find_or_create_task_index(t->pcTaskName);
+            int idx = _claim_task_slot(t, tasks_seen);
             if (idx == -1)
             {
-                ESP_LOGW(LOG_TAG, "Task capacity exceeded, cannot track task '%s' (capacity: %d, num_tasks: %d). Will retry next sample.", 
-                         t->pcTaskName, self.task_capacity, uxTaskGetNumberOfTasks());
+                ESP_LOGW(LOG_TAG, "Task capacity exceeded, cannot track task '%s' (capacity: %d, num_tasks: %u). Growing before next sample.", 
+                         t->pcTaskName, self.task_capacity, (unsigned)num_returned);
+                self.task_capacity_short = true;
                 continue;
             }
             
+            self.task_slot_hints[i] = (int16_t)idx;
             _update_task_history(idx, t, delta_total);
             tasks_seen[idx] = true;
         }
         
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+        _update_irq_rows(tasks_seen);
+#endif
+        
         // 4. Process deleted tasks
         _process_deleted_tasks(tasks_seen);
-        free(tasks_seen);
+        _record_sampler_cpu(num_returned);
+        _trace_drain_events();
         
         // 5. Calculate CPU metrics
-        float core_usage_0, core_usage_1, overall_usage;
-        _calculate_cpu_metrics(num_returned, delta_total, &core_usage_0, &core_usage_1, &overall_usage);
+        float core_usage[SYSMON_CORE_COUNT];
+        float core_unpinned[SYSMON_CORE_COUNT];
+        float overall_usage;
+        _calculate_cpu_metrics(num_returned, delta_total, core_usage, core_unpinned, &overall_usage);
         
         // 6. Collect memory statistics
         uint32_t dram_free, dram_min_free, dram_largest, dram_total;
@@ -524,21 +1894,46 @@ static void sysmon_monitor(void *param)
         _collect_memory_stats(&dram_free, &dram_min_free, &dram_largest, &dram_total, &dram_used_percent,
                               &psram_free, &psram_total, &psram_used_percent);
         
-        // 7. Update series buffers
-        _update_series_buffers(overall_usage, core_usage_0, core_usage_1,
+        // 7. Update series buffers (the oldest slot of a multi-interval span comes first)
+        self.slot_time_us = wake_us - (int64_t)(self.self_metrics.span - 1) * self.sample_interval_ms * 1000;
+        _update_series_buffers(overall_usage, core_usage, core_unpinned,
                                dram_free, dram_min_free, dram_largest, dram_total, dram_used_percent,
                                psram_free, psram_total, psram_used_percent);
+        _custom_commit_sample();
+        _rollup_commit_sample();
+        _heap_profile_commit_sample();
+        _recorder_commit_sample();
+        _flashlog_commit_sample();
+#ifdef CONFIG_SYSMON_ADAPTIVE_SAMPLING
+        for (uint32_t k = 1; k < self.self_metrics.span; k++)
+        {
+            // Each held slot is the spare slot of the window published before it
+            _publish_snapshot();
+            _hold_sample();
+        }
+        _adaptive_update(overall_usage, dram_free, dram_min_free, wake_us);
+#endif
+        
+        // 8. Publish the committed sample to readers and reclaim unpinned storage
+        _publish_snapshot();
+        _api_notify_subscribers();
+        _release_retired_history();
+        
+        // 9. Encode once and fan out to WebSocket subscribers
+        sysmon_push_publish();
+        _export_notify();
         
-        // 8. Delay before next sample
-        vTaskDelay(pdMS_TO_TICKS(CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS));
+        // 10. Account this iteration and sleep until the next deadline
+        _record_sample_work(wake_us);
+        _wait_for_next_sample(&last_wake);
     }
 }
 
 /**
  * @brief Deinitialize all sysmon state and monitoring resources.
  *
- * Shuts down HTTP telemetry, stops the sampler task, and releases all
- * dynamically allocated memory. After calling, all state is reset and
+ * Stops the sampler and exporter tasks, shuts down HTTP telemetry, and
+ * releases all dynamically allocated memory. After calling, all state is reset and
  * sysmon monitoring is fully stopped.
  *
  * Safe to call multiple times (idempotent).
@@ -548,21 +1943,72 @@ static void sysmon_monitor(void *param)
  */
 void sysmon_deinit(void)
 {
-    sysmon_http_stop();
-
-    // Terminate task monitor, if running
+    // Terminate task monitor, if running; it publishes to the push channel the HTTP server owns
     if (self.monitor_task_handle != NULL)
     {
         vTaskDelete(self.monitor_task_handle);
         self.monitor_task_handle = NULL;
     }
-    // Free task metric storage buffers
+    // The exporter may still pin a snapshot; wait for it before freeing storage
+    _export_stop();
+
+    // No producer is left, so stopping the server can release the push buffers
+    sysmon_http_stop();
+    _hardware_cache_deinit();
+    _flashlog_deinit();
+    _heap_task_tracking_stop();
+    _trace_stop();
+    _irq_stop();
+    // Free task metric storage buffers (HTTP readers are stopped, nothing is pinned)
     free(self.tasks);
     self.tasks = NULL;
+    heap_caps_free(self.history);
+    self.history = NULL;
+    heap_caps_free(self.retired_history);
+    self.retired_history = NULL;
+    self.series_write_index = 0;
+    self.series_available   = 0;
+    self.sample_interval_ms = 0;
+    self.sample_count       = 0;
+#ifdef CONFIG_SYSMON_ROLLUPS
+    heap_caps_free(self.series_rollups);
+    self.series_rollups = NULL;
+    memset(self.rollup_sequence, 0, sizeof(self.rollup_sequence));
+#endif
+#ifdef CONFIG_SYSMON_HEAP_PROFILE
+    heap_caps_free(self.heap_profile);
+    self.heap_profile = NULL;
+    self.heap_profile_sequence = 0;
+#endif
+#ifdef CONFIG_SYSMON_TRACE
+    self.trace_events  = 0;
+    self.trace_dropped = 0;
+#endif
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+    memset(self.irq_idle_percent, 0, sizeof(self.irq_idle_percent));
+    memset(self.irq_max_us, 0, sizeof(self.irq_max_us));
+#endif
+    for (int i = 0; i < 2; i++)
+    {
+        free(self.snapshots[i].tasks);
+        memset(&self.snapshots[i], 0, sizeof(SysMonSnapshot));
+    }
+    self.published_snapshot = 0;
     free(self.task_status);
     self.task_status          = NULL;
+    free(self.task_slot_hints);
+    self.task_slot_hints      = NULL;
+    free(self.tasks_seen);
+    self.tasks_seen           = NULL;
+    self.task_capacity_short  = false;
+    free(self.task_index);
+    self.task_index           = NULL;
+    self.task_index_size      = 0;
+    self.task_index_dirty     = false;
     self.task_capacity        = 0;
     self.prev_total_run_time  = 0;
+    memset(self.prev_idle_run_time, 0, sizeof(self.prev_idle_run_time));
+    memset(&self.self_metrics, 0, sizeof(self.self_metrics));
     
     // Clean up stack records
     sysmon_stack_cleanup();
@@ -579,15 +2025,28 @@ void sysmon_deinit(void)
  * @note Call only once at system startup or when first enabling the UI/telemetry feature.
  *
  * Step-by-step operation:
+ *  0. Publish an empty history window, so readers never see a snapshot without one.
  *  1. Verify WiFi connectivity (required for HTTP server).
- *  2. Start HTTP API handler for telemetry endpoints.
- *  3. If not already running, create task monitor (CPU+memory) pinned to core 0.
+ *  2. Build the cached '/hardware' document (the only flash scan) and start
+ *     the HTTP API handler for telemetry endpoints.
+ *  3. If not already running, create task monitor (CPU+memory) pinned to core 0,
+ *     then start the push exporter (CONFIG_SYSMON_EXPORT).
  *  4. Report initialization status via log and return result.
+ *
+ * With CONFIG_SYSMON_HEADLESS steps 1 and 2 are skipped: no HTTP server is
+ * started and telemetry leaves the device through the exporter only.
  */
 esp_err_t sysmon_init(void)
 {
+    esp_err_t err = _history_init();
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to allocate the history window");
+        return err;
+    }
+#ifndef CONFIG_SYSMON_HEADLESS
     // 1. Verify WiFi connectivity before starting HTTP server
-    esp_err_t err = _check_wifi_connectivity();
+    err = _check_wifi_connectivity();
     if (err != ESP_OK)
     {
         ESP_LOGE(LOG_TAG, "sysmon initialization failed: WiFi connectivity check failed.");
@@ -595,7 +2054,13 @@ esp_err_t sysmon_init(void)
         return err;
     }
 
-    // 2. Start HTTP endpoint
+    // 2. Build the static hardware document, then start HTTP endpoint
+    if (_hardware_cache_init() != ESP_OK)
+    {
+        // Not fatal: the '/hardware' handler retries the build on first request
+        ESP_LOGW(LOG_TAG, "Failed to build hardware JSON cache");
+    }
+
     err = sysmon_http_start();
     if (err != ESP_OK)
     {
@@ -603,10 +2068,15 @@ esp_err_t sysmon_init(void)
                  esp_err_to_name(err), err);
         return err;
     }
+#endif // !CONFIG_SYSMON_HEADLESS
 
     // 3. Only start monitor if not running (singleton pattern)
     if (self.monitor_task_handle == NULL)
     {
+        // Take over the previous boot's flight recording before the first sample overwrites it
+        _recorder_init();
+        _flashlog_init();
+
         BaseType_t result = xTaskCreatePinnedToCore(
             sysmon_monitor,
             "sysmon_monitor",
@@ -628,6 +2098,16 @@ esp_err_t sysmon_init(void)
 
     }
 
+    err = _export_start();
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to start telemetry exporter: %s", esp_err_to_name(err));
+        return err;
+    }
+
+#ifdef CONFIG_SYSMON_HEADLESS
+    ESP_LOGW(LOG_TAG, "sysmon initialized headless (no HTTP server)");
+#else
     // 4. Successful startup log for diagnostics with actual IP and port
     char ip_buffer[16] = { 0 };
     esp_err_t ip_err = _get_wifi_ip_info(ip_buffer, sizeof(ip_buffer));
@@ -639,6 +2119,7 @@ esp_err_t sysmon_init(void)
     {
         ESP_LOGW(LOG_TAG, "sysmon fully initialized and ready: http://<device-ip>:%d/", CONFIG_SYSMON_HTTPD_SERVER_PORT);
     }
+#endif // CONFIG_SYSMON_HEADLESS
     return ESP_OK;
 }
 
@@ -0,0 +1,426 @@
+/**
+ * @file sysmon_api.c
+ * @brief In-process consumer API: zero-copy snapshot access and sample callbacks.
+ *
+ * This file implements the public sysmon_snapshot_*() functions declared in
+ * sysmon.h. They are thin accessors over the double-buffered snapshot the
+ * sampler publishes for the HTTP handlers: sysmon_get_snapshot() pins it,
+ * accessors read task metadata from the snapshot and series values straight
+ * from the rings, and nothing is serialized, copied or allocated.
+ *
+ * Sample callbacks live in a fixed table guarded by a spinlock. The sampler
+ * copies the table under the lock and runs the copy with the new snapshot
+ * pinned, so registering or removing a callback never waits for a dispatch
+ * except in sysmon_unsubscribe(), which waits for a running dispatch to end.
+ */
+
+// Project-specific includes
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief One registered sample callback.
+ */
+typedef struct
+{
+    sysmon_sample_cb_t callback;
+    void *arg;
+} api_subscriber_t;
+
+static portMUX_TYPE s_api_lock = portMUX_INITIALIZER_UNLOCKED;
+static api_subscriber_t s_subscribers[SYSMON_MAX_SAMPLE_SUBSCRIBERS];
+static volatile bool s_dispatching = false;
+
+// ============================================================================
+// Helper Functions
+// ============================================================================
+
+/**
+ * @brief Number of samples in a snapshot's history window.
+ *
+ * @param snapshot Pinned snapshot.
+ * @return Samples available (0 to the snapshot's sample_count).
+ */
+static uint32_t _snapshot_sample_count(const SysMonSnapshot *snapshot)
+{
+    return (uint32_t)snapshot->available;
+}
+
+/**
+ * @brief Point an iterator at the newest samples of one ring.
+ *
+ * @param snapshot Pinned snapshot.
+ * @param task Task the ring belongs to (NULL for a global series).
+ * @param percent_ring Percentage ring (NULL for a byte series).
+ * @param bytes_ring Byte ring (NULL for a percentage series).
+ * @param count Samples requested (0 = all available).
+ * @param iter Output iterator.
+ */
+static void _series_iter_init(const SysMonSnapshot *snapshot, const SysMonTaskSnapshot *task,
+                              const float *percent_ring, const uint32_t *bytes_ring, uint32_t count,
+                              sysmon_series_iter_t *iter)
+{
+    uint32_t available = _snapshot_sample_count(snapshot);
+    if (count == 0 || count > available)
+    {
+        count = available;
+    }
+
+    // The window ends at the newest sample; start count samples before its end
+    iter->snapshot     = snapshot;
+    iter->task         = task;
+    iter->percent_ring = percent_ring;
+    iter->bytes_ring   = bytes_ring;
+    iter->index        = SYSMON_HISTORY_INDEX(snapshot, snapshot->sample_count - (int)count);
+    iter->slots        = snapshot->history->slots;
+    iter->remaining    = count;
+    iter->sequence     = snapshot->sequence - count + 1;
+    iter->overwritten  = false;
+}
+
+// ============================================================================
+// Snapshot Access
+// ============================================================================
+
+/**
+ * @brief Pin the newest snapshot for reading.
+ *
+ * @return Pinned snapshot, or NULL before the first sample.
+ */
+const sysmon_snapshot_t *sysmon_get_snapshot(void)
+{
+    const SysMonSnapshot *snapshot = _snapshot_acquire();
+    if (snapshot->sequence == 0 || snapshot->history == NULL)
+    {
+        _snapshot_release(snapshot);
+        return NULL;
+    }
+    return snapshot;
+}
+
+/**
+ * @brief Release a snapshot returned by sysmon_get_snapshot().
+ *
+ * @param snapshot Snapshot to release (NULL is ignored).
+ */
+void sysmon_release_snapshot(const sysmon_snapshot_t *snapshot)
+{
+    _snapshot_release(snapshot);
+}
+
+/**
+ * @brief Read the newest values of a snapshot.
+ *
+ * @param snapshot Pinned snapshot.
+ * @param summary Output values.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if an argument is NULL.
+ */
+esp_err_t sysmon_snapshot_summary(const sysmon_snapshot_t *snapshot, sysmon_summary_t *summary)
+{
+    if (snapshot == NULL || summary == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const SysMonSampleValues *newest = &snapshot->newest;
+    summary->sequence           = snapshot->sequence;
+    summary->sample_count       = _snapshot_sample_count(snapshot);
+    summary->interval_ms        = snapshot->interval_ms;
+    summary->cpu_percent        = newest->cpu_overall_percent;
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        summary->core_percent[core] = newest->cpu_core_percent[core];
+    }
+    summary->dram_free          = newest->dram_free;
+    summary->dram_min_free      = newest->dram_min_free;
+    summary->dram_largest_block = newest->dram_largest_block;
+    summary->dram_total         = newest->dram_total;
+    summary->psram_free         = newest->psram_free;
+    summary->psram_total        = newest->psram_total;
+    summary->task_count         = snapshot->task_count;
+    summary->sampler_latency_us = snapshot->self_metrics.latency_us;
+    summary->sampler_work_us    = snapshot->self_metrics.work_us;
+    summary->sampler_cpu_percent = snapshot->self_metrics.cpu_percent;
+    return ESP_OK;
+}
+
+/**
+ * @brief Read the newest values of one task.
+ *
+ * @param snapshot Pinned snapshot.
+ * @param index Task index (0 to task_count - 1).
+ * @param info Output values.
+ * @return true if index is valid.
+ */
+bool sysmon_snapshot_get_task(const sysmon_snapshot_t *snapshot, int index, sysmon_task_info_t *info)
+{
+    if (snapshot == NULL || info == NULL || index < 0 || index >= snapshot->task_count)
+    {
+        return false;
+    }
+
+    const SysMonTaskSnapshot *task = &snapshot->tasks[index];
+    info->name               = task->task_name;
+    info->task_number        = task->task_id;
+    info->priority           = task->current_priority;
+    info->core_id            = task->core_id;
+    info->cpu_percent        = task->usage_percent;
+    info->run_time_ticks     = task->total_run_time_ticks;
+    info->stack_used_bytes   = task->stack_usage_bytes;
+    info->stack_size_bytes   = task->stack_size_bytes;
+    info->stack_used_percent = task->stack_usage_percent;
+    return true;
+}
+
+// ============================================================================
+// Series Iteration
+// ============================================================================
+
+/**
+ * @brief Start iterating the newest samples of a global series, oldest first.
+ *
+ * @param snapshot Pinned snapshot.
+ * @param series Series to read.
+ * @param count Samples to read (0 or more than available = the whole window).
+ * @param iter Output iterator for sysmon_series_next().
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an unknown series or NULL argument.
+ */
+esp_err_t sysmon_snapshot_series(const sysmon_snapshot_t *snapshot, sysmon_series_t series,
+                                 uint32_t count, sysmon_series_iter_t *iter)
+{
+    if (snapshot == NULL || iter == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const SysMonHistoryStore *history = snapshot->history;
+    const float *percent_ring = NULL;
+    const uint32_t *bytes_ring = NULL;
+    switch (series)
+    {
+        case SYSMON_SERIES_CPU:                percent_ring = history->cpu_overall_percent; break;
+        case SYSMON_SERIES_DRAM_FREE:          bytes_ring   = history->dram_free;           break;
+        case SYSMON_SERIES_DRAM_MIN_FREE:      bytes_ring   = history->dram_min_free;       break;
+        case SYSMON_SERIES_DRAM_LARGEST_BLOCK: bytes_ring   = history->dram_largest_block;  break;
+        case SYSMON_SERIES_DRAM_USED_PERCENT:  percent_ring = history->dram_used_percent;   break;
+        case SYSMON_SERIES_PSRAM_FREE:         bytes_ring   = history->psram_free;          break;
+        case SYSMON_SERIES_PSRAM_USED_PERCENT: percent_ring = history->psram_used_percent;  break;
+        default:
+            if (series >= SYSMON_SERIES_CORE_CPU_FIRST && series < SYSMON_SERIES_CORE_CPU(SYSMON_CORE_COUNT))
+            {
+                percent_ring = SYSMON_CORE_RING(history, cpu_core_percent, series - SYSMON_SERIES_CORE_CPU_FIRST);
+                break;
+            }
+            return ESP_ERR_INVALID_ARG;
+    }
+
+    _series_iter_init(snapshot, NULL, percent_ring, bytes_ring, count, iter);
+    return ESP_OK;
+}
+
+/**
+ * @brief Start iterating the newest samples of a task series, oldest first.
+ *
+ * @param snapshot Pinned snapshot.
+ * @param index Task index (as for sysmon_snapshot_get_task()).
+ * @param series Series to read.
+ * @param count Samples to read (0 or more than available = the whole window).
+ * @param iter Output iterator for sysmon_series_next().
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an unknown task or series.
+ */
+esp_err_t sysmon_snapshot_task_series(const sysmon_snapshot_t *snapshot, int index, sysmon_task_series_t series,
+                                      uint32_t count, sysmon_series_iter_t *iter)
+{
+    if (snapshot == NULL || iter == NULL || index < 0 || index >= snapshot->task_count)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int slot = snapshot->tasks[index].slot;
+    const float *percent_ring = NULL;
+    const uint32_t *bytes_ring = NULL;
+    switch (series)
+    {
+        case SYSMON_TASK_SERIES_CPU:
+            percent_ring = SYSMON_TASK_RING(snapshot->history, usage_percent, slot);
+            break;
+        case SYSMON_TASK_SERIES_STACK_BYTES:
+            bytes_ring = SYSMON_TASK_RING(snapshot->history, stack_usage_bytes, slot);
+            break;
+        case SYSMON_TASK_SERIES_STACK_PERCENT:
+            percent_ring = SYSMON_TASK_RING(snapshot->history, stack_usage_percent, slot);
+            break;
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+        case SYSMON_TASK_SERIES_HEAP_ALLOC:
+            bytes_ring = SYSMON_TASK_RING(snapshot->history, heap_alloc_bytes, slot);
+            break;
+#endif
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+
+    _series_iter_init(snapshot, &snapshot->tasks[index], percent_ring, bytes_ring, count, iter);
+    return ESP_OK;
+}
+
+/**
+ * @brief Get the next sample of a series.
+ *
+ * @param iter Iterator from sysmon_snapshot_series() or sysmon_snapshot_task_series().
+ * @param sample Output sample.
+ * @return true if a sample was produced, false at the end of the series or once
+ *         the sampler has overwritten the next sample (see sysmon_series_overwritten()).
+ */
+bool sysmon_series_next(sysmon_series_iter_t *iter, sysmon_sample_t *sample)
+{
+    if (iter == NULL || sample == NULL || iter->remaining == 0)
+    {
+        return false;
+    }
+
+    // Read first, then check that the sampler had not reused the entry meanwhile
+    float percent = (iter->percent_ring != NULL) ? iter->percent_ring[iter->index] : 0.0f;
+    uint32_t bytes = (iter->bytes_ring != NULL) ? iter->bytes_ring[iter->index] : 0;
+    if (!_snapshot_sample_intact(iter->snapshot, iter->task, iter->sequence))
+    {
+        iter->overwritten = true;
+        iter->remaining = 0;
+        return false;
+    }
+
+    sample->sequence = iter->sequence;
+    sample->percent  = percent;
+    sample->bytes    = bytes;
+
+    iter->index = (iter->index + 1) % iter->slots;
+    iter->sequence++;
+    iter->remaining--;
+    return true;
+}
+
+/**
+ * @brief Tell whether a series ended early because the sampler overwrote it.
+ *
+ * @param iter Iterator sysmon_series_next() returned false for.
+ * @return true if the remaining samples were overwritten while the snapshot was pinned.
+ */
+bool sysmon_series_overwritten(const sysmon_series_iter_t *iter)
+{
+    return (iter != NULL) && iter->overwritten;
+}
+
+// ============================================================================
+// Sample Callbacks
+// ============================================================================
+
+/**
+ * @brief Register a callback run after every committed sample.
+ *
+ * @param callback Callback.
+ * @param arg User argument passed to the callback.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if callback is NULL,
+ *         ESP_ERR_NO_MEM if SYSMON_MAX_SAMPLE_SUBSCRIBERS callbacks are registered.
+ */
+esp_err_t sysmon_subscribe(sysmon_sample_cb_t callback, void *arg)
+{
+    if (callback == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = ESP_ERR_NO_MEM;
+    portENTER_CRITICAL(&s_api_lock);
+    for (int i = 0; i < SYSMON_MAX_SAMPLE_SUBSCRIBERS; i++)
+    {
+        if (s_subscribers[i].callback == NULL)
+        {
+            s_subscribers[i].callback = callback;
+            s_subscribers[i].arg      = arg;
+            err = ESP_OK;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_api_lock);
+    return err;
+}
+
+/**
+ * @brief Remove a callback registered with sysmon_subscribe().
+ *
+ * @param callback Callback.
+ * @param arg User argument it was registered with.
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if it was not registered.
+ */
+esp_err_t sysmon_unsubscribe(sysmon_sample_cb_t callback, void *arg)
+{
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+    portENTER_CRITICAL(&s_api_lock);
+    for (int i = 0; i < SYSMON_MAX_SAMPLE_SUBSCRIBERS; i++)
+    {
+        if (s_subscribers[i].callback == callback && s_subscribers[i].arg == arg)
+        {
+            s_subscribers[i].callback = NULL;
+            s_subscribers[i].arg      = NULL;
+            err = ESP_OK;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_api_lock);
+
+    // A dispatch may still be running a copy of the entry; wait it out unless the sampler is gone
+    while (err == ESP_OK && s_dispatching && self.monitor_task_handle != NULL &&
+           xTaskGetCurrentTaskHandle() != self.monitor_task_handle)
+    {
+        vTaskDelay(1);
+    }
+    return err;
+}
+
+/**
+ * @brief Run the sample callbacks on the snapshot just published.
+ *
+ * Does nothing if no callback is registered or publishing was skipped for the
+ * newest sample (a reader still pinned the other buffer).
+ */
+void _api_notify_subscribers(void)
+{
+    api_subscriber_t subscribers[SYSMON_MAX_SAMPLE_SUBSCRIBERS];
+    int count = 0;
+    portENTER_CRITICAL(&s_api_lock);
+    for (int i = 0; i < SYSMON_MAX_SAMPLE_SUBSCRIBERS; i++)
+    {
+        if (s_subscribers[i].callback != NULL)
+        {
+            subscribers[count++] = s_subscribers[i];
+        }
+    }
+    s_dispatching = (count > 0);
+    portEXIT_CRITICAL(&s_api_lock);
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    const SysMonSnapshot *snapshot = _snapshot_acquire();
+    if (snapshot->sequence == self.sample_sequence && snapshot->history != NULL)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            subscribers[i].callback(snapshot, subscribers[i].arg);
+        }
+    }
+    _snapshot_release(snapshot);
+
+    s_dispatching = false;
+}
@@ -0,0 +1,343 @@
+/**
+ * @file sysmon_binary.c
+ * @brief Compact binary encoders for sysmon HTTP endpoints.
+ *
+ * This file implements the packed little-endian encoders for '/telemetry.bin'
+ * and '/history.bin'. Values are written straight from the pinned snapshot and
+ * the ring buffers it refers to through the chunked stream writer, so no cJSON tree
+ * or decimal formatting is involved. See sysmon_binary.h for the layout.
+ */
+
+// Project-specific includes
+#include "sysmon_binary.h"
+#include "sysmon.h"
+#include "sysmon_custom.h"
+#include "sysmon_query.h"
+#include "sysmon_stream.h"
+#include "sysmon_utils.h"
+
+// ESP-IDF includes
+#include "freertos/FreeRTOS.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Number of per-core CPU series carried in SysMonState
+#define BINARY_CORE_COUNT ((uint8_t)SYSMON_CORE_COUNT)
+
+// ============================================================================
+// Internal Helper Functions (Little-Endian Writers)
+// ============================================================================
+
+static void _put_u8(sysmon_stream_t *stream, uint8_t value)
+{
+    _stream_write(stream, (const char *)&value, 1);
+}
+
+static void _put_u16(sysmon_stream_t *stream, uint16_t value)
+{
+    uint8_t bytes[2] = { (uint8_t)(value & 0xFF), (uint8_t)(value >> 8) };
+    _stream_write(stream, (const char *)bytes, sizeof(bytes));
+}
+
+static void _put_u32(sysmon_stream_t *stream, uint32_t value)
+{
+    uint8_t bytes[4] =
+    {
+        (uint8_t)(value & 0xFF),
+        (uint8_t)((value >> 8) & 0xFF),
+        (uint8_t)((value >> 16) & 0xFF),
+        (uint8_t)(value >> 24)
+    };
+    _stream_write(stream, (const char *)bytes, sizeof(bytes));
+}
+
+/**
+ * @brief Write the common versioned header.
+ *
+ * @param stream Stream writer.
+ * @param kind SYSMON_BINARY_KIND_* payload kind.
+ */
+static void _put_header(sysmon_stream_t *stream, uint8_t kind)
+{
+    _stream_write(stream, "SYSM", 4);
+    _put_u8(stream, SYSMON_BINARY_VERSION);
+    _put_u8(stream, kind);
+    _put_u16(stream, 0);
+}
+
+/**
+ * @brief Write a length-prefixed task display name.
+ *
+ * @param stream Stream writer.
+ * @param task_name Raw task name (renamed via _get_task_display_name()).
+ */
+static void _put_task_name(sysmon_stream_t *stream, const char *task_name)
+{
+    const char *display_name = _get_task_display_name(task_name);
+    size_t name_len = strlen(display_name);
+    if (name_len >= SYSMON_BINARY_END_OF_TASKS)
+    {
+        name_len = SYSMON_BINARY_END_OF_TASKS - 1;
+    }
+    _put_u8(stream, (uint8_t)name_len);
+    _stream_write(stream, display_name, name_len);
+}
+
+/**
+ * @brief Write a percentage ring over the snapshot's window, oldest to newest.
+ *
+ * Samples the sampler reused while the snapshot was pinned are written as
+ * SYSMON_BINARY_NO_PERCENT.
+ *
+ * @param stream Stream writer.
+ * @param snapshot Pinned snapshot the ring belongs to.
+ * @param task Task the ring belongs to (NULL for a global series).
+ * @param ring Ring buffer.
+ */
+static void _put_percent_ring(sysmon_stream_t *stream, const SysMonSnapshot *snapshot,
+                              const SysMonTaskSnapshot *task, const float *ring)
+{
+    uint32_t sequence = snapshot->sequence - (uint32_t)snapshot->sample_count + 1;
+    for (int j = 0; j < snapshot->sample_count; j++, sequence++)
+    {
+        float value = ring[SYSMON_HISTORY_INDEX(snapshot, j)];
+        _put_u16(stream, _snapshot_sample_intact(snapshot, task, sequence) ? _quantize_percent(value)
+                                                                           : SYSMON_BINARY_NO_PERCENT);
+    }
+}
+
+/**
+ * @brief Write a 32-bit ring over the snapshot's window, oldest to newest.
+ *
+ * @param stream Stream writer.
+ * @param snapshot Pinned snapshot the ring belongs to.
+ * @param task Task the ring belongs to (NULL for a global series).
+ * @param ring Ring buffer.
+ * @param no_value Value written for samples the sampler reused while the snapshot was pinned.
+ */
+static void _put_u32_ring(sysmon_stream_t *stream, const SysMonSnapshot *snapshot,
+                          const SysMonTaskSnapshot *task, const uint32_t *ring, uint32_t no_value)
+{
+    uint32_t sequence = snapshot->sequence - (uint32_t)snapshot->sample_count + 1;
+    for (int j = 0; j < snapshot->sample_count; j++, sequence++)
+    {
+        uint32_t value = ring[SYSMON_HISTORY_INDEX(snapshot, j)];
+        _put_u32(stream, _snapshot_sample_intact(snapshot, task, sequence) ? value : no_value);
+    }
+}
+
+/**
+ * @brief Write the custom metric section that follows the task records.
+ *
+ * @param stream Stream writer.
+ * @param snapshot Pinned snapshot.
+ * @param history true to write the whole history window, false for the newest value only.
+ */
+static void _put_custom_metrics(sysmon_stream_t *stream, const SysMonSnapshot *snapshot, bool history)
+{
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+    _put_u8(stream, (uint8_t)snapshot->custom_metric_count);
+    for (int i = 0; i < snapshot->custom_metric_count; i++)
+    {
+        sysmon_metric_type_t type = SYSMON_METRIC_GAUGE;
+        const char *name = _custom_get_metric(i, &type);
+        size_t name_len = (name != NULL) ? strlen(name) : 0;
+        _put_u8(stream, (uint8_t)name_len);
+        _stream_write(stream, name, name_len);
+        _put_u8(stream, (uint8_t)type);
+
+        if (!history)
+        {
+            _put_u32(stream, (uint32_t)snapshot->newest.custom_metric_values[i]);
+            continue;
+        }
+        _put_u32_ring(stream, snapshot, NULL, (const uint32_t *)SYSMON_CUSTOM_RING(snapshot->history, i),
+                      SYSMON_BINARY_NO_I32);
+    }
+#else
+    _put_u8(stream, 0);
+#endif
+}
+
+// ============================================================================
+// Public API Functions (Encoders and Endpoint Handlers)
+// ============================================================================
+
+/**
+ * @brief Encode the packed binary telemetry snapshot into a stream.
+ *
+ * Shared by the '/telemetry.bin' route and the WebSocket push channel so both
+ * carry the identical payload. The stream is not terminated.
+ *
+ * @param stream Initialized stream writer.
+ */
+void _encode_telemetry_binary(sysmon_stream_t *stream)
+{
+    const SysMonSnapshot *snapshot = _snapshot_acquire();
+    const SysMonSampleValues *newest = &snapshot->newest;
+
+    int8_t rssi = 0;
+    bool rssi_valid = (_get_wifi_rssi(&rssi) == ESP_OK);
+
+    _put_header(stream, SYSMON_BINARY_KIND_TELEMETRY);
+    _put_u8(stream, BINARY_CORE_COUNT);
+    _put_u8(stream, (self.psram_seen ? 0x01 : 0x00) | (rssi_valid ? 0x02 : 0x00));
+    _put_u8(stream, (uint8_t)rssi);
+    _put_u8(stream, (uint8_t)snapshot->sampling_generation);
+
+    // CPU summary
+    _put_u16(stream, _quantize_percent(newest->cpu_overall_percent));
+    for (uint8_t core = 0; core < BINARY_CORE_COUNT; core++)
+    {
+        _put_u16(stream, _quantize_percent(newest->cpu_core_percent[core]));
+    }
+
+    // Memory summary
+    _put_u32(stream, newest->dram_free);
+    _put_u32(stream, newest->dram_largest_block);
+    _put_u32(stream, newest->dram_total);
+    _put_u16(stream, _quantize_percent(newest->dram_used_percent));
+    _put_u32(stream, newest->psram_free);
+    _put_u32(stream, newest->psram_total);
+    _put_u16(stream, _quantize_percent(newest->psram_used_percent));
+
+    // Current task usage
+    for (int i = 0; i < snapshot->task_count; i++)
+    {
+        const SysMonTaskSnapshot *task = &snapshot->tasks[i];
+        uint32_t stack_bytes = task->stack_usage_bytes;
+        float stack_pct = task->stack_usage_percent;
+
+        // Only report stackRemaining if stack & stackPct are nonzero, matching /telemetry
+        uint32_t stack_remaining = 0;
+        if (stack_bytes > 0U && stack_pct > 0.0f)
+        {
+            stack_remaining = task->stack_high_water_mark * sizeof(StackType_t);
+        }
+
+        _put_task_name(stream, task->task_name);
+        _put_u16(stream, _quantize_percent(task->usage_percent));
+        _put_u32(stream, stack_bytes);
+        _put_u16(stream, _quantize_percent(stack_pct));
+        _put_u32(stream, stack_remaining);
+    }
+    _put_u8(stream, SYSMON_BINARY_END_OF_TASKS);
+    _put_custom_metrics(stream, snapshot, false);
+
+    _snapshot_release(snapshot);
+}
+
+/**
+ * @brief Stream the packed binary telemetry snapshot as a chunked response.
+ *
+ * @param request HTTP request to stream the response on.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the writer cannot be allocated,
+ *         or the first chunk send error.
+ */
+esp_err_t _stream_telemetry_binary(httpd_req_t *request)
+{
+    sysmon_stream_t *stream = (sysmon_stream_t *)malloc(sizeof(sysmon_stream_t));
+    if (stream == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    _stream_begin(stream, request);
+    _encode_telemetry_binary(stream);
+
+    esp_err_t result = _stream_end(stream);
+    free(stream);
+    return result;
+}
+
+/**
+ * @brief Stream the packed binary series and task history as a chunked response.
+ *
+ * Task records are limited to the tasks selected by the task query parameters
+ * (see sysmon_query.h).
+ *
+ * @param request HTTP request to stream the response on.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the writer or selection cannot be allocated,
+ *         or the first chunk send error.
+ */
+esp_err_t _stream_history_binary(httpd_req_t *request)
+{
+    SysMonTaskQuery query;
+    const char *query_error = NULL;
+    esp_err_t parse_err = _task_query_parse(request, &query, &query_error);
+    if (parse_err == ESP_ERR_NO_MEM)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    if (parse_err != ESP_OK)
+    {
+        return httpd_resp_send_err(request, HTTPD_400_BAD_REQUEST, query_error);
+    }
+
+    sysmon_stream_t *stream = (sysmon_stream_t *)malloc(sizeof(sysmon_stream_t));
+    if (stream == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    const SysMonSnapshot *snapshot = _snapshot_acquire();
+    SysMonTaskSelection selection;
+    if (_task_query_select(&query, snapshot, &selection) != ESP_OK)
+    {
+        _snapshot_release(snapshot);
+        free(stream);
+        return ESP_ERR_NO_MEM;
+    }
+    _stream_begin(stream, request);
+    const SysMonHistoryStore *history = snapshot->history;
+
+    _put_header(stream, SYSMON_BINARY_KIND_HISTORY);
+    _put_u16(stream, (uint16_t)snapshot->sample_count);
+    _put_u8(stream, BINARY_CORE_COUNT);
+    _put_u8(stream, self.psram_seen ? 0x01 : 0x00);
+    _put_u32(stream, snapshot->newest.dram_total);
+    _put_u32(stream, snapshot->newest.psram_total);
+
+    // Global series, oldest to newest
+    _put_percent_ring(stream, snapshot, NULL, history->cpu_overall_percent);
+    for (uint8_t core = 0; core < BINARY_CORE_COUNT; core++)
+    {
+        _put_percent_ring(stream, snapshot, NULL, SYSMON_CORE_RING(history, cpu_core_percent, core));
+    }
+    _put_u32_ring(stream, snapshot, NULL, history->dram_free, SYSMON_BINARY_NO_U32);
+    _put_u32_ring(stream, snapshot, NULL, history->dram_min_free, SYSMON_BINARY_NO_U32);
+    _put_u32_ring(stream, snapshot, NULL, history->dram_largest_block, SYSMON_BINARY_NO_U32);
+    _put_percent_ring(stream, snapshot, NULL, history->dram_used_percent);
+    _put_u32_ring(stream, snapshot, NULL, history->psram_free, SYSMON_BINARY_NO_U32);
+    _put_percent_ring(stream, snapshot, NULL, history->psram_used_percent);
+
+    // Per-task histories
+    for (int i = 0; i < selection.count; i++)
+    {
+        const SysMonTaskSnapshot *task = &snapshot->tasks[selection.index[i]];
+        bool is_registered = (task->stack_size_bytes > 0U);
+
+        _put_task_name(stream, task->task_name);
+        _put_u8(stream, is_registered ? 0x01 : 0x00);
+        _put_u32(stream, task->stack_size_bytes);
+
+        _put_percent_ring(stream, snapshot, task, SYSMON_TASK_RING(history, usage_percent, task->slot));
+        if (is_registered)
+        {
+            _put_u32_ring(stream, snapshot, task, SYSMON_TASK_RING(history, stack_usage_bytes, task->slot),
+                          SYSMON_BINARY_NO_U32);
+        }
+    }
+    _put_u8(stream, SYSMON_BINARY_END_OF_TASKS);
+    _put_custom_metrics(stream, snapshot, true);
+
+    _task_selection_free(&selection);
+    _snapshot_release(snapshot);
+
+    esp_err_t result = _stream_end(stream);
+    free(stream);
+    return result;
+}
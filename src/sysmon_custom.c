@@ -0,0 +1,226 @@
+/**
+ * @file sysmon_custom.c
+ * @brief Application-defined counters and gauges sampled next to the built-in series.
+ *
+ * This file implements the custom metric registry declared in sysmon_custom.h.
+ * Metrics live in a fixed static table. Registration fills an entry under a
+ * spinlock and then publishes the new entry count with a release store, so
+ * the sampler and the HTTP handlers read names and types without a lock.
+ *
+ * Updates are a single relaxed atomic: counters add to the writing core's own
+ * word (no cache-line ping-pong between cores), gauges write one shared word.
+ * Once per sample the sampler sums the per-core counter words, records the
+ * difference to the previous sum (unsigned arithmetic, so wrap-around is
+ * harmless) in the metric's ring and adds it to the running total. A sample
+ * covering several intervals (adaptive sampling backed off) records the
+ * per-interval share.
+ */
+
+// Project-specific includes
+#include "sysmon_custom.h"
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_custom";
+
+/**
+ * @brief Registry entry of one metric.
+ *
+ * Members:
+ * - name   : Metric name (NUL-terminated, truncated to SYSMON_METRIC_NAME_MAX_LEN).
+ * - type   : Counter or gauge.
+ * - counts : Counter: running sum per core. Gauge: value in counts[0].
+ */
+struct sysmon_metric
+{
+    char name[SYSMON_METRIC_NAME_MAX_LEN + 1];
+    sysmon_metric_type_t type;
+    uint32_t counts[SYSMON_CORE_COUNT];
+};
+
+static portMUX_TYPE s_custom_lock = portMUX_INITIALIZER_UNLOCKED;
+static struct sysmon_metric s_metrics[SYSMON_CUSTOM_METRIC_COUNT];
+static int s_metric_count = 0;
+
+// Sampler state: counter sums at the previous sample
+static uint32_t s_previous_sum[SYSMON_CUSTOM_METRIC_COUNT];
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Register a custom metric, or look up an existing one.
+ *
+ * @param name Metric name (up to SYSMON_METRIC_NAME_MAX_LEN characters are kept).
+ * @param type Counter or gauge.
+ * @return Metric handle, or NULL on failure.
+ */
+sysmon_metric_handle_t sysmon_metric_register(const char *name, sysmon_metric_type_t type)
+{
+    if (name == NULL || name[0] == '\0' || (type != SYSMON_METRIC_COUNTER && type != SYSMON_METRIC_GAUGE))
+    {
+        return NULL;
+    }
+
+    sysmon_metric_handle_t metric = NULL;
+    bool type_conflict = false;
+    portENTER_CRITICAL(&s_custom_lock);
+    for (int i = 0; i < s_metric_count; i++)
+    {
+        if (strncmp(s_metrics[i].name, name, SYSMON_METRIC_NAME_MAX_LEN) == 0)
+        {
+            type_conflict = (s_metrics[i].type != type);
+            metric = type_conflict ? NULL : &s_metrics[i];
+            break;
+        }
+    }
+    if (metric == NULL && !type_conflict && s_metric_count < SYSMON_CUSTOM_METRIC_COUNT)
+    {
+        metric = &s_metrics[s_metric_count];
+        strncpy(metric->name, name, SYSMON_METRIC_NAME_MAX_LEN);
+        metric->name[SYSMON_METRIC_NAME_MAX_LEN] = '\0';
+        metric->type = type;
+        memset(metric->counts, 0, sizeof(metric->counts));
+        // Readers only look at entries below the count, so publish it last
+        __atomic_store_n(&s_metric_count, s_metric_count + 1, __ATOMIC_RELEASE);
+    }
+    portEXIT_CRITICAL(&s_custom_lock);
+
+    if (metric == NULL)
+    {
+        ESP_LOGW(LOG_TAG, "Cannot register metric '%s': %s", name,
+                 type_conflict ? "registered with another type" : "registry full");
+    }
+    return metric;
+}
+
+/**
+ * @brief Add to a counter, or move a gauge up or down.
+ *
+ * @param metric Metric handle (NULL is ignored).
+ * @param delta Amount to add.
+ */
+void IRAM_ATTR sysmon_metric_add(sysmon_metric_handle_t metric, int32_t delta)
+{
+    if (metric == NULL)
+    {
+        return;
+    }
+    int slot = (metric->type == SYSMON_METRIC_COUNTER) ? xPortGetCoreID() : 0;
+    __atomic_fetch_add(&metric->counts[slot], (uint32_t)delta, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Set the value of a gauge.
+ *
+ * @param metric Metric handle (NULL is ignored).
+ * @param value New value.
+ */
+void IRAM_ATTR sysmon_metric_set(sysmon_metric_handle_t metric, int32_t value)
+{
+    if (metric == NULL || metric->type != SYSMON_METRIC_GAUGE)
+    {
+        return;
+    }
+    __atomic_store_n(&metric->counts[0], (uint32_t)value, __ATOMIC_RELAXED);
+}
+
+// ============================================================================
+// Internal API Functions (Sampler and Readers)
+// ============================================================================
+
+/**
+ * @brief Get the name and type of a registered metric.
+ *
+ * @param index Metric index.
+ * @param type Output: metric type (may be NULL).
+ * @return Metric name, or NULL if index is not registered.
+ */
+const char *_custom_get_metric(int index, sysmon_metric_type_t *type)
+{
+    if (index < 0 || index >= __atomic_load_n(&s_metric_count, __ATOMIC_ACQUIRE))
+    {
+        return NULL;
+    }
+    if (type != NULL)
+    {
+        *type = s_metrics[index].type;
+    }
+    return s_metrics[index].name;
+}
+
+/**
+ * @brief Fold the metrics into the newest sample.
+ *
+ * Runs after the series write index has advanced, so the newest sample sits
+ * one slot behind it.
+ */
+void _custom_commit_sample(void)
+{
+    int count = __atomic_load_n(&s_metric_count, __ATOMIC_ACQUIRE);
+    int write_index = (self.series_write_index - 1 + self.history->slots) % self.history->slots;
+
+    for (int i = 0; i < count; i++)
+    {
+        const struct sysmon_metric *metric = &s_metrics[i];
+        int32_t value;
+        if (metric->type == SYSMON_METRIC_COUNTER)
+        {
+            uint32_t sum = 0;
+            for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+            {
+                sum += __atomic_load_n(&metric->counts[core], __ATOMIC_RELAXED);
+            }
+            uint32_t delta = sum - s_previous_sum[i];
+            s_previous_sum[i] = sum;
+            self.custom_metric_totals[i] += delta;
+            // Spread evenly over the intervals this sample covers
+            value = (int32_t)(delta / self.self_metrics.span);
+        }
+        else
+        {
+            value = (int32_t)__atomic_load_n(&metric->counts[0], __ATOMIC_RELAXED);
+        }
+        SYSMON_CUSTOM_RING(self.history, i)[write_index] = value;
+    }
+    self.custom_metric_count = count;
+}
+
+#else // !CONFIG_SYSMON_CUSTOM_METRICS
+
+sysmon_metric_handle_t sysmon_metric_register(const char *name, sysmon_metric_type_t type)
+{
+    return NULL;
+}
+
+void sysmon_metric_add(sysmon_metric_handle_t metric, int32_t delta)
+{
+}
+
+void sysmon_metric_set(sysmon_metric_handle_t metric, int32_t value)
+{
+}
+
+const char *_custom_get_metric(int index, sysmon_metric_type_t *type)
+{
+    return NULL;
+}
+
+void _custom_commit_sample(void)
+{
+}
+
+#endif // CONFIG_SYSMON_CUSTOM_METRICS
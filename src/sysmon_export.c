@@ -0,0 +1,693 @@
+/**
+ * @file sysmon_export.c
+ * @brief Batched push exporter for sending sysmon telemetry to a collector.
+ *
+ * This file implements the exporter task declared in sysmon_export.h. The
+ * sampler only gives the task a notification per sample; all encoding and
+ * sending happens on the exporter task, at a lower priority than the sampler.
+ * The task keeps a cursor (sequence of the newest exported sample) and, once a
+ * batch worth of samples is pending, pins the published snapshot, encodes the
+ * batch straight from the history rings into a static datagram buffer and
+ * hands each full datagram to the transport. Nothing is allocated per batch.
+ *
+ * The UDP socket is opened on the first batch (resolving the collector name
+ * before the snapshot is pinned) and reopened after a send error.
+ */
+
+// Project-specific includes
+#include "sysmon_export.h"
+#include "sysmon.h"
+#include "sysmon_binary.h"
+#include "sysmon_custom.h"
+#include "sysmon_stack.h"
+#include "sysmon_utils.h"
+
+// ESP-IDF includes
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "lwip/netdb.h"
+#include "lwip/sockets.h"
+
+// System includes
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef CONFIG_SYSMON_EXPORT
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_export";
+
+#define EXPORT_STACK_SIZE           3072
+#define EXPORT_PRIORITY             (SYSMON_MONITOR_PRIORITY - 2)
+
+// Bytes of the part 0 series arrays (with custom metrics) and of the largest task record
+#define EXPORT_SERIES_BYTES         (CONFIG_SYSMON_EXPORT_BATCH * (2 + 2 * SYSMON_CORE_COUNT + 12) + 1 + \
+                                     SYSMON_CUSTOM_METRIC_COUNT * (2 + SYSMON_METRIC_NAME_MAX_LEN + 4 * CONFIG_SYSMON_EXPORT_BATCH))
+#define EXPORT_MAX_TASK_RECORD      (1 + 23 + 2 * CONFIG_SYSMON_EXPORT_BATCH + 8)
+
+#if SYSMON_EXPORT_HEADER_SIZE + EXPORT_SERIES_BYTES + EXPORT_MAX_TASK_RECORD > CONFIG_SYSMON_EXPORT_DATAGRAM_SIZE
+#error "CONFIG_SYSMON_EXPORT_DATAGRAM_SIZE is too small for CONFIG_SYSMON_EXPORT_BATCH samples"
+#endif
+
+// Largest stride the u8 header field can carry
+#define EXPORT_STRIDE_MAX           255U
+
+// Byte offsets of the header fields patched after the header is written
+#define EXPORT_OFFSET_FLAGS         21
+
+/**
+ * @brief Samples covered by one batch.
+ *
+ * Members:
+ * - snapshot  : Pinned snapshot the samples are read from.
+ * - first_seq : Sequence of the first sample of the batch.
+ * - entries   : Number of entries per series.
+ * - stride    : Consecutive samples averaged into one entry (1 = raw samples).
+ * - count     : Samples covered (the last entry may cover fewer than stride).
+ */
+typedef struct
+{
+    const SysMonSnapshot *snapshot;
+    uint32_t first_seq;
+    uint32_t entries;
+    uint32_t stride;
+    uint32_t count;
+} export_batch_t;
+
+static TaskHandle_t s_export_task = NULL;
+static SemaphoreHandle_t s_export_done = NULL;
+static volatile bool s_export_stop = false;
+static portMUX_TYPE s_export_lock = portMUX_INITIALIZER_UNLOCKED;
+static sysmon_export_sink_t s_export_sink = NULL;
+static void *s_export_sink_arg = NULL;
+static sysmon_export_stats_t s_export_stats;
+
+// Exporter task state
+static int s_socket = -1;
+static struct sockaddr_in s_collector;
+static uint8_t s_datagram[CONFIG_SYSMON_EXPORT_DATAGRAM_SIZE];
+static size_t s_datagram_len = 0;
+
+// ============================================================================
+// Internal Helper Functions (Datagram Writers)
+// ============================================================================
+
+static void _put_u8(uint8_t value)
+{
+    s_datagram[s_datagram_len++] = value;
+}
+
+static void _put_u16(uint16_t value)
+{
+    _put_u8((uint8_t)(value & 0xFF));
+    _put_u8((uint8_t)(value >> 8));
+}
+
+static void _put_u32(uint32_t value)
+{
+    _put_u16((uint16_t)(value & 0xFFFF));
+    _put_u16((uint16_t)(value >> 16));
+}
+
+/**
+ * @brief Start a datagram with the common and batch headers.
+ *
+ * @param batch Batch being sent.
+ * @param batch_seq Batch sequence number.
+ * @param part Part index within the batch.
+ */
+static void _begin_part(const export_batch_t *batch, uint32_t batch_seq, uint8_t part)
+{
+    s_datagram_len = 0;
+    memcpy(s_datagram, "SYSM", 4);
+    s_datagram_len = 4;
+    _put_u8(SYSMON_BINARY_VERSION);
+    _put_u8(SYSMON_BINARY_KIND_EXPORT);
+    _put_u16(0);
+    _put_u32(batch_seq);
+    _put_u32(batch->first_seq);
+    _put_u16((uint16_t)batch->entries);
+    _put_u8((uint8_t)batch->stride);
+    _put_u8((uint8_t)SYSMON_CORE_COUNT);
+    _put_u8(part);
+    _put_u8((self.psram_seen ? SYSMON_EXPORT_FLAG_PSRAM : 0) |
+            (batch->stride > 1 ? SYSMON_EXPORT_FLAG_DOWNSAMPLED : 0));
+    _put_u8((uint8_t)batch->snapshot->sampling_generation);
+    _put_u8(0);
+    _put_u32(batch->snapshot->interval_ms);
+}
+
+// ============================================================================
+// Internal Helper Functions (Ring Readers)
+// ============================================================================
+
+/**
+ * @brief Get the ring index of a sample of the batch.
+ *
+ * @param batch Batch.
+ * @param seq Sample sequence (within the snapshot's window).
+ * @return Ring index.
+ */
+static int _ring_index(const export_batch_t *batch, uint32_t seq)
+{
+    uint32_t behind = batch->snapshot->sequence - seq;
+    int slots = batch->snapshot->history->slots;
+    return (int)((batch->snapshot->newest_index - (int)behind + slots) % slots);
+}
+
+/**
+ * @brief Get the range of samples one entry covers.
+ *
+ * @param batch Batch.
+ * @param entry Entry index.
+ * @param first Output: first sample sequence.
+ * @param count Output: number of samples.
+ */
+static void _entry_range(const export_batch_t *batch, uint32_t entry, uint32_t *first, uint32_t *count)
+{
+    uint32_t offset = entry * batch->stride;
+    *first = batch->first_seq + offset;
+    *count = (batch->count - offset < batch->stride) ? (batch->count - offset) : batch->stride;
+}
+
+/**
+ * @brief Average a percentage ring over one entry.
+ *
+ * @param batch Batch.
+ * @param ring Ring of percentages.
+ * @param entry Entry index.
+ * @return Mean percentage, quantized to hundredths.
+ */
+static uint16_t _entry_percent(const export_batch_t *batch, const float *ring, uint32_t entry)
+{
+    uint32_t first, count;
+    _entry_range(batch, entry, &first, &count);
+    float sum = 0.0f;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        sum += ring[_ring_index(batch, first + i)];
+    }
+    return _quantize_percent(sum / (float)count);
+}
+
+/**
+ * @brief Take the lowest value of a free-bytes ring over one entry.
+ *
+ * @param batch Batch.
+ * @param ring Ring of byte counts.
+ * @param entry Entry index.
+ * @return Lowest value (the conservative reading for free memory).
+ */
+static uint32_t _entry_min_u32(const export_batch_t *batch, const uint32_t *ring, uint32_t entry)
+{
+    uint32_t first, count;
+    _entry_range(batch, entry, &first, &count);
+    uint32_t lowest = UINT32_MAX;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t value = ring[_ring_index(batch, first + i)];
+        lowest = (value < lowest) ? value : lowest;
+    }
+    return lowest;
+}
+
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+/**
+ * @brief Combine a custom metric ring over one entry.
+ *
+ * @param batch Batch.
+ * @param ring Ring of custom metric values.
+ * @param type Metric type.
+ * @param entry Entry index.
+ * @return Sum of the counter increases, or mean of the gauge values.
+ */
+static int32_t _entry_custom(const export_batch_t *batch, const int32_t *ring, sysmon_metric_type_t type, uint32_t entry)
+{
+    uint32_t first, count;
+    _entry_range(batch, entry, &first, &count);
+    int64_t sum = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        sum += ring[_ring_index(batch, first + i)];
+    }
+    return (type == SYSMON_METRIC_COUNTER) ? (int32_t)sum : (int32_t)(sum / (int64_t)count);
+}
+#endif
+
+// ============================================================================
+// Internal Helper Functions (Transport)
+// ============================================================================
+
+/**
+ * @brief Open the UDP socket to the configured collector if not open yet.
+ *
+ * @return true if the socket is ready.
+ */
+static bool _open_socket(void)
+{
+    if (s_socket >= 0)
+    {
+        return true;
+    }
+
+    char port[8];
+    snprintf(port, sizeof(port), "%d", CONFIG_SYSMON_EXPORT_PORT);
+    const struct addrinfo hints = { .ai_family = AF_INET, .ai_socktype = SOCK_DGRAM };
+    struct addrinfo *result = NULL;
+    if (getaddrinfo(CONFIG_SYSMON_EXPORT_HOST, port, &hints, &result) != 0 || result == NULL)
+    {
+        ESP_LOGW(LOG_TAG, "Cannot resolve collector '%s'", CONFIG_SYSMON_EXPORT_HOST);
+        return false;
+    }
+    memcpy(&s_collector, result->ai_addr, sizeof(s_collector));
+    freeaddrinfo(result);
+
+    s_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    if (s_socket < 0)
+    {
+        ESP_LOGW(LOG_TAG, "Failed to create UDP socket: errno %d", errno);
+        return false;
+    }
+    ESP_LOGI(LOG_TAG, "Exporting to %s:%d over UDP", CONFIG_SYSMON_EXPORT_HOST, CONFIG_SYSMON_EXPORT_PORT);
+    return true;
+}
+
+/**
+ * @brief Close the UDP socket.
+ */
+static void _close_socket(void)
+{
+    if (s_socket >= 0)
+    {
+        close(s_socket);
+        s_socket = -1;
+    }
+}
+
+/**
+ * @brief Hand the current datagram to the transport.
+ *
+ * @return true if the transport accepted it.
+ */
+static bool _send_datagram(void)
+{
+    portENTER_CRITICAL(&s_export_lock);
+    sysmon_export_sink_t sink = s_export_sink;
+    void *arg = s_export_sink_arg;
+    portEXIT_CRITICAL(&s_export_lock);
+
+    bool sent = false;
+    if (sink != NULL)
+    {
+        sent = (sink(s_datagram, s_datagram_len, arg) == ESP_OK);
+    }
+    else if (s_socket >= 0)
+    {
+        ssize_t written = sendto(s_socket, s_datagram, s_datagram_len, MSG_DONTWAIT,
+                                 (const struct sockaddr *)&s_collector, sizeof(s_collector));
+        sent = (written == (ssize_t)s_datagram_len);
+        if (!sent && errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOMEM)
+        {
+            // Not just a full queue: reopen (and re-resolve) on the next batch
+            _close_socket();
+        }
+    }
+
+    portENTER_CRITICAL(&s_export_lock);
+    if (sent)
+    {
+        s_export_stats.datagrams_sent++;
+    }
+    else
+    {
+        s_export_stats.datagrams_dropped++;
+    }
+    portEXIT_CRITICAL(&s_export_lock);
+    return sent;
+}
+
+// ============================================================================
+// Internal Helper Functions (Batching)
+// ============================================================================
+
+/**
+ * @brief Encode and send one batch, split into datagrams at task record boundaries.
+ *
+ * Every datagram is checked before it is handed to the transport: once the
+ * sampler has reused the batch's oldest sample, the rest of the batch is not
+ * sent. Task records whose slot was handed to another task meanwhile are left out.
+ *
+ * @param batch Batch to send (its snapshot is pinned).
+ * @param batch_seq Batch sequence number.
+ * @param overwritten Output: true if the batch was cut short because its samples were reused.
+ * @return true if every datagram was accepted.
+ */
+static bool _send_batch(const export_batch_t *batch, uint32_t batch_seq, bool *overwritten)
+{
+    const SysMonSnapshot *snapshot = batch->snapshot;
+    const SysMonHistoryStore *history = snapshot->history;
+    bool all_sent = true;
+    uint8_t part = 0;
+    _begin_part(batch, batch_seq, part);
+
+    // Global series (part 0 only)
+    for (uint32_t e = 0; e < batch->entries; e++)
+    {
+        _put_u16(_entry_percent(batch, history->cpu_overall_percent, e));
+    }
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        for (uint32_t e = 0; e < batch->entries; e++)
+        {
+            _put_u16(_entry_percent(batch, SYSMON_CORE_RING(history, cpu_core_percent, core), e));
+        }
+    }
+    for (uint32_t e = 0; e < batch->entries; e++)
+    {
+        _put_u32(_entry_min_u32(batch, history->dram_free, e));
+    }
+    for (uint32_t e = 0; e < batch->entries; e++)
+    {
+        _put_u32(_entry_min_u32(batch, history->dram_min_free, e));
+    }
+    for (uint32_t e = 0; e < batch->entries; e++)
+    {
+        _put_u32(_entry_min_u32(batch, history->psram_free, e));
+    }
+
+    // Custom metrics (part 0 only)
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+    _put_u8((uint8_t)snapshot->custom_metric_count);
+    for (int i = 0; i < snapshot->custom_metric_count; i++)
+    {
+        sysmon_metric_type_t type = SYSMON_METRIC_GAUGE;
+        const char *name = _custom_get_metric(i, &type);
+        size_t name_len = (name != NULL) ? strnlen(name, SYSMON_METRIC_NAME_MAX_LEN) : 0;
+        _put_u8((uint8_t)name_len);
+        memcpy(&s_datagram[s_datagram_len], name, name_len);
+        s_datagram_len += name_len;
+        _put_u8((uint8_t)type);
+        for (uint32_t e = 0; e < batch->entries; e++)
+        {
+            _put_u32((uint32_t)_entry_custom(batch, SYSMON_CUSTOM_RING(history, i), type, e));
+        }
+    }
+#else
+    _put_u8(0);
+#endif
+
+    // Task records
+    for (int i = 0; i < snapshot->task_count; i++)
+    {
+        const SysMonTaskSnapshot *task = &snapshot->tasks[i];
+        const char *name = _get_task_display_name(task->task_name);
+        size_t name_len = strnlen(name, 23);
+        size_t record_len = 1 + name_len + 2 * batch->entries + 8;
+        if (s_datagram_len + record_len > sizeof(s_datagram))
+        {
+            if (!_snapshot_sample_intact(snapshot, NULL, batch->first_seq))
+            {
+                *overwritten = true;
+                return false;
+            }
+            all_sent &= _send_datagram();
+            _begin_part(batch, batch_seq, ++part);
+        }
+        size_t record_start = s_datagram_len;
+
+        _put_u8((uint8_t)name_len);
+        memcpy(&s_datagram[s_datagram_len], name, name_len);
+        s_datagram_len += name_len;
+        const float *cpu_ring = SYSMON_TASK_RING(history, usage_percent, task->slot);
+        for (uint32_t e = 0; e < batch->entries; e++)
+        {
+            _put_u16(_entry_percent(batch, cpu_ring, e));
+        }
+        _put_u32(task->stack_usage_bytes);
+        _put_u32(task->stack_size_bytes);
+        if (!_snapshot_sample_intact(snapshot, task, snapshot->sequence))
+        {
+            // The slot now belongs to another task; drop the record
+            s_datagram_len = record_start;
+        }
+    }
+
+    if (!_snapshot_sample_intact(snapshot, NULL, batch->first_seq))
+    {
+        *overwritten = true;
+        return false;
+    }
+    s_datagram[EXPORT_OFFSET_FLAGS] |= SYSMON_EXPORT_FLAG_LAST_PART;
+    all_sent &= _send_datagram();
+    return all_sent;
+}
+
+/**
+ * @brief Send a batch if enough samples are pending, applying the backpressure policy.
+ *
+ * @param cursor In/out: sequence of the newest sample already exported.
+ * @param batch_seq In/out: sequence number of the next batch.
+ */
+static void _export_pending(uint32_t *cursor, uint32_t *batch_seq)
+{
+    // Resolve and open outside the pinned section; DNS may block
+    bool transport_ready;
+    portENTER_CRITICAL(&s_export_lock);
+    transport_ready = (s_export_sink != NULL);
+    portEXIT_CRITICAL(&s_export_lock);
+    if (!transport_ready)
+    {
+        transport_ready = _open_socket();
+    }
+
+    const SysMonSnapshot *snapshot = _snapshot_acquire();
+    uint32_t latest = snapshot->sequence;
+    if (latest < *cursor)
+    {
+        // The sampler restarted; start over with its samples
+        *cursor = 0;
+    }
+
+    // Samples the sampler has reused since the publish are gone as well
+    uint32_t samples_dropped = 0;
+    uint32_t oldest = _snapshot_intact_from(snapshot);
+    if (*cursor + 1 < oldest)
+    {
+        // Fell behind by more than the history window
+        samples_dropped += oldest - (*cursor + 1);
+        *cursor = oldest - 1;
+    }
+
+    uint32_t pending = latest - *cursor;
+    if (pending < CONFIG_SYSMON_EXPORT_BATCH)
+    {
+        _snapshot_release(snapshot);
+        return;
+    }
+
+    export_batch_t batch =
+    {
+        .snapshot  = snapshot,
+        .first_seq = *cursor + 1,
+        .stride    = 1,
+        .count     = CONFIG_SYSMON_EXPORT_BATCH,
+    };
+    if (pending >= 2 * CONFIG_SYSMON_EXPORT_BATCH)
+    {
+        // At least a whole batch behind: the link is slower than the sampler
+#ifdef CONFIG_SYSMON_EXPORT_BACKPRESSURE_DOWNSAMPLE
+        // The stride is a u8 on the wire; samples beyond what it can cover are dropped from the oldest end
+        if (pending > EXPORT_STRIDE_MAX * CONFIG_SYSMON_EXPORT_BATCH)
+        {
+            pending = EXPORT_STRIDE_MAX * CONFIG_SYSMON_EXPORT_BATCH;
+            batch.first_seq = latest - pending + 1;
+            samples_dropped += batch.first_seq - (*cursor + 1);
+        }
+        batch.count  = pending;
+        batch.stride = (pending + CONFIG_SYSMON_EXPORT_BATCH - 1) / CONFIG_SYSMON_EXPORT_BATCH;
+#else
+        batch.first_seq = latest - CONFIG_SYSMON_EXPORT_BATCH + 1;
+        samples_dropped += batch.first_seq - (*cursor + 1);
+#endif
+    }
+    batch.entries = (batch.count + batch.stride - 1) / batch.stride;
+    *cursor = batch.first_seq + batch.count - 1;
+
+    bool sent = false;
+    bool overwritten = false;
+    if (transport_ready)
+    {
+        sent = _send_batch(&batch, *batch_seq, &overwritten);
+    }
+    if (!transport_ready || overwritten)
+    {
+        samples_dropped += batch.count;
+    }
+    _snapshot_release(snapshot);
+
+    portENTER_CRITICAL(&s_export_lock);
+    s_export_stats.samples_dropped += samples_dropped;
+    s_export_stats.last_batch_seq   = *batch_seq;
+    if (sent)
+    {
+        s_export_stats.batches_sent++;
+    }
+    portEXIT_CRITICAL(&s_export_lock);
+    (*batch_seq)++;
+}
+
+/**
+ * @brief Exporter task: waits for sample notifications and sends due batches.
+ *
+ * @param arg Unused.
+ */
+static void _export_task(void *arg)
+{
+    uint32_t cursor = 0;
+    uint32_t batch_seq = 1;
+    while (!s_export_stop)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (s_export_stop)
+        {
+            break;
+        }
+        _export_pending(&cursor, &batch_seq);
+    }
+
+    _close_socket();
+    xSemaphoreGive(s_export_done);
+    vTaskDelete(NULL);
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Replace the built-in UDP transport.
+ *
+ * @param sink Transport function, or NULL to restore UDP.
+ * @param arg User argument passed to the sink.
+ * @return ESP_OK.
+ */
+esp_err_t sysmon_export_set_sink(sysmon_export_sink_t sink, void *arg)
+{
+    portENTER_CRITICAL(&s_export_lock);
+    s_export_sink     = sink;
+    s_export_sink_arg = arg;
+    portEXIT_CRITICAL(&s_export_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Read the exporter counters.
+ *
+ * @param stats Output counters.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if stats is NULL.
+ */
+esp_err_t sysmon_export_get_stats(sysmon_export_stats_t *stats)
+{
+    if (stats == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    portENTER_CRITICAL(&s_export_lock);
+    *stats = s_export_stats;
+    portEXIT_CRITICAL(&s_export_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Start the exporter task (called by sysmon_init() after the sampler started).
+ *
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the task cannot be created.
+ */
+esp_err_t _export_start(void)
+{
+    if (s_export_task != NULL)
+    {
+        return ESP_OK;
+    }
+    if (s_export_done == NULL)
+    {
+        s_export_done = xSemaphoreCreateBinary();
+        if (s_export_done == NULL)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    memset(&s_export_stats, 0, sizeof(s_export_stats));
+    s_export_stop = false;
+    if (xTaskCreate(_export_task, "sysmon_export", EXPORT_STACK_SIZE, NULL, EXPORT_PRIORITY, &s_export_task) != pdPASS)
+    {
+        s_export_task = NULL;
+        ESP_LOGE(LOG_TAG, "Failed to create sysmon_export task");
+        return ESP_ERR_NO_MEM;
+    }
+    sysmon_stack_register(s_export_task, EXPORT_STACK_SIZE);
+    return ESP_OK;
+}
+
+/**
+ * @brief Stop the exporter task and close its socket.
+ *
+ * Waits for the task to finish the batch it is sending, so no snapshot stays
+ * pinned once this returns.
+ */
+void _export_stop(void)
+{
+    if (s_export_task == NULL)
+    {
+        return;
+    }
+    s_export_stop = true;
+    xTaskNotifyGive(s_export_task);
+    xSemaphoreTake(s_export_done, portMAX_DELAY);
+    s_export_task = NULL;
+}
+
+/**
+ * @brief Wake the exporter after a sample was committed.
+ */
+void _export_notify(void)
+{
+    TaskHandle_t task = s_export_task;
+    if (task != NULL)
+    {
+        xTaskNotifyGive(task);
+    }
+}
+
+#else // !CONFIG_SYSMON_EXPORT
+
+esp_err_t sysmon_export_set_sink(sysmon_export_sink_t sink, void *arg)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t sysmon_export_get_stats(sysmon_export_stats_t *stats)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t _export_start(void)
+{
+    return ESP_OK;
+}
+
+void _export_stop(void)
+{
+}
+
+void _export_notify(void)
+{
+}
+
+#endif // CONFIG_SYSMON_EXPORT
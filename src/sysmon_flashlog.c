@@ -0,0 +1,853 @@
+/**
+ * @file sysmon_flashlog.c
+ * @brief Long-term telemetry log in a dedicated flash partition.
+ *
+ * This file implements the flash log declared in sysmon_flashlog.h. The
+ * sampler is the only writer. It keeps the entries of the block being
+ * collected in a static array and encodes them into a static scratch buffer,
+ * so writing allocates nothing. Readers walk the mapped partition with a
+ * cursor that decodes one entry at a time. The cursor's window is captured
+ * once per response, so every field array of a response covers the same
+ * entries even while the sampler appends more.
+ *
+ * Reader and writer share only the position of the sector being filled
+ * (guarded by a spinlock). Erases only ever hit the sector after that one,
+ * which readers exclude, and every block is CRC-checked before it is decoded.
+ */
+
+// Project-specific includes
+#include "sysmon_flashlog.h"
+#include "sysmon.h"
+#include "sysmon_stream.h"
+#include "sysmon_utils.h"
+
+// ESP-IDF includes
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+
+// System includes
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef CONFIG_SYSMON_FLASHLOG
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_flashlog";
+
+#define FLASHLOG_SECTOR_SIZE        4096
+#define FLASHLOG_SECTOR_MAGIC       0x4C465953U     // "SYFL"
+#define FLASHLOG_BLOCK_MAGIC        0xB10C
+#define FLASHLOG_VERSION            1
+#define FLASHLOG_MIN_WALL_TIME      1577836800U     // 2020-01-01: clock has been set
+
+// Entry fields: CPU mean/peak and per-core mean (hundredths of a percent), then memory minima (bytes)
+#define FLASHLOG_FIELD_CPU_AVG      0
+#define FLASHLOG_FIELD_CPU_MAX      1
+#define FLASHLOG_FIELD_CORE_AVG     2
+#define FLASHLOG_FIELD_DRAM_FREE    (2 + SYSMON_CORE_COUNT)
+#define FLASHLOG_FIELD_DRAM_LARGEST (3 + SYSMON_CORE_COUNT)
+#define FLASHLOG_FIELD_PSRAM_FREE   (4 + SYSMON_CORE_COUNT)
+#define FLASHLOG_FIELD_COUNT        (5 + SYSMON_CORE_COUNT)
+// Pseudo fields for the response arrays
+#define FLASHLOG_FIELD_SEQ          (-1)
+#define FLASHLOG_FIELD_TIME         (-2)
+
+// A varint takes at most 5 bytes
+#define FLASHLOG_MAX_PAYLOAD        (CONFIG_SYSMON_FLASHLOG_BLOCK_ENTRIES * FLASHLOG_FIELD_COUNT * 5)
+
+/**
+ * @brief Header at the start of every written sector.
+ *
+ * Members:
+ * - magic       : FLASHLOG_SECTOR_MAGIC.
+ * - sector_seq  : Increases by one for every sector opened; the highest is the newest.
+ * - interval_ms : Time covered by one entry.
+ * - version     : FLASHLOG_VERSION.
+ * - field_count : FLASHLOG_FIELD_COUNT of the writer.
+ * - reserved    : Zero.
+ * - crc         : CRC32 of the fields above.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t sector_seq;
+    uint32_t interval_ms;
+    uint8_t version;
+    uint8_t field_count;
+    uint16_t reserved;
+    uint32_t crc;
+} flashlog_sector_header_t;
+
+/**
+ * @brief Header in front of every block payload.
+ *
+ * Members:
+ * - magic       : FLASHLOG_BLOCK_MAGIC.
+ * - payload_len : Payload bytes following the header.
+ * - entry_count : Entries encoded in the payload.
+ * - field_count : Fields per entry.
+ * - reserved    : Zero.
+ * - first_seq   : Sequence number of the first entry (log-wide, survives reboots).
+ * - unix_time   : Wall-clock time of the first entry in seconds (0 = clock not set).
+ * - crc         : CRC32 of the payload.
+ */
+typedef struct
+{
+    uint16_t magic;
+    uint16_t payload_len;
+    uint8_t entry_count;
+    uint8_t field_count;
+    uint16_t reserved;
+    uint32_t first_seq;
+    uint32_t unix_time;
+    uint32_t crc;
+} flashlog_block_header_t;
+
+/**
+ * @brief Sectors and end position a reader walks.
+ *
+ * Members:
+ * - first_sector : Oldest sector of the window (two after the one being filled).
+ * - sectors      : Sectors in the window.
+ * - end_offset   : Write offset of the last sector when the window was taken.
+ */
+typedef struct
+{
+    int first_sector;
+    int sectors;
+    uint32_t end_offset;
+} flashlog_window_t;
+
+/**
+ * @brief Decoding position within a window.
+ */
+typedef struct
+{
+    const flashlog_window_t *window;
+    int sector;
+    int sectors_left;
+    uint32_t offset;
+    flashlog_block_header_t block;
+    const uint8_t *read;
+    const uint8_t *payload_end;
+    int entry;
+    uint32_t seq;
+    uint32_t time;
+    uint32_t values[FLASHLOG_FIELD_COUNT];
+} flashlog_cursor_t;
+
+static const esp_partition_t *s_partition = NULL;
+static const uint8_t *s_mapped = NULL;
+static esp_partition_mmap_handle_t s_mmap_handle;
+static int s_sector_count = 0;
+static int s_used_sectors = 0;
+
+// Position of the sector being filled, shared with readers
+static portMUX_TYPE s_flashlog_lock = portMUX_INITIALIZER_UNLOCKED;
+static int s_head_sector = 0;
+static uint32_t s_head_offset = FLASHLOG_SECTOR_SIZE;
+
+// Writer state (sampler task only)
+static uint32_t s_sector_seq = 0;
+static uint32_t s_next_entry_seq = 1;
+static uint32_t s_pending[CONFIG_SYSMON_FLASHLOG_BLOCK_ENTRIES][FLASHLOG_FIELD_COUNT];
+static int s_pending_count = 0;
+static uint32_t s_pending_time = 0;
+static uint8_t s_block[sizeof(flashlog_block_header_t) + FLASHLOG_MAX_PAYLOAD];
+
+#if FLASHLOG_MAX_PAYLOAD + 64 > FLASHLOG_SECTOR_SIZE
+#error "CONFIG_SYSMON_FLASHLOG_BLOCK_ENTRIES is too large for one flash sector"
+#endif
+
+// ============================================================================
+// Internal Helper Functions (Encoding)
+// ============================================================================
+
+static uint32_t _crc(const void *data, size_t len)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)data, (uint32_t)len);
+}
+
+static uint32_t _entry_interval_ms(void)
+{
+    return CONFIG_SYSMON_FLASHLOG_SAMPLES * CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS;
+}
+
+/**
+ * @brief Append a zigzag-encoded signed delta as a varint.
+ *
+ * @param out Output buffer (at least 5 bytes free).
+ * @param delta Difference to the previous value.
+ * @return Bytes written.
+ */
+static size_t _put_delta(uint8_t *out, int32_t delta)
+{
+    uint32_t value = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+    size_t len = 0;
+    while (value >= 0x80U)
+    {
+        out[len++] = (uint8_t)(value | 0x80U);
+        value >>= 7;
+    }
+    out[len++] = (uint8_t)value;
+    return len;
+}
+
+/**
+ * @brief Read one zigzag varint delta.
+ *
+ * @param read In/out: read position.
+ * @param end End of the payload.
+ * @param delta Output: decoded difference.
+ * @return true on success, false if the payload ends or the varint is too long.
+ */
+static bool _get_delta(const uint8_t **read, const uint8_t *end, int32_t *delta)
+{
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        if (*read >= end)
+        {
+            return false;
+        }
+        uint8_t byte = *(*read)++;
+        value |= (uint32_t)(byte & 0x7FU) << shift;
+        if ((byte & 0x80U) == 0)
+        {
+            *delta = (int32_t)(value >> 1) ^ -(int32_t)(value & 1U);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// Internal Helper Functions (Flash Layout)
+// ============================================================================
+
+/**
+ * @brief Read and check a sector header.
+ *
+ * @param sector Sector index.
+ * @param header Output header.
+ * @return true if the header is intact (it may still come from another configuration).
+ */
+static bool _read_sector_header(int sector, flashlog_sector_header_t *header)
+{
+    memcpy(header, s_mapped + (size_t)sector * FLASHLOG_SECTOR_SIZE, sizeof(*header));
+    return header->magic == FLASHLOG_SECTOR_MAGIC &&
+           header->crc == _crc(header, offsetof(flashlog_sector_header_t, crc));
+}
+
+/**
+ * @brief Check that a sector holds entries of the current layout.
+ *
+ * @param sector Sector index.
+ * @return true if readers should decode the sector.
+ */
+static bool _sector_readable(int sector)
+{
+    flashlog_sector_header_t header;
+    return _read_sector_header(sector, &header) &&
+           header.version == FLASHLOG_VERSION &&
+           header.field_count == FLASHLOG_FIELD_COUNT &&
+           header.interval_ms == _entry_interval_ms();
+}
+
+/**
+ * @brief Erase the sector after the current one and start filling it.
+ *
+ * @return true on success.
+ */
+static bool _open_next_sector(void)
+{
+    int next = (s_head_sector + 1) % s_sector_count;
+    portENTER_CRITICAL(&s_flashlog_lock);
+    s_head_sector = next;
+    s_head_offset = sizeof(flashlog_sector_header_t);
+    portEXIT_CRITICAL(&s_flashlog_lock);
+
+    esp_err_t err = esp_partition_erase_range(s_partition, (size_t)next * FLASHLOG_SECTOR_SIZE, FLASHLOG_SECTOR_SIZE);
+    if (err == ESP_OK)
+    {
+        flashlog_sector_header_t header =
+        {
+            .magic       = FLASHLOG_SECTOR_MAGIC,
+            .sector_seq  = ++s_sector_seq,
+            .interval_ms = _entry_interval_ms(),
+            .version     = FLASHLOG_VERSION,
+            .field_count = FLASHLOG_FIELD_COUNT,
+        };
+        header.crc = _crc(&header, offsetof(flashlog_sector_header_t, crc));
+        err = esp_partition_write(s_partition, (size_t)next * FLASHLOG_SECTOR_SIZE, &header, sizeof(header));
+    }
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(LOG_TAG, "Failed to open log sector %d: %s", next, esp_err_to_name(err));
+        return false;
+    }
+    s_used_sectors = (s_used_sectors < s_sector_count) ? s_used_sectors + 1 : s_sector_count;
+    return true;
+}
+
+/**
+ * @brief Encode the pending entries into one block and append it.
+ *
+ * The entries are consumed even if the write fails, so a failing flash does
+ * not stall the sampler; their sequence numbers are skipped.
+ */
+static void _write_pending_block(void)
+{
+    if (s_pending_count == 0)
+    {
+        return;
+    }
+
+    uint8_t *payload = s_block + sizeof(flashlog_block_header_t);
+    size_t payload_len = 0;
+    for (int e = 0; e < s_pending_count; e++)
+    {
+        for (int f = 0; f < FLASHLOG_FIELD_COUNT; f++)
+        {
+            uint32_t previous = (e == 0) ? 0U : s_pending[e - 1][f];
+            payload_len += _put_delta(payload + payload_len, (int32_t)(s_pending[e][f] - previous));
+        }
+    }
+
+    flashlog_block_header_t header =
+    {
+        .magic       = FLASHLOG_BLOCK_MAGIC,
+        .payload_len = (uint16_t)payload_len,
+        .entry_count = (uint8_t)s_pending_count,
+        .field_count = FLASHLOG_FIELD_COUNT,
+        .first_seq   = s_next_entry_seq,
+        .unix_time   = s_pending_time,
+        .crc         = _crc(payload, payload_len),
+    };
+    s_next_entry_seq += (uint32_t)s_pending_count;
+    s_pending_count = 0;
+
+    size_t block_len = sizeof(header) + payload_len;
+    if (s_head_offset + block_len > FLASHLOG_SECTOR_SIZE && !_open_next_sector())
+    {
+        return;
+    }
+
+    // Payload first: a block whose header is programmed is complete
+    size_t address = (size_t)s_head_sector * FLASHLOG_SECTOR_SIZE + s_head_offset;
+    esp_err_t err = esp_partition_write(s_partition, address + sizeof(header), payload, payload_len);
+    if (err == ESP_OK)
+    {
+        err = esp_partition_write(s_partition, address, &header, sizeof(header));
+    }
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(LOG_TAG, "Failed to write log block: %s", esp_err_to_name(err));
+    }
+
+    // Skip the space even after a failed write; it may be partially programmed
+    portENTER_CRITICAL(&s_flashlog_lock);
+    s_head_offset += (uint32_t)block_len;
+    portEXIT_CRITICAL(&s_flashlog_lock);
+}
+
+// ============================================================================
+// Internal Helper Functions (Reading)
+// ============================================================================
+
+/**
+ * @brief Capture the readable window: every sector except the one erased next.
+ *
+ * @param window Output window.
+ */
+static void _take_window(flashlog_window_t *window)
+{
+    portENTER_CRITICAL(&s_flashlog_lock);
+    int head = s_head_sector;
+    window->end_offset = s_head_offset;
+    portEXIT_CRITICAL(&s_flashlog_lock);
+    window->first_sector = (head + 2) % s_sector_count;
+    window->sectors = s_sector_count - 1;
+}
+
+/**
+ * @brief Move the cursor to the first readable sector at or after its current one.
+ *
+ * @param cursor Cursor.
+ * @return true if a readable sector was found within the window.
+ */
+static bool _cursor_open_sector(flashlog_cursor_t *cursor)
+{
+    while (cursor->sectors_left > 0)
+    {
+        if (_sector_readable(cursor->sector))
+        {
+            cursor->offset = sizeof(flashlog_sector_header_t);
+            return true;
+        }
+        cursor->sector = (cursor->sector + 1) % s_sector_count;
+        cursor->sectors_left--;
+    }
+    return false;
+}
+
+/**
+ * @brief Start decoding a window from its oldest entry.
+ *
+ * @param cursor Cursor to initialize.
+ * @param window Window taken with _take_window().
+ */
+static void _cursor_begin(flashlog_cursor_t *cursor, const flashlog_window_t *window)
+{
+    memset(cursor, 0, sizeof(*cursor));
+    cursor->window = window;
+    cursor->sector = window->first_sector;
+    cursor->sectors_left = window->sectors;
+    _cursor_open_sector(cursor);
+}
+
+/**
+ * @brief Advance the cursor to the next intact block.
+ *
+ * @param cursor Cursor.
+ * @return true if a block was found, false at the end of the window.
+ */
+static bool _cursor_next_block(flashlog_cursor_t *cursor)
+{
+    while (cursor->sectors_left > 0)
+    {
+        bool last_sector = (cursor->sectors_left == 1);
+        uint32_t limit = last_sector ? cursor->window->end_offset : FLASHLOG_SECTOR_SIZE;
+        if (limit > FLASHLOG_SECTOR_SIZE)
+        {
+            limit = FLASHLOG_SECTOR_SIZE;
+        }
+
+        if (cursor->offset + sizeof(flashlog_block_header_t) <= limit)
+        {
+            const uint8_t *base = s_mapped + (size_t)cursor->sector * FLASHLOG_SECTOR_SIZE + cursor->offset;
+            flashlog_block_header_t header;
+            memcpy(&header, base, sizeof(header));
+            uint32_t block_end = cursor->offset + sizeof(header) + header.payload_len;
+            if (header.magic == FLASHLOG_BLOCK_MAGIC && header.field_count == FLASHLOG_FIELD_COUNT &&
+                block_end <= limit && header.crc == _crc(base + sizeof(header), header.payload_len))
+            {
+                cursor->block = header;
+                cursor->read = base + sizeof(header);
+                cursor->payload_end = cursor->read + header.payload_len;
+                cursor->entry = 0;
+                cursor->offset = block_end;
+                return true;
+            }
+        }
+
+        // End of the written part of this sector (or a torn block): continue with the next sector
+        cursor->sector = (cursor->sector + 1) % s_sector_count;
+        cursor->sectors_left--;
+        if (!_cursor_open_sector(cursor))
+        {
+            return false;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Decode the next entry.
+ *
+ * @param cursor Cursor; on success seq, time and values describe the entry.
+ * @return true if an entry was decoded, false at the end of the window.
+ */
+static bool _cursor_next(flashlog_cursor_t *cursor)
+{
+    for (;;)
+    {
+        if (cursor->entry < cursor->block.entry_count)
+        {
+            bool intact = true;
+            for (int f = 0; f < FLASHLOG_FIELD_COUNT && intact; f++)
+            {
+                int32_t delta;
+                intact = _get_delta(&cursor->read, cursor->payload_end, &delta);
+                cursor->values[f] = ((cursor->entry == 0) ? 0U : cursor->values[f]) + (uint32_t)delta;
+            }
+            if (intact)
+            {
+                uint32_t interval_s = _entry_interval_ms() / 1000U;
+                cursor->seq = cursor->block.first_seq + (uint32_t)cursor->entry;
+                cursor->time = (cursor->block.unix_time != 0) ?
+                               cursor->block.unix_time + (uint32_t)cursor->entry * interval_s : 0U;
+                cursor->entry++;
+                return true;
+            }
+            // Should not happen with a valid CRC; drop the rest of the block
+            cursor->block.entry_count = 0;
+        }
+        if (!_cursor_next_block(cursor))
+        {
+            return false;
+        }
+    }
+}
+
+/**
+ * @brief Stream one field of the selected entries as a JSON array.
+ *
+ * @param stream Stream writer.
+ * @param window Window of the response.
+ * @param skip Entries to skip from the oldest end.
+ * @param field Field index, FLASHLOG_FIELD_SEQ or FLASHLOG_FIELD_TIME.
+ */
+static void _stream_flashlog_field(sysmon_stream_t *stream, const flashlog_window_t *window, uint32_t skip, int field)
+{
+    flashlog_cursor_t cursor;
+    _cursor_begin(&cursor, window);
+    uint32_t index = 0;
+    bool first = true;
+    _stream_puts(stream, "[");
+    while (_cursor_next(&cursor))
+    {
+        if (index++ < skip)
+        {
+            continue;
+        }
+        _stream_puts(stream, first ? "" : ",");
+        first = false;
+
+        if (field == FLASHLOG_FIELD_SEQ)
+        {
+            _stream_printf(stream, "%" PRIu32, cursor.seq);
+        }
+        else if (field == FLASHLOG_FIELD_TIME)
+        {
+            if (cursor.time != 0)
+            {
+                _stream_printf(stream, "%" PRIu32, cursor.time);
+            }
+            else
+            {
+                _stream_puts(stream, "null");
+            }
+        }
+        else if (field < FLASHLOG_FIELD_DRAM_FREE)
+        {
+            _stream_printf(stream, "%g", cursor.values[field] / 100.0);
+        }
+        else
+        {
+            _stream_printf(stream, "%" PRIu32, cursor.values[field]);
+        }
+    }
+    _stream_puts(stream, "]");
+}
+
+// ============================================================================
+// Internal Helper Functions (Sampling)
+// ============================================================================
+
+/**
+ * @brief Summarize the newest CONFIG_SYSMON_FLASHLOG_SAMPLES raw samples into one entry.
+ *
+ * @param fields Output entry fields.
+ */
+static void _summarize_entry(uint32_t *fields)
+{
+    const SysMonHistoryStore *history = self.history;
+    int newest = (self.series_write_index - 1 + history->slots) % history->slots;
+    float cpu_sum = 0.0f;
+    float cpu_max = 0.0f;
+    float core_sum[SYSMON_CORE_COUNT] = { 0 };
+    uint32_t dram_free = UINT32_MAX;
+    uint32_t dram_largest = UINT32_MAX;
+    uint32_t psram_free = UINT32_MAX;
+
+    for (int i = 0; i < CONFIG_SYSMON_FLASHLOG_SAMPLES; i++)
+    {
+        int index = (newest - i + history->slots) % history->slots;
+        float cpu = history->cpu_overall_percent[index];
+        cpu_sum += cpu;
+        cpu_max = (cpu > cpu_max) ? cpu : cpu_max;
+        for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+        {
+            core_sum[core] += SYSMON_CORE_RING(history, cpu_core_percent, core)[index];
+        }
+        dram_free    = (history->dram_free[index] < dram_free) ? history->dram_free[index] : dram_free;
+        dram_largest = (history->dram_largest_block[index] < dram_largest) ? history->dram_largest_block[index] : dram_largest;
+        psram_free   = (history->psram_free[index] < psram_free) ? history->psram_free[index] : psram_free;
+    }
+
+    fields[FLASHLOG_FIELD_CPU_AVG] = _quantize_percent(cpu_sum / CONFIG_SYSMON_FLASHLOG_SAMPLES);
+    fields[FLASHLOG_FIELD_CPU_MAX] = _quantize_percent(cpu_max);
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        fields[FLASHLOG_FIELD_CORE_AVG + core] = _quantize_percent(core_sum[core] / CONFIG_SYSMON_FLASHLOG_SAMPLES);
+    }
+    fields[FLASHLOG_FIELD_DRAM_FREE]    = dram_free;
+    fields[FLASHLOG_FIELD_DRAM_LARGEST] = dram_largest;
+    fields[FLASHLOG_FIELD_PSRAM_FREE]   = psram_free;
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Find and map the log partition and locate the newest entries.
+ *
+ * @return ESP_OK if the log is active, error code otherwise (not fatal).
+ */
+esp_err_t _flashlog_init(void)
+{
+    if (s_mapped != NULL)
+    {
+        return ESP_OK;
+    }
+
+    s_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                           CONFIG_SYSMON_FLASHLOG_PARTITION);
+    if (s_partition == NULL)
+    {
+        ESP_LOGW(LOG_TAG, "No data partition '%s', flash log disabled", CONFIG_SYSMON_FLASHLOG_PARTITION);
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (s_partition->encrypted)
+    {
+        ESP_LOGW(LOG_TAG, "Partition '%s' is encrypted, flash log disabled", s_partition->label);
+        s_partition = NULL;
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    s_sector_count = (int)(s_partition->size / FLASHLOG_SECTOR_SIZE);
+    if (s_sector_count < 2)
+    {
+        ESP_LOGW(LOG_TAG, "Partition '%s' needs at least 2 sectors, flash log disabled", s_partition->label);
+        s_partition = NULL;
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    esp_err_t err = esp_partition_mmap(s_partition, 0, (size_t)s_sector_count * FLASHLOG_SECTOR_SIZE,
+                                       ESP_PARTITION_MMAP_DATA, (const void **)&s_mapped, &s_mmap_handle);
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(LOG_TAG, "Failed to map partition '%s': %s", s_partition->label, esp_err_to_name(err));
+        s_mapped = NULL;
+        s_partition = NULL;
+        return err;
+    }
+
+    // The newest sector has the highest sequence; continue after it in a fresh sector
+    s_sector_seq = 0;
+    s_used_sectors = 0;
+    int newest = s_sector_count - 1;
+    for (int sector = 0; sector < s_sector_count; sector++)
+    {
+        flashlog_sector_header_t header;
+        if (!_read_sector_header(sector, &header))
+        {
+            continue;
+        }
+        s_used_sectors++;
+        if (header.sector_seq > s_sector_seq)
+        {
+            s_sector_seq = header.sector_seq;
+            newest = sector;
+        }
+    }
+    s_head_sector = newest;
+    s_head_offset = FLASHLOG_SECTOR_SIZE;
+
+    flashlog_window_t window;
+    flashlog_cursor_t cursor;
+    _take_window(&window);
+    _cursor_begin(&cursor, &window);
+    s_next_entry_seq = 1;
+    uint32_t entries = 0;
+    while (_cursor_next(&cursor))
+    {
+        s_next_entry_seq = cursor.seq + 1;
+        entries++;
+    }
+    s_pending_count = 0;
+
+    ESP_LOGI(LOG_TAG, "Flash log on '%s': %d sectors, %" PRIu32 " entries kept",
+             s_partition->label, s_sector_count, entries);
+    return ESP_OK;
+}
+
+/**
+ * @brief Write the entries collected so far and unmap the partition.
+ */
+void _flashlog_deinit(void)
+{
+    if (s_mapped == NULL)
+    {
+        return;
+    }
+    _write_pending_block();
+    esp_partition_munmap(s_mmap_handle);
+    s_mapped = NULL;
+    s_partition = NULL;
+    s_sector_count = 0;
+}
+
+/**
+ * @brief Add a log entry when the newest raw sample completes an entry interval.
+ */
+void _flashlog_commit_sample(void)
+{
+    if (s_mapped == NULL || self.sample_sequence % CONFIG_SYSMON_FLASHLOG_SAMPLES != 0)
+    {
+        return;
+    }
+    if (!_sampling_at_base_interval(CONFIG_SYSMON_FLASHLOG_SAMPLES))
+    {
+        // Entries of a block are one entry interval apart, so a pause closes the block
+        if (s_pending_count > 0)
+        {
+            _write_pending_block();
+        }
+        return;
+    }
+
+    if (s_pending_count == 0)
+    {
+        time_t now = time(NULL);
+        s_pending_time = (now >= (time_t)FLASHLOG_MIN_WALL_TIME) ? (uint32_t)now : 0U;
+    }
+    _summarize_entry(s_pending[s_pending_count++]);
+    if (s_pending_count >= CONFIG_SYSMON_FLASHLOG_BLOCK_ENTRIES)
+    {
+        _write_pending_block();
+    }
+}
+
+/**
+ * @brief Report how much of the log partition holds entries.
+ *
+ * @param part Partition to check.
+ * @param used_bytes Output: bytes in sectors holding log data.
+ * @param free_bytes Output: remaining bytes of the partition.
+ * @return true if part is the active log partition.
+ */
+bool _flashlog_get_usage(const esp_partition_t *part, uint32_t *used_bytes, uint32_t *free_bytes)
+{
+    if (s_partition == NULL || part == NULL || part->address != s_partition->address)
+    {
+        return false;
+    }
+    *used_bytes = (uint32_t)s_used_sectors * FLASHLOG_SECTOR_SIZE;
+    *free_bytes = part->size - *used_bytes;
+    return true;
+}
+
+/**
+ * @brief Stream the most recent entries of the log as a chunked JSON response.
+ *
+ * @param request HTTP request to send the response on.
+ * @param range_s Time span to return in seconds (0 = the whole log).
+ * @return ESP_OK on success, error code otherwise.
+ *
+ * Details:
+ *   - Emits {"intervalMs", "seq", "from", "count", "seqs", "time", "series": {"cpuAvg", "cpuMax",
+ *     "cpuCores", "dramFreeMin", "dramLargestMin", "psramFreeMin"}}, oldest entry first.
+ *   - "seq" is the sequence of the newest entry; sequences continue across reboots, and "time"
+ *     gives each entry's wall-clock time in seconds (null while the clock was not set).
+ *   - Entries still collected in RAM (less than one block) are not included.
+ *   - Each array is decoded straight from the mapped partition into the chunk buffer.
+ */
+esp_err_t _stream_flashlog_json(httpd_req_t *request, uint32_t range_s)
+{
+    if (s_mapped == NULL)
+    {
+        return httpd_resp_send_err(request, HTTPD_404_NOT_FOUND, "Flash log not active");
+    }
+
+    sysmon_stream_t *stream = (sysmon_stream_t *)malloc(sizeof(sysmon_stream_t));
+    if (stream == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    _stream_begin(stream, request);
+
+    // One window for every array, so all of them cover the same entries
+    flashlog_window_t window;
+    flashlog_cursor_t cursor;
+    _take_window(&window);
+    _cursor_begin(&cursor, &window);
+    uint32_t total = 0;
+    uint32_t latest = 0;
+    while (_cursor_next(&cursor))
+    {
+        total++;
+        latest = cursor.seq;
+    }
+
+    uint64_t wanted = (range_s == 0) ? total : ((uint64_t)range_s * 1000U + _entry_interval_ms() - 1) / _entry_interval_ms();
+    uint32_t skip = (total > wanted) ? (uint32_t)(total - wanted) : 0U;
+    uint32_t from = 0;
+    _cursor_begin(&cursor, &window);
+    for (uint32_t i = 0; i <= skip && _cursor_next(&cursor); i++)
+    {
+        from = cursor.seq;
+    }
+
+    _stream_printf(stream, "{\"intervalMs\":%" PRIu32 ",\"seq\":%" PRIu32 ",\"from\":%" PRIu32 ",\"count\":%" PRIu32,
+                   _entry_interval_ms(), latest, (total > skip) ? from : 0U, total - skip);
+    _stream_puts(stream, ",\"seqs\":");
+    _stream_flashlog_field(stream, &window, skip, FLASHLOG_FIELD_SEQ);
+    _stream_puts(stream, ",\"time\":");
+    _stream_flashlog_field(stream, &window, skip, FLASHLOG_FIELD_TIME);
+    _stream_puts(stream, ",\"series\":{\"cpuAvg\":");
+    _stream_flashlog_field(stream, &window, skip, FLASHLOG_FIELD_CPU_AVG);
+    _stream_puts(stream, ",\"cpuMax\":");
+    _stream_flashlog_field(stream, &window, skip, FLASHLOG_FIELD_CPU_MAX);
+    _stream_puts(stream, ",\"cpuCores\":[");
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        _stream_puts(stream, (core > 0) ? "," : "");
+        _stream_flashlog_field(stream, &window, skip, FLASHLOG_FIELD_CORE_AVG + core);
+    }
+    _stream_puts(stream, "],\"dramFreeMin\":");
+    _stream_flashlog_field(stream, &window, skip, FLASHLOG_FIELD_DRAM_FREE);
+    _stream_puts(stream, ",\"dramLargestMin\":");
+    _stream_flashlog_field(stream, &window, skip, FLASHLOG_FIELD_DRAM_LARGEST);
+    _stream_puts(stream, ",\"psramFreeMin\":");
+    _stream_flashlog_field(stream, &window, skip, FLASHLOG_FIELD_PSRAM_FREE);
+    _stream_puts(stream, "}}");
+
+    esp_err_t result = _stream_end(stream);
+    free(stream);
+    return result;
+}
+
+#else // !CONFIG_SYSMON_FLASHLOG
+
+esp_err_t _flashlog_init(void)
+{
+    return ESP_OK;
+}
+
+void _flashlog_deinit(void)
+{
+}
+
+void _flashlog_commit_sample(void)
+{
+}
+
+bool _flashlog_get_usage(const esp_partition_t *part, uint32_t *used_bytes, uint32_t *free_bytes)
+{
+    return false;
+}
+
+esp_err_t _stream_flashlog_json(httpd_req_t *request, uint32_t range_s)
+{
+    return httpd_resp_send_err(request, HTTPD_404_NOT_FOUND, "Flash log disabled");
+}
+
+#endif // CONFIG_SYSMON_FLASHLOG
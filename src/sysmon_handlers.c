@@ -3,7 +3,7 @@
  * @brief HTTP request handlers for sysmon HTTP server.
  *
  * This file implements HTTP request handlers for serving static files and
- * JSON endpoints in the sysmon HTTP server.
+ * API (JSON and binary) endpoints in the sysmon HTTP server.
  */
 
 // Project-specific includes
@@ -18,20 +18,48 @@
 #include "cJSON.h"
 
 // System includes
+#include <inttypes.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 
 // Logger tag for this module
 static const char *LOG_TAG = "sysmon_handlers";
 
+// Longest If-None-Match value checked (longer lists are treated as no match)
+#define SYSMON_IF_NONE_MATCH_MAX_LEN 128
+
+/**
+ * @brief Check whether an If-None-Match header value matches an ETag.
+ *
+ * @param header_value If-None-Match header value (comma-separated list or "*").
+ * @param etag Quoted ETag of the asset.
+ * @return true if the client's cached copy is current.
+ */
+static bool _etag_matches(const char *header_value, const char *etag)
+{
+    if (strcmp(header_value, "*") == 0)
+    {
+        return true;
+    }
+    // Entries may carry a weak prefix (W/"..."); the quoted tag still has to appear verbatim
+    return strstr(header_value, etag) != NULL;
+}
+
 /**
  * @brief Handler function for static files (internal use only).
  *
+ * Assets are embedded gzip-compressed and sent with Content-Encoding: gzip.
+ * Each response carries the asset's build-time ETag; a request whose
+ * If-None-Match matches it gets an empty 304 Not Modified.
+ *
  * @param request HTTP request object.
  * @return ESP_OK on success, error code otherwise.
  */
 esp_err_t http_handle_static_file(httpd_req_t *request)
 {
+    _sampling_note_client();
+
     // Get config from user_ctx
     const static_file_config_t *config = (const static_file_config_t *)request->user_ctx;
     if (config == NULL)
@@ -42,48 +70,95 @@ esp_err_t http_handle_static_file(httpd_req_t *request)
 
     const uint8_t *start = config->start;
     const uint8_t *end = config->end;
-    size_t len = (size_t)(end - start);
-
-    // Always exclude null terminator from TEXT mode embeddings
-    if (len > 0)
-    {
-        len--;
-    }
 
     // Symbol and length checks to prevent runtime failure.
-    if (start == NULL || end == NULL || len == 0)
+    if (start == NULL || end == NULL || end <= start)
     {
         ESP_LOGE(LOG_TAG, "embedded symbols not found for %s", config->uri);
         return httpd_resp_send_500(request);
     }
+    size_t len = (size_t)(end - start);
+
+    // Validation headers go on both 200 and 304 responses
+    httpd_resp_set_hdr(request, "ETag", config->etag);
+    httpd_resp_set_hdr(request, "Cache-Control", SYSMON_STATIC_CACHE_CONTROL);
+    httpd_resp_set_hdr(request, "Vary", "Accept-Encoding");
 
-    const char *content_type = _get_content_type_from_uri(config->uri);
-    httpd_resp_set_type(request, content_type);
-    
     // Add CORS headers to allow cross-origin requests from other machines
     httpd_resp_set_hdr(request, "Access-Control-Allow-Origin", "*");
     httpd_resp_set_hdr(request, "Access-Control-Allow-Methods", "GET, OPTIONS");
     httpd_resp_set_hdr(request, "Access-Control-Allow-Headers", "Content-Type");
-    
+
+    char if_none_match[SYSMON_IF_NONE_MATCH_MAX_LEN];
+    if (httpd_req_get_hdr_value_str(request, "If-None-Match", if_none_match, sizeof(if_none_match)) == ESP_OK &&
+        _etag_matches(if_none_match, config->etag))
+    {
+        httpd_resp_set_status(request, "304 Not Modified");
+        return httpd_resp_send(request, NULL, 0);
+    }
+
+    const char *content_type = _get_content_type_from_uri(config->uri);
+    httpd_resp_set_type(request, content_type);
+    httpd_resp_set_hdr(request, "Content-Encoding", "gzip");
+
     return httpd_resp_send(request, (const char *)start, (ssize_t)len);
 }
 
 /**
- * @brief Handler function for JSON endpoints (internal use only).
+ * @brief Set content type and CORS headers shared by all API responses.
+ *
+ * @param request HTTP request object.
+ * @param content_type Content type of the response body.
+ */
+static void _set_api_response_headers(httpd_req_t *request, const char *content_type)
+{
+    httpd_resp_set_type(request, content_type);
+
+    // Add CORS headers to allow cross-origin requests from other machines
+    httpd_resp_set_hdr(request, "Access-Control-Allow-Origin", "*");
+    httpd_resp_set_hdr(request, "Access-Control-Allow-Methods", "GET, POST, OPTIONS");
+    httpd_resp_set_hdr(request, "Access-Control-Allow-Headers", "Content-Type");
+}
+
+/**
+ * @brief Handler function for API endpoints (internal use only).
+ *
+ * Streamed endpoints (chunked JSON or binary) write their own response;
+ * tree-based endpoints are built with cJSON and serialized in one piece.
  *
  * @param request HTTP request object.
- * @return ESP_OK on success, HTTP 500 on JSON build failure.
+ * @return ESP_OK on success, HTTP 500 on response build failure.
  */
-esp_err_t http_handle_json_endpoint(httpd_req_t *request)
+esp_err_t http_handle_api_endpoint(httpd_req_t *request)
 {
+    _sampling_note_client();
+
     // Get config from user_ctx
-    const json_handler_config_t *config = (const json_handler_config_t *)request->user_ctx;
-    if (config == NULL || config->create_json == NULL)
+    const api_handler_config_t *config = (const api_handler_config_t *)request->user_ctx;
+    if (config == NULL || (config->create_json == NULL && config->stream == NULL))
     {
-        ESP_LOGE(LOG_TAG, "JSON handler config is NULL");
+        ESP_LOGE(LOG_TAG, "API handler config is NULL");
         return httpd_resp_send_500(request);
     }
 
+    if (config->stream != NULL)
+    {
+        _set_api_response_headers(request, config->content_type);
+        esp_err_t stream_result = config->stream(request);
+        if (stream_result == ESP_ERR_NO_MEM)
+        {
+            // Nothing has been sent yet, so an error status is still possible
+            ESP_LOGE(LOG_TAG, "Out of memory for %s", config->uri);
+            return httpd_resp_send_500(request);
+        }
+        if (stream_result != ESP_OK)
+        {
+            ESP_LOGE(LOG_TAG, "Streaming response failed for %s: %s (0x%x)",
+                     config->uri, esp_err_to_name(stream_result), stream_result);
+        }
+        return stream_result;
+    }
+
     cJSON *json_root = config->create_json();
     if (json_root == NULL)
     {
@@ -101,12 +176,7 @@ esp_err_t http_handle_json_endpoint(httpd_req_t *request)
     }
 
     // Send JSON response
-    httpd_resp_set_type(request, "application/json; charset=utf-8");
-    
-    // Add CORS headers to allow cross-origin requests from other machines
-    httpd_resp_set_hdr(request, "Access-Control-Allow-Origin", "*");
-    httpd_resp_set_hdr(request, "Access-Control-Allow-Methods", "GET, OPTIONS");
-    httpd_resp_set_hdr(request, "Access-Control-Allow-Headers", "Content-Type");
+    _set_api_response_headers(request, config->content_type);
     
     esp_err_t result = httpd_resp_send(request, json_string, HTTPD_RESP_USE_STRLEN);
     if (result != ESP_OK)
@@ -121,3 +191,39 @@ esp_err_t http_handle_json_endpoint(httpd_req_t *request)
     return result;
 }
 
+/**
+ * @brief Handler function for POST /sampling (internal use only).
+ *
+ * Reads '?intervalMs=' and '?samples=' (either may be omitted), queues them
+ * with sysmon_set_sampling() and answers like GET /sampling, so the response
+ * shows the change as pending until the sampler applies it.
+ *
+ * @param request HTTP request object (user_ctx is the '/sampling' API config).
+ * @return ESP_OK on success, HTTP 400 on a missing or out-of-range value,
+ *         HTTP 500 if the query could not be read.
+ */
+esp_err_t http_handle_sampling_update(httpd_req_t *request)
+{
+    uint32_t interval_ms = 0;
+    uint32_t sample_count = 0;
+    esp_err_t interval_err = _get_query_uint32(request, "intervalMs", &interval_ms);
+    esp_err_t samples_err = _get_query_uint32(request, "samples", &sample_count);
+    if (interval_err == ESP_ERR_NO_MEM || samples_err == ESP_ERR_NO_MEM)
+    {
+        return httpd_resp_send_500(request);
+    }
+    if (interval_err == ESP_ERR_INVALID_ARG || samples_err == ESP_ERR_INVALID_ARG ||
+        (interval_err != ESP_OK && samples_err != ESP_OK))
+    {
+        return httpd_resp_send_err(request, HTTPD_400_BAD_REQUEST, "Expected 'intervalMs' and/or 'samples'");
+    }
+    if ((interval_err == ESP_OK && interval_ms == 0) || (samples_err == ESP_OK && sample_count == 0) ||
+        sysmon_set_sampling(interval_ms, sample_count) != ESP_OK)
+    {
+        return httpd_resp_send_err(request, HTTPD_400_BAD_REQUEST, "'intervalMs' or 'samples' out of range (see GET /sampling)");
+    }
+
+    ESP_LOGI(LOG_TAG, "Sampling change requested: interval %" PRIu32 " ms, %" PRIu32 " samples (0 = unchanged)",
+             interval_ms, sample_count);
+    return http_handle_api_endpoint(request);
+}
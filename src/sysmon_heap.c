@@ -0,0 +1,320 @@
+/**
+ * @file sysmon_heap.c
+ * @brief Per-capability heap region profiler for sysmon.
+ *
+ * This file implements the periodic heap region profile behind '/heap'.
+ * Every CONFIG_SYSMON_HEAP_PROFILE_SAMPLES raw samples the sampler calls
+ * heap_caps_get_info() once per capability region and stores the result in
+ * that region's ring in self.heap_profile. Regions without any heap on this
+ * target (total size 0) are recorded as zeros and skipped, so no heap is walked.
+ *
+ * Profile n lives at ring index n % slots; the spare slot keeps the profile
+ * being written outside the window of the published snapshot.
+ *
+ * Per-task attribution (CONFIG_SYSMON_HEAP_TASK_TRACKING) implements the
+ * esp_heap_trace_alloc_hook()/esp_heap_trace_free_hook() hooks. Counter blocks
+ * are static and indexed by task slot, so a task's thread-local pointer stays
+ * valid while task storage grows and after sysmon_deinit(). A block is reset
+ * only when the sampler attaches it to a new owner, before the owner's pointer
+ * is set; from then on the owning task is its only writer. Unattributed
+ * allocations may come from any task on a core, so those counters use atomics.
+ */
+
+// Project-specific includes
+#include "sysmon_heap.h"
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <stdint.h>
+#include <string.h>
+
+#ifdef CONFIG_SYSMON_HEAP_PROFILE
+
+static const SysMonHeapRegion s_heap_regions[SYSMON_HEAP_REGION_COUNT] =
+{
+    { .name = "iram",  .caps = MALLOC_CAP_EXEC },
+    { .name = "dma",   .caps = MALLOC_CAP_DMA },
+    { .name = "8bit",  .caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT },
+    { .name = "rtc",   .caps = MALLOC_CAP_RTCRAM },
+    { .name = "psram", .caps = MALLOC_CAP_SPIRAM }
+};
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Profile one heap region.
+ *
+ * @param region Region description.
+ * @param sample Output profile entry.
+ */
+static void _profile_region(const SysMonHeapRegion *region, SysMonHeapRegionSample *sample)
+{
+    memset(sample, 0, sizeof(*sample));
+    if (heap_caps_get_total_size(region->caps) == 0)
+    {
+        return;
+    }
+
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, region->caps);
+
+    sample->free_bytes         = (uint32_t)info.total_free_bytes;
+    sample->largest_free_block = (uint32_t)info.largest_free_block;
+    sample->minimum_free_bytes = (uint32_t)info.minimum_free_bytes;
+    sample->free_blocks        = (info.free_blocks > UINT16_MAX) ? UINT16_MAX : (uint16_t)info.free_blocks;
+    if (info.total_free_bytes > 0 && info.largest_free_block <= info.total_free_bytes)
+    {
+        uint64_t contiguous = (uint64_t)info.largest_free_block * 10000U / info.total_free_bytes;
+        sample->fragmentation = (uint16_t)(10000U - contiguous);
+    }
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Get the description of a heap region.
+ *
+ * @param region Region index (0 to SYSMON_HEAP_REGION_COUNT - 1).
+ * @return Region description, or NULL if the region does not exist.
+ */
+const SysMonHeapRegion *_heap_get_region(int region)
+{
+    if (region < 0 || region >= SYSMON_HEAP_REGION_COUNT)
+    {
+        return NULL;
+    }
+    return &s_heap_regions[region];
+}
+
+/**
+ * @brief Get the time between two heap region profiles.
+ *
+ * @return Profile interval in milliseconds.
+ */
+uint32_t _heap_profile_interval_ms(void)
+{
+    return CONFIG_SYSMON_HEAP_PROFILE_SAMPLES * CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS;
+}
+
+/**
+ * @brief Profile every heap region when the newest raw sample reaches a profile boundary.
+ */
+void _heap_profile_commit_sample(void)
+{
+    if (self.heap_profile == NULL || self.sample_sequence % CONFIG_SYSMON_HEAP_PROFILE_SAMPLES != 0 ||
+        !_sampling_at_base_interval(0))
+    {
+        return;
+    }
+
+    int index = (int)(self.heap_profile_sequence % SYSMON_HEAP_PROFILE_SLOTS);
+    for (int region = 0; region < SYSMON_HEAP_REGION_COUNT; region++)
+    {
+        _profile_region(&s_heap_regions[region], &SYSMON_HEAP_REGION_RING(self.heap_profile, region)[index]);
+    }
+    self.heap_profile_sequence++;
+}
+
+#else // !CONFIG_SYSMON_HEAP_PROFILE
+
+const SysMonHeapRegion *_heap_get_region(int region)
+{
+    return NULL;
+}
+
+uint32_t _heap_profile_interval_ms(void)
+{
+    return 0;
+}
+
+void _heap_profile_commit_sample(void)
+{
+}
+
+#endif // CONFIG_SYSMON_HEAP_PROFILE
+
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+
+// Counter blocks by task slot (internal RAM: the hooks may run while the flash cache is disabled)
+static DRAM_ATTR SysMonTaskHeapCounters s_task_heap_counters[SYSMON_MAX_TRACKED_TASKS];
+static DRAM_ATTR SysMonTaskHeapCounters s_unattributed_heap_counters[SYSMON_CORE_COUNT];
+static DRAM_ATTR volatile bool s_task_tracking_enabled = false;
+
+// ============================================================================
+// Heap Hooks
+// ============================================================================
+
+/**
+ * @brief Get the counter block of the calling task, or NULL if it has none.
+ *
+ * @return Counter block of the running task.
+ */
+static IRAM_ATTR SysMonTaskHeapCounters *_current_task_counters(void)
+{
+    if (xPortInIsrContext())
+    {
+        return NULL;
+    }
+    return (SysMonTaskHeapCounters *)pvTaskGetThreadLocalStoragePointer(NULL, CONFIG_SYSMON_HEAP_TASK_TLS_INDEX);
+}
+
+/**
+ * @brief Heap allocation hook (CONFIG_HEAP_USE_HOOKS): count the allocation for the calling task.
+ *
+ * @param ptr Allocated block (NULL if the allocation failed).
+ * @param size Requested size in bytes.
+ * @param caps Capabilities of the allocation.
+ */
+void IRAM_ATTR esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps)
+{
+    if (ptr == NULL || !s_task_tracking_enabled)
+    {
+        return;
+    }
+
+    SysMonTaskHeapCounters *counters = _current_task_counters();
+    if (counters != NULL)
+    {
+        counters->alloc_bytes += (uint32_t)size;
+        counters->alloc_count++;
+        return;
+    }
+
+    SysMonTaskHeapCounters *unattributed = &s_unattributed_heap_counters[xPortGetCoreID()];
+    __atomic_fetch_add(&unattributed->alloc_bytes, (uint32_t)size, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&unattributed->alloc_count, 1U, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Heap free hook (CONFIG_HEAP_USE_HOOKS): count the free for the calling task.
+ *
+ * @param ptr Freed block.
+ */
+void IRAM_ATTR esp_heap_trace_free_hook(void *ptr)
+{
+    if (ptr == NULL || !s_task_tracking_enabled)
+    {
+        return;
+    }
+
+    SysMonTaskHeapCounters *counters = _current_task_counters();
+    if (counters != NULL)
+    {
+        counters->free_count++;
+        return;
+    }
+
+    __atomic_fetch_add(&s_unattributed_heap_counters[xPortGetCoreID()].free_count, 1U, __ATOMIC_RELAXED);
+}
+
+// ============================================================================
+// Task Attribution API
+// ============================================================================
+
+/**
+ * @brief Enable per-task heap attribution in the alloc/free hooks.
+ */
+void _heap_task_tracking_start(void)
+{
+    memset(s_unattributed_heap_counters, 0, sizeof(s_unattributed_heap_counters));
+    s_task_tracking_enabled = true;
+}
+
+/**
+ * @brief Disable per-task heap attribution.
+ *
+ * Tasks keep their thread-local pointers into the static counter blocks; the
+ * sampler re-attaches every task it sees after a restart.
+ */
+void _heap_task_tracking_stop(void)
+{
+    s_task_tracking_enabled = false;
+}
+
+/**
+ * @brief Give a task slot's counter block to a task.
+ *
+ * @param slot Task slot index.
+ * @param handle Task now owning the slot.
+ */
+void _heap_task_attach(int slot, TaskHandle_t handle)
+{
+    if (slot < 0 || slot >= SYSMON_MAX_TRACKED_TASKS || handle == NULL)
+    {
+        return;
+    }
+    memset(&s_task_heap_counters[slot], 0, sizeof(SysMonTaskHeapCounters));
+    vTaskSetThreadLocalStoragePointer(handle, CONFIG_SYSMON_HEAP_TASK_TLS_INDEX, &s_task_heap_counters[slot]);
+}
+
+/**
+ * @brief Read a task slot's cumulative counters.
+ *
+ * @param slot Task slot index.
+ * @param counters Output counters.
+ */
+void _heap_task_read(int slot, SysMonTaskHeapCounters *counters)
+{
+    if (slot < 0 || slot >= SYSMON_MAX_TRACKED_TASKS)
+    {
+        memset(counters, 0, sizeof(*counters));
+        return;
+    }
+    // Aligned 32-bit loads; each field is consistent, the three may be one allocation apart
+    const volatile SysMonTaskHeapCounters *source = &s_task_heap_counters[slot];
+    counters->alloc_bytes = source->alloc_bytes;
+    counters->alloc_count = source->alloc_count;
+    counters->free_count  = source->free_count;
+}
+
+/**
+ * @brief Read the counters of allocations that could not be attributed to a tracked task.
+ *
+ * @param counters Output counters, summed over all cores.
+ */
+void _heap_task_read_unattributed(SysMonTaskHeapCounters *counters)
+{
+    memset(counters, 0, sizeof(*counters));
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        counters->alloc_bytes += __atomic_load_n(&s_unattributed_heap_counters[core].alloc_bytes, __ATOMIC_RELAXED);
+        counters->alloc_count += __atomic_load_n(&s_unattributed_heap_counters[core].alloc_count, __ATOMIC_RELAXED);
+        counters->free_count  += __atomic_load_n(&s_unattributed_heap_counters[core].free_count, __ATOMIC_RELAXED);
+    }
+}
+
+#else // !CONFIG_SYSMON_HEAP_TASK_TRACKING
+
+void _heap_task_tracking_start(void)
+{
+}
+
+void _heap_task_tracking_stop(void)
+{
+}
+
+void _heap_task_attach(int slot, TaskHandle_t handle)
+{
+}
+
+void _heap_task_read(int slot, SysMonTaskHeapCounters *counters)
+{
+    memset(counters, 0, sizeof(*counters));
+}
+
+void _heap_task_read_unattributed(SysMonTaskHeapCounters *counters)
+{
+    memset(counters, 0, sizeof(*counters));
+}
+
+#endif // CONFIG_SYSMON_HEAP_TASK_TRACKING
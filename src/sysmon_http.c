@@ -8,7 +8,7 @@
  *
  * Responsibilities:
  *   - Initializes and runs the HTTP server for telemetry endpoints.
- *   - Registers static file and JSON endpoint handlers.
+ *   - Registers static file and API (JSON and binary) endpoint handlers.
  *   - Manages server lifecycle (start/stop).
  *
  * Dependencies:
@@ -16,18 +16,28 @@
  *   - sysmon core API (sysmon.h)
  *   - sysmon_config.h for configuration structures
  *   - sysmon_json.h for JSON function declarations
+ *   - sysmon_binary.h for binary encoder declarations
+ *   - sysmon_metrics.h for the Prometheus text encoder
+ *   - sysmon_push.h for the WebSocket push channel
  *   - sysmon_handlers.c for HTTP request handlers
  *
  * Usage:
  *   - Call sysmon_http_start() to activate endpoints; sysmon_http_stop() to disable.
- *   - Endpoints: '/', '/tasks', '/history', '/telemetry', '/hardware'
+ *   - Endpoints: '/', '/tasks', '/history', '/telemetry', '/hardware', '/sampling' (GET and POST),
+ *     '/telemetry.bin', '/history.bin',
+ *     '/ws' (WebSocket push, when CONFIG_SYSMON_WEBSOCKET_PUSH is enabled), '/heap', '/trace' and
+ *     '/metrics' (when CONFIG_SYSMON_HEAP_PROFILE, CONFIG_SYSMON_TRACE and CONFIG_SYSMON_METRICS are enabled)
  *  */
 
 // Project-specific includes
 #include "sysmon_http.h"
 #include "sysmon.h"
+#include "sysmon_binary.h"
 #include "sysmon_config.h"
 #include "sysmon_json.h"
+#include "sysmon_metrics.h"
+#include "sysmon_push.h"
+#include "sysmon_www_assets.h"  // Generated at build time (asset ETags)
 
 // ESP-IDF includes
 #include "esp_log.h"
@@ -41,7 +51,8 @@ static const char *LOG_TAG = "sysmon_http";
 
 // Forward declarations for handler functions (defined in sysmon_handlers.c)
 extern esp_err_t http_handle_static_file(httpd_req_t *request);
-extern esp_err_t http_handle_json_endpoint(httpd_req_t *request);
+extern esp_err_t http_handle_api_endpoint(httpd_req_t *request);
+extern esp_err_t http_handle_sampling_update(httpd_req_t *request);
 
 // Static file handler configurations
 static const static_file_config_t static_file_configs[] =
@@ -58,15 +69,30 @@ static const static_file_config_t static_file_configs[] =
     STATIC_FILE_ENTRY("/js/app.js", app_js)
 };
 
-// JSON endpoint handler configurations
-static const json_handler_config_t json_handler_configs[] =
+// API endpoint handler configurations (each route selects its own encoder)
+static const api_handler_config_t api_handler_configs[] =
 {
-    JSON_ENDPOINT_ENTRY("/tasks", _create_tasks_json),
-    JSON_ENDPOINT_ENTRY("/history", _create_history_json),
+    JSON_STREAM_ENDPOINT_ENTRY("/tasks", _stream_tasks_json),
+    JSON_STREAM_ENDPOINT_ENTRY("/history", _stream_history_json),
     JSON_ENDPOINT_ENTRY("/telemetry", _create_telemetry_json),
-    JSON_ENDPOINT_ENTRY("/hardware", _create_hardware_json)
+    JSON_STREAM_ENDPOINT_ENTRY("/hardware", _stream_hardware_json),
+    JSON_ENDPOINT_ENTRY("/sampling", _create_sampling_json),
+#ifdef CONFIG_SYSMON_HEAP_PROFILE
+    JSON_STREAM_ENDPOINT_ENTRY("/heap", _stream_heap_json),
+#endif
+#ifdef CONFIG_SYSMON_TRACE
+    JSON_ENDPOINT_ENTRY("/trace", _create_trace_json),
+#endif
+#ifdef CONFIG_SYSMON_METRICS
+    METRICS_ENDPOINT_ENTRY("/metrics", _stream_metrics_text),
+#endif
+    BINARY_ENDPOINT_ENTRY("/telemetry.bin", _stream_telemetry_binary),
+    BINARY_ENDPOINT_ENTRY("/history.bin", _stream_history_binary)
 };
 
+// POST /sampling answers with the GET document, so it gets the same route configuration
+static const api_handler_config_t sampling_update_config = JSON_ENDPOINT_ENTRY("/sampling", _create_sampling_json);
+
 /**
  * @brief Helper function to register a URI handler with error handling.
  *
@@ -114,7 +140,8 @@ static esp_err_t _register_handler(httpd_handle_t server, const char *uri, httpd
  *   4. On error, leaves self.httpd = NULL and propagates error upwards.
  *
  * @note The HTTP API uses port/task settings defined by CONFIG_SYSMON_HTTPD_SERVER_PORT/etc.
- * @note All handlers are GET (read-only, telemetry export).
+ * @note All handlers are GET (read-only, telemetry export), except POST /sampling,
+ *       which changes the sampling interval and history depth.
  * @note The sysmon_http module must be initialized before use.
  */
 esp_err_t sysmon_http_start(void)
@@ -129,17 +156,17 @@ esp_err_t sysmon_http_start(void)
     config.ctrl_port        = CONFIG_SYSMON_HTTPD_CTRL_PORT; // necessary if you want to create multiple HTTPD servers
 
     // Allow more simultaneous connections for multiple browser asset/API requests
-    // Served files: 1 HTML + 3 CSS + 6 JS = 10 static files, plus 4 JSON API endpoints
+    // Served files: 1 HTML + 3 CSS + 6 JS = 10 static files, plus 4 JSON and 2 binary API endpoints
     // Browsers load these concurrently, so default max_open_sockets=7 is insufficient
     config.max_open_sockets = 12;
 
     // Set max URI handlers based on how many static files & APIs we'll serve
     size_t static_file_count  = sizeof(static_file_configs) / sizeof(static_file_configs[0]);
-    size_t json_handler_count = sizeof(json_handler_configs) / sizeof(json_handler_configs[0]);
-    config.max_uri_handlers   = static_file_count + json_handler_count;
+    size_t api_handler_count  = sizeof(api_handler_configs) / sizeof(api_handler_configs[0]);
+    config.max_uri_handlers   = static_file_count + api_handler_count + 1 + SYSMON_PUSH_URI_HANDLER_COUNT;
 
     // Warn if LWIP socket pool is too small for this server config
-#if CONFIG_LWIP_MAX_SOCKETS < 15
+#if !defined(CONFIG_SYSMON_HEADLESS) && CONFIG_LWIP_MAX_SOCKETS < 15
     #warning "CONFIG_LWIP_MAX_SOCKETS may be too low (need at least 15 for max_open_sockets=12)."
 #endif
 
@@ -164,18 +191,36 @@ esp_err_t sysmon_http_start(void)
         }
     }
 
-    // Register all JSON endpoint handlers
-    for (size_t i = 0; i < sizeof(json_handler_configs) / sizeof(json_handler_configs[0]); i++)
+    // Register all API endpoint handlers
+    for (size_t i = 0; i < sizeof(api_handler_configs) / sizeof(api_handler_configs[0]); i++)
     {
-        err = _register_handler(self.httpd, json_handler_configs[i].uri, HTTP_GET,
-                                 http_handle_json_endpoint, (void *)&json_handler_configs[i],
-                                 json_handler_configs[i].uri);
+        err = _register_handler(self.httpd, api_handler_configs[i].uri, HTTP_GET,
+                                 http_handle_api_endpoint, (void *)&api_handler_configs[i],
+                                 api_handler_configs[i].uri);
         if (err != ESP_OK)
         {
             return err;
         }
     }
 
+    // Register the only write endpoint
+    err = _register_handler(self.httpd, sampling_update_config.uri, HTTP_POST,
+                             http_handle_sampling_update, (void *)&sampling_update_config,
+                             "POST /sampling");
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Register the WebSocket push channel (no-op when disabled)
+    err = sysmon_push_register(self.httpd);
+    if (err != ESP_OK)
+    {
+        httpd_stop(self.httpd);
+        self.httpd = NULL;
+        return err;
+    }
+
     return ESP_OK;
 }
 
@@ -192,5 +237,6 @@ void sysmon_http_stop(void)
     {
         httpd_stop(self.httpd);
         self.httpd = NULL;
+        sysmon_push_reset();
     }
 }
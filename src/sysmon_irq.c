@@ -0,0 +1,429 @@
+/**
+ * @file sysmon_irq.c
+ * @brief Interrupt and critical-section time accounting for sysmon.
+ *
+ * This file implements the sampling timers declared in sysmon_irq.h and the
+ * sampler-side drain.
+ *
+ * Each core has its own timer, counters and a single-producer/single-consumer
+ * ring of the tasks that were running when a sample was held off: the alarm
+ * handler owns the counters and the ring head, the sampler owns the tail. The
+ * counters only ever grow, so the drain takes differences against the values
+ * it saw last time; only the per-interval maximum is handed over with an
+ * atomic exchange. The handler runs from IRAM and touches internal RAM only.
+ */
+
+// Project-specific includes
+#include "sysmon_irq.h"
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_attr.h"
+#include "esp_err.h"
+#include "esp_idf_version.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+
+// The gptimer driver only exists from ESP-IDF v5.0 on
+#if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 0, 0)
+    #error "CONFIG_SYSMON_IRQ_ACCOUNTING requires ESP-IDF v5.0 or later (gptimer driver)."
+#endif
+#include "driver/gptimer.h"
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_irq";
+
+// Timer resolution: one count per microsecond
+#define IRQ_TIMER_RESOLUTION_HZ     1000000U
+
+// Distinct tasks attributed per core and interval (samples of further tasks are dropped)
+#define IRQ_DRAIN_TASKS_MAX         16
+
+/**
+ * @brief Sampling state of one core.
+ *
+ * Members:
+ * - samples   : Alarms handled (handler only).
+ * - held      : Alarms that ran late, i.e. were held off (handler only).
+ * - baseline  : Lowest lateness seen, in microseconds (handler only).
+ * - max_us    : Longest lateness above baseline since the last drain (exchanged by the sampler).
+ * - head      : Ring entries written (handler only).
+ * - tail      : Ring entries consumed (sampler only).
+ * - tasks     : Task running at each held-off sample, indexed modulo CONFIG_SYSMON_IRQ_RING_DEPTH.
+ */
+typedef struct
+{
+    uint32_t samples;
+    uint32_t held;
+    uint32_t baseline;
+    uint32_t max_us;
+    uint32_t head;
+    uint32_t tail;
+    TaskHandle_t tasks[CONFIG_SYSMON_IRQ_RING_DEPTH];
+} irq_core_t;
+
+/**
+ * @brief Held-off samples of one task within a drain.
+ *
+ * Members:
+ * - task  : Task that was running.
+ * - count : Samples recorded for it.
+ */
+typedef struct
+{
+    TaskHandle_t task;
+    uint32_t count;
+} irq_task_count_t;
+
+// Per-core state lives in internal RAM: the handler may run while the flash cache is disabled
+static DRAM_ATTR irq_core_t s_irq_cores[SYSMON_CORE_COUNT];
+static gptimer_handle_t s_irq_timers[SYSMON_CORE_COUNT];
+
+// Sampler-side state: counter values at the previous drain
+static uint32_t s_prev_samples[SYSMON_CORE_COUNT];
+static uint32_t s_prev_held[SYSMON_CORE_COUNT];
+static bool s_irq_running = false;
+
+// Timer setup hand-off between _irq_start() and the per-core setup task
+static TaskHandle_t s_setup_waiter = NULL;
+static esp_err_t s_setup_result = ESP_OK;
+
+// ============================================================================
+// Timer Alarm Handler
+// ============================================================================
+
+/**
+ * @brief Timer alarm callback: classify the sample and record the running task.
+ *
+ * The timer is reloaded to zero by the hardware at the alarm, so the count
+ * captured by the driver is the time since the alarm fired.
+ *
+ * @param timer Timer handle (unused).
+ * @param edata Alarm event data.
+ * @param user_ctx Core state (irq_core_t).
+ * @return false (no task was woken).
+ */
+static bool IRAM_ATTR _irq_on_alarm(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx)
+{
+    irq_core_t *state = (irq_core_t *)user_ctx;
+    uint32_t late_us = (uint32_t)edata->count_value;
+
+    state->samples++;
+    if (late_us < state->baseline)
+    {
+        state->baseline = late_us;
+    }
+    uint32_t excess_us = late_us - state->baseline;
+    if (excess_us <= CONFIG_SYSMON_IRQ_SLACK_US)
+    {
+        return false;
+    }
+
+    state->held++;
+    if (excess_us > state->max_us)
+    {
+        state->max_us = excess_us;
+    }
+
+    // The running task is still the one the held-off stretch was charged to
+    uint32_t head = state->head;
+    if (head - __atomic_load_n(&state->tail, __ATOMIC_ACQUIRE) < CONFIG_SYSMON_IRQ_RING_DEPTH)
+    {
+        state->tasks[head & (CONFIG_SYSMON_IRQ_RING_DEPTH - 1)] = xTaskGetCurrentTaskHandleForCore(xPortGetCoreID());
+        __atomic_store_n(&state->head, head + 1, __ATOMIC_RELEASE);
+    }
+    return false;
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Create, arm and start the sampling timer of the calling core.
+ *
+ * @param core Core index (the caller runs pinned to it).
+ * @return ESP_OK on success, otherwise the timer driver error.
+ */
+static esp_err_t _irq_timer_create(int core)
+{
+    gptimer_config_t timer_config = {
+        .clk_src       = GPTIMER_CLK_SRC_DEFAULT,
+        .direction     = GPTIMER_COUNT_UP,
+        .resolution_hz = IRQ_TIMER_RESOLUTION_HZ,
+    };
+    gptimer_handle_t timer = NULL;
+    esp_err_t err = gptimer_new_timer(&timer_config, &timer);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // The interrupt is allocated on the core registering the callbacks
+    gptimer_event_callbacks_t callbacks = {
+        .on_alarm = _irq_on_alarm,
+    };
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count  = IRQ_TIMER_RESOLUTION_HZ / CONFIG_SYSMON_IRQ_SAMPLE_HZ,
+        .reload_count = 0,
+        .flags.auto_reload_on_alarm = true,
+    };
+    err = gptimer_register_event_callbacks(timer, &callbacks, &s_irq_cores[core]);
+    if (err == ESP_OK)
+    {
+        err = gptimer_set_alarm_action(timer, &alarm_config);
+    }
+    if (err == ESP_OK)
+    {
+        err = gptimer_enable(timer);
+    }
+    if (err == ESP_OK)
+    {
+        err = gptimer_start(timer);
+        if (err != ESP_OK)
+        {
+            gptimer_disable(timer);
+        }
+    }
+    if (err != ESP_OK)
+    {
+        gptimer_del_timer(timer);
+        return err;
+    }
+    s_irq_timers[core] = timer;
+    return ESP_OK;
+}
+
+/**
+ * @brief Setup task: create the timer of the core it is pinned to and report back.
+ *
+ * @param param Core index.
+ */
+static void _irq_setup_task(void *param)
+{
+    s_setup_result = _irq_timer_create((int)(intptr_t)param);
+    xTaskNotifyGive(s_setup_waiter);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Find the slot tracking a task handle.
+ *
+ * Only called for the few distinct tasks of a drain, so a scan is enough.
+ *
+ * @param handle Task handle.
+ * @return Slot index, or -1 if the task has no slot.
+ */
+static int _irq_find_slot(TaskHandle_t handle)
+{
+    for (int slot = 0; slot < self.task_capacity; slot++)
+    {
+        // IRQ rows have no handle
+        if (self.tasks[slot].is_active && handle != NULL && self.tasks[slot].task_handle == handle)
+        {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Drain one core's ring into per-task sample counts.
+ *
+ * @param state Core state.
+ * @param counts Output: distinct tasks and their samples (IRQ_DRAIN_TASKS_MAX entries).
+ * @param count_used Output: entries used in counts.
+ * @return Samples consumed from the ring (including those of tasks that did not fit).
+ */
+static uint32_t _irq_drain_ring(irq_core_t *state, irq_task_count_t *counts, int *count_used)
+{
+    uint32_t start = state->tail;
+    uint32_t end   = __atomic_load_n(&state->head, __ATOMIC_ACQUIRE);
+    int used = 0;
+    int last = -1;
+
+    for (uint32_t read = start; read != end; read++)
+    {
+        TaskHandle_t task = state->tasks[read & (CONFIG_SYSMON_IRQ_RING_DEPTH - 1)];
+        // Consecutive samples mostly hit the same task
+        if (last < 0 || counts[last].task != task)
+        {
+            last = -1;
+            for (int i = 0; i < used; i++)
+            {
+                if (counts[i].task == task)
+                {
+                    last = i;
+                    break;
+                }
+            }
+            if (last < 0 && used < IRQ_DRAIN_TASKS_MAX)
+            {
+                counts[used].task  = task;
+                counts[used].count = 0;
+                last = used++;
+            }
+        }
+        if (last >= 0)
+        {
+            counts[last].count++;
+        }
+    }
+
+    __atomic_store_n(&state->tail, end, __ATOMIC_RELEASE);
+    *count_used = used;
+    return end - start;
+}
+
+// ============================================================================
+// Internal API Functions
+// ============================================================================
+
+/**
+ * @brief Start the sampling timers.
+ *
+ * @return ESP_OK on success, otherwise the timer driver error (sampling stays off).
+ */
+esp_err_t _irq_start(void)
+{
+    if (s_irq_running)
+    {
+        return ESP_OK;
+    }
+
+    s_setup_waiter = xTaskGetCurrentTaskHandle();
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        irq_core_t *state = &s_irq_cores[core];
+        state->baseline = UINT32_MAX;
+        state->max_us   = 0;
+        __atomic_store_n(&state->tail, __atomic_load_n(&state->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+        s_prev_samples[core] = state->samples;
+        s_prev_held[core]    = state->held;
+
+        if (xTaskCreatePinnedToCore(_irq_setup_task, "sysmon_irq", 3 * 1024, (void *)(intptr_t)core,
+                                    configMAX_PRIORITIES - 1, NULL, core) != pdPASS)
+        {
+            s_setup_result = ESP_ERR_NO_MEM;
+        }
+        else
+        {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        if (s_setup_result != ESP_OK)
+        {
+            ESP_LOGE(LOG_TAG, "Failed to start the sampling timer of core %d: %s", core, esp_err_to_name(s_setup_result));
+            _irq_stop();
+            return s_setup_result;
+        }
+    }
+
+    s_irq_running = true;
+    ESP_LOGI(LOG_TAG, "Sampling interrupt and critical-section time at %d Hz per core", CONFIG_SYSMON_IRQ_SAMPLE_HZ);
+    return ESP_OK;
+}
+
+/**
+ * @brief Stop and release the sampling timers.
+ */
+void _irq_stop(void)
+{
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        if (s_irq_timers[core] != NULL)
+        {
+            gptimer_stop(s_irq_timers[core]);
+            gptimer_disable(s_irq_timers[core]);
+            gptimer_del_timer(s_irq_timers[core]);
+            s_irq_timers[core] = NULL;
+        }
+    }
+    s_irq_running = false;
+}
+
+/**
+ * @brief Drain the per-core counters into per-core figures and per-task shares.
+ *
+ * When a ring overflowed, the samples it kept are scaled up to the number of
+ * held-off samples counted, so the task shares still add up.
+ *
+ * @param cores Output: one entry per core.
+ */
+void _irq_drain(SysMonIrqCoreSample *cores)
+{
+    memset(cores, 0, sizeof(SysMonIrqCoreSample) * SYSMON_CORE_COUNT);
+    if (self.tasks == NULL)
+    {
+        return;
+    }
+    for (int slot = 0; slot < self.task_capacity; slot++)
+    {
+        self.tasks[slot].irq_percent = 0.0f;
+    }
+    if (!s_irq_running)
+    {
+        return;
+    }
+
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        irq_core_t *state = &s_irq_cores[core];
+        uint32_t samples_now = state->samples;
+        uint32_t held_now    = state->held;
+        uint32_t samples = samples_now - s_prev_samples[core];
+        uint32_t held    = held_now - s_prev_held[core];
+        s_prev_samples[core] = samples_now;
+        s_prev_held[core]    = held_now;
+        cores[core].max_us = __atomic_exchange_n(&state->max_us, 0, __ATOMIC_ACQ_REL);
+
+        irq_task_count_t counts[IRQ_DRAIN_TASKS_MAX];
+        int count_used = 0;
+        uint32_t recorded = _irq_drain_ring(state, counts, &count_used);
+        if (samples == 0)
+        {
+            continue;
+        }
+
+        cores[core].irq_percent = (float)held * 100.0f / (float)samples;
+        float percent_per_record = (recorded > 0) ? cores[core].irq_percent / (float)recorded : 0.0f;
+        for (int i = 0; i < count_used; i++)
+        {
+            float share = (float)counts[i].count * percent_per_record;
+            if (counts[i].task == self.idle_task_handles[core])
+            {
+                cores[core].idle_percent += share;
+            }
+            int slot = _irq_find_slot(counts[i].task);
+            if (slot >= 0)
+            {
+                self.tasks[slot].irq_percent += share;
+            }
+        }
+    }
+}
+
+#else // !CONFIG_SYSMON_IRQ_ACCOUNTING
+
+esp_err_t _irq_start(void)
+{
+    return ESP_OK;
+}
+
+void _irq_stop(void)
+{
+}
+
+void _irq_drain(SysMonIrqCoreSample *cores)
+{
+    memset(cores, 0, sizeof(SysMonIrqCoreSample) * SYSMON_CORE_COUNT);
+}
+
+#endif // CONFIG_SYSMON_IRQ_ACCOUNTING
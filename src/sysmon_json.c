@@ -9,6 +9,15 @@
 // Project-specific includes
 #include "sysmon_json.h"
 #include "sysmon.h"
+#include "sysmon_custom.h"
+#include "sysmon_flashlog.h"
+#include "sysmon_heap.h"
+#include "sysmon_push.h"
+#include "sysmon_query.h"
+#include "sysmon_recorder.h"
+#include "sysmon_rollup.h"
+#include "sysmon_stream.h"
+#include "sysmon_trace.h"
 #include "sysmon_utils.h"
 
 // ESP-IDF includes
@@ -32,6 +41,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stddef.h>
+#include <stdio.h>
 #include <time.h>
 
 // Logger tag for this module
@@ -121,11 +131,12 @@ static const char *_determine_chip_variant(const esp_chip_info_t *chip_info, uin
 /**
  * @brief Build CPU summary JSON object.
  *
- * @param read_index Index into series arrays for latest sample.
+ * @param snapshot Pinned snapshot.
  * @return CPU summary JSON object, or NULL on allocation failure.
  */
-static cJSON *_build_cpu_summary(int read_index)
+static cJSON *_build_cpu_summary(const SysMonSnapshot *snapshot)
 {
+    const SysMonSampleValues *newest = &snapshot->newest;
     cJSON *cpu = cJSON_CreateObject();
     if (cpu == NULL)
     {
@@ -133,7 +144,7 @@ static cJSON *_build_cpu_summary(int read_index)
     }
 
     // Round CPU overall to 2 decimal places (XX.XX%)
-    float overall_raw = self.cpu_overall_percent[read_index];
+    float overall_raw = newest->cpu_overall_percent;
     double overall_rounded = round(overall_raw * 100.0) / 100.0;
     cJSON_AddNumberToObject(cpu, "overall", overall_rounded);
 
@@ -143,25 +154,51 @@ static cJSON *_build_cpu_summary(int read_index)
         JSON_CLEANUP(cpu);
         return NULL;
     }
-    // Round CPU core percentages to 2 decimal places (XX.XX%)
-    float core0_raw = self.cpu_core_percent[0][read_index];
-    float core1_raw = self.cpu_core_percent[1][read_index];
-    double core0_rounded = round(core0_raw * 100.0) / 100.0;
-    double core1_rounded = round(core1_raw * 100.0) / 100.0;
-    cJSON_AddItemToArray(cores_array, cJSON_CreateNumber(core0_rounded));
-    cJSON_AddItemToArray(cores_array, cJSON_CreateNumber(core1_rounded));
     cJSON_AddItemToObject(cpu, "cores", cores_array);
 
+    cJSON *unpinned_array = cJSON_AddArrayToObject(cpu, "coresUnpinned");
+    if (unpinned_array == NULL)
+    {
+        JSON_CLEANUP(cpu);
+        return NULL;
+    }
+
+    // Round CPU core percentages to 2 decimal places (XX.XX%)
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        double core_rounded = round(newest->cpu_core_percent[core] * 100.0) / 100.0;
+        double unpinned_rounded = round(newest->cpu_core_unpinned_percent[core] * 100.0) / 100.0;
+        cJSON_AddItemToArray(cores_array, cJSON_CreateNumber(core_rounded));
+        cJSON_AddItemToArray(unpinned_array, cJSON_CreateNumber(unpinned_rounded));
+    }
+
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+    // Interrupt and critical-section time per core (see sysmon_irq.h)
+    cJSON *irq_array = cJSON_AddArrayToObject(cpu, "coresIrq");
+    cJSON *irq_max_array = cJSON_AddArrayToObject(cpu, "coresIrqMaxUs");
+    if (irq_array == NULL || irq_max_array == NULL)
+    {
+        JSON_CLEANUP(cpu);
+        return NULL;
+    }
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        double irq_rounded = round(newest->cpu_core_irq_percent[core] * 100.0) / 100.0;
+        cJSON_AddItemToArray(irq_array, cJSON_CreateNumber(irq_rounded));
+        cJSON_AddItemToArray(irq_max_array, cJSON_CreateNumber((double)snapshot->irq_max_us[core]));
+    }
+#endif
+
     return cpu;
 }
 
 /**
  * @brief Build memory summary JSON object.
  *
- * @param read_index Index into series arrays for latest sample.
+ * @param newest Newest values of the pinned snapshot.
  * @return Memory summary JSON object, or NULL on allocation failure.
  */
-static cJSON *_build_memory_summary(int read_index)
+static cJSON *_build_memory_summary(const SysMonSampleValues *newest)
 {
     cJSON *mem = cJSON_CreateObject();
     if (mem == NULL)
@@ -176,10 +213,10 @@ static cJSON *_build_memory_summary(int read_index)
         JSON_CLEANUP(mem);
         return NULL;
     }
-    cJSON_AddNumberToObject(dram, "free", (double)self.dram_free[read_index]);
-    cJSON_AddNumberToObject(dram, "largest", (double)self.dram_largest_block[read_index]);
-    cJSON_AddNumberToObject(dram, "total", (double)self.dram_total[read_index]);
-    cJSON_AddNumberToObject(dram, "usedPct", (double)self.dram_used_percent[read_index]);
+    cJSON_AddNumberToObject(dram, "free", (double)newest->dram_free);
+    cJSON_AddNumberToObject(dram, "largest", (double)newest->dram_largest_block);
+    cJSON_AddNumberToObject(dram, "total", (double)newest->dram_total);
+    cJSON_AddNumberToObject(dram, "usedPct", (double)newest->dram_used_percent);
     cJSON_AddItemToObject(mem, "dram", dram);
 
     // PSRAM stats
@@ -189,15 +226,72 @@ static cJSON *_build_memory_summary(int read_index)
         JSON_CLEANUP(mem);
         return NULL;
     }
-    cJSON_AddNumberToObject(psram, "free", (double)self.psram_free[read_index]);
-    cJSON_AddNumberToObject(psram, "total", (double)self.psram_total[read_index]);
-    cJSON_AddNumberToObject(psram, "usedPct", (double)self.psram_used_percent[read_index]);
+    cJSON_AddNumberToObject(psram, "free", (double)newest->psram_free);
+    cJSON_AddNumberToObject(psram, "total", (double)newest->psram_total);
+    cJSON_AddNumberToObject(psram, "usedPct", (double)newest->psram_used_percent);
     cJSON_AddBoolToObject(psram, "present", self.psram_seen);
     cJSON_AddItemToObject(mem, "psram", psram);
 
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+    // Allocations made from ISRs or by tasks the sampler has not attached yet
+    SysMonTaskHeapCounters unattributed;
+    _heap_task_read_unattributed(&unattributed);
+    cJSON *heap_unattributed = cJSON_CreateObject();
+    if (heap_unattributed == NULL)
+    {
+        JSON_CLEANUP(mem);
+        return NULL;
+    }
+    cJSON_AddNumberToObject(heap_unattributed, "allocBytes", (double)unattributed.alloc_bytes);
+    cJSON_AddNumberToObject(heap_unattributed, "allocs", (double)unattributed.alloc_count);
+    cJSON_AddNumberToObject(heap_unattributed, "frees", (double)unattributed.free_count);
+    cJSON_AddItemToObject(mem, "heapUnattributed", heap_unattributed);
+#endif
+
     return mem;
 }
 
+/**
+ * @brief Get estimated usage of an NVS partition.
+ *
+ * @param part NVS partition.
+ * @param used_bytes Output parameter for used bytes.
+ * @param free_bytes Output parameter for free bytes.
+ * @return true if nvs_get_stats() succeeded, false otherwise.
+ *
+ * Reads the NVS page state kept in RAM (no flash access), so it is cheap
+ * enough for the periodic /hardware refresh.
+ */
+static bool _get_nvs_usage(const esp_partition_t *part, uint32_t *used_bytes, uint32_t *free_bytes)
+{
+    nvs_stats_t nvs_stats;
+    esp_err_t err = nvs_get_stats(part->label, &nvs_stats);
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(LOG_TAG, "nvs_get_stats() failed for partition '%s': %s (0x%x). Usage stats unavailable.", 
+                 part->label, esp_err_to_name(err), err);
+        return false;
+    }
+
+    // NVS doesn't directly give bytes, but we can estimate
+    // Each entry has overhead, so we calculate based on entries
+    // This is approximate - NVS has variable entry sizes
+    uint32_t total_entries = nvs_stats.used_entries + nvs_stats.free_entries;
+    if (total_entries > 0)
+    {
+        // Estimate: used entries / total entries * partition size
+        *used_bytes = (uint32_t)((double)nvs_stats.used_entries / 
+                                (double)total_entries * part->size);
+        *free_bytes = part->size - *used_bytes;
+    }
+    else
+    {
+        *used_bytes = 0;
+        *free_bytes = part->size;
+    }
+    return true;
+}
+
 /**
  * @brief Get usage statistics for a partition based on its type.
  *
@@ -208,7 +302,9 @@ static cJSON *_build_memory_summary(int read_index)
  *
  * Details:
  *   - For NVS partitions: Uses nvs_get_stats() to get actual usage.
- *   - For App partitions: Assumes fully used (contains firmware).
+ *   - For App partitions: Sums the image segment sizes read from flash
+ *     (assumes fully used if the image header cannot be read).
+ *   - For the flash log partition (CONFIG_SYSMON_FLASHLOG): Sectors holding log data.
  *   - For other partition types: Returns false (stats not available).
  */
 static bool _get_partition_usage(const esp_partition_t *part, 
@@ -223,36 +319,18 @@ static bool _get_partition_usage(const esp_partition_t *part,
     *used_bytes = 0;
     *free_bytes = 0;
 
+    // sysmon's own flash log partition
+    if (_flashlog_get_usage(part, used_bytes, free_bytes))
+    {
+        return true;
+    }
+
     // NVS partitions - can get actual usage stats
     if (part->type == ESP_PARTITION_TYPE_DATA && 
-        part->subtype == ESP_PARTITION_SUBTYPE_DATA_NVS)
+        part->subtype == ESP_PARTITION_SUBTYPE_DATA_NVS &&
+        _get_nvs_usage(part, used_bytes, free_bytes))
     {
-        nvs_stats_t nvs_stats;
-        esp_err_t err = nvs_get_stats(part->label, &nvs_stats);
-        if (err == ESP_OK)
-        {
-            // NVS doesn't directly give bytes, but we can estimate
-            // Each entry has overhead, so we calculate based on entries
-            // This is approximate - NVS has variable entry sizes
-            uint32_t total_entries = nvs_stats.used_entries + nvs_stats.free_entries;
-            if (total_entries > 0)
-            {
-                // Estimate: used entries / total entries * partition size
-                *used_bytes = (uint32_t)((double)nvs_stats.used_entries / 
-                                        (double)total_entries * part->size);
-                *free_bytes = part->size - *used_bytes;
-            }
-            else
-            {
-                *free_bytes = part->size;
-            }
-            return true;
-        }
-        else
-        {
-            ESP_LOGW(LOG_TAG, "nvs_get_stats() failed for partition '%s': %s (0x%x). Usage stats unavailable.", 
-                     part->label, esp_err_to_name(err), err);
-        }
+        return true;
     }
 
     // App partitions - read actual image size from image header
@@ -325,6 +403,59 @@ static bool _get_partition_usage(const esp_partition_t *part,
     return false;
 }
 
+/**
+ * @brief Set a number member of a JSON object, adding it if missing.
+ *
+ * @param object JSON object.
+ * @param key Member name.
+ * @param value New value.
+ */
+static void _set_json_number(cJSON *object, const char *key, double value)
+{
+    cJSON *item = cJSON_GetObjectItem(object, key);
+    if (item != NULL && cJSON_IsNumber(item))
+    {
+        cJSON_SetNumberValue(item, value);
+    }
+    else
+    {
+        cJSON_DeleteItemFromObject(object, key);
+        cJSON_AddNumberToObject(object, key, value);
+    }
+}
+
+/**
+ * @brief Set the usage members (usageAvailable, used, free, usedPct) of a partition object.
+ *
+ * @param part_obj Partition JSON object.
+ * @param part_size Partition size in bytes.
+ * @param usage_available Whether usage stats are available.
+ * @param used_bytes Used bytes.
+ * @param free_bytes Free bytes.
+ */
+static void _set_partition_usage_json(cJSON *part_obj, uint32_t part_size, bool usage_available,
+                                      uint32_t used_bytes, uint32_t free_bytes)
+{
+    cJSON_DeleteItemFromObject(part_obj, "usageAvailable");
+    cJSON_AddBoolToObject(part_obj, "usageAvailable", usage_available);
+    if (!usage_available)
+    {
+        return;
+    }
+
+    _set_json_number(part_obj, "used", (double)used_bytes);
+    _set_json_number(part_obj, "free", (double)free_bytes);
+    if (part_size > 0)
+    {
+        double used_pct = ((double)used_bytes / (double)part_size) * 100.0;
+        _set_json_number(part_obj, "usedPct", used_pct);
+    }
+    else
+    {
+        _set_json_number(part_obj, "usedPct", 0.0);
+    }
+}
+
 /**
  * @brief Build partitions JSON array.
  *
@@ -388,22 +519,7 @@ static cJSON *_build_partitions_json(void)
         uint32_t used_bytes = 0;
         uint32_t free_bytes = 0;
         bool usage_available = _get_partition_usage(part, &used_bytes, &free_bytes);
-        
-        cJSON_AddBoolToObject(part_obj, "usageAvailable", usage_available);
-        if (usage_available)
-        {
-            cJSON_AddNumberToObject(part_obj, "used", (double)used_bytes);
-            cJSON_AddNumberToObject(part_obj, "free", (double)free_bytes);
-            if (part->size > 0)
-            {
-                double used_pct = ((double)used_bytes / (double)part->size) * 100.0;
-                cJSON_AddNumberToObject(part_obj, "usedPct", used_pct);
-            }
-            else
-            {
-                cJSON_AddNumberToObject(part_obj, "usedPct", 0.0);
-            }
-        }
+        _set_partition_usage_json(part_obj, part->size, usage_available, used_bytes, free_bytes);
 
         cJSON_AddItemToArray(partitions, part_obj);
         it = esp_partition_next(it);
@@ -413,12 +529,91 @@ static cJSON *_build_partitions_json(void)
     return partitions;
 }
 
+/**
+ * @brief Build the sampler self-metrics JSON object.
+ *
+ * @param snapshot Pinned snapshot to read from.
+ * @return Self-metrics JSON object, or NULL on allocation failure.
+ */
+static cJSON *_build_self_metrics(const SysMonSnapshot *snapshot)
+{
+    const SysMonSelfMetrics *metrics = &snapshot->self_metrics;
+
+    cJSON *self_obj = cJSON_CreateObject();
+    if (self_obj == NULL)
+    {
+        return NULL;
+    }
+
+    cJSON_AddNumberToObject(self_obj, "sampleTimeMs", (double)metrics->sample_time_us / 1000.0);
+    cJSON_AddNumberToObject(self_obj, "intervalMs", (double)snapshot->interval_ms);
+    cJSON_AddNumberToObject(self_obj, "sampleCount", (double)snapshot->sample_count);
+    cJSON_AddNumberToObject(self_obj, "samplingGeneration", (double)snapshot->sampling_generation);
+    cJSON_AddNumberToObject(self_obj, "periodUs", (double)metrics->period_us);
+    cJSON_AddNumberToObject(self_obj, "jitterUs", (double)metrics->jitter_us);
+    cJSON_AddNumberToObject(self_obj, "jitterMaxUs", (double)metrics->jitter_max_us);
+    cJSON_AddNumberToObject(self_obj, "latencyUs", (double)metrics->latency_us);
+    cJSON_AddNumberToObject(self_obj, "latencyMaxUs", (double)metrics->latency_max_us);
+    cJSON_AddNumberToObject(self_obj, "workUs", (double)metrics->work_us);
+    cJSON_AddNumberToObject(self_obj, "workAvgUs", (double)metrics->work_avg_us);
+    cJSON_AddNumberToObject(self_obj, "workMaxUs", (double)metrics->work_max_us);
+    cJSON_AddNumberToObject(self_obj, "cpuPercent", (double)metrics->cpu_percent);
+    cJSON_AddNumberToObject(self_obj, "overruns", (double)metrics->overruns);
+    cJSON_AddNumberToObject(self_obj, "span", (double)metrics->span);
+    cJSON_AddNumberToObject(self_obj, "adaptiveFactor", (double)metrics->adaptive_factor);
+
+    return self_obj;
+}
+
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+/**
+ * @brief Build the custom metrics JSON object keyed by metric name.
+ *
+ * @param snapshot Pinned snapshot to read from.
+ * @return Custom metrics JSON object, or NULL on allocation failure.
+ *
+ * Details:
+ *   - Each entry is {"type", "value"}; counters add "total", the running total,
+ *     while "value" is the increase over the newest interval.
+ */
+static cJSON *_build_custom_metrics(const SysMonSnapshot *snapshot)
+{
+    cJSON *custom = cJSON_CreateObject();
+    if (custom == NULL)
+    {
+        return NULL;
+    }
+
+    for (int i = 0; i < snapshot->custom_metric_count; i++)
+    {
+        sysmon_metric_type_t type;
+        const char *name = _custom_get_metric(i, &type);
+        cJSON *metric = cJSON_CreateObject();
+        if (name == NULL || metric == NULL)
+        {
+            cJSON_Delete(metric);
+            continue;
+        }
+        bool is_counter = (type == SYSMON_METRIC_COUNTER);
+        cJSON_AddStringToObject(metric, "type", is_counter ? "counter" : "gauge");
+        cJSON_AddNumberToObject(metric, "value", (double)snapshot->newest.custom_metric_values[i]);
+        if (is_counter)
+        {
+            cJSON_AddNumberToObject(metric, "total", (double)snapshot->custom_metric_totals[i]);
+        }
+        cJSON_AddItemToObject(custom, name, metric);
+    }
+    return custom;
+}
+#endif
+
 /**
  * @brief Build current task usage JSON object.
  *
+ * @param snapshot Pinned snapshot to read from.
  * @return Current task usage JSON object, or NULL on allocation failure.
  */
-static cJSON *_build_current_task_usage(void)
+static cJSON *_build_current_task_usage(const SysMonSnapshot *snapshot)
 {
     cJSON *current = cJSON_CreateObject();
     if (current == NULL)
@@ -426,14 +621,10 @@ static cJSON *_build_current_task_usage(void)
         return NULL;
     }
 
-    for (int i = 0; i < self.task_capacity; i++)
+    for (int i = 0; i < snapshot->task_count; i++)
     {
-        if (!self.tasks || !self.tasks[i].is_active)
-        {
-            continue;
-        }
+        const SysMonTaskSnapshot *task = &snapshot->tasks[i];
 
-        int read_index = (self.tasks[i].write_index - 1 + CONFIG_SYSMON_SAMPLE_COUNT) % CONFIG_SYSMON_SAMPLE_COUNT;
         cJSON *task_obj = cJSON_CreateObject();
         if (task_obj == NULL)
         {
@@ -441,24 +632,56 @@ static cJSON *_build_current_task_usage(void)
             return NULL;
         }
         // Round CPU usage to 2 decimal places (XX.XX%)
-        float cpu_raw = self.tasks[i].usage_percent_history[read_index];
+        float cpu_raw = task->usage_percent;
         double cpu_rounded = round(cpu_raw * 100.0) / 100.0;
         cJSON_AddNumberToObject(task_obj, "cpu", cpu_rounded);
 
-        double stack_bytes = (double)self.tasks[i].stack_usage_bytes_history[read_index];
-        double stack_pct   = (double)self.tasks[i].stack_usage_percent_history[read_index];
+        double stack_bytes = (double)task->stack_usage_bytes;
+        double stack_pct   = (double)task->stack_usage_percent;
         cJSON_AddNumberToObject(task_obj, "stack", stack_bytes);
         cJSON_AddNumberToObject(task_obj, "stackPct", stack_pct);
 
         // Only include stackRemaining if stack & stackPct are nonzero
         if (stack_bytes > 0.0 && stack_pct > 0.0)
         {
-            uint32_t stack_remaining_bytes = self.tasks[i].stack_high_water_mark * sizeof(StackType_t);
+            uint32_t stack_remaining_bytes = task->stack_high_water_mark * sizeof(StackType_t);
             cJSON_AddNumberToObject(task_obj, "stackRemaining", (double)stack_remaining_bytes);
         }
 
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+        // Heap activity since the task was first seen (the free hook reports no sizes)
+        cJSON *heap_obj = cJSON_AddObjectToObject(task_obj, "heap");
+        if (heap_obj != NULL)
+        {
+            cJSON_AddNumberToObject(heap_obj, "allocBytes", (double)task->heap_alloc_bytes);
+            cJSON_AddNumberToObject(heap_obj, "allocs", (double)task->heap_alloc_count);
+            cJSON_AddNumberToObject(heap_obj, "frees", (double)task->heap_free_count);
+        }
+#endif
+#ifdef CONFIG_SYSMON_TRACE
+        // Scheduler figures of the last sample interval (see '/trace' for the histograms)
+        cJSON *trace_obj = cJSON_AddObjectToObject(task_obj, "trace");
+        if (trace_obj != NULL)
+        {
+            cJSON_AddNumberToObject(trace_obj, "switchRate", round(task->trace_switch_rate * 10.0) / 10.0);
+            cJSON_AddNumberToObject(trace_obj, "preemptions", (double)task->trace_preemptions);
+            cJSON_AddNumberToObject(trace_obj, "readyLatencyMaxUs", (double)task->trace_latency_max_us);
+        }
+#endif
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+        // IRQ rows carry the core's interrupt time; tasks the share moved out of their 'cpu'
+        if (task->irq_row)
+        {
+            cJSON_AddBoolToObject(task_obj, "irqRow", true);
+        }
+        else
+        {
+            cJSON_AddNumberToObject(task_obj, "irq", round(task->irq_percent * 100.0) / 100.0);
+        }
+#endif
+
         // Use display name for JSON key (renames "main" to "app_main")
-        const char *display_name = _get_task_display_name(self.tasks[i].task_name);
+        const char *display_name = _get_task_display_name(task->task_name);
         cJSON_AddItemToObject(current, display_name, task_obj);
     }
 
@@ -470,165 +693,809 @@ static cJSON *_build_current_task_usage(void)
 // ============================================================================
 
 /**
- * @brief Build task metadata JSON object for all monitored tasks.
+ * @brief Ring index of a sample in a snapshot's history window.
+ *
+ * @param snapshot Pinned snapshot.
+ * @param sequence Sequence number of a sample of the window.
+ * @return Ring index.
+ */
+static int _history_ring_index(const SysMonSnapshot *snapshot, uint32_t sequence)
+{
+    int slots = snapshot->history->slots;
+    return (snapshot->newest_index - (int)(snapshot->sequence - sequence) + slots) % slots;
+}
+
+/**
+ * @brief Stream a float ring buffer segment as a JSON array rounded to 1 decimal place.
+ *
+ * Samples the sampler reused while the snapshot was pinned are emitted as null.
+ *
+ * @param stream Stream writer.
+ * @param snapshot Pinned snapshot the ring belongs to.
+ * @param task Task the ring belongs to (NULL for a global series).
+ * @param ring Ring buffer.
+ * @param first Sequence number of the first (oldest) sample to emit.
+ * @param count Number of samples to emit.
+ */
+static void _stream_float_ring(sysmon_stream_t *stream, const SysMonSnapshot *snapshot,
+                               const SysMonTaskSnapshot *task, const float *ring, uint32_t first, uint32_t count)
+{
+    _stream_puts(stream, "[");
+    for (uint32_t j = 0; j < count; j++)
+    {
+        float value = ring[_history_ring_index(snapshot, first + j)];
+        if (j > 0)
+        {
+            _stream_puts(stream, ",");
+        }
+        if (_snapshot_sample_intact(snapshot, task, first + j))
+        {
+            _stream_printf(stream, "%g", round(value * 10.0) / 10.0);
+        }
+        else
+        {
+            _stream_puts(stream, "null");
+        }
+    }
+    _stream_puts(stream, "]");
+}
+
+/**
+ * @brief Stream a uint32 ring buffer segment as a JSON array.
+ *
+ * Samples the sampler reused while the snapshot was pinned are emitted as null.
+ *
+ * @param stream Stream writer.
+ * @param snapshot Pinned snapshot the ring belongs to.
+ * @param task Task the ring belongs to (NULL for a global series).
+ * @param ring Ring buffer.
+ * @param first Sequence number of the first (oldest) sample to emit.
+ * @param count Number of samples to emit.
+ */
+static void _stream_u32_ring(sysmon_stream_t *stream, const SysMonSnapshot *snapshot,
+                             const SysMonTaskSnapshot *task, const uint32_t *ring, uint32_t first, uint32_t count)
+{
+    _stream_puts(stream, "[");
+    for (uint32_t j = 0; j < count; j++)
+    {
+        uint32_t value = ring[_history_ring_index(snapshot, first + j)];
+        if (j > 0)
+        {
+            _stream_puts(stream, ",");
+        }
+        if (_snapshot_sample_intact(snapshot, task, first + j))
+        {
+            _stream_printf(stream, "%" PRIu32, value);
+        }
+        else
+        {
+            _stream_puts(stream, "null");
+        }
+    }
+    _stream_puts(stream, "]");
+}
+
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+/**
+ * @brief Stream an int32 ring buffer segment as a JSON array.
+ *
+ * Samples the sampler reused while the snapshot was pinned are emitted as null.
+ *
+ * @param stream Stream writer.
+ * @param snapshot Pinned snapshot the ring belongs to.
+ * @param ring Ring buffer.
+ * @param first Sequence number of the first (oldest) sample to emit.
+ * @param count Number of samples to emit.
+ */
+static void _stream_i32_ring(sysmon_stream_t *stream, const SysMonSnapshot *snapshot, const int32_t *ring,
+                             uint32_t first, uint32_t count)
+{
+    _stream_puts(stream, "[");
+    for (uint32_t j = 0; j < count; j++)
+    {
+        int32_t value = ring[_history_ring_index(snapshot, first + j)];
+        if (j > 0)
+        {
+            _stream_puts(stream, ",");
+        }
+        if (_snapshot_sample_intact(snapshot, NULL, first + j))
+        {
+            _stream_printf(stream, "%" PRId32, value);
+        }
+        else
+        {
+            _stream_puts(stream, "null");
+        }
+    }
+    _stream_puts(stream, "]");
+}
+#endif
+
+/**
+ * @brief Stream the full history window keyed by task name.
+ *
+ * @param stream Stream writer.
+ * @param snapshot Pinned snapshot to read from.
+ * @param selection Tasks to emit (indices into snapshot->tasks).
+ */
+static void _stream_history_full(sysmon_stream_t *stream, const SysMonSnapshot *snapshot,
+                                 const SysMonTaskSelection *selection)
+{
+    uint32_t count = (uint32_t)snapshot->sample_count;
+    uint32_t first = snapshot->sequence - count + 1;
+    _stream_puts(stream, "{");
+    for (int i = 0; i < selection->count; i++)
+    {
+        const SysMonTaskSnapshot *task = &snapshot->tasks[selection->index[i]];
+        const float *cpu_ring = SYSMON_TASK_RING(snapshot->history, usage_percent, task->slot);
+        const uint32_t *stack_ring = SYSMON_TASK_RING(snapshot->history, stack_usage_bytes, task->slot);
+
+        // Use display name for JSON key (renames "main" to "app_main")
+        const char *display_name = _get_task_display_name(task->task_name);
+        if (i > 0)
+        {
+            _stream_puts(stream, ",");
+        }
+        _stream_json_string(stream, display_name);
+
+        // CPU history array, starting from the oldest sample of the window
+        _stream_puts(stream, ":{\"cpu\":");
+        _stream_float_ring(stream, snapshot, task, cpu_ring, first, count);
+
+        // Stack history array (only for registered tasks)
+        if (task->stack_size_bytes > 0U)
+        {
+            _stream_puts(stream, ",\"stack\":");
+            _stream_u32_ring(stream, snapshot, task, stack_ring, first, count);
+        }
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+        // Bytes allocated by the task in each sampling interval
+        _stream_puts(stream, ",\"heapAlloc\":");
+        _stream_u32_ring(stream, snapshot, task, SYSMON_TASK_RING(snapshot->history, heap_alloc_bytes, task->slot),
+                         first, count);
+#endif
+        _stream_puts(stream, "}");
+    }
+    _stream_puts(stream, "}");
+}
+
+/**
+ * @brief Stream only the samples newer than a client cursor.
  *
- * @return Pointer to root cJSON object (must be freed by caller), or NULL on oom.
+ * @param stream Stream writer.
+ * @param snapshot Pinned snapshot to read from.
+ * @param since Client cursor: sequence number of the newest sample it already has.
+ * @param selection Tasks to emit (indices into snapshot->tasks).
  *
  * Details:
- *   - Iterates over all known tasks, skipping inactive or missing entries.
- *   - For each active task, emits static task metadata: core, priority, stack sizes.
- *   - Top-level dictionary keys are task names, values are per-task metadata objects.
- *   - Fails safely on allocation errors—frees all partial data.
+ *   - Emits {"seq", "from", "count", "series": {...}, "tasks": {...}}.
+ *   - "from" is the sequence number of the first emitted sample. If it is greater
+ *     than since + 1, the gap was longer than the history window and the client
+ *     should treat its data as discontinuous. A cursor ahead of "seq" (device
+ *     restarted) returns the whole window. Samples the sampler has reused since
+ *     the snapshot was published are never sent, so "from" can also move forward
+ *     while the response is being built.
+ *   - Task rings advance in lockstep with the global series, so the same sequence
+ *     selects the same sample for every series and task. Each task has its own
+ *     "from": a task whose slot was claimed after the response's "from" (a new
+ *     task) only sends the samples since then. Task entries whose slot was taken
+ *     over while the response was built are sent as null.
  */
-cJSON *_create_tasks_json(void)
+static void _stream_history_delta(sysmon_stream_t *stream, const SysMonSnapshot *snapshot, uint32_t since,
+                                  const SysMonTaskSelection *selection)
 {
-    cJSON *root = cJSON_CreateObject();
-    if (root == NULL)
+    uint32_t latest = snapshot->sequence;
+    uint32_t available = (uint32_t)snapshot->available;
+    uint32_t count = 0;
+    if (since < latest)
     {
-        return NULL;
+        count = latest - since;
+    }
+    else if (since > latest)
+    {
+        // Cursor from before a restart; resend everything we have
+        count = available;
+    }
+    if (count > available)
+    {
+        count = available;
     }
+    // Samples the sampler has reused since the publish are not sent at all
+    uint32_t intact_from = _snapshot_intact_from(snapshot);
+    if (count > latest - intact_from + 1)
+    {
+        count = latest - intact_from + 1;
+    }
+    uint32_t from = latest - count + 1;
+    const SysMonHistoryStore *history = snapshot->history;
+
+    _stream_printf(stream, "{\"seq\":%" PRIu32 ",\"from\":%" PRIu32 ",\"count\":%" PRIu32 ",\"series\":{",
+                   latest, from, count);
+    _stream_puts(stream, "\"cpuOverall\":");
+    _stream_float_ring(stream, snapshot, NULL, history->cpu_overall_percent, from, count);
+    _stream_puts(stream, ",\"cpuCores\":[");
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        if (core > 0)
+        {
+            _stream_puts(stream, ",");
+        }
+        _stream_float_ring(stream, snapshot, NULL, SYSMON_CORE_RING(history, cpu_core_percent, core), from, count);
+    }
+    _stream_puts(stream, "],\"cpuCoresUnpinned\":[");
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        if (core > 0)
+        {
+            _stream_puts(stream, ",");
+        }
+        _stream_float_ring(stream, snapshot, NULL, SYSMON_CORE_RING(history, cpu_core_unpinned_percent, core), from,
+                           count);
+    }
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+    _stream_puts(stream, "],\"cpuCoresIrq\":[");
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        if (core > 0)
+        {
+            _stream_puts(stream, ",");
+        }
+        _stream_float_ring(stream, snapshot, NULL, SYSMON_CORE_RING(history, cpu_core_irq_percent, core), from, count);
+    }
+#endif
+    _stream_puts(stream, "],\"dramFree\":");
+    _stream_u32_ring(stream, snapshot, NULL, history->dram_free, from, count);
+    _stream_puts(stream, ",\"dramMinFree\":");
+    _stream_u32_ring(stream, snapshot, NULL, history->dram_min_free, from, count);
+    _stream_puts(stream, ",\"dramLargest\":");
+    _stream_u32_ring(stream, snapshot, NULL, history->dram_largest_block, from, count);
+    _stream_puts(stream, ",\"dramUsedPct\":");
+    _stream_float_ring(stream, snapshot, NULL, history->dram_used_percent, from, count);
+    _stream_puts(stream, ",\"psramFree\":");
+    _stream_u32_ring(stream, snapshot, NULL, history->psram_free, from, count);
+    _stream_puts(stream, ",\"psramUsedPct\":");
+    _stream_float_ring(stream, snapshot, NULL, history->psram_used_percent, from, count);
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+    _stream_puts(stream, ",\"custom\":{");
+    for (int i = 0; i < snapshot->custom_metric_count; i++)
+    {
+        if (i > 0)
+        {
+            _stream_puts(stream, ",");
+        }
+        _stream_json_string(stream, _custom_get_metric(i, NULL));
+        _stream_puts(stream, ":");
+        _stream_i32_ring(stream, snapshot, SYSMON_CUSTOM_RING(history, i), from, count);
+    }
+    _stream_puts(stream, "}");
+#endif
+    _stream_puts(stream, "},\"tasks\":{");
 
-    for (int i = 0; i < self.task_capacity; i++)
+    for (int i = 0; i < selection->count; i++)
     {
-        // Defensive skip for inactive or missing tasks.
-        if (!self.tasks || !self.tasks[i].is_active)
+        const SysMonTaskSnapshot *task = &snapshot->tasks[selection->index[i]];
+        const float *cpu_ring = SYSMON_TASK_RING(history, usage_percent, task->slot);
+        const uint32_t *stack_ring = SYSMON_TASK_RING(history, stack_usage_bytes, task->slot);
+
+        const char *display_name = _get_task_display_name(task->task_name);
+        if (i > 0)
         {
-            continue;
+            _stream_puts(stream, ",");
         }
+        _stream_json_string(stream, display_name);
 
-        cJSON *task_obj = cJSON_CreateObject();
-        if (task_obj == NULL)
+        // A task that took its slot after "from" has no samples of its own before that
+        uint32_t task_from = from;
+        if ((int32_t)(task->since - from) > 0)
         {
-            JSON_CLEANUP(root);
-            return NULL;
+            task_from = task->since;
+        }
+        uint32_t task_count = latest - task_from + 1;
+
+        _stream_printf(stream, ":{\"from\":%" PRIu32 ",\"cpu\":", task_from);
+        _stream_float_ring(stream, snapshot, task, cpu_ring, task_from, task_count);
+        if (task->stack_size_bytes > 0U)
+        {
+            _stream_puts(stream, ",\"stack\":");
+            _stream_u32_ring(stream, snapshot, task, stack_ring, task_from, task_count);
         }
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+        _stream_puts(stream, ",\"heapAlloc\":");
+        _stream_u32_ring(stream, snapshot, task, SYSMON_TASK_RING(history, heap_alloc_bytes, task->slot), task_from,
+                         task_count);
+#endif
+        _stream_puts(stream, "}");
+    }
+    _stream_puts(stream, "}}");
+}
 
-        int read_index = (self.tasks[i].write_index - 1 + CONFIG_SYSMON_SAMPLE_COUNT) % CONFIG_SYSMON_SAMPLE_COUNT;
+#if defined(CONFIG_SYSMON_ROLLUPS) || defined(CONFIG_SYSMON_HEAP_PROFILE)
+/**
+ * @brief Stream one quantized percentage field of consecutive rollup buckets as a JSON array.
+ *
+ * Also used for heap profile entries, which share the strided ring layout.
+ *
+ * @param stream Stream writer.
+ * @param first Field in the tier's first ring bucket.
+ * @param stride Size of one bucket in bytes.
+ * @param slots Tier ring length.
+ * @param start_index Ring index of the first (oldest) bucket to emit.
+ * @param count Number of buckets to emit.
+ */
+static void _stream_rollup_percent(sysmon_stream_t *stream, const uint16_t *first, size_t stride,
+                                   int slots, int start_index, uint32_t count)
+{
+    _stream_puts(stream, "[");
+    int read_index = start_index;
+    for (uint32_t j = 0; j < count; j++)
+    {
+        uint16_t value = *(const uint16_t *)((const uint8_t *)first + stride * (size_t)read_index);
+        _stream_printf(stream, (j == 0) ? "%g" : ",%g", value / 100.0);
+        read_index = (read_index + 1) % slots;
+    }
+    _stream_puts(stream, "]");
+}
 
-        cJSON_AddNumberToObject(task_obj, "core", self.tasks[i].core_id);
-        cJSON_AddNumberToObject(task_obj, "prio", (double)self.tasks[i].current_priority);
-        cJSON_AddNumberToObject(task_obj, "stackSize", (double)self.tasks[i].stack_size_bytes);
+/**
+ * @brief Stream one uint32 field of consecutive rollup buckets as a JSON array.
+ *
+ * @param stream Stream writer.
+ * @param first Field in the tier's first ring bucket.
+ * @param stride Size of one bucket in bytes.
+ * @param slots Tier ring length.
+ * @param start_index Ring index of the first (oldest) bucket to emit.
+ * @param count Number of buckets to emit.
+ */
+static void _stream_rollup_u32(sysmon_stream_t *stream, const uint32_t *first, size_t stride,
+                               int slots, int start_index, uint32_t count)
+{
+    _stream_puts(stream, "[");
+    int read_index = start_index;
+    for (uint32_t j = 0; j < count; j++)
+    {
+        uint32_t value = *(const uint32_t *)((const uint8_t *)first + stride * (size_t)read_index);
+        _stream_printf(stream, (j == 0) ? "%" PRIu32 : ",%" PRIu32, value);
+        read_index = (read_index + 1) % slots;
+    }
+    _stream_puts(stream, "]");
+}
+#endif // CONFIG_SYSMON_ROLLUPS || CONFIG_SYSMON_HEAP_PROFILE
 
-        double stack_bytes = (double)self.tasks[i].stack_usage_bytes_history[read_index];
-        double stack_pct   = (double)self.tasks[i].stack_usage_percent_history[read_index];
+#ifdef CONFIG_SYSMON_ROLLUPS
+/**
+ * @brief Stream a min/avg/max statistic of consecutive rollup buckets as {"min","avg","max"} arrays.
+ *
+ * @param stream Stream writer.
+ * @param first Statistic in the tier's first ring bucket.
+ * @param stride Size of one bucket in bytes.
+ * @param slots Tier ring length.
+ * @param start_index Ring index of the first (oldest) bucket to emit.
+ * @param count Number of buckets to emit.
+ */
+static void _stream_rollup_stat(sysmon_stream_t *stream, const SysMonRollupStat *first, size_t stride,
+                                int slots, int start_index, uint32_t count)
+{
+    _stream_puts(stream, "{\"min\":");
+    _stream_rollup_percent(stream, &first->min, stride, slots, start_index, count);
+    _stream_puts(stream, ",\"avg\":");
+    _stream_rollup_percent(stream, &first->avg, stride, slots, start_index, count);
+    _stream_puts(stream, ",\"max\":");
+    _stream_rollup_percent(stream, &first->max, stride, slots, start_index, count);
+    _stream_puts(stream, "}");
+}
 
-        cJSON_AddNumberToObject(task_obj, "stackUsed", stack_bytes);
-        cJSON_AddNumberToObject(task_obj, "stackUsedPct", stack_pct);
+/**
+ * @brief Stream a downsampled history tier.
+ *
+ * @param stream Stream writer.
+ * @param snapshot Pinned snapshot to read from.
+ * @param tier Rollup tier index.
+ * @param since Client cursor (newest bucket sequence it already has); ignored unless is_delta.
+ * @param is_delta Whether a cursor was given.
+ * @param selection Tasks to emit (indices into snapshot->tasks).
+ *
+ * Details:
+ *   - Emits {"resolutionMs", "seq", "from", "count", "series": {...}, "tasks": {...}}, with the
+ *     same cursor semantics as _stream_history_delta() but counted in buckets of this tier.
+ *   - Percentages are {"min","avg","max"} arrays; memory fields are per-bucket minimums and
+ *     "stackMax" is the per-bucket peak stack usage (registered tasks only).
+ */
+static void _stream_history_rollup(sysmon_stream_t *stream, const SysMonSnapshot *snapshot, int tier,
+                                   uint32_t since, bool is_delta, const SysMonTaskSelection *selection)
+{
+    const SysMonRollupTier *description = _rollup_get_tier(tier);
+    uint32_t latest = snapshot->rollup_sequence[tier];
+    uint32_t available = (latest < (uint32_t)description->bucket_count) ? latest : (uint32_t)description->bucket_count;
+    uint32_t count = available;
+    if (is_delta && since <= latest)
+    {
+        count = latest - since;
+    }
+    if (count > available)
+    {
+        count = available;
+    }
+    uint32_t from = latest - count + 1;
+
+    // Bucket number n (1-based) lives at ring index (n - 1) % slots
+    int start = (int)((from - 1) % (uint32_t)description->slots);
+    int slots = description->slots;
+    const SysMonSeriesRollup *series = &self.series_rollups[description->offset];
+    size_t series_stride = sizeof(SysMonSeriesRollup);
+
+    _stream_printf(stream, "{\"resolutionMs\":%" PRIu32 ",\"seq\":%" PRIu32 ",\"from\":%" PRIu32
+                   ",\"count\":%" PRIu32 ",\"series\":{", _rollup_tier_resolution_ms(tier), latest, from, count);
+    _stream_puts(stream, "\"cpuOverall\":");
+    _stream_rollup_stat(stream, &series->cpu_overall, series_stride, slots, start, count);
+    _stream_puts(stream, ",\"cpuCores\":[");
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        if (core > 0)
+        {
+            _stream_puts(stream, ",");
+        }
+        _stream_rollup_stat(stream, &series->cpu_core[core], series_stride, slots, start, count);
+    }
+    _stream_puts(stream, "],\"dramUsedPct\":");
+    _stream_rollup_stat(stream, &series->dram_used_percent, series_stride, slots, start, count);
+    _stream_puts(stream, ",\"psramUsedPct\":");
+    _stream_rollup_stat(stream, &series->psram_used_percent, series_stride, slots, start, count);
+    _stream_puts(stream, ",\"dramMinFree\":");
+    _stream_rollup_u32(stream, &series->dram_free_min, series_stride, slots, start, count);
+    _stream_puts(stream, ",\"dramMinLargest\":");
+    _stream_rollup_u32(stream, &series->dram_largest_min, series_stride, slots, start, count);
+    _stream_puts(stream, ",\"psramMinFree\":");
+    _stream_rollup_u32(stream, &series->psram_free_min, series_stride, slots, start, count);
+    _stream_puts(stream, "},\"tasks\":{");
+
+    for (int i = 0; i < selection->count; i++)
+    {
+        const SysMonTaskSnapshot *task = &snapshot->tasks[selection->index[i]];
+        const SysMonTaskRollup *rollups = SYSMON_TASK_ROLLUPS(snapshot->history, task->slot) + description->offset;
 
-        // Only include stackRemaining if stack & stackPct are nonzero
-        if (stack_bytes > 0.0 && stack_pct > 0.0)
+        if (i > 0)
         {
-            uint32_t stack_remaining_bytes = self.tasks[i].stack_high_water_mark * sizeof(StackType_t);
-            cJSON_AddNumberToObject(task_obj, "stackRemaining", (double)stack_remaining_bytes);
+            _stream_puts(stream, ",");
+        }
+        _stream_json_string(stream, _get_task_display_name(task->task_name));
+
+        _stream_puts(stream, ":{\"cpu\":");
+        _stream_rollup_stat(stream, &rollups->cpu, sizeof(SysMonTaskRollup), slots, start, count);
+        if (task->stack_size_bytes > 0U)
+        {
+            _stream_puts(stream, ",\"stackMax\":");
+            _stream_rollup_u32(stream, &rollups->stack_max, sizeof(SysMonTaskRollup), slots, start, count);
         }
+        _stream_puts(stream, "}");
+    }
+    _stream_puts(stream, "}}");
+}
+#endif // CONFIG_SYSMON_ROLLUPS
+
+/**
+ * @brief Stream task metadata JSON for the monitored tasks matching the request's task query.
+ *
+ * @param request HTTP request to stream the response on.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the writer or selection cannot be allocated,
+ *         or the first chunk send error.
+ *
+ * Details:
+ *   - Top-level keys are task names, values are {"core", "prio", "stackSize", "stackUsed",
+ *     "stackUsedPct"} plus "stackRemaining" for registered tasks with a measured usage.
+ *   - Only tasks selected by the task query are encoded (see sysmon_query.h); ranked
+ *     queries emit the keys highest rank first.
+ */
+esp_err_t _stream_tasks_json(httpd_req_t *request)
+{
+    SysMonTaskQuery query;
+    const char *query_error = NULL;
+    esp_err_t parse_err = _task_query_parse(request, &query, &query_error);
+    if (parse_err == ESP_ERR_NO_MEM)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    if (parse_err != ESP_OK)
+    {
+        return httpd_resp_send_err(request, HTTPD_400_BAD_REQUEST, query_error);
+    }
+
+    sysmon_stream_t *stream = (sysmon_stream_t *)malloc(sizeof(sysmon_stream_t));
+    if (stream == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    const SysMonSnapshot *snapshot = _snapshot_acquire();
+    SysMonTaskSelection selection;
+    if (_task_query_select(&query, snapshot, &selection) != ESP_OK)
+    {
+        _snapshot_release(snapshot);
+        free(stream);
+        return ESP_ERR_NO_MEM;
+    }
+    _stream_begin(stream, request);
+
+    _stream_puts(stream, "{");
+    for (int i = 0; i < selection.count; i++)
+    {
+        const SysMonTaskSnapshot *task = &snapshot->tasks[selection.index[i]];
+        uint32_t stack_bytes = task->stack_usage_bytes;
+        float stack_pct = task->stack_usage_percent;
 
         // Use display name for JSON key (renames "main" to "app_main")
-        const char *display_name = _get_task_display_name(self.tasks[i].task_name);
-        cJSON_AddItemToObject(root, display_name, task_obj);
+        if (i > 0)
+        {
+            _stream_puts(stream, ",");
+        }
+        _stream_json_string(stream, _get_task_display_name(task->task_name));
+        _stream_printf(stream, ":{\"core\":%d,\"prio\":%u,\"stackSize\":%" PRIu32 ",\"stackUsed\":%" PRIu32
+                       ",\"stackUsedPct\":%g", task->core_id, (unsigned)task->current_priority,
+                       task->stack_size_bytes, stack_bytes, round(stack_pct * 100.0) / 100.0);
+
+        // Only include stackRemaining if stack & stackPct are nonzero
+        if (stack_bytes > 0U && stack_pct > 0.0f)
+        {
+            _stream_printf(stream, ",\"stackRemaining\":%" PRIu32,
+                           (uint32_t)(task->stack_high_water_mark * sizeof(StackType_t)));
+        }
+        _stream_puts(stream, "}");
     }
+    _stream_puts(stream, "}");
 
-    return root;
+    esp_err_t result = _stream_end(stream);
+    _task_selection_free(&selection);
+    _snapshot_release(snapshot);
+    free(stream);
+    return result;
 }
 
 /**
- * @brief Build JSON object tracing task usage history for all monitored tasks.
+ * @brief Stream task usage history JSON for all monitored tasks.
  *
- * @return Root cJSON object, or NULL on allocation failure.
+ * @param request HTTP request to stream the response on.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the writer cannot be allocated,
+ *         or the first chunk send error.
  *
  * Details:
- *   - Each key (task name) maps to an object with "cpu" and "stack" arrays.
+ *   - Without parameters, each key (task name) maps to an object with "cpu" and "stack" arrays
+ *     covering the full history window.
+ *   - With ?since=<seq>, only samples newer than the client cursor are returned, for both the
+ *     global series and the per-task rings (see _stream_history_delta()).
+ *   - With ?boot=previous the flight recording of the previous boot is returned instead
+ *     (see _stream_recorder_json(); 404 without CONFIG_SYSMON_RECORDER or a recording).
+ *   - With ?range=<seconds> the flash log entries of that time span are returned instead
+ *     (see _stream_flashlog_json(); 0 returns the whole log).
+ *   - With ?resolution=<seconds> coarser than the sampling interval, the matching rollup tier is
+ *     returned instead (see _stream_history_rollup()); "since" then counts buckets of that tier.
+ *   - The task query parameters (top, by, include, exclude, core; see sysmon_query.h) limit the
+ *     per-task histories to the selected tasks; the global series are always sent.
  *   - "cpu" array contains CPU usage percent samples over time (rounded to 1 decimal place).
  *   - "stack" array contains stack usage in bytes samples over time (only for registered tasks).
  *   - Only active, known tasks included.
  *   - Array order is oldest-to-newest based on cyclic buffer logic.
- *   - All allocations checked for robustness/low-memory resilience.
+ *   - The X-Sysmon-Seq response header carries the sequence number of the newest sample,
+ *     which clients use as their next cursor.
+ *   - Walks the task ring buffers directly and sends fixed-size chunks, so peak
+ *     memory is one chunk buffer regardless of task count or sample count.
  */
-cJSON *_create_history_json(void)
+esp_err_t _stream_history_json(httpd_req_t *request)
 {
-    cJSON *root = cJSON_CreateObject();
-    if (root == NULL)
+    char boot[12] = { 0 };
+    esp_err_t boot_err = _get_query_value(request, "boot", boot, sizeof(boot));
+    if (boot_err == ESP_ERR_NO_MEM)
     {
-        return NULL;
+        return ESP_ERR_NO_MEM;
     }
-
-    for (int i = 0; i < self.task_capacity; i++)
+    if (boot_err != ESP_ERR_NOT_FOUND)
     {
-        if (!self.tasks || !self.tasks[i].is_active)
+        if (strcmp(boot, "previous") != 0)
         {
-            continue;
+            return httpd_resp_send_err(request, HTTPD_400_BAD_REQUEST, "Invalid 'boot' (only 'previous' is supported)");
         }
+        return _stream_recorder_json(request);
+    }
 
-        cJSON *task_obj = cJSON_CreateObject();
-        if (task_obj == NULL)
-        {
-            JSON_CLEANUP(root);
-            return NULL;
-        }
+    uint32_t range_s = 0;
+    esp_err_t range_err = _get_query_uint32(request, "range", &range_s);
+    if (range_err == ESP_ERR_NO_MEM)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    if (range_err == ESP_ERR_INVALID_ARG)
+    {
+        return httpd_resp_send_err(request, HTTPD_400_BAD_REQUEST, "Invalid 'range' in seconds");
+    }
+    if (range_err == ESP_OK)
+    {
+        return _stream_flashlog_json(request, range_s);
+    }
+
+    uint32_t since = 0;
+    esp_err_t query_err = _get_query_uint32(request, "since", &since);
+    if (query_err == ESP_ERR_NO_MEM)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    if (query_err == ESP_ERR_INVALID_ARG)
+    {
+        return httpd_resp_send_err(request, HTTPD_400_BAD_REQUEST, "Invalid 'since' sequence number");
+    }
+    bool is_delta = (query_err == ESP_OK);
+
+    uint32_t resolution_s = 0;
+    esp_err_t resolution_err = _get_query_uint32(request, "resolution", &resolution_s);
+    if (resolution_err == ESP_ERR_NO_MEM)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    if (resolution_err == ESP_ERR_INVALID_ARG)
+    {
+        return httpd_resp_send_err(request, HTTPD_400_BAD_REQUEST, "Invalid 'resolution' in seconds");
+    }
+    uint32_t resolution_ms = (resolution_s > UINT32_MAX / 1000U) ? UINT32_MAX : resolution_s * 1000U;
+    int tier = _rollup_find_tier(resolution_ms);
+
+    SysMonTaskQuery query;
+    const char *query_error = NULL;
+    esp_err_t parse_err = _task_query_parse(request, &query, &query_error);
+    if (parse_err == ESP_ERR_NO_MEM)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    if (parse_err != ESP_OK)
+    {
+        return httpd_resp_send_err(request, HTTPD_400_BAD_REQUEST, query_error);
+    }
+
+    sysmon_stream_t *stream = (sysmon_stream_t *)malloc(sizeof(sysmon_stream_t));
+    if (stream == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Pin one snapshot for the whole response so every series agrees on the same samples
+    const SysMonSnapshot *snapshot = _snapshot_acquire();
+    SysMonTaskSelection selection;
+    if (_task_query_select(&query, snapshot, &selection) != ESP_OK)
+    {
+        _snapshot_release(snapshot);
+        free(stream);
+        return ESP_ERR_NO_MEM;
+    }
+    _stream_begin(stream, request);
+
+    // Header value must stay valid until the first chunk is sent
+    char seq_header[12];
+    snprintf(seq_header, sizeof(seq_header), "%" PRIu32, snapshot->sequence);
+    httpd_resp_set_hdr(request, "X-Sysmon-Seq", seq_header);
+    httpd_resp_set_hdr(request, "Access-Control-Expose-Headers", "X-Sysmon-Seq");
+
+    if (tier >= 0)
+    {
+#ifdef CONFIG_SYSMON_ROLLUPS
+        _stream_history_rollup(stream, snapshot, tier, since, is_delta, &selection);
+#endif
+    }
+    else if (is_delta)
+    {
+        _stream_history_delta(stream, snapshot, since, &selection);
+    }
+    else
+    {
+        _stream_history_full(stream, snapshot, &selection);
+    }
+
+    esp_err_t result = _stream_end(stream);
+    _task_selection_free(&selection);
+    _snapshot_release(snapshot);
+    free(stream);
+    return result;
+}
+
+#ifdef CONFIG_SYSMON_HEAP_PROFILE
+/**
+ * @brief Stream the heap region profile history as a chunked response.
+ *
+ * @param request HTTP request to send the response on.
+ * @return ESP_OK on success, error code otherwise.
+ *
+ * Details:
+ *   - Emits {"intervalMs", "seq", "from", "count", "regions": {...}}; "seq" is the number of
+ *     profiles committed and "from" the sequence number of the first one returned.
+ *   - With '?since=<seq>' only profiles newer than the cursor are returned (bounded by the
+ *     CONFIG_SYSMON_HEAP_PROFILE_COUNT window), mirroring the '/history' delta cursor.
+ *   - Each region present on this target carries "caps" and "total" plus "free", "largest",
+ *     "minFree", "freeBlocks" and "fragPct" arrays, oldest to newest. Regions without any
+ *     heap are omitted.
+ *   - "fragPct" is 100 * (1 - largest / free): 0 when all free memory is one block.
+ */
+esp_err_t _stream_heap_json(httpd_req_t *request)
+{
+    uint32_t since = 0;
+    esp_err_t query_err = _get_query_uint32(request, "since", &since);
+    if (query_err == ESP_ERR_NO_MEM)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    if (query_err == ESP_ERR_INVALID_ARG)
+    {
+        return httpd_resp_send_err(request, HTTPD_400_BAD_REQUEST, "Invalid 'since' sequence number");
+    }
+    bool is_delta = (query_err == ESP_OK);
+
+    sysmon_stream_t *stream = (sysmon_stream_t *)malloc(sizeof(sysmon_stream_t));
+    if (stream == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    _stream_begin(stream, request);
+
+    const SysMonSnapshot *snapshot = _snapshot_acquire();
+    uint32_t latest = (self.heap_profile != NULL) ? snapshot->heap_profile_sequence : 0;
+    uint32_t available = (latest < CONFIG_SYSMON_HEAP_PROFILE_COUNT) ? latest : CONFIG_SYSMON_HEAP_PROFILE_COUNT;
+    uint32_t count = available;
+    if (is_delta && since <= latest)
+    {
+        count = latest - since;
+    }
+    if (count > available)
+    {
+        count = available;
+    }
+    uint32_t from = latest - count + 1;
 
-        // CPU history array
-        cJSON *cpu_array = cJSON_CreateArray();
-        if (cpu_array == NULL)
-        {
-            JSON_CLEANUP(task_obj, root);
-            return NULL;
-        }
+    // Profile number n (1-based) lives at ring index (n - 1) % slots
+    int start = (int)((from - 1) % SYSMON_HEAP_PROFILE_SLOTS);
+    size_t stride = sizeof(SysMonHeapRegionSample);
 
-        // Stack history array (only for registered tasks)
-        cJSON *stack_array = NULL;
-        bool is_registered = (self.tasks[i].stack_size_bytes > 0U);
-        if (is_registered)
+    _stream_printf(stream, "{\"intervalMs\":%" PRIu32 ",\"seq\":%" PRIu32 ",\"from\":%" PRIu32
+                   ",\"count\":%" PRIu32 ",\"regions\":{", _heap_profile_interval_ms(), latest, from, count);
+    bool first_region = true;
+    for (int region = 0; region < SYSMON_HEAP_REGION_COUNT; region++)
+    {
+        const SysMonHeapRegion *description = _heap_get_region(region);
+        size_t total = heap_caps_get_total_size(description->caps);
+        if (total == 0)
         {
-            stack_array = cJSON_CreateArray();
-            if (stack_array == NULL)
-            {
-                JSON_CLEANUP(cpu_array, task_obj, root);
-                return NULL;
-            }
+            continue;
         }
 
-        // Start from current write index (oldest sample).
-        int read_index = self.tasks[i].write_index;
-        for (int j = 0; j < CONFIG_SYSMON_SAMPLE_COUNT; j++)
+        const SysMonHeapRegionSample *ring = (self.heap_profile != NULL) ?
+                                             SYSMON_HEAP_REGION_RING(self.heap_profile, region) : NULL;
+        _stream_printf(stream, "%s\"%s\":{\"caps\":%" PRIu32 ",\"total\":%u",
+                       first_region ? "" : ",", description->name, description->caps, (unsigned)total);
+        first_region = false;
+        if (ring == NULL)
         {
-            // Round CPU usage to 1 decimal place to reduce JSON size
-            float cpu_raw = self.tasks[i].usage_percent_history[read_index];
-            double cpu_rounded = round(cpu_raw * 10.0) / 10.0;
-            cJSON *cpu_value = cJSON_CreateNumber(cpu_rounded);
-            if (cpu_value == NULL)
-            {
-                JSON_CLEANUP(cpu_array, stack_array, task_obj, root);
-                return NULL;
-            }
-            cJSON_AddItemToArray(cpu_array, cpu_value);
-
-            // Only generate stack history for registered tasks
-            if (is_registered)
-            {
-                uint32_t stack_value_bytes = self.tasks[i].stack_usage_bytes_history[read_index];
-                cJSON *stack_value = cJSON_CreateNumber((double)stack_value_bytes);
-                if (stack_value == NULL)
-                {
-                    JSON_CLEANUP(cpu_array, stack_array, task_obj, root);
-                    return NULL;
-                }
-                cJSON_AddItemToArray(stack_array, stack_value);
-            }
-
-            read_index = (read_index + 1) % CONFIG_SYSMON_SAMPLE_COUNT;
+            _stream_puts(stream, "}");
+            continue;
         }
 
-        cJSON_AddItemToObject(task_obj, "cpu", cpu_array);
-        if (is_registered && stack_array != NULL)
+        _stream_puts(stream, ",\"free\":");
+        _stream_rollup_u32(stream, &ring->free_bytes, stride, SYSMON_HEAP_PROFILE_SLOTS, start, count);
+        _stream_puts(stream, ",\"largest\":");
+        _stream_rollup_u32(stream, &ring->largest_free_block, stride, SYSMON_HEAP_PROFILE_SLOTS, start, count);
+        _stream_puts(stream, ",\"minFree\":");
+        _stream_rollup_u32(stream, &ring->minimum_free_bytes, stride, SYSMON_HEAP_PROFILE_SLOTS, start, count);
+        _stream_puts(stream, ",\"freeBlocks\":[");
+        int read_index = start;
+        for (uint32_t j = 0; j < count; j++)
         {
-            cJSON_AddItemToObject(task_obj, "stack", stack_array);
+            _stream_printf(stream, (j == 0) ? "%u" : ",%u", (unsigned)ring[read_index].free_blocks);
+            read_index = (read_index + 1) % SYSMON_HEAP_PROFILE_SLOTS;
         }
-        // Use display name for JSON key (renames "main" to "app_main")
-        const char *display_name = _get_task_display_name(self.tasks[i].task_name);
-        cJSON_AddItemToObject(root, display_name, task_obj);
+        _stream_puts(stream, "],\"fragPct\":");
+        _stream_rollup_percent(stream, &ring->fragmentation, stride, SYSMON_HEAP_PROFILE_SLOTS, start, count);
+        _stream_puts(stream, "}");
     }
+    _stream_puts(stream, "}}");
 
-    return root;
+    esp_err_t result = _stream_end(stream);
+    _snapshot_release(snapshot);
+    free(stream);
+    return result;
 }
+#endif // CONFIG_SYSMON_HEAP_PROFILE
 
 /**
  * @brief Build a complete telemetry JSON object summarizing CPU/memory and current registered task usage.
@@ -637,7 +1504,8 @@ cJSON *_create_history_json(void)
  *
  * Details:
  *   - Produces a two-level structure:
- *       root->summary: {cpu, mem}, root->current: {task current usages}
+ *       root->summary: {cpu, mem}, root->current: {task current usages},
+ *       root->self: sampler timing and cost (see SysMonSelfMetrics)
  *   - 'cpu' includes overall percent + per-core array.
  *   - 'mem' summary embeds DRAM and (if present) PSRAM details.
  *   - Defensive allocation checks propagate errors cleanly upward.
@@ -650,27 +1518,30 @@ cJSON *_create_telemetry_json(void)
         return NULL;
     }
 
-    int read_index = (self.series_write_index - 1 + CONFIG_SYSMON_SAMPLE_COUNT) % CONFIG_SYSMON_SAMPLE_COUNT;
+    const SysMonSnapshot *snapshot = _snapshot_acquire();
 
     // Summary object
     cJSON *summary = cJSON_CreateObject();
     if (summary == NULL)
     {
+        _snapshot_release(snapshot);
         JSON_CLEANUP(root);
         return NULL;
     }
 
-    cJSON *cpu = _build_cpu_summary(read_index);
+    cJSON *cpu = _build_cpu_summary(snapshot);
     if (cpu == NULL)
     {
+        _snapshot_release(snapshot);
         JSON_CLEANUP(summary, root);
         return NULL;
     }
     cJSON_AddItemToObject(summary, "cpu", cpu);
 
-    cJSON *mem = _build_memory_summary(read_index);
+    cJSON *mem = _build_memory_summary(&snapshot->newest);
     if (mem == NULL)
     {
+        _snapshot_release(snapshot);
         JSON_CLEANUP(summary, root);
         return NULL;
     }
@@ -690,8 +1561,31 @@ cJSON *_create_telemetry_json(void)
 
     cJSON_AddItemToObject(root, "summary", summary);
 
+    // Sampler self-metrics
+    cJSON *self_obj = _build_self_metrics(snapshot);
+    if (self_obj == NULL)
+    {
+        _snapshot_release(snapshot);
+        JSON_CLEANUP(root);
+        return NULL;
+    }
+    cJSON_AddItemToObject(root, "self", self_obj);
+
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+    // Application-defined metrics
+    cJSON *custom = _build_custom_metrics(snapshot);
+    if (custom == NULL)
+    {
+        _snapshot_release(snapshot);
+        JSON_CLEANUP(root);
+        return NULL;
+    }
+    cJSON_AddItemToObject(root, "custom", custom);
+#endif
+
     // Current task usage
-    cJSON *current = _build_current_task_usage();
+    cJSON *current = _build_current_task_usage(snapshot);
+    _snapshot_release(snapshot);
     if (current == NULL)
     {
         JSON_CLEANUP(root);
@@ -703,7 +1597,243 @@ cJSON *_create_telemetry_json(void)
 }
 
 /**
- * @brief Create hardware information JSON object with static chip and system info.
+ * @brief Build the sampling configuration JSON object.
+ *
+ * @return Root cJSON object (must be freed by caller), or NULL on oom.
+ *
+ * Details:
+ *   - 'intervalMs' and 'sampleCount' are in effect; 'pending' is true while a
+ *     change queued by sysmon_set_sampling() (or POST /sampling) waits for the
+ *     next sample.
+ *   - 'generation' counts applied changes, so clients can tell when to reload
+ *     their history window.
+ *   - 'adaptive' tells whether CONFIG_SYSMON_ADAPTIVE_SAMPLING is built in;
+ *     'adaptiveFactor' is how many intervals the sampler currently sleeps
+ *     (the request reading it restores full rate within one interval).
+ */
+cJSON *_create_sampling_json(void)
+{
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return NULL;
+    }
+
+    uint32_t interval_ms = 0;
+    uint32_t sample_count = 0;
+    bool pending = sysmon_get_sampling(&interval_ms, &sample_count);
+    cJSON_AddNumberToObject(root, "intervalMs", (double)interval_ms);
+    cJSON_AddNumberToObject(root, "sampleCount", (double)sample_count);
+    cJSON_AddBoolToObject(root, "pending", pending);
+    cJSON_AddNumberToObject(root, "generation", (double)self.sampling_generation);
+    cJSON_AddNumberToObject(root, "baseIntervalMs", (double)CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS);
+    cJSON_AddNumberToObject(root, "minIntervalMs", (double)SYSMON_SAMPLING_INTERVAL_MIN_MS);
+    cJSON_AddNumberToObject(root, "maxIntervalMs", (double)SYSMON_SAMPLING_INTERVAL_MAX_MS);
+    cJSON_AddNumberToObject(root, "minSampleCount", (double)sysmon_get_min_sample_count());
+    cJSON_AddNumberToObject(root, "maxSampleCount", (double)CONFIG_SYSMON_SAMPLE_COUNT_MAX);
+#ifdef CONFIG_SYSMON_ADAPTIVE_SAMPLING
+    cJSON_AddBoolToObject(root, "adaptive", true);
+    cJSON_AddNumberToObject(root, "adaptiveFactor", (double)self.self_metrics.adaptive_factor);
+    cJSON_AddNumberToObject(root, "adaptiveMaxFactor", (double)CONFIG_SYSMON_ADAPTIVE_MAX_FACTOR);
+#else
+    cJSON_AddBoolToObject(root, "adaptive", false);
+#endif
+
+    return root;
+}
+
+#ifdef CONFIG_SYSMON_TRACE
+/**
+ * @brief Build the scheduler trace JSON object (context switches and ready-to-run latency per task).
+ *
+ * @return Root cJSON object (must be freed by caller), or NULL on oom.
+ *
+ * Details:
+ *   - 'hooksInstalled' is false until the first event arrives, which usually
+ *     means sysmon_trace_hooks.h is not force-included into the build.
+ *   - 'latencyBucketsUs' lists the exclusive upper bounds of the histogram
+ *     buckets; the last histogram bucket is open-ended.
+ *   - 'switchRate' and 'readyLatencyMaxUs' cover the last sample interval;
+ *     counts and histograms are cumulative since the task was first seen.
+ */
+cJSON *_create_trace_json(void)
+{
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return NULL;
+    }
+
+    const SysMonSnapshot *snapshot = _snapshot_acquire();
+    cJSON_AddBoolToObject(root, "hooksInstalled", snapshot->trace_events > 0);
+    cJSON_AddNumberToObject(root, "events", (double)snapshot->trace_events);
+    cJSON_AddNumberToObject(root, "dropped", (double)snapshot->trace_dropped);
+    cJSON_AddNumberToObject(root, "ringDepth", CONFIG_SYSMON_TRACE_RING_DEPTH);
+
+    cJSON *buckets = cJSON_AddArrayToObject(root, "latencyBucketsUs");
+    cJSON *tasks   = cJSON_AddObjectToObject(root, "tasks");
+    if (buckets == NULL || tasks == NULL)
+    {
+        _snapshot_release(snapshot);
+        JSON_CLEANUP(root);
+        return NULL;
+    }
+    for (int bucket = 0; bucket < SYSMON_TRACE_LATENCY_BUCKETS - 1; bucket++)
+    {
+        cJSON_AddItemToArray(buckets, cJSON_CreateNumber((double)_trace_latency_bucket_limit_us(bucket)));
+    }
+
+    for (int i = 0; i < snapshot->task_count; i++)
+    {
+        const SysMonTaskSnapshot *task = &snapshot->tasks[i];
+        cJSON *task_obj = cJSON_CreateObject();
+        cJSON *hist     = cJSON_CreateArray();
+        if (task_obj == NULL || hist == NULL)
+        {
+            _snapshot_release(snapshot);
+            cJSON_Delete(task_obj);
+            cJSON_Delete(hist);
+            JSON_CLEANUP(root);
+            return NULL;
+        }
+        cJSON_AddNumberToObject(task_obj, "switches", (double)task->trace_switches);
+        cJSON_AddNumberToObject(task_obj, "switchRate", round(task->trace_switch_rate * 10.0) / 10.0);
+        cJSON_AddNumberToObject(task_obj, "preemptions", (double)task->trace_preemptions);
+        cJSON_AddNumberToObject(task_obj, "readyLatencyMaxUs", (double)task->trace_latency_max_us);
+        for (int bucket = 0; bucket < SYSMON_TRACE_LATENCY_BUCKETS; bucket++)
+        {
+            cJSON_AddItemToArray(hist, cJSON_CreateNumber((double)task->trace_latency_hist[bucket]));
+        }
+        cJSON_AddItemToObject(task_obj, "readyLatencyHist", hist);
+        cJSON_AddItemToObject(tasks, _get_task_display_name(task->task_name), task_obj);
+    }
+    _snapshot_release(snapshot);
+
+    return root;
+}
+#endif // CONFIG_SYSMON_TRACE
+
+/**
+ * @brief Build WiFi connection JSON object (SSID, RSSI, IP, server port).
+ *
+ * @return WiFi JSON object, or NULL on allocation failure.
+ */
+static cJSON *_build_wifi_json(void)
+{
+    cJSON *wifi = cJSON_CreateObject();
+    if (wifi == NULL)
+    {
+        return NULL;
+    }
+
+    // Get WiFi SSID
+    char ssid_buffer[33] = { 0 };
+    esp_err_t ssid_err = _get_wifi_ssid(ssid_buffer, sizeof(ssid_buffer));
+    if (ssid_err == ESP_OK)
+    {
+        cJSON_AddStringToObject(wifi, "ssid", ssid_buffer);
+    }
+    else
+    {
+        cJSON_AddStringToObject(wifi, "ssid", "Not Connected");
+    }
+
+    // Get WiFi RSSI
+    int8_t rssi = 0;
+    esp_err_t rssi_err = _get_wifi_rssi(&rssi);
+    if (rssi_err == ESP_OK)
+    {
+        cJSON_AddNumberToObject(wifi, "rssi", (double)rssi);
+    }
+    else
+    {
+        cJSON_AddNullToObject(wifi, "rssi");
+    }
+
+    // Get WiFi IP address
+    char ip_buffer[16] = { 0 };
+    esp_err_t ip_err = _get_wifi_ip_info(ip_buffer, sizeof(ip_buffer));
+    if (ip_err == ESP_OK)
+    {
+        cJSON_AddStringToObject(wifi, "ip", ip_buffer);
+    }
+    else
+    {
+        cJSON_AddStringToObject(wifi, "ip", "N/A");
+    }
+
+    // HTTP server port
+    cJSON_AddNumberToObject(wifi, "port", (double)CONFIG_SYSMON_HTTPD_SERVER_PORT);
+
+    return wifi;
+}
+
+/**
+ * @brief Build the frontend configuration JSON object.
+ *
+ * @return Configuration JSON object, or NULL on allocation failure.
+ */
+static cJSON *_build_hardware_config_json(void)
+{
+    cJSON *config = cJSON_CreateObject();
+    if (config == NULL)
+    {
+        return NULL;
+    }
+
+    uint32_t interval_ms = 0;
+    uint32_t sample_count = 0;
+    sysmon_get_sampling(&interval_ms, &sample_count);
+    cJSON_AddNumberToObject(config, "cpuSamplingIntervalMs", (double)interval_ms);
+    cJSON_AddNumberToObject(config, "sampleCount", (double)sample_count);
+    cJSON_AddNumberToObject(config, "samplingGeneration", (double)self.sampling_generation);
+    cJSON_AddBoolToObject(config, "pushEnabled", SYSMON_PUSH_URI_HANDLER_COUNT > 0);
+
+    // Bucket durations accepted by /history?resolution= (raw sampling interval first)
+    cJSON *resolutions = cJSON_AddArrayToObject(config, "historyResolutionsMs");
+    if (resolutions != NULL)
+    {
+        cJSON_AddItemToArray(resolutions, cJSON_CreateNumber((double)interval_ms));
+#ifdef CONFIG_SYSMON_ROLLUPS
+        for (int tier = 0; self.series_rollups != NULL && tier < SYSMON_ROLLUP_TIER_COUNT; tier++)
+        {
+            cJSON_AddItemToArray(resolutions, cJSON_CreateNumber((double)_rollup_tier_resolution_ms(tier)));
+        }
+#endif
+    }
+
+    return config;
+}
+
+/**
+ * @brief Format the current local time like __DATE__ __TIME__ ("MMM DD YYYY HH:MM:SS").
+ *
+ * @param buffer Output buffer.
+ * @param buffer_size Size of the output buffer.
+ */
+static void _format_current_time(char *buffer, size_t buffer_size)
+{
+    time_t now = time(NULL);
+    if (now > 0)
+    {
+        struct tm timeinfo;
+        if (localtime_r(&now, &timeinfo) != NULL)
+        {
+            strftime(buffer, buffer_size, "%b %d %Y %H:%M:%S", &timeinfo);
+        }
+        else
+        {
+            snprintf(buffer, buffer_size, "Time not available");
+        }
+    }
+    else
+    {
+        snprintf(buffer, buffer_size, "Time not set");
+    }
+}
+
+/**
+ * @brief Build the complete hardware information JSON object.
  *
  * @return Hardware info JSON object, or NULL on allocation failure.
  *
@@ -711,9 +1841,11 @@ cJSON *_create_telemetry_json(void)
  *   - Retrieves static hardware information that doesn't change during execution.
  *   - Includes chip model, revision, cores, features.
  *   - Includes ESP-IDF version, build info, memory totals.
+ *   - Reads the app image headers from flash, so it is only called when the
+ *     cached document is built (see _hardware_cache_init()).
  *   - All allocations checked for robustness.
  */
-cJSON *_create_hardware_json(void)
+static cJSON *_build_hardware_json(void)
 {
     cJSON *root = cJSON_CreateObject();
     if (root == NULL)
@@ -881,26 +2013,9 @@ cJSON *_create_hardware_json(void)
     snprintf(compile_time, sizeof(compile_time), "%s %s", __DATE__, __TIME__);
     cJSON_AddStringToObject(system, "compileTime", compile_time);
 
-    // Boot time - show current date/time as ESP32 sees it
-    // Format matches compile time: "MMM DD YYYY HH:MM:SS" (e.g., "Nov 11 2025 02:17:56")
-    time_t now = time(NULL);
+    // Boot time - current date/time as ESP32 sees it (updated by each refresh)
     char boot_time_str[64];
-    if (now > 0)
-    {
-        struct tm timeinfo;
-        if (localtime_r(&now, &timeinfo) != NULL)
-        {
-            strftime(boot_time_str, sizeof(boot_time_str), "%b %d %Y %H:%M:%S", &timeinfo);
-        }
-        else
-        {
-            snprintf(boot_time_str, sizeof(boot_time_str), "Time not available");
-        }
-    }
-    else
-    {
-        snprintf(boot_time_str, sizeof(boot_time_str), "Time not set");
-    }
+    _format_current_time(boot_time_str, sizeof(boot_time_str));
     cJSON_AddStringToObject(system, "bootTime", boot_time_str);
 
     cJSON_AddItemToObject(root, "system", system);
@@ -965,65 +2080,177 @@ cJSON *_create_hardware_json(void)
         }
     }
 
-    // WiFi information
-    cJSON *wifi = cJSON_CreateObject();
-    if (wifi == NULL)
+    // WiFi information (optional; don't fail the entire hardware JSON response)
+    cJSON *wifi = _build_wifi_json();
+    if (wifi != NULL)
     {
-        // If WiFi object creation fails, continue without it
-        // Don't fail the entire hardware JSON response
+        cJSON_AddItemToObject(root, "wifi", wifi);
     }
-    else
+
+    // Configuration section for frontend
+    cJSON *config = _build_hardware_config_json();
+    if (config != NULL)
     {
-        // Get WiFi SSID
-        char ssid_buffer[33] = { 0 };
-        esp_err_t ssid_err = _get_wifi_ssid(ssid_buffer, sizeof(ssid_buffer));
-        if (ssid_err == ESP_OK)
-        {
-            cJSON_AddStringToObject(wifi, "ssid", ssid_buffer);
-        }
-        else
-        {
-            cJSON_AddStringToObject(wifi, "ssid", "Not Connected");
-        }
+        cJSON_AddItemToObject(root, "config", config);
+    }
 
-        // Get WiFi RSSI
-        int8_t rssi = 0;
-        esp_err_t rssi_err = _get_wifi_rssi(&rssi);
-        if (rssi_err == ESP_OK)
-        {
-            cJSON_AddNumberToObject(wifi, "rssi", (double)rssi);
-        }
-        else
-        {
-            cJSON_AddNullToObject(wifi, "rssi");
-        }
+    return root;
+}
+
+// ============================================================================
+// Cached Hardware Document
+// ============================================================================
+
+// Hardware document, built once; only touched by sysmon_init()/sysmon_deinit()
+// and by the HTTP server task, so it needs no locking
+static cJSON *s_hardware_root = NULL;
+static char *s_hardware_json = NULL;
+static size_t s_hardware_json_len = 0;
+static TickType_t s_hardware_refreshed_at = 0;
+static uint32_t s_hardware_sampling_generation = 0;
+
+/**
+ * @brief Refresh the volatile members of the cached hardware document.
+ *
+ * Updates NVS usage, boot time, WiFi info and the frontend configuration in
+ * place. Partition discovery and app image sizes are kept from the initial
+ * build, so no flash is read.
+ *
+ * @param root Cached hardware JSON object.
+ */
+static void _refresh_hardware_volatile(cJSON *root)
+{
+    cJSON *system = cJSON_GetObjectItem(root, "system");
+    if (system != NULL)
+    {
+        char boot_time_str[64];
+        _format_current_time(boot_time_str, sizeof(boot_time_str));
+        cJSON_DeleteItemFromObject(system, "bootTime");
+        cJSON_AddStringToObject(system, "bootTime", boot_time_str);
+    }
 
-        // Get WiFi IP address
-        char ip_buffer[16] = { 0 };
-        esp_err_t ip_err = _get_wifi_ip_info(ip_buffer, sizeof(ip_buffer));
-        if (ip_err == ESP_OK)
+    // Data partitions listed by label; re-query the NVS ones
+    cJSON *part_obj = NULL;
+    cJSON_ArrayForEach(part_obj, cJSON_GetObjectItem(root, "partitions"))
+    {
+        cJSON *type = cJSON_GetObjectItem(part_obj, "type");
+        const char *label = cJSON_GetStringValue(cJSON_GetObjectItem(part_obj, "label"));
+        if (label == NULL || type == NULL || (int)cJSON_GetNumberValue(type) != ESP_PARTITION_TYPE_DATA)
         {
-            cJSON_AddStringToObject(wifi, "ip", ip_buffer);
+            continue;
         }
-        else
+
+        const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                               ESP_PARTITION_SUBTYPE_DATA_NVS, label);
+        uint32_t used_bytes = 0;
+        uint32_t free_bytes = 0;
+        if (part != NULL && _get_nvs_usage(part, &used_bytes, &free_bytes))
         {
-            cJSON_AddStringToObject(wifi, "ip", "N/A");
+            _set_partition_usage_json(part_obj, part->size, true, used_bytes, free_bytes);
         }
+    }
 
-        // HTTP server port
-        cJSON_AddNumberToObject(wifi, "port", (double)CONFIG_SYSMON_HTTPD_SERVER_PORT);
-
+    cJSON_DeleteItemFromObject(root, "wifi");
+    cJSON *wifi = _build_wifi_json();
+    if (wifi != NULL)
+    {
         cJSON_AddItemToObject(root, "wifi", wifi);
     }
 
-    // Configuration section for frontend
-    cJSON *config = cJSON_CreateObject();
+    cJSON_DeleteItemFromObject(root, "config");
+    cJSON *config = _build_hardware_config_json();
     if (config != NULL)
     {
-        cJSON_AddNumberToObject(config, "cpuSamplingIntervalMs", (double)CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS);
-        cJSON_AddNumberToObject(config, "sampleCount", (double)CONFIG_SYSMON_SAMPLE_COUNT);
         cJSON_AddItemToObject(root, "config", config);
     }
+}
 
-    return root;
+/**
+ * @brief Serialize the cached hardware document, replacing the cached bytes.
+ *
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if serialization failed (previous bytes are kept).
+ */
+static esp_err_t _serialize_hardware_cache(void)
+{
+    char *json = cJSON_PrintUnformatted(s_hardware_root);
+    if (json == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    free(s_hardware_json);
+    s_hardware_json = json;
+    s_hardware_json_len = strlen(json);
+    s_hardware_refreshed_at = xTaskGetTickCount();
+    s_hardware_sampling_generation = self.sampling_generation;
+    return ESP_OK;
+}
+
+/**
+ * @brief Build and serialize the cached '/hardware' document.
+ *
+ * @return ESP_OK on success (or if already built), ESP_ERR_NO_MEM on allocation failure.
+ */
+esp_err_t _hardware_cache_init(void)
+{
+    if (s_hardware_root != NULL)
+    {
+        return ESP_OK;
+    }
+
+    s_hardware_root = _build_hardware_json();
+    if (s_hardware_root == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t err = _serialize_hardware_cache();
+    if (err != ESP_OK)
+    {
+        _hardware_cache_deinit();
+    }
+    return err;
+}
+
+/**
+ * @brief Free the cached '/hardware' document.
+ */
+void _hardware_cache_deinit(void)
+{
+    cJSON_Delete(s_hardware_root);
+    s_hardware_root = NULL;
+    free(s_hardware_json);
+    s_hardware_json = NULL;
+    s_hardware_json_len = 0;
+}
+
+/**
+ * @brief Send the cached '/hardware' document.
+ *
+ * Refreshes the volatile members first when the cached bytes are older than
+ * CONFIG_SYSMON_HARDWARE_REFRESH_MS or the sampling configuration changed since;
+ * otherwise the request is a single send of the cached bytes.
+ *
+ * @param request HTTP request to send the response on.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the document is unavailable.
+ */
+esp_err_t _stream_hardware_json(httpd_req_t *request)
+{
+    // Built by sysmon_init(); retry here in case that allocation failed
+    if (_hardware_cache_init() != ESP_OK)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    if ((xTaskGetTickCount() - s_hardware_refreshed_at) >= pdMS_TO_TICKS(CONFIG_SYSMON_HARDWARE_REFRESH_MS) ||
+        s_hardware_sampling_generation != self.sampling_generation)
+    {
+        _refresh_hardware_volatile(s_hardware_root);
+        if (_serialize_hardware_cache() != ESP_OK)
+        {
+            ESP_LOGW(LOG_TAG, "Failed to refresh hardware JSON, serving previous copy");
+        }
+    }
+
+    return httpd_resp_send(request, s_hardware_json, (ssize_t)s_hardware_json_len);
 }
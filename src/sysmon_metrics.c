@@ -0,0 +1,406 @@
+/**
+ * @file sysmon_metrics.c
+ * @brief Prometheus text exposition encoder for sysmon HTTP endpoints.
+ *
+ * This file implements '/metrics'. Every metric family is written as a
+ * HELP/TYPE pair followed by its samples, as the text format requires samples
+ * of one family to be contiguous; per-task families therefore walk the
+ * snapshot's task list once each. Values are formatted with the stream
+ * writer's printf into its fixed chunk buffer, which is flushed as a chunk
+ * whenever it fills.
+ *
+ * The stream writer itself is static: httpd runs all handlers on its single
+ * server task, so scrapes never overlap and a scrape allocates nothing.
+ */
+
+// Project-specific includes
+#include "sysmon_metrics.h"
+#include "sysmon.h"
+#include "sysmon_custom.h"
+#include "sysmon_stream.h"
+#include "sysmon_utils.h"
+
+// ESP-IDF includes
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+// System includes
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef CONFIG_SYSMON_METRICS
+
+/**
+ * @brief Per-task metric families, in output order.
+ */
+typedef enum
+{
+    TASK_METRIC_CPU_PERCENT,
+    TASK_METRIC_RUNTIME_TICKS,
+    TASK_METRIC_PRIORITY,
+    TASK_METRIC_STACK_REMAINING,
+    TASK_METRIC_STACK_SIZE,
+    TASK_METRIC_STACK_USED,
+    TASK_METRIC_STACK_PERCENT,
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+    TASK_METRIC_HEAP_ALLOC_BYTES,
+    TASK_METRIC_HEAP_ALLOCS,
+    TASK_METRIC_HEAP_FREES,
+#endif
+#ifdef CONFIG_SYSMON_TRACE
+    TASK_METRIC_CONTEXT_SWITCHES,
+    TASK_METRIC_PREEMPTIONS,
+#endif
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+    TASK_METRIC_IRQ_PERCENT,
+#endif
+    TASK_METRIC_COUNT
+} task_metric_t;
+
+/**
+ * @brief Description of one metric family.
+ *
+ * Members:
+ * - name : Metric name (counters end in _total).
+ * - type : Prometheus type ("gauge" or "counter").
+ * - help : HELP text.
+ */
+typedef struct
+{
+    const char *name;
+    const char *type;
+    const char *help;
+} metric_family_t;
+
+static const metric_family_t s_task_families[TASK_METRIC_COUNT] =
+{
+    [TASK_METRIC_CPU_PERCENT]     = { "sysmon_task_cpu_usage_percent", "gauge", "Task CPU usage over the last sampling interval." },
+    [TASK_METRIC_RUNTIME_TICKS]   = { "sysmon_task_runtime_ticks_total", "counter", "Task run time counter (run time stats clock, wraps at 2^32)." },
+    [TASK_METRIC_PRIORITY]        = { "sysmon_task_priority", "gauge", "Current FreeRTOS task priority." },
+    [TASK_METRIC_STACK_REMAINING] = { "sysmon_task_stack_remaining_bytes", "gauge", "Smallest free stack seen since task creation (high water mark)." },
+    [TASK_METRIC_STACK_SIZE]      = { "sysmon_task_stack_size_bytes", "gauge", "Registered task stack size (registered tasks only)." },
+    [TASK_METRIC_STACK_USED]      = { "sysmon_task_stack_used_bytes", "gauge", "Peak task stack usage (registered tasks only)." },
+    [TASK_METRIC_STACK_PERCENT]   = { "sysmon_task_stack_used_percent", "gauge", "Peak task stack usage relative to its size (registered tasks only)." },
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+    [TASK_METRIC_HEAP_ALLOC_BYTES] = { "sysmon_task_heap_allocated_bytes_total", "counter", "Bytes allocated by the task (wraps at 2^32)." },
+    [TASK_METRIC_HEAP_ALLOCS]     = { "sysmon_task_heap_allocations_total", "counter", "Heap allocations made by the task." },
+    [TASK_METRIC_HEAP_FREES]      = { "sysmon_task_heap_frees_total", "counter", "Heap frees made by the task." },
+#endif
+#ifdef CONFIG_SYSMON_TRACE
+    [TASK_METRIC_CONTEXT_SWITCHES] = { "sysmon_task_context_switches_total", "counter", "Times the task was switched in." },
+    [TASK_METRIC_PREEMPTIONS]     = { "sysmon_task_preemptions_total", "counter", "Times the task was switched out while still ready." },
+#endif
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+    [TASK_METRIC_IRQ_PERCENT]     = { "sysmon_task_irq_percent", "gauge", "Interrupt and critical-section time moved out of the task's CPU usage." },
+#endif
+};
+
+// Stream writer reused by every scrape (see the file comment)
+static sysmon_stream_t s_metrics_stream;
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Write the HELP and TYPE lines of a metric family.
+ *
+ * @param stream Stream writer.
+ * @param family Metric family.
+ */
+static void _put_family(sysmon_stream_t *stream, const metric_family_t *family)
+{
+    _stream_printf(stream, "# HELP %s %s\n# TYPE %s %s\n", family->name, family->help, family->name, family->type);
+}
+
+/**
+ * @brief Write a label value with the text format escapes (backslash, quote, newline).
+ *
+ * @param stream Stream writer.
+ * @param value Label value.
+ */
+static void _put_label_value(sysmon_stream_t *stream, const char *value)
+{
+    for (const char *c = value; *c != '\0'; c++)
+    {
+        switch (*c)
+        {
+            case '\\': _stream_puts(stream, "\\\\"); break;
+            case '"':  _stream_puts(stream, "\\\""); break;
+            case '\n': _stream_puts(stream, "\\n"); break;
+            default:   _stream_write(stream, c, 1); break;
+        }
+    }
+}
+
+/**
+ * @brief Write the label set identifying a task.
+ *
+ * The task number is included because task names need not be unique.
+ *
+ * @param stream Stream writer.
+ * @param task Task from the pinned snapshot.
+ */
+static void _put_task_labels(sysmon_stream_t *stream, const SysMonTaskSnapshot *task)
+{
+    _stream_puts(stream, "{task=\"");
+    _put_label_value(stream, _get_task_display_name(task->task_name));
+    _stream_printf(stream, "\",id=\"%u\",core=\"", (unsigned)task->task_id);
+    if (task->core_id >= 0 && task->core_id < SYSMON_CORE_COUNT)
+    {
+        _stream_printf(stream, "%d\"}", task->core_id);
+    }
+    else
+    {
+        _stream_puts(stream, "any\"}");
+    }
+}
+
+/**
+ * @brief Get the value of a per-task metric.
+ *
+ * @param metric Metric family.
+ * @param task Task from the pinned snapshot.
+ * @param value Output value.
+ * @return true if the task has a value for this metric.
+ */
+static bool _task_metric_value(task_metric_t metric, const SysMonTaskSnapshot *task, double *value)
+{
+    bool registered = (task->stack_size_bytes > 0U);
+    switch (metric)
+    {
+        case TASK_METRIC_CPU_PERCENT:
+            *value = task->usage_percent;
+            return true;
+        case TASK_METRIC_RUNTIME_TICKS:
+            *value = task->total_run_time_ticks;
+            return true;
+        case TASK_METRIC_PRIORITY:
+            *value = task->current_priority;
+            return true;
+        case TASK_METRIC_STACK_REMAINING:
+            *value = (double)task->stack_high_water_mark * sizeof(StackType_t);
+            return true;
+        case TASK_METRIC_STACK_SIZE:
+            *value = task->stack_size_bytes;
+            return registered;
+        case TASK_METRIC_STACK_USED:
+            *value = task->stack_usage_bytes;
+            return registered;
+        case TASK_METRIC_STACK_PERCENT:
+            *value = task->stack_usage_percent;
+            return registered;
+#ifdef CONFIG_SYSMON_HEAP_TASK_TRACKING
+        case TASK_METRIC_HEAP_ALLOC_BYTES:
+            *value = task->heap_alloc_bytes;
+            return true;
+        case TASK_METRIC_HEAP_ALLOCS:
+            *value = task->heap_alloc_count;
+            return true;
+        case TASK_METRIC_HEAP_FREES:
+            *value = task->heap_free_count;
+            return true;
+#endif
+#ifdef CONFIG_SYSMON_TRACE
+        case TASK_METRIC_CONTEXT_SWITCHES:
+            *value = task->trace_switches;
+            return true;
+        case TASK_METRIC_PREEMPTIONS:
+            *value = task->trace_preemptions;
+            return true;
+#endif
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+        case TASK_METRIC_IRQ_PERCENT:
+            *value = task->irq_percent;
+            return !task->irq_row;
+#endif
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Write the system-wide CPU, memory and sampler metrics.
+ *
+ * @param stream Stream writer.
+ * @param snapshot Pinned snapshot.
+ */
+static void _put_system_metrics(sysmon_stream_t *stream, const SysMonSnapshot *snapshot)
+{
+    const SysMonSampleValues *newest = &snapshot->newest;
+
+    _stream_puts(stream, "# HELP sysmon_cpu_usage_percent Overall CPU usage over the last sampling interval.\n"
+                         "# TYPE sysmon_cpu_usage_percent gauge\n");
+    _stream_printf(stream, "sysmon_cpu_usage_percent %.2f\n", newest->cpu_overall_percent);
+
+    _stream_puts(stream, "# HELP sysmon_cpu_core_usage_percent Per-core CPU usage over the last sampling interval.\n"
+                         "# TYPE sysmon_cpu_core_usage_percent gauge\n");
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        _stream_printf(stream, "sysmon_cpu_core_usage_percent{core=\"%d\"} %.2f\n",
+                       core, newest->cpu_core_percent[core]);
+    }
+#ifdef CONFIG_SYSMON_IRQ_ACCOUNTING
+    _stream_puts(stream, "# HELP sysmon_cpu_core_irq_percent Per-core time in interrupts and critical sections over the last sampling interval.\n"
+                         "# TYPE sysmon_cpu_core_irq_percent gauge\n");
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        _stream_printf(stream, "sysmon_cpu_core_irq_percent{core=\"%d\"} %.2f\n",
+                       core, newest->cpu_core_irq_percent[core]);
+    }
+    _stream_puts(stream, "# HELP sysmon_cpu_core_irq_max_seconds Longest interrupt or critical-section stretch sampled in the last sampling interval.\n"
+                         "# TYPE sysmon_cpu_core_irq_max_seconds gauge\n");
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        _stream_printf(stream, "sysmon_cpu_core_irq_max_seconds{core=\"%d\"} %.6f\n",
+                       core, (double)snapshot->irq_max_us[core] / 1000000.0);
+    }
+#endif
+
+    _stream_puts(stream, "# HELP sysmon_memory_free_bytes Free heap memory.\n"
+                         "# TYPE sysmon_memory_free_bytes gauge\n");
+    _stream_printf(stream, "sysmon_memory_free_bytes{region=\"dram\"} %" PRIu32 "\n", newest->dram_free);
+    if (self.psram_seen)
+    {
+        _stream_printf(stream, "sysmon_memory_free_bytes{region=\"psram\"} %" PRIu32 "\n", newest->psram_free);
+    }
+
+    _stream_puts(stream, "# HELP sysmon_memory_total_bytes Total heap memory.\n"
+                         "# TYPE sysmon_memory_total_bytes gauge\n");
+    _stream_printf(stream, "sysmon_memory_total_bytes{region=\"dram\"} %" PRIu32 "\n", newest->dram_total);
+    if (self.psram_seen)
+    {
+        _stream_printf(stream, "sysmon_memory_total_bytes{region=\"psram\"} %" PRIu32 "\n", newest->psram_total);
+    }
+
+    _stream_printf(stream, "# HELP sysmon_memory_min_free_bytes Lowest free DRAM since boot.\n"
+                           "# TYPE sysmon_memory_min_free_bytes gauge\n"
+                           "sysmon_memory_min_free_bytes{region=\"dram\"} %" PRIu32 "\n",
+                   newest->dram_min_free);
+    _stream_printf(stream, "# HELP sysmon_memory_largest_free_block_bytes Largest free DRAM block.\n"
+                           "# TYPE sysmon_memory_largest_free_block_bytes gauge\n"
+                           "sysmon_memory_largest_free_block_bytes{region=\"dram\"} %" PRIu32 "\n",
+                   newest->dram_largest_block);
+
+    _stream_printf(stream, "# HELP sysmon_uptime_seconds Time since boot.\n"
+                           "# TYPE sysmon_uptime_seconds gauge\n"
+                           "sysmon_uptime_seconds %.3f\n", (double)esp_timer_get_time() / 1000000.0);
+    _stream_printf(stream, "# HELP sysmon_tasks Tasks currently monitored.\n"
+                           "# TYPE sysmon_tasks gauge\n"
+                           "sysmon_tasks %d\n", snapshot->task_count);
+    _stream_printf(stream, "# HELP sysmon_samples_total Samples taken by the monitor task.\n"
+                           "# TYPE sysmon_samples_total counter\n"
+                           "sysmon_samples_total %" PRIu32 "\n", snapshot->sequence);
+    _stream_printf(stream, "# HELP sysmon_sampling_interval_seconds Active sampling interval.\n"
+                           "# TYPE sysmon_sampling_interval_seconds gauge\n"
+                           "sysmon_sampling_interval_seconds %.3f\n", (double)snapshot->interval_ms / 1000.0);
+    _stream_printf(stream, "# HELP sysmon_sampler_sleep_intervals Sampling intervals the sampler sleeps between wakes (1 = full rate).\n"
+                           "# TYPE sysmon_sampler_sleep_intervals gauge\n"
+                           "sysmon_sampler_sleep_intervals %" PRIu32 "\n", snapshot->self_metrics.adaptive_factor);
+    _stream_printf(stream, "# HELP sysmon_sampler_overruns_total Sampling intervals whose processing ran past the next deadline.\n"
+                           "# TYPE sysmon_sampler_overruns_total counter\n"
+                           "sysmon_sampler_overruns_total %" PRIu32 "\n", snapshot->self_metrics.overruns);
+    _stream_printf(stream, "# HELP sysmon_sampler_work_seconds Processing time of the last sample.\n"
+                           "# TYPE sysmon_sampler_work_seconds gauge\n"
+                           "sysmon_sampler_work_seconds %.6f\n", (double)snapshot->self_metrics.work_us / 1000000.0);
+#ifdef CONFIG_SYSMON_TRACE
+    _stream_printf(stream, "# HELP sysmon_trace_dropped_events_total Scheduler trace events dropped because a ring was full.\n"
+                           "# TYPE sysmon_trace_dropped_events_total counter\n"
+                           "sysmon_trace_dropped_events_total %" PRIu32 "\n", snapshot->trace_dropped);
+#endif
+}
+
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+/**
+ * @brief Write the application-defined metrics.
+ *
+ * Metric names are free-form, so every metric becomes a sample labelled with
+ * its name in one counter and one gauge family instead of a family of its own.
+ *
+ * @param stream Stream writer.
+ * @param snapshot Pinned snapshot.
+ */
+static void _put_custom_metrics(sysmon_stream_t *stream, const SysMonSnapshot *snapshot)
+{
+    _stream_puts(stream, "# HELP sysmon_custom_counter_total Application-defined counters.\n"
+                         "# TYPE sysmon_custom_counter_total counter\n");
+    for (int i = 0; i < snapshot->custom_metric_count; i++)
+    {
+        sysmon_metric_type_t type;
+        const char *name = _custom_get_metric(i, &type);
+        if (name != NULL && type == SYSMON_METRIC_COUNTER)
+        {
+            _stream_puts(stream, "sysmon_custom_counter_total{name=\"");
+            _put_label_value(stream, name);
+            _stream_printf(stream, "\"} %.0f\n", (double)snapshot->custom_metric_totals[i]);
+        }
+    }
+
+    _stream_puts(stream, "# HELP sysmon_custom_gauge Application-defined gauges.\n"
+                         "# TYPE sysmon_custom_gauge gauge\n");
+    for (int i = 0; i < snapshot->custom_metric_count; i++)
+    {
+        sysmon_metric_type_t type;
+        const char *name = _custom_get_metric(i, &type);
+        if (name != NULL && type == SYSMON_METRIC_GAUGE)
+        {
+            _stream_puts(stream, "sysmon_custom_gauge{name=\"");
+            _put_label_value(stream, name);
+            _stream_printf(stream, "\"} %" PRId32 "\n", snapshot->newest.custom_metric_values[i]);
+        }
+    }
+}
+#endif
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Stream all metrics in the Prometheus text format as a chunked response.
+ *
+ * @param request HTTP request to stream the response on.
+ * @return ESP_OK on success, or the first chunk send error.
+ */
+esp_err_t _stream_metrics_text(httpd_req_t *request)
+{
+    sysmon_stream_t *stream = &s_metrics_stream;
+    _stream_begin(stream, request);
+
+    const SysMonSnapshot *snapshot = _snapshot_acquire();
+    _put_system_metrics(stream, snapshot);
+#ifdef CONFIG_SYSMON_CUSTOM_METRICS
+    _put_custom_metrics(stream, snapshot);
+#endif
+
+    for (int metric = 0; metric < TASK_METRIC_COUNT; metric++)
+    {
+        const metric_family_t *family = &s_task_families[metric];
+        _put_family(stream, family);
+        for (int i = 0; i < snapshot->task_count; i++)
+        {
+            const SysMonTaskSnapshot *task = &snapshot->tasks[i];
+            double value = 0.0;
+            if (!_task_metric_value((task_metric_t)metric, task, &value))
+            {
+                continue;
+            }
+            _stream_puts(stream, family->name);
+            _put_task_labels(stream, task);
+            _stream_printf(stream, " %.10g\n", value);
+        }
+    }
+    _snapshot_release(snapshot);
+
+    return _stream_end(stream);
+}
+
+#else // !CONFIG_SYSMON_METRICS
+
+esp_err_t _stream_metrics_text(httpd_req_t *request)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif // CONFIG_SYSMON_METRICS
@@ -0,0 +1,362 @@
+/**
+ * @file sysmon_push.c
+ * @brief WebSocket push channel for live sysmon telemetry.
+ *
+ * This file implements the '/ws' endpoint. The sampler encodes each new sample
+ * once into a message using the binary telemetry encoder, then hands the
+ * message to the HTTP server task with httpd_queue_work(). The server task
+ * sends the same frame to every subscribed socket. Only one message is in
+ * flight at a time, so a single message buffer and stream writer are reused
+ * for every sample; they are allocated on first use and only grow.
+ *
+ * The subscriber list is only modified from the HTTP server task (handshake
+ * handler, send work and reset after stop), so it needs no locking; the
+ * sampler only reads the subscriber count.
+ */
+
+// Project-specific includes
+#include "sysmon_push.h"
+#include "sysmon.h"
+#include "sysmon_binary.h"
+#include "sysmon_stream.h"
+
+// ESP-IDF includes
+#include "esp_log.h"
+#include "esp_http_server.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef CONFIG_SYSMON_WEBSOCKET_PUSH
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_push";
+
+/**
+ * @brief Encoded frame shared by all subscribers.
+ *
+ * Members:
+ * - length   : Number of payload bytes.
+ * - capacity : Allocated payload size.
+ * - data     : Payload bytes (binary telemetry layout).
+ */
+typedef struct
+{
+    size_t length;
+    size_t capacity;
+    uint8_t *data;
+} push_message_t;
+
+// Subscribed WebSocket socket descriptors (-1 = free slot, set up by sysmon_push_register())
+static int s_subscriber_fds[SYSMON_PUSH_MAX_SUBSCRIBERS];
+static volatile size_t s_subscriber_count = 0;
+
+// Set while a message is queued or being sent by the HTTP server task
+static volatile bool s_send_in_flight = false;
+
+// Reused message and stream writer (owned by the sampler unless a send is in flight)
+static push_message_t s_message = { 0 };
+static sysmon_stream_t *s_stream = NULL;
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Stream sink appending chunks to a growable push message.
+ *
+ * @param ctx Push message.
+ * @param data Chunk bytes (NULL at end of stream).
+ * @param len Number of bytes.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the message cannot grow.
+ */
+static esp_err_t _push_message_sink(void *ctx, const char *data, size_t len)
+{
+    push_message_t *message = (push_message_t *)ctx;
+    if (data == NULL || len == 0)
+    {
+        return ESP_OK;
+    }
+
+    if (message->length + len > message->capacity)
+    {
+        size_t new_capacity = message->capacity ? message->capacity * 2 : SYSMON_STREAM_CHUNK_SIZE;
+        while (new_capacity < message->length + len)
+        {
+            new_capacity *= 2;
+        }
+        uint8_t *new_data = (uint8_t *)realloc(message->data, new_capacity);
+        if (new_data == NULL)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+        message->data = new_data;
+        message->capacity = new_capacity;
+    }
+
+    memcpy(message->data + message->length, data, len);
+    message->length += len;
+    return ESP_OK;
+}
+
+/**
+ * @brief Remove a subscriber slot.
+ *
+ * @param slot Slot index.
+ */
+static void _remove_subscriber(int slot)
+{
+    if (s_subscriber_fds[slot] >= 0)
+    {
+        s_subscriber_fds[slot] = -1;
+        s_subscriber_count--;
+    }
+}
+
+/**
+ * @brief Add a socket to the subscriber list (no-op if already present).
+ *
+ * @param fd Socket descriptor.
+ * @return true if subscribed, false if all slots are in use.
+ */
+static bool _add_subscriber(int fd)
+{
+    int free_slot = -1;
+    for (int i = 0; i < SYSMON_PUSH_MAX_SUBSCRIBERS; i++)
+    {
+        if (s_subscriber_fds[i] == fd)
+        {
+            return true;
+        }
+        // Reclaim slots whose socket is no longer a WebSocket (closed or reused)
+        if (s_subscriber_fds[i] >= 0 &&
+            httpd_ws_get_fd_info(self.httpd, s_subscriber_fds[i]) != HTTPD_WS_CLIENT_WEBSOCKET)
+        {
+            _remove_subscriber(i);
+        }
+        if (s_subscriber_fds[i] < 0 && free_slot < 0)
+        {
+            free_slot = i;
+        }
+    }
+
+    if (free_slot < 0)
+    {
+        return false;
+    }
+    s_subscriber_fds[free_slot] = fd;
+    s_subscriber_count++;
+    return true;
+}
+
+/**
+ * @brief Send a queued message to every subscriber (runs in the HTTP server task).
+ *
+ * @param arg Push message; handed back to the sampler before returning.
+ */
+static void _push_send_work(void *arg)
+{
+    push_message_t *message = (push_message_t *)arg;
+
+    httpd_ws_frame_t frame =
+    {
+        .final      = true,
+        .fragmented = false,
+        .type       = HTTPD_WS_TYPE_BINARY,
+        .payload    = message->data,
+        .len        = message->length
+    };
+
+    for (int i = 0; i < SYSMON_PUSH_MAX_SUBSCRIBERS && self.httpd != NULL; i++)
+    {
+        int fd = s_subscriber_fds[i];
+        if (fd < 0)
+        {
+            continue;
+        }
+        if (httpd_ws_get_fd_info(self.httpd, fd) != HTTPD_WS_CLIENT_WEBSOCKET)
+        {
+            _remove_subscriber(i);
+            continue;
+        }
+
+        esp_err_t err = httpd_ws_send_frame_async(self.httpd, fd, &frame);
+        if (err != ESP_OK)
+        {
+            ESP_LOGW(LOG_TAG, "Dropping subscriber fd %d: %s", fd, esp_err_to_name(err));
+            _remove_subscriber(i);
+        }
+    }
+
+    s_send_in_flight = false;
+}
+
+/**
+ * @brief '/ws' handler: subscribes on handshake and discards client frames.
+ *
+ * @param request HTTP request object.
+ * @return ESP_OK on success, error code otherwise (closes the socket).
+ */
+static esp_err_t _push_ws_handler(httpd_req_t *request)
+{
+    if (request->method == HTTP_GET)
+    {
+        int fd = httpd_req_to_sockfd(request);
+        if (!_add_subscriber(fd))
+        {
+            ESP_LOGW(LOG_TAG, "Push subscriber limit (%d) reached, rejecting fd %d", SYSMON_PUSH_MAX_SUBSCRIBERS, fd);
+            return ESP_FAIL;
+        }
+        ESP_LOGI(LOG_TAG, "Push subscriber connected (fd %d, %u total)", fd, (unsigned)s_subscriber_count);
+        _sampling_note_client();
+        return ESP_OK;
+    }
+
+    // The channel is one-way; read and discard anything the client sends
+    httpd_ws_frame_t frame = { 0 };
+    esp_err_t err = httpd_ws_recv_frame(request, &frame, 0);
+    if (err != ESP_OK || frame.len == 0)
+    {
+        return err;
+    }
+
+    frame.payload = (uint8_t *)malloc(frame.len);
+    if (frame.payload == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    err = httpd_ws_recv_frame(request, &frame, frame.len);
+    free(frame.payload);
+    return err;
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Register the '/ws' WebSocket endpoint on the sysmon HTTP server.
+ *
+ * @param server HTTP server handle.
+ * @return ESP_OK on success, error code otherwise.
+ */
+esp_err_t sysmon_push_register(httpd_handle_t server)
+{
+    sysmon_push_reset();
+
+    httpd_uri_t uri_config =
+    {
+        .uri          = "/ws",
+        .method       = HTTP_GET,
+        .handler      = _push_ws_handler,
+        .user_ctx     = NULL,
+        .is_websocket = true
+    };
+
+    esp_err_t err = httpd_register_uri_handler(server, &uri_config);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to register /ws handler: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+/**
+ * @brief Drop all subscribers and any pending message state.
+ *
+ * Also releases the reused message buffers; the HTTP server is stopped (or not
+ * started yet), so no queued send can still refer to them, and sysmon_deinit()
+ * deletes the sampler first, so no publish can still be encoding into them.
+ */
+void sysmon_push_reset(void)
+{
+    for (int i = 0; i < SYSMON_PUSH_MAX_SUBSCRIBERS; i++)
+    {
+        s_subscriber_fds[i] = -1;
+    }
+    s_subscriber_count = 0;
+    s_send_in_flight = false;
+
+    free(s_message.data);
+    memset(&s_message, 0, sizeof(s_message));
+    free(s_stream);
+    s_stream = NULL;
+}
+
+/**
+ * @brief Encode the newest sample once and queue it for every subscriber.
+ *
+ * Encoding happens in the sampler task; only the socket writes run in the
+ * HTTP server task. A sample is dropped (not queued) while the previous one
+ * is still in flight. The message buffer is reused, so steady-state
+ * publishing performs no heap allocation.
+ */
+void sysmon_push_publish(void)
+{
+    if (self.httpd == NULL || s_subscriber_count == 0 || s_send_in_flight)
+    {
+        return;
+    }
+
+    if (s_stream == NULL)
+    {
+        s_stream = (sysmon_stream_t *)malloc(sizeof(sysmon_stream_t));
+        if (s_stream == NULL)
+        {
+            return;
+        }
+    }
+
+    s_message.length = 0;
+    _stream_begin_sink(s_stream, _push_message_sink, &s_message);
+    _encode_telemetry_binary(s_stream);
+    esp_err_t err = _stream_end(s_stream);
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(LOG_TAG, "Failed to encode push message: %s", esp_err_to_name(err));
+        return;
+    }
+
+    s_send_in_flight = true;
+    err = httpd_queue_work(self.httpd, _push_send_work, &s_message);
+    if (err != ESP_OK)
+    {
+        ESP_LOGW(LOG_TAG, "httpd_queue_work() failed: %s", esp_err_to_name(err));
+        s_send_in_flight = false;
+    }
+}
+
+/**
+ * @brief Get the number of connected push subscribers.
+ *
+ * @return Subscriber count.
+ */
+size_t sysmon_push_subscriber_count(void)
+{
+    return s_subscriber_count;
+}
+
+#else // !CONFIG_SYSMON_WEBSOCKET_PUSH
+
+esp_err_t sysmon_push_register(httpd_handle_t server)
+{
+    return ESP_OK;
+}
+
+void sysmon_push_reset(void)
+{
+}
+
+void sysmon_push_publish(void)
+{
+}
+
+size_t sysmon_push_subscriber_count(void)
+{
+    return 0;
+}
+
+#endif // CONFIG_SYSMON_WEBSOCKET_PUSH
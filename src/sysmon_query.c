@@ -0,0 +1,408 @@
+/**
+ * @file sysmon_query.c
+ * @brief Task selection for '/tasks' and '/history' evaluated on the device.
+ *
+ * This file implements the task query declared in sysmon_query.h. Filters
+ * are checked per task of the pinned snapshot; ranked queries push the
+ * matching tasks through a bounded min-heap (the lowest-ranked candidate at
+ * the root), so a top-n query over T tasks costs O(T log n) comparisons and
+ * needs an index of n entries. The heap is then sorted in place, highest
+ * rank first.
+ */
+
+// Project-specific includes
+#include "sysmon_query.h"
+#include "sysmon_utils.h"
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Match a name against one pattern in which '*' matches any run of characters.
+ *
+ * @param pattern Pattern (not NUL-terminated).
+ * @param pattern_len Pattern length.
+ * @param name Name to match.
+ * @return true if the whole name matches.
+ */
+static bool _pattern_matches(const char *pattern, size_t pattern_len, const char *name)
+{
+    size_t p = 0;
+    size_t star = SIZE_MAX;
+    const char *star_name = NULL;
+
+    while (*name != '\0')
+    {
+        if (p < pattern_len && pattern[p] == '*')
+        {
+            star = p++;
+            star_name = name;
+        }
+        else if (p < pattern_len && pattern[p] == *name)
+        {
+            p++;
+            name++;
+        }
+        else if (star != SIZE_MAX)
+        {
+            // Let the last '*' absorb one more character and retry
+            p = star + 1;
+            name = ++star_name;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while (p < pattern_len && pattern[p] == '*')
+    {
+        p++;
+    }
+    return p == pattern_len;
+}
+
+/**
+ * @brief Check whether a task name matches any pattern of a comma-separated list.
+ *
+ * @param patterns Comma-separated patterns (empty segments are ignored).
+ * @param task_name FreeRTOS task name (its display name is tried as well).
+ * @return true if a pattern matches.
+ */
+static bool _name_matches_any(const char *patterns, const char *task_name)
+{
+    const char *display_name = _get_task_display_name(task_name);
+    const char *segment = patterns;
+    for (;;)
+    {
+        const char *end = strchr(segment, ',');
+        size_t len = (end != NULL) ? (size_t)(end - segment) : strlen(segment);
+        if (len > 0 && (_pattern_matches(segment, len, task_name) || _pattern_matches(segment, len, display_name)))
+        {
+            return true;
+        }
+        if (end == NULL)
+        {
+            return false;
+        }
+        segment = end + 1;
+    }
+}
+
+/**
+ * @brief Check whether a task passes the core and name filters of a query.
+ *
+ * @param query Parsed query.
+ * @param task Task of the pinned snapshot.
+ * @return true if the task is selected (before ranking).
+ */
+static bool _task_matches(const SysMonTaskQuery *query, const SysMonTaskSnapshot *task)
+{
+    if (query->core != SYSMON_QUERY_CORE_ANY)
+    {
+        bool is_pinned = (task->core_id >= 0 && task->core_id < SYSMON_CORE_COUNT);
+        if (query->core == SYSMON_QUERY_CORE_UNPINNED ? is_pinned : task->core_id != query->core)
+        {
+            return false;
+        }
+    }
+    if (query->include[0] != '\0' && !_name_matches_any(query->include, task->task_name))
+    {
+        return false;
+    }
+    return query->exclude[0] == '\0' || !_name_matches_any(query->exclude, task->task_name);
+}
+
+/**
+ * @brief Check whether task a ranks above task b in the newest sample.
+ *
+ * Ties keep snapshot order, so equal tasks come out in a stable order.
+ *
+ * @param snapshot Pinned snapshot.
+ * @param by Ranking.
+ * @param a Index into snapshot->tasks.
+ * @param b Index into snapshot->tasks.
+ * @return true if a ranks above b.
+ */
+static bool _ranks_above(const SysMonSnapshot *snapshot, sysmon_task_rank_t by, int a, int b)
+{
+    const SysMonTaskSnapshot *task_a = &snapshot->tasks[a];
+    const SysMonTaskSnapshot *task_b = &snapshot->tasks[b];
+    float key_a;
+    float key_b;
+
+    if (by == SYSMON_TASK_RANK_STACK)
+    {
+        // Percentages exist for registered tasks only; the others follow by bytes
+        bool registered_a = (task_a->stack_size_bytes > 0U);
+        bool registered_b = (task_b->stack_size_bytes > 0U);
+        if (registered_a != registered_b)
+        {
+            return registered_a;
+        }
+        key_a = registered_a ? task_a->stack_usage_percent : (float)task_a->stack_usage_bytes;
+        key_b = registered_b ? task_b->stack_usage_percent : (float)task_b->stack_usage_bytes;
+    }
+    else
+    {
+        key_a = task_a->usage_percent;
+        key_b = task_b->usage_percent;
+    }
+
+    if (key_a != key_b)
+    {
+        return key_a > key_b;
+    }
+    return a < b;
+}
+
+/**
+ * @brief Restore the min-heap order below a position.
+ *
+ * @param snapshot Pinned snapshot.
+ * @param by Ranking.
+ * @param heap Heap of task indices (lowest rank at the root).
+ * @param count Heap size.
+ * @param pos Position whose entry may rank above its children.
+ */
+static void _heap_sift_down(const SysMonSnapshot *snapshot, sysmon_task_rank_t by, int16_t *heap, int count, int pos)
+{
+    for (;;)
+    {
+        int lowest = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+        if (left < count && _ranks_above(snapshot, by, heap[lowest], heap[left]))
+        {
+            lowest = left;
+        }
+        if (right < count && _ranks_above(snapshot, by, heap[lowest], heap[right]))
+        {
+            lowest = right;
+        }
+        if (lowest == pos)
+        {
+            return;
+        }
+        int16_t entry = heap[pos];
+        heap[pos] = heap[lowest];
+        heap[lowest] = entry;
+        pos = lowest;
+    }
+}
+
+/**
+ * @brief Restore the min-heap order above a newly appended entry.
+ *
+ * @param snapshot Pinned snapshot.
+ * @param by Ranking.
+ * @param heap Heap of task indices (lowest rank at the root).
+ * @param pos Position of the new entry.
+ */
+static void _heap_sift_up(const SysMonSnapshot *snapshot, sysmon_task_rank_t by, int16_t *heap, int pos)
+{
+    while (pos > 0)
+    {
+        int parent = (pos - 1) / 2;
+        if (!_ranks_above(snapshot, by, heap[parent], heap[pos]))
+        {
+            return;
+        }
+        int16_t entry = heap[pos];
+        heap[pos] = heap[parent];
+        heap[parent] = entry;
+        pos = parent;
+    }
+}
+
+// ============================================================================
+// Internal API Functions (Encoders)
+// ============================================================================
+
+/**
+ * @brief Parse the task query parameters of a request.
+ *
+ * @param request HTTP request object.
+ * @param query Output: parsed query (all tasks in snapshot order if no parameter is present).
+ * @param error Output: message for a 400 Bad Request response (set with ESP_ERR_INVALID_ARG).
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an invalid parameter,
+ *         ESP_ERR_NO_MEM if the query could not be read.
+ */
+esp_err_t _task_query_parse(httpd_req_t *request, SysMonTaskQuery *query, const char **error)
+{
+    memset(query, 0, sizeof(*query));
+    query->core = SYSMON_QUERY_CORE_ANY;
+    *error = NULL;
+
+    esp_err_t err = _get_query_uint32(request, "top", &query->top);
+    if (err == ESP_ERR_NO_MEM)
+    {
+        return err;
+    }
+    if (err == ESP_ERR_INVALID_ARG || (err == ESP_OK && query->top == 0))
+    {
+        *error = "Invalid 'top' (expected a task count of at least 1)";
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (err == ESP_OK)
+    {
+        query->by = SYSMON_TASK_RANK_CPU;
+    }
+
+    char value[12] = { 0 };
+    err = _get_query_value(request, "by", value, sizeof(value));
+    if (err == ESP_ERR_NO_MEM)
+    {
+        return err;
+    }
+    if (err == ESP_OK && strcmp(value, "cpu") == 0)
+    {
+        query->by = SYSMON_TASK_RANK_CPU;
+    }
+    else if (err == ESP_OK && strcmp(value, "stack") == 0)
+    {
+        query->by = SYSMON_TASK_RANK_STACK;
+    }
+    else if (err != ESP_ERR_NOT_FOUND)
+    {
+        *error = "Invalid 'by' (expected 'cpu' or 'stack')";
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t core = 0;
+    err = _get_query_uint32(request, "core", &core);
+    if (err == ESP_ERR_NO_MEM)
+    {
+        return err;
+    }
+    if (err == ESP_OK && core < SYSMON_CORE_COUNT)
+    {
+        query->core = (int)core;
+    }
+    else if (err == ESP_ERR_INVALID_ARG &&
+             _get_query_value(request, "core", value, sizeof(value)) == ESP_OK && strcmp(value, "unpinned") == 0)
+    {
+        query->core = SYSMON_QUERY_CORE_UNPINNED;
+    }
+    else if (err != ESP_ERR_NOT_FOUND)
+    {
+        *error = "Invalid 'core' (expected a core index or 'unpinned')";
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    err = _get_query_value(request, "include", query->include, sizeof(query->include));
+    if (err == ESP_ERR_NO_MEM)
+    {
+        return err;
+    }
+    if (err != ESP_OK && err != ESP_ERR_NOT_FOUND)
+    {
+        *error = "Invalid 'include' (at most 127 characters of comma-separated names)";
+        return ESP_ERR_INVALID_ARG;
+    }
+    err = _get_query_value(request, "exclude", query->exclude, sizeof(query->exclude));
+    if (err == ESP_ERR_NO_MEM)
+    {
+        return err;
+    }
+    if (err != ESP_OK && err != ESP_ERR_NOT_FOUND)
+    {
+        *error = "Invalid 'exclude' (at most 127 characters of comma-separated names)";
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Select the tasks of a snapshot matching a query.
+ *
+ * @param query Parsed query.
+ * @param snapshot Pinned snapshot to select from.
+ * @param selection Output: selected tasks (release with _task_selection_free()).
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the index cannot be allocated.
+ */
+esp_err_t _task_query_select(const SysMonTaskQuery *query, const SysMonSnapshot *snapshot,
+                             SysMonTaskSelection *selection)
+{
+    selection->index = NULL;
+    selection->count = 0;
+
+    int capacity = snapshot->task_count;
+    if (query->top > 0U && query->top < (uint32_t)capacity)
+    {
+        capacity = (int)query->top;
+    }
+    if (capacity == 0)
+    {
+        return ESP_OK;
+    }
+    int16_t *index = (int16_t *)malloc(sizeof(int16_t) * capacity);
+    if (index == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    int count = 0;
+    for (int i = 0; i < snapshot->task_count; i++)
+    {
+        if (!_task_matches(query, &snapshot->tasks[i]))
+        {
+            continue;
+        }
+        if (query->by == SYSMON_TASK_RANK_NONE)
+        {
+            // Unranked queries have no limit, so every match fits
+            index[count++] = (int16_t)i;
+        }
+        else if (count < capacity)
+        {
+            index[count] = (int16_t)i;
+            _heap_sift_up(snapshot, query->by, index, count++);
+        }
+        else if (_ranks_above(snapshot, query->by, i, index[0]))
+        {
+            // Replace the lowest-ranked candidate
+            index[0] = (int16_t)i;
+            _heap_sift_down(snapshot, query->by, index, count, 0);
+        }
+    }
+
+    if (query->by != SYSMON_TASK_RANK_NONE)
+    {
+        // Move the lowest-ranked entry to the back until the heap is empty: highest rank first
+        for (int end = count - 1; end > 0; end--)
+        {
+            int16_t entry = index[0];
+            index[0] = index[end];
+            index[end] = entry;
+            _heap_sift_down(snapshot, query->by, index, end, 0);
+        }
+    }
+
+    selection->index = index;
+    selection->count = count;
+    return ESP_OK;
+}
+
+/**
+ * @brief Release a selection filled by _task_query_select().
+ *
+ * @param selection Selection to release (may be empty).
+ */
+void _task_selection_free(SysMonTaskSelection *selection)
+{
+    free(selection->index);
+    selection->index = NULL;
+    selection->count = 0;
+}
@@ -0,0 +1,602 @@
+/**
+ * @file sysmon_recorder.c
+ * @brief Crash-surviving flight recorder of recent sysmon samples.
+ *
+ * This file implements the recorder declared in sysmon_recorder.h. The region
+ * lives in a no-init section, so the startup code leaves it alone and its
+ * contents survive every reset that keeps memory powered. Its layout is fixed
+ * at build time and described by the header, so a recording made by a
+ * different firmware configuration fails validation and is ignored.
+ *
+ * Sample n goes to record n % CONFIG_SYSMON_RECORDER_SAMPLES. A record is
+ * built on the stack (zeroed, so padding is deterministic for the CRC) and
+ * copied into place in one memcpy; no other part of the region is written per
+ * sample, except a task table entry when a task gets a column.
+ */
+
+// Project-specific includes
+#include "sysmon_recorder.h"
+#include "sysmon.h"
+#include "sysmon_stream.h"
+#include "sysmon_utils.h"
+
+// ESP-IDF includes
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "esp_system.h"
+
+// System includes
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef CONFIG_SYSMON_RECORDER
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_recorder";
+
+#define RECORDER_MAGIC          0x524D5953U     // "SYMR"
+#define RECORDER_VERSION        1
+#define RECORDER_NO_VALUE       0xFFFF
+#define RECORDER_NAME_LEN       16
+
+/**
+ * @brief Recording header, written once per boot and again when the sampling changes.
+ *
+ * Members:
+ * - magic        : RECORDER_MAGIC.
+ * - version      : RECORDER_VERSION.
+ * - record_size  : sizeof(SysMonRecorderSample) of the firmware that wrote it.
+ * - record_count : CONFIG_SYSMON_RECORDER_SAMPLES.
+ * - task_columns : CONFIG_SYSMON_RECORDER_TASKS.
+ * - core_count   : SYSMON_CORE_COUNT.
+ * - interval_ms  : Sampling interval of the recording.
+ * - boot_count   : Boots recorded since the region was last found invalid.
+ * - crc          : CRC32 of the fields above.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint16_t record_count;
+    uint8_t task_columns;
+    uint8_t core_count;
+    uint32_t interval_ms;
+    uint32_t boot_count;
+    uint32_t crc;
+} SysMonRecorderHeader;
+
+/**
+ * @brief Task owning a column of the sample records.
+ *
+ * Members:
+ * - name      : Task name (truncated).
+ * - task_id   : FreeRTOS task number, to tell same-named tasks apart.
+ * - first_seq : First sample recorded in the column for this task (0 = unused).
+ * - crc       : CRC32 of the fields above.
+ */
+typedef struct
+{
+    char name[RECORDER_NAME_LEN];
+    uint32_t task_id;
+    uint32_t first_seq;
+    uint32_t crc;
+} SysMonRecorderTask;
+
+/**
+ * @brief One recorded sample.
+ *
+ * Members:
+ * - sequence      : sample_sequence of the sample (0 = empty record).
+ * - uptime_ms     : Time since boot the sample stands for (see SysMonState.slot_time_us).
+ * - dram_free     : DRAM free bytes.
+ * - dram_min_free : DRAM minimum free bytes.
+ * - psram_free    : PSRAM free bytes.
+ * - cpu_overall   : Overall CPU usage, hundredths of a percent.
+ * - cpu_core      : CPU usage per core, hundredths of a percent.
+ * - task_cpu      : CPU usage per task column (RECORDER_NO_VALUE = no task).
+ * - task_stack    : Stack usage per task column, hundredths of a percent
+ *                   (RECORDER_NO_VALUE = no task or unregistered stack size).
+ * - crc           : CRC32 of all bytes before it.
+ */
+typedef struct
+{
+    uint32_t sequence;
+    uint32_t uptime_ms;
+    uint32_t dram_free;
+    uint32_t dram_min_free;
+    uint32_t psram_free;
+    uint16_t cpu_overall;
+    uint16_t cpu_core[SYSMON_CORE_COUNT];
+    uint16_t task_cpu[CONFIG_SYSMON_RECORDER_TASKS];
+    uint16_t task_stack[CONFIG_SYSMON_RECORDER_TASKS];
+    uint32_t crc;
+} SysMonRecorderSample;
+
+typedef struct
+{
+    SysMonRecorderHeader header;
+    SysMonRecorderTask tasks[CONFIG_SYSMON_RECORDER_TASKS];
+    SysMonRecorderSample samples[CONFIG_SYSMON_RECORDER_SAMPLES];
+} SysMonRecorderRegion;
+
+#ifdef CONFIG_SYSMON_RECORDER_STORE_PSRAM
+static EXT_RAM_NOINIT_ATTR SysMonRecorderRegion s_region;
+#else
+static RTC_NOINIT_ATTR SysMonRecorderRegion s_region;
+#endif
+
+// Previous boot's recording (heap copy, kept until reboot)
+static SysMonRecorderRegion *s_previous = NULL;
+static esp_reset_reason_t s_previous_reset_reason = ESP_RST_UNKNOWN;
+static bool s_boot_checked = false;
+
+// Sampling configuration the current recording was started with (see sysmon_set_sampling())
+static uint32_t s_recorded_generation = 0;
+
+// Column bookkeeping of the current recording (cleared with .bss on every boot)
+static int16_t s_column_slot[CONFIG_SYSMON_RECORDER_TASKS];
+
+// ============================================================================
+// Internal Helper Functions (Validation)
+// ============================================================================
+
+static uint32_t _crc(const void *data, size_t len)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)data, (uint32_t)len);
+}
+
+/**
+ * @brief Check that a region holds a recording with this firmware's layout.
+ *
+ * @param region Region to check.
+ * @return true if the header is intact and the layout matches.
+ */
+static bool _header_valid(const SysMonRecorderRegion *region)
+{
+    const SysMonRecorderHeader *header = &region->header;
+    return header->magic == RECORDER_MAGIC &&
+           header->crc == _crc(header, offsetof(SysMonRecorderHeader, crc)) &&
+           header->version == RECORDER_VERSION &&
+           header->record_size == sizeof(SysMonRecorderSample) &&
+           header->record_count == CONFIG_SYSMON_RECORDER_SAMPLES &&
+           header->task_columns == CONFIG_SYSMON_RECORDER_TASKS &&
+           header->core_count == SYSMON_CORE_COUNT;
+}
+
+/**
+ * @brief Clear torn records and task entries of a copied recording.
+ *
+ * Afterwards a record is valid exactly when its sequence is non-zero, and a
+ * task entry when its first_seq is non-zero.
+ *
+ * @param region Copied recording.
+ */
+static void _scrub_recording(SysMonRecorderRegion *region)
+{
+    for (int i = 0; i < CONFIG_SYSMON_RECORDER_SAMPLES; i++)
+    {
+        SysMonRecorderSample *sample = &region->samples[i];
+        if (sample->crc != _crc(sample, offsetof(SysMonRecorderSample, crc)))
+        {
+            sample->sequence = 0;
+        }
+    }
+    for (int c = 0; c < CONFIG_SYSMON_RECORDER_TASKS; c++)
+    {
+        SysMonRecorderTask *task = &region->tasks[c];
+        if (task->crc != _crc(task, offsetof(SysMonRecorderTask, crc)))
+        {
+            task->first_seq = 0;
+        }
+        task->name[RECORDER_NAME_LEN - 1] = '\0';
+    }
+}
+
+/**
+ * @brief Reset the region for a new recording.
+ *
+ * @param boot_count Boot count to store in the header.
+ */
+static void _start_recording(uint32_t boot_count)
+{
+    memset(&s_region, 0, sizeof(s_region));
+    for (int c = 0; c < CONFIG_SYSMON_RECORDER_TASKS; c++)
+    {
+        s_column_slot[c] = -1;
+    }
+
+    SysMonRecorderHeader *header = &s_region.header;
+    header->magic        = RECORDER_MAGIC;
+    header->version      = RECORDER_VERSION;
+    header->record_size  = sizeof(SysMonRecorderSample);
+    header->record_count = CONFIG_SYSMON_RECORDER_SAMPLES;
+    header->task_columns = CONFIG_SYSMON_RECORDER_TASKS;
+    header->core_count   = SYSMON_CORE_COUNT;
+    header->interval_ms  = self.sample_interval_ms;
+    header->boot_count   = boot_count;
+    header->crc          = _crc(header, offsetof(SysMonRecorderHeader, crc));
+    s_recorded_generation = self.sampling_generation;
+}
+
+// ============================================================================
+// Internal Helper Functions (Recording)
+// ============================================================================
+
+/**
+ * @brief Check whether a column still belongs to the task in its sysmon slot.
+ *
+ * @param column Column index.
+ * @return true if the column's task is still tracked in the same slot.
+ */
+static bool _column_live(int column)
+{
+    int slot = s_column_slot[column];
+    return slot >= 0 && slot < self.task_capacity && self.tasks[slot].is_active &&
+           (uint32_t)self.tasks[slot].task_id == s_region.tasks[column].task_id;
+}
+
+/**
+ * @brief Give free columns to active tasks that have none.
+ *
+ * Columns are handed out first come, first served; a column is freed when its
+ * task is deleted. Only the table entry of a newly assigned column is written.
+ */
+static void _assign_columns(void)
+{
+    int next_free = 0;
+    for (int slot = 0; slot < self.task_capacity; slot++)
+    {
+        const TaskUsageSample *task = &self.tasks[slot];
+        if (!task->is_active)
+        {
+            continue;
+        }
+
+        bool has_column = false;
+        for (int c = 0; c < CONFIG_SYSMON_RECORDER_TASKS && !has_column; c++)
+        {
+            has_column = (s_column_slot[c] == slot && _column_live(c));
+        }
+        if (has_column)
+        {
+            continue;
+        }
+
+        while (next_free < CONFIG_SYSMON_RECORDER_TASKS && s_column_slot[next_free] >= 0)
+        {
+            next_free++;
+        }
+        if (next_free >= CONFIG_SYSMON_RECORDER_TASKS)
+        {
+            return;
+        }
+
+        SysMonRecorderTask entry = { 0 };
+        strncpy(entry.name, _get_task_display_name(task->task_name), RECORDER_NAME_LEN - 1);
+        entry.task_id   = (uint32_t)task->task_id;
+        entry.first_seq = self.sample_sequence;
+        entry.crc       = _crc(&entry, offsetof(SysMonRecorderTask, crc));
+        s_region.tasks[next_free] = entry;
+        s_column_slot[next_free]  = (int16_t)slot;
+    }
+}
+
+// ============================================================================
+// Internal Helper Functions (Readback)
+// ============================================================================
+
+/**
+ * @brief Get a short name for a reset reason.
+ *
+ * @param reason Reset reason of the current boot (why the previous one ended).
+ * @return Static string.
+ */
+static const char *_reset_reason_name(esp_reset_reason_t reason)
+{
+    switch (reason)
+    {
+        case ESP_RST_POWERON:   return "poweron";
+        case ESP_RST_EXT:       return "external";
+        case ESP_RST_SW:        return "software";
+        case ESP_RST_PANIC:     return "panic";
+        case ESP_RST_INT_WDT:   return "int_wdt";
+        case ESP_RST_TASK_WDT:  return "task_wdt";
+        case ESP_RST_WDT:       return "wdt";
+        case ESP_RST_DEEPSLEEP: return "deepsleep";
+        case ESP_RST_BROWNOUT:  return "brownout";
+        case ESP_RST_SDIO:      return "sdio";
+        default:                return "unknown";
+    }
+}
+
+/**
+ * @brief Find the sequence range of the valid records of a recording.
+ *
+ * @param region Scrubbed recording.
+ * @param first Output: oldest sequence still in the ring window.
+ * @param latest Output: newest recorded sequence (0 = no records).
+ */
+static void _recording_range(const SysMonRecorderRegion *region, uint32_t *first, uint32_t *latest)
+{
+    *latest = 0;
+    for (int i = 0; i < CONFIG_SYSMON_RECORDER_SAMPLES; i++)
+    {
+        if (region->samples[i].sequence > *latest)
+        {
+            *latest = region->samples[i].sequence;
+        }
+    }
+    *first = (*latest > CONFIG_SYSMON_RECORDER_SAMPLES) ? (*latest - CONFIG_SYSMON_RECORDER_SAMPLES + 1) : 1;
+}
+
+/**
+ * @brief Get the valid record of a sequence number, or NULL if it was lost.
+ *
+ * @param region Scrubbed recording.
+ * @param seq Sample sequence.
+ * @return Record or NULL.
+ */
+static const SysMonRecorderSample *_record_at(const SysMonRecorderRegion *region, uint32_t seq)
+{
+    const SysMonRecorderSample *sample = &region->samples[seq % CONFIG_SYSMON_RECORDER_SAMPLES];
+    return (sample->sequence == seq) ? sample : NULL;
+}
+
+/**
+ * @brief Stream one field of every valid record as a JSON array.
+ *
+ * @param stream Stream writer.
+ * @param first First sequence.
+ * @param latest Last sequence.
+ * @param offset Byte offset of the field in SysMonRecorderSample.
+ * @param is_percent Field is a uint16 in hundredths of a percent (else uint32).
+ * @param since_seq Samples before this sequence are emitted as null (task columns).
+ */
+static void _stream_record_field(sysmon_stream_t *stream, uint32_t first, uint32_t latest,
+                                 size_t offset, bool is_percent, uint32_t since_seq)
+{
+    bool first_value = true;
+    _stream_puts(stream, "[");
+    for (uint32_t seq = first; seq <= latest && latest > 0; seq++)
+    {
+        const SysMonRecorderSample *sample = _record_at(s_previous, seq);
+        if (sample == NULL)
+        {
+            continue;
+        }
+        _stream_puts(stream, first_value ? "" : ",");
+        first_value = false;
+
+        const uint8_t *field = (const uint8_t *)sample + offset;
+        if (is_percent)
+        {
+            uint16_t value;
+            memcpy(&value, field, sizeof(value));
+            if (value == RECORDER_NO_VALUE || seq < since_seq)
+            {
+                _stream_puts(stream, "null");
+            }
+            else
+            {
+                _stream_printf(stream, "%g", value / 100.0);
+            }
+        }
+        else
+        {
+            uint32_t value;
+            memcpy(&value, field, sizeof(value));
+            _stream_printf(stream, "%" PRIu32, value);
+        }
+    }
+    _stream_puts(stream, "]");
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Validate and keep the previous boot's recording, then start a new one.
+ */
+void _recorder_init(void)
+{
+    uint32_t boot_count = 1;
+    if (!s_boot_checked)
+    {
+        s_boot_checked = true;
+        if (_header_valid(&s_region))
+        {
+            boot_count = s_region.header.boot_count + 1;
+            s_previous = (SysMonRecorderRegion *)malloc(sizeof(SysMonRecorderRegion));
+            if (s_previous != NULL)
+            {
+                memcpy(s_previous, &s_region, sizeof(SysMonRecorderRegion));
+                _scrub_recording(s_previous);
+                s_previous_reset_reason = esp_reset_reason();
+                ESP_LOGI(LOG_TAG, "Kept flight recording of boot %" PRIu32 " (reset reason: %s)",
+                         s_previous->header.boot_count, _reset_reason_name(s_previous_reset_reason));
+            }
+            else
+            {
+                ESP_LOGW(LOG_TAG, "No memory to keep the previous boot's flight recording");
+            }
+        }
+    }
+    else
+    {
+        // Restarted within the same boot: keep counting this boot
+        boot_count = _header_valid(&s_region) ? s_region.header.boot_count : 1;
+    }
+    _start_recording(boot_count);
+}
+
+/**
+ * @brief Append the newest committed sample to the recording.
+ *
+ * A recording holds samples of a single sampling interval: when
+ * sysmon_set_sampling() changes it, the recording starts over, as the
+ * history window does.
+ */
+void _recorder_commit_sample(void)
+{
+    if (self.sample_sequence == 0 || self.history == NULL)
+    {
+        return;
+    }
+    if (self.sampling_generation != s_recorded_generation)
+    {
+        _start_recording(s_region.header.boot_count);
+    }
+    const SysMonHistoryStore *history = self.history;
+    int index = (self.series_write_index - 1 + history->slots) % history->slots;
+
+    for (int c = 0; c < CONFIG_SYSMON_RECORDER_TASKS; c++)
+    {
+        if (s_column_slot[c] >= 0 && !_column_live(c))
+        {
+            s_column_slot[c] = -1;
+        }
+    }
+    _assign_columns();
+
+    SysMonRecorderSample sample;
+    memset(&sample, 0, sizeof(sample));
+    sample.sequence      = self.sample_sequence;
+    sample.uptime_ms     = (uint32_t)(self.slot_time_us / 1000);
+    sample.dram_free     = history->dram_free[index];
+    sample.dram_min_free = history->dram_min_free[index];
+    sample.psram_free    = history->psram_free[index];
+    sample.cpu_overall   = _quantize_percent(history->cpu_overall_percent[index]);
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        sample.cpu_core[core] = _quantize_percent(SYSMON_CORE_RING(history, cpu_core_percent, core)[index]);
+    }
+    for (int c = 0; c < CONFIG_SYSMON_RECORDER_TASKS; c++)
+    {
+        int slot = s_column_slot[c];
+        sample.task_cpu[c]   = RECORDER_NO_VALUE;
+        sample.task_stack[c] = RECORDER_NO_VALUE;
+        if (slot < 0)
+        {
+            continue;
+        }
+        sample.task_cpu[c] = _quantize_percent(SYSMON_TASK_RING(self.history, usage_percent, slot)[index]);
+        if (self.tasks[slot].stack_size_bytes > 0U)
+        {
+            sample.task_stack[c] = _quantize_percent(SYSMON_TASK_RING(self.history, stack_usage_percent, slot)[index]);
+        }
+    }
+    sample.crc = _crc(&sample, offsetof(SysMonRecorderSample, crc));
+
+    s_region.samples[sample.sequence % CONFIG_SYSMON_RECORDER_SAMPLES] = sample;
+}
+
+/**
+ * @brief Stream the previous boot's recording as a chunked JSON response.
+ *
+ * @param request HTTP request to send the response on.
+ * @return ESP_OK on success, error code otherwise.
+ *
+ * Details:
+ *   - Emits {"boot":"previous", "bootCount", "resetReason", "intervalMs", "seq", "from", "count",
+ *     "seqs", "uptimeMs", "series": {...}, "tasks": {...}}; "resetReason" is why that boot ended.
+ *   - Records lost to a reset while they were being written are skipped; "seqs" lists the
+ *     sequence number of every emitted sample, so gaps are visible.
+ *   - Task "cpu" and "stackPct" arrays hold null for samples before the task got its column
+ *     and, for "stackPct", for tasks without a registered stack size.
+ */
+esp_err_t _stream_recorder_json(httpd_req_t *request)
+{
+    if (s_previous == NULL)
+    {
+        return httpd_resp_send_err(request, HTTPD_404_NOT_FOUND, "No flight recording from the previous boot");
+    }
+
+    sysmon_stream_t *stream = (sysmon_stream_t *)malloc(sizeof(sysmon_stream_t));
+    if (stream == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    _stream_begin(stream, request);
+
+    uint32_t first, latest;
+    _recording_range(s_previous, &first, &latest);
+    uint32_t count = 0;
+    for (uint32_t seq = first; seq <= latest && latest > 0; seq++)
+    {
+        count += (_record_at(s_previous, seq) != NULL) ? 1U : 0U;
+    }
+
+    _stream_printf(stream, "{\"boot\":\"previous\",\"bootCount\":%" PRIu32 ",\"resetReason\":\"%s\","
+                   "\"intervalMs\":%" PRIu32 ",\"seq\":%" PRIu32 ",\"from\":%" PRIu32 ",\"count\":%" PRIu32,
+                   s_previous->header.boot_count, _reset_reason_name(s_previous_reset_reason),
+                   s_previous->header.interval_ms, latest, (count > 0) ? first : 0, count);
+    _stream_puts(stream, ",\"seqs\":");
+    _stream_record_field(stream, first, latest, offsetof(SysMonRecorderSample, sequence), false, 0);
+    _stream_puts(stream, ",\"uptimeMs\":");
+    _stream_record_field(stream, first, latest, offsetof(SysMonRecorderSample, uptime_ms), false, 0);
+
+    _stream_puts(stream, ",\"series\":{\"cpuOverall\":");
+    _stream_record_field(stream, first, latest, offsetof(SysMonRecorderSample, cpu_overall), true, 0);
+    _stream_puts(stream, ",\"cpuCores\":[");
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        _stream_puts(stream, (core > 0) ? "," : "");
+        _stream_record_field(stream, first, latest,
+                             offsetof(SysMonRecorderSample, cpu_core) + core * sizeof(uint16_t), true, 0);
+    }
+    _stream_puts(stream, "],\"dramFree\":");
+    _stream_record_field(stream, first, latest, offsetof(SysMonRecorderSample, dram_free), false, 0);
+    _stream_puts(stream, ",\"dramMinFree\":");
+    _stream_record_field(stream, first, latest, offsetof(SysMonRecorderSample, dram_min_free), false, 0);
+    _stream_puts(stream, ",\"psramFree\":");
+    _stream_record_field(stream, first, latest, offsetof(SysMonRecorderSample, psram_free), false, 0);
+
+    _stream_puts(stream, "},\"tasks\":{");
+    bool first_task = true;
+    for (int c = 0; c < CONFIG_SYSMON_RECORDER_TASKS; c++)
+    {
+        const SysMonRecorderTask *task = &s_previous->tasks[c];
+        if (task->first_seq == 0)
+        {
+            continue;
+        }
+        _stream_puts(stream, first_task ? "" : ",");
+        first_task = false;
+        _stream_json_string(stream, task->name);
+        _stream_printf(stream, ":{\"id\":%" PRIu32 ",\"cpu\":", task->task_id);
+        _stream_record_field(stream, first, latest,
+                             offsetof(SysMonRecorderSample, task_cpu) + c * sizeof(uint16_t), true, task->first_seq);
+        _stream_puts(stream, ",\"stackPct\":");
+        _stream_record_field(stream, first, latest,
+                             offsetof(SysMonRecorderSample, task_stack) + c * sizeof(uint16_t), true, task->first_seq);
+        _stream_puts(stream, "}");
+    }
+    _stream_puts(stream, "}}");
+
+    esp_err_t result = _stream_end(stream);
+    free(stream);
+    return result;
+}
+
+#else // !CONFIG_SYSMON_RECORDER
+
+void _recorder_init(void)
+{
+}
+
+void _recorder_commit_sample(void)
+{
+}
+
+esp_err_t _stream_recorder_json(httpd_req_t *request)
+{
+    return httpd_resp_send_err(request, HTTPD_404_NOT_FOUND, "Flight recorder disabled");
+}
+
+#endif // CONFIG_SYSMON_RECORDER
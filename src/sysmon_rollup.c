@@ -0,0 +1,433 @@
+/**
+ * @file sysmon_rollup.c
+ * @brief Downsampled history tiers for sysmon.
+ *
+ * This file implements the incremental rollups behind '/history?resolution='.
+ * Whenever the raw sample count reaches a medium bucket boundary, the sampler
+ * summarizes the newest CONFIG_SYSMON_ROLLUP_MID_SAMPLES raw samples (still in
+ * the raw rings) into one medium bucket; every CONFIG_SYSMON_ROLLUP_COARSE_FACTOR
+ * medium buckets are in turn summarized into one coarse bucket. The global
+ * series buckets live in self.series_rollups and the per-task buckets in the
+ * task history store, so they share its placement (PSRAM) and lifetime.
+ *
+ * Bucket n of a tier lives at ring index n % slots; the spare slot keeps the
+ * bucket being written outside the window of the published snapshot.
+ */
+
+// Project-specific includes
+#include "sysmon_rollup.h"
+#include "sysmon.h"
+#include "sysmon_utils.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef CONFIG_SYSMON_ROLLUPS
+
+static const SysMonRollupTier s_rollup_tiers[SYSMON_ROLLUP_TIER_COUNT] =
+{
+    {
+        .span_samples = CONFIG_SYSMON_ROLLUP_MID_SAMPLES,
+        .bucket_count = CONFIG_SYSMON_ROLLUP_MID_COUNT,
+        .slots        = CONFIG_SYSMON_ROLLUP_MID_COUNT + 1,
+        .offset       = 0
+    },
+    {
+        .span_samples = CONFIG_SYSMON_ROLLUP_MID_SAMPLES * CONFIG_SYSMON_ROLLUP_COARSE_FACTOR,
+        .bucket_count = CONFIG_SYSMON_ROLLUP_COARSE_COUNT,
+        .slots        = CONFIG_SYSMON_ROLLUP_COARSE_COUNT + 1,
+        .offset       = CONFIG_SYSMON_ROLLUP_MID_COUNT + 1
+    }
+};
+
+/**
+ * @brief Running min/sum/max of quantized percentages.
+ */
+typedef struct
+{
+    uint32_t sum;
+    uint32_t count;
+    uint16_t min;
+    uint16_t max;
+} stat_accumulator_t;
+
+/**
+ * @brief Accumulator for one global series bucket.
+ */
+typedef struct
+{
+    stat_accumulator_t cpu_overall;
+    stat_accumulator_t cpu_core[SYSMON_CORE_COUNT];
+    stat_accumulator_t dram_used_percent;
+    stat_accumulator_t psram_used_percent;
+    uint32_t dram_free_min;
+    uint32_t dram_largest_min;
+    uint32_t psram_free_min;
+} series_accumulator_t;
+
+/**
+ * @brief Accumulator for one task bucket.
+ */
+typedef struct
+{
+    stat_accumulator_t cpu;
+    uint32_t stack_max;
+} task_accumulator_t;
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Reset a statistic accumulator.
+ *
+ * @param acc Accumulator.
+ */
+static void _stat_begin(stat_accumulator_t *acc)
+{
+    acc->sum   = 0;
+    acc->count = 0;
+    acc->min   = UINT16_MAX;
+    acc->max   = 0;
+}
+
+/**
+ * @brief Fold a bucket statistic (or a raw sample with min == avg == max) into an accumulator.
+ *
+ * @param acc Accumulator.
+ * @param stat Statistic to add.
+ */
+static void _stat_add(stat_accumulator_t *acc, const SysMonRollupStat *stat)
+{
+    acc->sum += stat->avg;
+    acc->count++;
+    if (stat->min < acc->min)
+    {
+        acc->min = stat->min;
+    }
+    if (stat->max > acc->max)
+    {
+        acc->max = stat->max;
+    }
+}
+
+/**
+ * @brief Store an accumulated statistic (buckets have equal spans, so the average of averages is exact).
+ *
+ * @param acc Accumulator.
+ * @param stat Output statistic.
+ */
+static void _stat_end(const stat_accumulator_t *acc, SysMonRollupStat *stat)
+{
+    if (acc->count == 0)
+    {
+        stat->min = stat->avg = stat->max = 0;
+        return;
+    }
+    stat->min = acc->min;
+    stat->avg = (uint16_t)((acc->sum + acc->count / 2) / acc->count);
+    stat->max = acc->max;
+}
+
+/**
+ * @brief Build a statistic for a single raw percentage sample.
+ *
+ * @param percent Raw percentage.
+ * @return Statistic with min, avg and max set to the sample.
+ */
+static SysMonRollupStat _stat_from_sample(float percent)
+{
+    uint16_t value = _quantize_percent(percent);
+    SysMonRollupStat stat = { .min = value, .avg = value, .max = value };
+    return stat;
+}
+
+/**
+ * @brief Reset a global series accumulator.
+ *
+ * @param acc Accumulator.
+ */
+static void _series_begin(series_accumulator_t *acc)
+{
+    _stat_begin(&acc->cpu_overall);
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        _stat_begin(&acc->cpu_core[core]);
+    }
+    _stat_begin(&acc->dram_used_percent);
+    _stat_begin(&acc->psram_used_percent);
+    acc->dram_free_min    = UINT32_MAX;
+    acc->dram_largest_min = UINT32_MAX;
+    acc->psram_free_min   = UINT32_MAX;
+}
+
+/**
+ * @brief Fold a global series bucket into an accumulator.
+ *
+ * @param acc Accumulator.
+ * @param bucket Bucket to add.
+ */
+static void _series_add(series_accumulator_t *acc, const SysMonSeriesRollup *bucket)
+{
+    _stat_add(&acc->cpu_overall, &bucket->cpu_overall);
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        _stat_add(&acc->cpu_core[core], &bucket->cpu_core[core]);
+    }
+    _stat_add(&acc->dram_used_percent, &bucket->dram_used_percent);
+    _stat_add(&acc->psram_used_percent, &bucket->psram_used_percent);
+    if (bucket->dram_free_min < acc->dram_free_min)
+    {
+        acc->dram_free_min = bucket->dram_free_min;
+    }
+    if (bucket->dram_largest_min < acc->dram_largest_min)
+    {
+        acc->dram_largest_min = bucket->dram_largest_min;
+    }
+    if (bucket->psram_free_min < acc->psram_free_min)
+    {
+        acc->psram_free_min = bucket->psram_free_min;
+    }
+}
+
+/**
+ * @brief Store an accumulated global series bucket.
+ *
+ * @param acc Accumulator.
+ * @param bucket Output bucket.
+ */
+static void _series_end(const series_accumulator_t *acc, SysMonSeriesRollup *bucket)
+{
+    _stat_end(&acc->cpu_overall, &bucket->cpu_overall);
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        _stat_end(&acc->cpu_core[core], &bucket->cpu_core[core]);
+    }
+    _stat_end(&acc->dram_used_percent, &bucket->dram_used_percent);
+    _stat_end(&acc->psram_used_percent, &bucket->psram_used_percent);
+    bucket->dram_free_min    = acc->dram_free_min;
+    bucket->dram_largest_min = acc->dram_largest_min;
+    bucket->psram_free_min   = acc->psram_free_min;
+}
+
+/**
+ * @brief Build a global series bucket from a single raw sample.
+ *
+ * @param index Raw ring index.
+ * @param bucket Output bucket.
+ */
+static void _series_from_sample(int index, SysMonSeriesRollup *bucket)
+{
+    const SysMonHistoryStore *history = self.history;
+    bucket->cpu_overall        = _stat_from_sample(history->cpu_overall_percent[index]);
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        bucket->cpu_core[core] = _stat_from_sample(SYSMON_CORE_RING(history, cpu_core_percent, core)[index]);
+    }
+    bucket->dram_used_percent  = _stat_from_sample(history->dram_used_percent[index]);
+    bucket->psram_used_percent = _stat_from_sample(history->psram_used_percent[index]);
+    bucket->dram_free_min      = history->dram_free[index];
+    bucket->dram_largest_min   = history->dram_largest_block[index];
+    bucket->psram_free_min     = history->psram_free[index];
+}
+
+/**
+ * @brief Fold a task bucket into an accumulator.
+ *
+ * @param acc Accumulator.
+ * @param bucket Bucket to add.
+ */
+static void _task_add(task_accumulator_t *acc, const SysMonTaskRollup *bucket)
+{
+    _stat_add(&acc->cpu, &bucket->cpu);
+    if (bucket->stack_max > acc->stack_max)
+    {
+        acc->stack_max = bucket->stack_max;
+    }
+}
+
+/**
+ * @brief Commit the medium bucket ending at the newest raw sample.
+ *
+ * @param tier Medium tier.
+ */
+static void _commit_mid_bucket(const SysMonRollupTier *tier)
+{
+    int bucket = tier->offset + (int)(self.rollup_sequence[0] % (uint32_t)tier->slots);
+    int slots = self.history->slots;
+    int newest = (self.series_write_index - 1 + slots) % slots;
+    int start = (newest - (int)tier->span_samples + 1 + slots) % slots;
+
+    series_accumulator_t series;
+    _series_begin(&series);
+    for (uint32_t k = 0; k < tier->span_samples; k++)
+    {
+        SysMonSeriesRollup sample;
+        _series_from_sample((start + (int)k) % slots, &sample);
+        _series_add(&series, &sample);
+    }
+    _series_end(&series, &self.series_rollups[bucket]);
+
+    for (int slot = 0; slot < self.task_capacity; slot++)
+    {
+        if (!self.tasks[slot].is_active)
+        {
+            continue;
+        }
+
+        const float *cpu_ring = SYSMON_TASK_RING(self.history, usage_percent, slot);
+        const uint32_t *stack_ring = SYSMON_TASK_RING(self.history, stack_usage_bytes, slot);
+        task_accumulator_t task = { .stack_max = 0 };
+        _stat_begin(&task.cpu);
+        for (uint32_t k = 0; k < tier->span_samples; k++)
+        {
+            int index = (start + (int)k) % slots;
+            SysMonTaskRollup sample = { .cpu = _stat_from_sample(cpu_ring[index]), .stack_max = stack_ring[index] };
+            _task_add(&task, &sample);
+        }
+
+        SysMonTaskRollup *out = &SYSMON_TASK_ROLLUPS(self.history, slot)[bucket];
+        _stat_end(&task.cpu, &out->cpu);
+        out->stack_max = task.stack_max;
+    }
+
+    self.rollup_sequence[0]++;
+}
+
+/**
+ * @brief Commit the coarse bucket made of the newest medium buckets.
+ *
+ * @param mid Medium tier.
+ * @param tier Coarse tier.
+ */
+static void _commit_coarse_bucket(const SysMonRollupTier *mid, const SysMonRollupTier *tier)
+{
+    int bucket = tier->offset + (int)(self.rollup_sequence[1] % (uint32_t)tier->slots);
+    uint32_t first_mid = self.rollup_sequence[0] - CONFIG_SYSMON_ROLLUP_COARSE_FACTOR;
+
+    series_accumulator_t series;
+    _series_begin(&series);
+    for (uint32_t k = 0; k < CONFIG_SYSMON_ROLLUP_COARSE_FACTOR; k++)
+    {
+        int source = mid->offset + (int)((first_mid + k) % (uint32_t)mid->slots);
+        _series_add(&series, &self.series_rollups[source]);
+    }
+    _series_end(&series, &self.series_rollups[bucket]);
+
+    for (int slot = 0; slot < self.task_capacity; slot++)
+    {
+        if (!self.tasks[slot].is_active)
+        {
+            continue;
+        }
+
+        SysMonTaskRollup *rollups = SYSMON_TASK_ROLLUPS(self.history, slot);
+        task_accumulator_t task = { .stack_max = 0 };
+        _stat_begin(&task.cpu);
+        for (uint32_t k = 0; k < CONFIG_SYSMON_ROLLUP_COARSE_FACTOR; k++)
+        {
+            _task_add(&task, &rollups[mid->offset + (int)((first_mid + k) % (uint32_t)mid->slots)]);
+        }
+        _stat_end(&task.cpu, &rollups[bucket].cpu);
+        rollups[bucket].stack_max = task.stack_max;
+    }
+
+    self.rollup_sequence[1]++;
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Get the description of a rollup tier.
+ *
+ * @param tier Tier index (0 = medium, 1 = coarse).
+ * @return Tier description, or NULL if the tier does not exist.
+ */
+const SysMonRollupTier *_rollup_get_tier(int tier)
+{
+    if (tier < 0 || tier >= SYSMON_ROLLUP_TIER_COUNT)
+    {
+        return NULL;
+    }
+    return &s_rollup_tiers[tier];
+}
+
+/**
+ * @brief Get the duration one bucket of a rollup tier covers.
+ *
+ * @param tier Tier index.
+ * @return Bucket duration in milliseconds (0 if the tier does not exist).
+ */
+uint32_t _rollup_tier_resolution_ms(int tier)
+{
+    const SysMonRollupTier *description = _rollup_get_tier(tier);
+    return (description != NULL) ? description->span_samples * CONFIG_SYSMON_CPU_SAMPLING_INTERVAL_MS : 0;
+}
+
+/**
+ * @brief Pick the tier serving a requested resolution.
+ *
+ * @param resolution_ms Requested resolution in milliseconds.
+ * @return Tier index, or -1 for the raw samples.
+ */
+int _rollup_find_tier(uint32_t resolution_ms)
+{
+    if (self.series_rollups == NULL || resolution_ms <= self.sample_interval_ms)
+    {
+        return -1;
+    }
+
+    for (int tier = 0; tier < SYSMON_ROLLUP_TIER_COUNT; tier++)
+    {
+        if (_rollup_tier_resolution_ms(tier) >= resolution_ms)
+        {
+            return tier;
+        }
+    }
+    return SYSMON_ROLLUP_TIER_COUNT - 1;
+}
+
+/**
+ * @brief Commit rollup buckets that completed with the newest raw sample.
+ */
+void _rollup_commit_sample(void)
+{
+    if (self.series_rollups == NULL || self.history == NULL ||
+        self.sample_sequence % CONFIG_SYSMON_ROLLUP_MID_SAMPLES != 0 ||
+        !_sampling_at_base_interval(CONFIG_SYSMON_ROLLUP_MID_SAMPLES))
+    {
+        return;
+    }
+
+    _commit_mid_bucket(&s_rollup_tiers[0]);
+    if (self.rollup_sequence[0] % CONFIG_SYSMON_ROLLUP_COARSE_FACTOR == 0)
+    {
+        _commit_coarse_bucket(&s_rollup_tiers[0], &s_rollup_tiers[1]);
+    }
+}
+
+#else // !CONFIG_SYSMON_ROLLUPS
+
+const SysMonRollupTier *_rollup_get_tier(int tier)
+{
+    return NULL;
+}
+
+uint32_t _rollup_tier_resolution_ms(int tier)
+{
+    return 0;
+}
+
+int _rollup_find_tier(uint32_t resolution_ms)
+{
+    return -1;
+}
+
+void _rollup_commit_sample(void)
+{
+}
+
+#endif // CONFIG_SYSMON_ROLLUPS
@@ -4,6 +4,20 @@
  *
  * This module manages stack size registration for tasks to enable accurate
  * stack usage percentage calculations in the sysmon monitoring system.
+ *
+ * Records live in an open-addressing hash table keyed by TaskHandle_t.
+ * Registration is serialized with a spinlock; lookups are lock-free and
+ * validated with a sequence counter (seqlock), so the sampler never masks
+ * interrupts to read a stack size. When the table grows, the previous table
+ * is retired and only freed on the next growth or at cleanup, so a lock-free
+ * reader that is still probing it never touches released memory.
+ *
+ * Each record also carries the task's stack alert threshold. With
+ * CONFIG_SYSMON_STACK_ALERTS the sampler checks every registered task once
+ * per sample against that threshold and against a growth trend taken from the
+ * stack usage ring (the current entry against the one
+ * CONFIG_SYSMON_STACK_ALERT_WINDOW samples back), and raises an alert through
+ * the user callback and the default event loop when the task's level rises.
  */
 
 // Project-specific includes
@@ -11,28 +25,228 @@
 #include "sysmon.h"
 
 // ESP-IDF includes
+#include "esp_event.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
 // System includes
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
 // Logger tag for this module
 static const char *LOG_TAG = "sysmon_stack";
 
+// Initial number of buckets (power of two); the table doubles at 50% load
+#define STACK_TABLE_INITIAL_SIZE    32
+
+// Lock-free read attempts before falling back to the registration lock
+#define STACK_READ_RETRIES          4
+
 typedef struct
 {
     TaskHandle_t handle;
     uint32_t     depth_bytes;
-    bool         is_valid;
+    uint8_t      alert_percent;  // SYSMON_STACK_ALERT_DEFAULT, SYSMON_STACK_ALERT_OFF or 1-100
 } TaskStackRecord;
 
-static TaskStackRecord *s_stack_records = NULL;
-static int s_stack_records_capacity = 0;
+typedef struct
+{
+    int             size;       // Number of buckets (power of two)
+    int             count;      // Number of occupied buckets
+    TaskStackRecord records[];  // Buckets (handle == NULL means empty)
+} TaskStackTable;
+
+static TaskStackTable *s_stack_table = NULL;
+static TaskStackTable *s_retired_stack_table = NULL;
+static uint32_t s_stack_table_sequence = 0;    // Odd while a writer is modifying the table
+static uint32_t s_stack_table_generation = 0;  // Bumped on every registration change
 static portMUX_TYPE s_stack_records_lock = portMUX_INITIALIZER_UNLOCKED;
 
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Hash a task handle into a table bucket.
+ *
+ * @param table Hash table.
+ * @param handle Task handle.
+ * @return Bucket index.
+ */
+static int _stack_table_bucket(const TaskStackTable *table, TaskHandle_t handle)
+{
+    // TCBs are word-aligned; drop the low bits before Fibonacci hashing
+    uint32_t key = (uint32_t)(uintptr_t)handle >> 2;
+    return (int)((key * 2654435761U) & (uint32_t)(table->size - 1));
+}
+
+/**
+ * @brief Find the bucket holding a handle, or the empty bucket where it belongs.
+ *
+ * @param table Hash table.
+ * @param handle Task handle.
+ * @return Bucket index.
+ */
+static int _stack_table_probe(const TaskStackTable *table, TaskHandle_t handle)
+{
+    int bucket = _stack_table_bucket(table, handle);
+    while (table->records[bucket].handle != NULL && table->records[bucket].handle != handle)
+    {
+        bucket = (bucket + 1) & (table->size - 1);
+    }
+    return bucket;
+}
+
+/**
+ * @brief Allocate an empty hash table.
+ *
+ * @param size Number of buckets (power of two).
+ * @return New table, or NULL on allocation failure.
+ */
+static TaskStackTable *_stack_table_create(int size)
+{
+    TaskStackTable *table = (TaskStackTable *)calloc(1, sizeof(TaskStackTable) + sizeof(TaskStackRecord) * size);
+    if (table != NULL)
+    {
+        table->size = size;
+    }
+    return table;
+}
+
+/**
+ * @brief Insert or update a record (caller holds the lock and has room in the table).
+ *
+ * @param table Hash table.
+ * @param handle Task handle.
+ * @param depth_bytes Stack size in bytes.
+ * @return true if an existing record was updated, false if a new one was added.
+ */
+static bool _stack_table_put(TaskStackTable *table, TaskHandle_t handle, uint32_t depth_bytes)
+{
+    int bucket = _stack_table_probe(table, handle);
+    bool existed = (table->records[bucket].handle != NULL);
+    table->records[bucket].depth_bytes = depth_bytes;
+    table->records[bucket].handle      = handle;
+    if (!existed)
+    {
+        table->count++;
+    }
+    return existed;
+}
+
+/**
+ * @brief Copy a record into a table being rebuilt (caller holds the lock and has room in the table).
+ *
+ * @param table Hash table.
+ * @param record Record to copy, including its alert threshold.
+ */
+static void _stack_table_insert(TaskStackTable *table, const TaskStackRecord *record)
+{
+    int bucket = _stack_table_probe(table, record->handle);
+    if (table->records[bucket].handle == NULL)
+    {
+        table->count++;
+    }
+    table->records[bucket] = *record;
+}
+
+/**
+ * @brief Begin a table modification (caller holds the lock).
+ */
+static void _stack_table_write_begin(void)
+{
+    __atomic_store_n(&s_stack_table_sequence, s_stack_table_sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * @brief End a table modification (caller holds the lock).
+ */
+static void _stack_table_write_end(void)
+{
+    __atomic_store_n(&s_stack_table_sequence, s_stack_table_sequence + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&s_stack_table_generation, s_stack_table_generation + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Look up a handle in a table.
+ *
+ * @param table Hash table (may be NULL).
+ * @param handle Task handle.
+ * @param record Output: copy of the record (zeroed if not registered).
+ * @return true if the handle is registered.
+ */
+static bool _stack_table_get(const TaskStackTable *table, TaskHandle_t handle, TaskStackRecord *record)
+{
+    memset(record, 0, sizeof(*record));
+    if (table == NULL)
+    {
+        return false;
+    }
+
+    int bucket = _stack_table_bucket(table, handle);
+    for (int probes = 0; probes < table->size; probes++)
+    {
+        TaskHandle_t stored = table->records[bucket].handle;
+        if (stored == NULL)
+        {
+            return false;
+        }
+        if (stored == handle)
+        {
+            *record = table->records[bucket];
+            return true;
+        }
+        bucket = (bucket + 1) & (table->size - 1);
+    }
+    return false;
+}
+
+/**
+ * @brief Look up a handle in the current table.
+ *
+ * Lock-free: retries if a registration ran concurrently and only takes the
+ * registration lock after repeated collisions.
+ *
+ * @param handle Task handle.
+ * @param record Output: copy of the record (zeroed if not registered).
+ * @return true if the handle is registered.
+ */
+static bool _stack_lookup(TaskHandle_t handle, TaskStackRecord *record)
+{
+    for (int attempt = 0; attempt < STACK_READ_RETRIES; attempt++)
+    {
+        uint32_t sequence = __atomic_load_n(&s_stack_table_sequence, __ATOMIC_ACQUIRE);
+        if ((sequence & 1U) != 0U)
+        {
+            continue;
+        }
+
+        const TaskStackTable *table = __atomic_load_n(&s_stack_table, __ATOMIC_ACQUIRE);
+        TaskStackRecord candidate;
+        bool found = _stack_table_get(table, handle, &candidate);
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&s_stack_table_sequence, __ATOMIC_RELAXED) == sequence)
+        {
+            *record = candidate;
+            return found;
+        }
+    }
+
+    // Persistent writer activity; read under the lock
+    portENTER_CRITICAL(&s_stack_records_lock);
+    bool found = _stack_table_get(s_stack_table, handle, record);
+    portEXIT_CRITICAL(&s_stack_records_lock);
+    return found;
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
 /**
  * @brief Register a task's stack size for accurate monitoring.
  *
@@ -54,7 +268,7 @@ void sysmon_stack_register(TaskHandle_t task_handle, uint32_t stack_size_bytes)
 
     if (task_handle == NULL || stack_size_bytes == 0U)
     {
-        ESP_LOGW(LOG_TAG, "Invalid parameters for task stack registration: handle=%p, size=%lu", 
+        ESP_LOGW(LOG_TAG, "Invalid parameters for task stack registration: handle=%p, size=%lu",
                  task_handle, (unsigned long)stack_size_bytes);
         return;
     }
@@ -66,68 +280,66 @@ void sysmon_stack_register(TaskHandle_t task_handle, uint32_t stack_size_bytes)
         task_name = "unknown";
     }
 
-    // Store or update the stack record
-    portENTER_CRITICAL(&s_stack_records_lock);
-    
-    // Determine required capacity (use task_capacity if set, otherwise use a reasonable initial size)
-    int required_capacity = (self.task_capacity > 0) ? self.task_capacity : 32;
-    
-    // Ensure capacity matches task capacity (grow if needed)
-    if (s_stack_records_capacity < required_capacity)
-    {
-        int new_capacity = required_capacity;
-        TaskStackRecord *new_records = (TaskStackRecord *)calloc(new_capacity, sizeof(TaskStackRecord));
-        if (new_records == NULL)
+    for (;;)
+    {
+        // Store or update the stack record when the table has room (load factor <= 50%)
+        portENTER_CRITICAL(&s_stack_records_lock);
+        TaskStackTable *table = s_stack_table;
+        if (table != NULL && (table->count + 1) * 2 <= table->size)
         {
+            _stack_table_write_begin();
+            bool updated = _stack_table_put(table, task_handle, stack_size_bytes);
+            _stack_table_write_end();
             portEXIT_CRITICAL(&s_stack_records_lock);
-            ESP_LOGE(LOG_TAG, "Failed to allocate stack records (capacity: %d)", new_capacity);
+            ESP_LOGI(LOG_TAG, "%s stack size for task '%s': %lu bytes", updated ? "Updated" : "Registered",
+                     task_name, (unsigned long)stack_size_bytes);
             return;
         }
-        
-        // Copy existing records
-        if (s_stack_records != NULL)
-        {
-            memcpy(new_records, s_stack_records, s_stack_records_capacity * sizeof(TaskStackRecord));
-            free(s_stack_records);
-        }
-        
-        s_stack_records = new_records;
-        s_stack_records_capacity = new_capacity;
-    }
-    
-    // Update existing record
-    for (int i = 0; i < s_stack_records_capacity; i++)
-    {
-        if (s_stack_records[i].is_valid && s_stack_records[i].handle == task_handle)
+        int new_size = (table != NULL) ? table->size * 2 : STACK_TABLE_INITIAL_SIZE;
+        portEXIT_CRITICAL(&s_stack_records_lock);
+
+        // Grow outside the critical section (heap calls must not run with interrupts masked)
+        TaskStackTable *new_table = _stack_table_create(new_size);
+        if (new_table == NULL)
         {
-            s_stack_records[i].depth_bytes = stack_size_bytes;
-            portEXIT_CRITICAL(&s_stack_records_lock);
-            ESP_LOGI(LOG_TAG, "Updated stack size for task '%s': %lu bytes", 
-                     task_name, (unsigned long)stack_size_bytes);
+            ESP_LOGE(LOG_TAG, "Failed to allocate stack records (capacity: %d)", new_size);
             return;
         }
-    }
 
-    // Create new record
-    for (int i = 0; i < s_stack_records_capacity; i++)
-    {
-        if (!s_stack_records[i].is_valid)
+        TaskStackTable *to_free = new_table;
+        portENTER_CRITICAL(&s_stack_records_lock);
+        if (s_stack_table == table)
         {
-            s_stack_records[i].handle      = task_handle;
-            s_stack_records[i].depth_bytes = stack_size_bytes;
-            s_stack_records[i].is_valid    = true;
-            break;
+            // Rehash into the new table, then publish it; readers still probing the
+            // old table are covered by the retired pointer and the sequence check
+            if (table != NULL)
+            {
+                for (int i = 0; i < table->size; i++)
+                {
+                    if (table->records[i].handle != NULL)
+                    {
+                        _stack_table_insert(new_table, &table->records[i]);
+                    }
+                }
+            }
+            _stack_table_write_begin();
+            __atomic_store_n(&s_stack_table, new_table, __ATOMIC_RELEASE);
+            _stack_table_write_end();
+            to_free = s_retired_stack_table;
+            s_retired_stack_table = table;
         }
+        portEXIT_CRITICAL(&s_stack_records_lock);
+
+        // Either the table retired two growths ago, or ours if another caller grew first
+        free(to_free);
     }
-    
-    portEXIT_CRITICAL(&s_stack_records_lock);
-    ESP_LOGI(LOG_TAG, "Registered stack size for task '%s': %lu bytes", 
-             task_name, (unsigned long)stack_size_bytes);
 }
 
 /**
  * @brief Get registered stack size for a task.
  *
+ * Lock-free hash lookup keyed by the task handle (see _stack_lookup()).
+ *
  * @param task_handle Handle of the task.
  * @param stack_size_bytes Output: stack size in bytes (0 if not registered).
  * @return true if task is registered, false otherwise.
@@ -139,23 +351,75 @@ bool sysmon_stack_get_size(TaskHandle_t task_handle, uint32_t *stack_size_bytes)
         return false;
     }
 
+    TaskStackRecord record;
+    bool found = _stack_lookup(task_handle, &record);
+    *stack_size_bytes = record.depth_bytes;
+    return found;
+}
+
+/**
+ * @brief Look up a task's registered stack size and alert threshold (used by the sampler).
+ *
+ * @param task_handle Handle of the task.
+ * @param stack_size_bytes Output: stack size in bytes (0 if not registered).
+ * @param threshold_percent Output: alert threshold (SYSMON_STACK_ALERT_DEFAULT if not set).
+ * @return true if task is registered, false otherwise.
+ */
+bool _stack_get_record(TaskHandle_t task_handle, uint32_t *stack_size_bytes, uint8_t *threshold_percent)
+{
+    TaskStackRecord record;
+    bool found = (task_handle != NULL) && _stack_lookup(task_handle, &record);
+    *stack_size_bytes  = found ? record.depth_bytes : 0U;
+    *threshold_percent = found ? record.alert_percent : SYSMON_STACK_ALERT_DEFAULT;
+    return found;
+}
+
+/**
+ * @brief Set the stack alert threshold of a registered task.
+ *
+ * Bumps the registry generation, so the sampler picks the new threshold up on
+ * its next sample through its cached lookup.
+ *
+ * @param task_handle Handle of a registered task.
+ * @param threshold_percent Peak usage percentage (1-100), SYSMON_STACK_ALERT_DEFAULT or SYSMON_STACK_ALERT_OFF.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a bad threshold,
+ *         ESP_ERR_NOT_FOUND if the task is not registered.
+ */
+esp_err_t sysmon_stack_set_alert_threshold(TaskHandle_t task_handle, uint8_t threshold_percent)
+{
+    if (task_handle == NULL || (threshold_percent > 100U && threshold_percent != SYSMON_STACK_ALERT_OFF))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = ESP_ERR_NOT_FOUND;
     portENTER_CRITICAL(&s_stack_records_lock);
-    if (s_stack_records != NULL)
+    TaskStackTable *table = s_stack_table;
+    if (table != NULL)
     {
-        for (int i = 0; i < s_stack_records_capacity; i++)
+        int bucket = _stack_table_probe(table, task_handle);
+        if (table->records[bucket].handle == task_handle)
         {
-            if (s_stack_records[i].is_valid && s_stack_records[i].handle == task_handle)
-            {
-                *stack_size_bytes = s_stack_records[i].depth_bytes;
-                portEXIT_CRITICAL(&s_stack_records_lock);
-                return true;
-            }
+            _stack_table_write_begin();
+            table->records[bucket].alert_percent = threshold_percent;
+            _stack_table_write_end();
+            err = ESP_OK;
         }
     }
     portEXIT_CRITICAL(&s_stack_records_lock);
-    
-    *stack_size_bytes = 0;
-    return false;
+    return err;
+}
+
+/**
+ * @brief Get the registry generation, which changes whenever a registration is added or updated.
+ *
+ * Callers caching stack sizes re-query sysmon_stack_get_size() when it changes.
+ *
+ * @return Current registry generation.
+ */
+uint32_t sysmon_stack_get_generation(void)
+{
+    return __atomic_load_n(&s_stack_table_generation, __ATOMIC_ACQUIRE);
 }
 
 /**
@@ -164,12 +428,181 @@ bool sysmon_stack_get_size(TaskHandle_t task_handle, uint32_t *stack_size_bytes)
 void sysmon_stack_cleanup(void)
 {
     portENTER_CRITICAL(&s_stack_records_lock);
-    if (s_stack_records != NULL)
+    TaskStackTable *table = s_stack_table;
+    TaskStackTable *retired = s_retired_stack_table;
+    _stack_table_write_begin();
+    __atomic_store_n(&s_stack_table, NULL, __ATOMIC_RELEASE);
+    _stack_table_write_end();
+    s_retired_stack_table = NULL;
+    portEXIT_CRITICAL(&s_stack_records_lock);
+
+    free(table);
+    free(retired);
+}
+
+// ============================================================================
+// Stack Alerts
+// ============================================================================
+
+ESP_EVENT_DEFINE_BASE(SYSMON_EVENT);
+
+#ifdef CONFIG_SYSMON_STACK_ALERTS
+
+static sysmon_stack_alert_cb_t s_alert_callback = NULL;
+static void *s_alert_callback_arg = NULL;
+static portMUX_TYPE s_alert_callback_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Predict the time until a stack is exhausted at its recent growth rate.
+ *
+ * @param remaining_bytes Stack left below the high water mark.
+ * @param growth_bytes Peak usage growth over the last CONFIG_SYSMON_STACK_ALERT_WINDOW samples.
+ * @return Seconds to overflow, or UINT32_MAX if usage is not growing.
+ */
+static uint32_t _seconds_to_overflow(uint32_t remaining_bytes, uint32_t growth_bytes)
+{
+    if (growth_bytes == 0U)
     {
-        free(s_stack_records);
-        s_stack_records = NULL;
-        s_stack_records_capacity = 0;
+        return UINT32_MAX;
     }
-    portEXIT_CRITICAL(&s_stack_records_lock);
+    uint64_t window_ms = (uint64_t)CONFIG_SYSMON_STACK_ALERT_WINDOW * self.sample_interval_ms;
+    uint64_t seconds = (uint64_t)remaining_bytes * window_ms / growth_bytes / 1000U;
+    return (seconds >= UINT32_MAX) ? (UINT32_MAX - 1U) : (uint32_t)seconds;
+}
+
+/**
+ * @brief Report a raised alert level through the log, the callback and the default event loop.
+ *
+ * @param alert Alert to report.
+ */
+static void _raise_alert(const sysmon_stack_alert_t *alert)
+{
+    if (alert->level == SYSMON_STACK_ALERT_THRESHOLD)
+    {
+        ESP_LOGW(LOG_TAG, "Task '%s' reached its stack alert threshold: %.1f%% used (%lu of %lu bytes, threshold %u%%)",
+                 alert->task_name, alert->usage_percent, (unsigned long)alert->used_bytes,
+                 (unsigned long)alert->stack_size_bytes, alert->threshold_percent);
+    }
+    else
+    {
+        ESP_LOGW(LOG_TAG, "Task '%s' stack trending toward overflow in ~%lu s: %.1f%% used (%lu of %lu bytes)",
+                 alert->task_name, (unsigned long)alert->seconds_to_overflow, alert->usage_percent,
+                 (unsigned long)alert->used_bytes, (unsigned long)alert->stack_size_bytes);
+    }
+
+    portENTER_CRITICAL(&s_alert_callback_lock);
+    sysmon_stack_alert_cb_t callback = s_alert_callback;
+    void *arg = s_alert_callback_arg;
+    portEXIT_CRITICAL(&s_alert_callback_lock);
+    if (callback != NULL)
+    {
+        callback(alert, arg);
+    }
+
+#ifdef CONFIG_SYSMON_STACK_ALERT_EVENT
+    // Fails without a default event loop or with a full queue; the log and callback still report it
+    esp_err_t err = esp_event_post(SYSMON_EVENT, SYSMON_EVENT_STACK_ALERT, alert, sizeof(*alert), 0);
+    if (err != ESP_OK)
+    {
+        ESP_LOGD(LOG_TAG, "Stack alert event not posted: %s", esp_err_to_name(err));
+    }
+#endif
+}
+
+/**
+ * @brief Set the function called when a task's stack alert level rises.
+ *
+ * @param callback Callback, or NULL to remove it.
+ * @param arg User argument passed to the callback.
+ * @return ESP_OK.
+ */
+esp_err_t sysmon_stack_set_alert_callback(sysmon_stack_alert_cb_t callback, void *arg)
+{
+    portENTER_CRITICAL(&s_alert_callback_lock);
+    s_alert_callback     = callback;
+    s_alert_callback_arg = arg;
+    portEXIT_CRITICAL(&s_alert_callback_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Check one task's stack usage against its threshold and growth trend.
+ *
+ * The high water mark only ever rises, so the difference between the current
+ * peak usage and the one CONFIG_SYSMON_STACK_ALERT_WINDOW samples back is the
+ * recent growth. Until a slot has that many samples of a constant stack size
+ * only the threshold is checked. An alert is raised when the level rises; a
+ * trend alert that subsides re-arms silently.
+ *
+ * @param idx Task slot index.
+ * @param write_index Ring index of the current sample.
+ */
+void _stack_alert_check(int idx, int write_index)
+{
+    TaskUsageSample *task = &self.tasks[idx];
+    uint32_t stack_size_bytes = task->stack_size_bytes;
+    if (stack_size_bytes == 0U || task->stack_alert_percent == SYSMON_STACK_ALERT_OFF)
+    {
+        task->stack_alert_level = SYSMON_STACK_ALERT_NONE;
+        return;
+    }
+    uint8_t threshold = (task->stack_alert_percent == SYSMON_STACK_ALERT_DEFAULT) ?
+                        CONFIG_SYSMON_STACK_ALERT_PERCENT : task->stack_alert_percent;
+
+    const uint32_t *ring = SYSMON_TASK_RING(self.history, stack_usage_bytes, idx);
+    uint32_t used_bytes = ring[write_index];
+    uint32_t growth_bytes = 0U;
+    if (task->stack_alert_samples >= CONFIG_SYSMON_STACK_ALERT_WINDOW)
+    {
+        int slots = self.history->slots;
+        int past_index = (write_index + slots - CONFIG_SYSMON_STACK_ALERT_WINDOW) % slots;
+        growth_bytes = (used_bytes > ring[past_index]) ? (used_bytes - ring[past_index]) : 0U;
+    }
+    else
+    {
+        task->stack_alert_samples++;
+    }
+
+    uint32_t remaining_bytes = (stack_size_bytes > used_bytes) ? (stack_size_bytes - used_bytes) : 0U;
+    uint32_t seconds_to_overflow = _seconds_to_overflow(remaining_bytes, growth_bytes);
+
+    sysmon_stack_alert_level_t level = SYSMON_STACK_ALERT_NONE;
+    if ((uint64_t)used_bytes * 100U >= (uint64_t)threshold * stack_size_bytes)
+    {
+        level = SYSMON_STACK_ALERT_THRESHOLD;
+    }
+    else if (seconds_to_overflow <= CONFIG_SYSMON_STACK_ALERT_HORIZON_S)
+    {
+        level = SYSMON_STACK_ALERT_TREND;
+    }
+
+    if (level > (sysmon_stack_alert_level_t)task->stack_alert_level)
+    {
+        sysmon_stack_alert_t alert =
+        {
+            .task_handle         = task->task_handle,
+            .level               = level,
+            .threshold_percent   = threshold,
+            .usage_percent       = (float)used_bytes * 100.0f / (float)stack_size_bytes,
+            .used_bytes          = used_bytes,
+            .stack_size_bytes    = stack_size_bytes,
+            .seconds_to_overflow = seconds_to_overflow,
+        };
+        snprintf(alert.task_name, sizeof(alert.task_name), "%s", task->task_name);
+        _raise_alert(&alert);
+    }
+    task->stack_alert_level = (uint8_t)level;
+}
+
+#else // !CONFIG_SYSMON_STACK_ALERTS
+
+esp_err_t sysmon_stack_set_alert_callback(sysmon_stack_alert_cb_t callback, void *arg)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void _stack_alert_check(int idx, int write_index)
+{
 }
 
+#endif // CONFIG_SYSMON_STACK_ALERTS
@@ -0,0 +1,224 @@
+/**
+ * @file sysmon_stream.c
+ * @brief Fixed-size chunked response writer for sysmon HTTP endpoints.
+ *
+ * This file implements a streaming writer that buffers output in a fixed-size
+ * chunk and hands it to a sink (httpd_resp_send_chunk() by default) whenever
+ * the chunk fills.
+ * Endpoint encoders write directly from the sampler ring buffers through this
+ * writer, so no intermediate cJSON tree or full response string is needed.
+ */
+
+// Project-specific includes
+#include "sysmon_stream.h"
+
+// ESP-IDF includes
+#include "esp_log.h"
+#include "esp_http_server.h"
+
+// System includes
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_stream";
+
+/**
+ * @brief Sink sending each chunk as part of a chunked HTTP response.
+ *
+ * @param ctx HTTP request.
+ * @param data Chunk bytes (NULL to terminate the response).
+ * @param len Number of bytes.
+ * @return ESP_OK on success, httpd error code otherwise.
+ */
+static esp_err_t _http_chunk_sink(void *ctx, const char *data, size_t len)
+{
+    esp_err_t err = httpd_resp_send_chunk((httpd_req_t *)ctx, data, (ssize_t)len);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(LOG_TAG, "httpd_resp_send_chunk() failed: %s (0x%x)", esp_err_to_name(err), err);
+    }
+    return err;
+}
+
+/**
+ * @brief Hand buffered bytes to the sink as one chunk.
+ *
+ * @param stream Stream writer.
+ */
+static void _stream_flush(sysmon_stream_t *stream)
+{
+    if (stream->length == 0 || stream->error != ESP_OK)
+    {
+        stream->length = 0;
+        return;
+    }
+
+    stream->error = stream->sink(stream->sink_ctx, stream->buffer, stream->length);
+    stream->length = 0;
+}
+
+/**
+ * @brief Initialize a stream writer for a request.
+ *
+ * @param stream Stream writer to initialize.
+ * @param request HTTP request to send chunks on.
+ */
+void _stream_begin(sysmon_stream_t *stream, httpd_req_t *request)
+{
+    _stream_begin_sink(stream, _http_chunk_sink, request);
+}
+
+/**
+ * @brief Initialize a stream writer that flushes into a custom sink.
+ *
+ * @param stream Stream writer to initialize.
+ * @param sink Function receiving each flushed chunk.
+ * @param sink_ctx Context passed to the sink.
+ */
+void _stream_begin_sink(sysmon_stream_t *stream, sysmon_stream_sink_t sink, void *sink_ctx)
+{
+    stream->sink     = sink;
+    stream->sink_ctx = sink_ctx;
+    stream->length   = 0;
+    stream->error    = ESP_OK;
+}
+
+/**
+ * @brief Append raw bytes to the stream, flushing full chunks as needed.
+ *
+ * @param stream Stream writer.
+ * @param data Bytes to append.
+ * @param len Number of bytes to append.
+ */
+void _stream_write(sysmon_stream_t *stream, const char *data, size_t len)
+{
+    while (len > 0 && stream->error == ESP_OK)
+    {
+        size_t space = sizeof(stream->buffer) - stream->length;
+        size_t copy_len = (len < space) ? len : space;
+        memcpy(stream->buffer + stream->length, data, copy_len);
+        stream->length += copy_len;
+        data += copy_len;
+        len -= copy_len;
+
+        if (stream->length == sizeof(stream->buffer))
+        {
+            _stream_flush(stream);
+        }
+    }
+}
+
+/**
+ * @brief Append a NUL-terminated string to the stream.
+ *
+ * @param stream Stream writer.
+ * @param str String to append.
+ */
+void _stream_puts(sysmon_stream_t *stream, const char *str)
+{
+    _stream_write(stream, str, strlen(str));
+}
+
+/**
+ * @brief Append printf-style formatted text to the stream.
+ *
+ * Formats directly into the free tail of the chunk buffer. If the output does
+ * not fit, the buffer is flushed and formatting is retried into the empty buffer.
+ *
+ * @param stream Stream writer.
+ * @param format printf-style format string.
+ * @param ... Format arguments.
+ */
+void _stream_printf(sysmon_stream_t *stream, const char *format, ...)
+{
+    if (stream->error != ESP_OK)
+    {
+        return;
+    }
+
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        size_t space = sizeof(stream->buffer) - stream->length;
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(stream->buffer + stream->length, space, format, args);
+        va_end(args);
+
+        if (written < 0)
+        {
+            return;
+        }
+        if ((size_t)written < space)
+        {
+            stream->length += (size_t)written;
+            return;
+        }
+        if (stream->length == 0)
+        {
+            // Output larger than a whole chunk; keep what fits
+            ESP_LOGW(LOG_TAG, "Formatted output truncated to %u bytes", (unsigned)(space - 1));
+            stream->length = space - 1;
+            return;
+        }
+        _stream_flush(stream);
+    }
+}
+
+/**
+ * @brief Append a quoted, escaped JSON string to the stream.
+ *
+ * @param stream Stream writer.
+ * @param str String to encode (NULL is written as an empty string).
+ */
+void _stream_json_string(sysmon_stream_t *stream, const char *str)
+{
+    _stream_write(stream, "\"", 1);
+    if (str != NULL)
+    {
+        const char *run_start = str;
+        for (const char *p = str; *p != '\0'; p++)
+        {
+            unsigned char c = (unsigned char)*p;
+            if (c != '"' && c != '\\' && c >= 0x20)
+            {
+                continue;
+            }
+
+            // Write the unescaped run, then the escape sequence
+            _stream_write(stream, run_start, (size_t)(p - run_start));
+            if (c == '"' || c == '\\')
+            {
+                char escaped[2] = { '\\', (char)c };
+                _stream_write(stream, escaped, sizeof(escaped));
+            }
+            else
+            {
+                _stream_printf(stream, "\\u%04x", c);
+            }
+            run_start = p + 1;
+        }
+        _stream_puts(stream, run_start);
+    }
+    _stream_write(stream, "\"", 1);
+}
+
+/**
+ * @brief Flush any buffered bytes and terminate the output (final empty chunk for HTTP).
+ *
+ * @param stream Stream writer.
+ * @return ESP_OK on success, or the first send error encountered.
+ */
+esp_err_t _stream_end(sysmon_stream_t *stream)
+{
+    _stream_flush(stream);
+    if (stream->error != ESP_OK)
+    {
+        return stream->error;
+    }
+
+    // A zero-length chunk terminates the output
+    stream->error = stream->sink(stream->sink_ctx, NULL, 0);
+    return stream->error;
+}
@@ -0,0 +1,450 @@
+/**
+ * @file sysmon_trace.c
+ * @brief Context-switch and scheduling latency tracing for sysmon.
+ *
+ * This file implements the FreeRTOS trace macro callbacks declared in
+ * sysmon_trace_hooks.h and the sampler-side drain behind '/trace'.
+ *
+ * Each core has a single-producer/single-consumer event ring. The trace
+ * macros run inside the kernel's critical sections, so events recorded on one
+ * core never interleave; the producer owns the head and the sampler owns the
+ * tail. Timestamps come from esp_timer, which is common to both cores, so a
+ * task readied on one core and switched in on the other gets a valid latency.
+ * The sampler merges the rings in timestamp order and folds the events into
+ * the per-task statistics in TaskUsageSample.
+ */
+
+// Project-specific includes
+#include "sysmon_trace.h"
+#include "sysmon_trace_hooks.h"
+#include "sysmon.h"
+
+// ESP-IDF includes
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// System includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef CONFIG_SYSMON_TRACE
+
+// Logger tag for this module
+static const char *LOG_TAG = "sysmon_trace";
+
+#define TRACE_EVENT_SWITCHED_IN     0U
+#define TRACE_EVENT_READY           1U
+
+// Exclusive upper bounds of the ready-latency histogram buckets (last bucket is open)
+static const uint32_t s_latency_bucket_limits_us[SYSMON_TRACE_LATENCY_BUCKETS] =
+{
+    10, 50, 100, 500, 1000, 5000, 10000, UINT32_MAX
+};
+
+/**
+ * @brief One scheduler event.
+ *
+ * Members:
+ * - time_us : Low 32 bits of esp_timer_get_time() (deltas survive the wrap).
+ * - type    : TRACE_EVENT_SWITCHED_IN or TRACE_EVENT_READY.
+ * - task    : Task the event refers to.
+ */
+typedef struct
+{
+    uint32_t time_us;
+    uint32_t type;
+    TaskHandle_t task;
+} trace_event_t;
+
+/**
+ * @brief Per-core event ring.
+ *
+ * Members:
+ * - head    : Events written (producer only).
+ * - tail    : Events consumed (sampler only).
+ * - dropped : Events discarded because the ring was full (producer only).
+ * - events  : Ring storage, indexed modulo CONFIG_SYSMON_TRACE_RING_DEPTH.
+ */
+typedef struct
+{
+    uint32_t head;
+    uint32_t tail;
+    uint32_t dropped;
+    trace_event_t events[CONFIG_SYSMON_TRACE_RING_DEPTH];
+} trace_ring_t;
+
+// Rings live in internal RAM: the trace macros run while the flash cache may be disabled
+static DRAM_ATTR trace_ring_t s_trace_rings[SYSMON_CORE_COUNT];
+static DRAM_ATTR volatile bool s_trace_enabled = false;
+
+// Sampler-side state: task handle to slot map (rebuilt per drain) and per-core running slot
+static TaskHandle_t *s_slot_map_handles = NULL;
+static int16_t *s_slot_map_slots = NULL;
+static int s_slot_map_size = 0;
+static int s_running_slot[SYSMON_CORE_COUNT];
+static int64_t s_last_drain_us = 0;
+
+// ============================================================================
+// Trace Macro Callbacks
+// ============================================================================
+
+/**
+ * @brief Append an event to the calling core's ring.
+ *
+ * @param type Event type.
+ * @param task Task the event refers to.
+ */
+static inline IRAM_ATTR void _trace_record(uint32_t type, TaskHandle_t task)
+{
+    trace_ring_t *ring = &s_trace_rings[xPortGetCoreID()];
+    uint32_t head = ring->head;
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= CONFIG_SYSMON_TRACE_RING_DEPTH)
+    {
+        ring->dropped++;
+        return;
+    }
+
+    trace_event_t *event = &ring->events[head & (CONFIG_SYSMON_TRACE_RING_DEPTH - 1)];
+    event->time_us = (uint32_t)esp_timer_get_time();
+    event->type    = type;
+    event->task    = task;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief traceTASK_SWITCHED_IN callback.
+ */
+void IRAM_ATTR sysmon_trace_task_switched_in(void)
+{
+    if (s_trace_enabled)
+    {
+        _trace_record(TRACE_EVENT_SWITCHED_IN, xTaskGetCurrentTaskHandle());
+    }
+}
+
+/**
+ * @brief traceMOVED_TASK_TO_READY_STATE callback.
+ *
+ * @param task TCB of the task moved to the ready list.
+ */
+void IRAM_ATTR sysmon_trace_task_ready(void *task)
+{
+    if (s_trace_enabled)
+    {
+        _trace_record(TRACE_EVENT_READY, (TaskHandle_t)task);
+    }
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * @brief Hash a task handle into a slot map bucket.
+ *
+ * @param handle Task handle.
+ * @return Bucket index.
+ */
+static int _slot_map_bucket(TaskHandle_t handle)
+{
+    uint32_t key = (uint32_t)(uintptr_t)handle >> 2;
+    return (int)((key * 2654435761U) & (uint32_t)(s_slot_map_size - 1));
+}
+
+/**
+ * @brief Rebuild the task handle to slot map from the active task slots.
+ *
+ * Only allocates when the task capacity outgrew the map.
+ *
+ * @return true on success, false on allocation failure.
+ */
+static bool _rebuild_slot_map(void)
+{
+    int required = 8;
+    while (required < self.task_capacity * 2)
+    {
+        required *= 2;
+    }
+    if (required > s_slot_map_size)
+    {
+        TaskHandle_t *handles = (TaskHandle_t *)malloc(sizeof(TaskHandle_t) * required);
+        int16_t *slots = (int16_t *)malloc(sizeof(int16_t) * required);
+        if (handles == NULL || slots == NULL)
+        {
+            free(handles);
+            free(slots);
+            return false;
+        }
+        free(s_slot_map_handles);
+        free(s_slot_map_slots);
+        s_slot_map_handles = handles;
+        s_slot_map_slots   = slots;
+        s_slot_map_size    = required;
+    }
+
+    memset(s_slot_map_handles, 0, sizeof(TaskHandle_t) * s_slot_map_size);
+    for (int slot = 0; slot < self.task_capacity; slot++)
+    {
+        TaskHandle_t handle = self.tasks[slot].task_handle;
+        if (!self.tasks[slot].is_active || handle == NULL)
+        {
+            continue;
+        }
+        int bucket = _slot_map_bucket(handle);
+        while (s_slot_map_handles[bucket] != NULL && s_slot_map_handles[bucket] != handle)
+        {
+            bucket = (bucket + 1) & (s_slot_map_size - 1);
+        }
+        s_slot_map_handles[bucket] = handle;
+        s_slot_map_slots[bucket]   = (int16_t)slot;
+    }
+    return true;
+}
+
+/**
+ * @brief Look up the slot tracking a task handle.
+ *
+ * @param handle Task handle.
+ * @return Slot index, or -1 if the task has no slot.
+ */
+static int _slot_map_find(TaskHandle_t handle)
+{
+    int bucket = _slot_map_bucket(handle);
+    while (s_slot_map_handles[bucket] != NULL)
+    {
+        if (s_slot_map_handles[bucket] == handle)
+        {
+            return s_slot_map_slots[bucket];
+        }
+        bucket = (bucket + 1) & (s_slot_map_size - 1);
+    }
+    return -1;
+}
+
+/**
+ * @brief Record a ready-to-run latency sample for a task.
+ *
+ * @param task Task slot.
+ * @param latency_us Latency in microseconds.
+ */
+static void _record_latency(TaskUsageSample *task, uint32_t latency_us)
+{
+    int bucket = 0;
+    while (latency_us >= s_latency_bucket_limits_us[bucket])
+    {
+        bucket++;
+    }
+    task->trace_latency_hist[bucket]++;
+    if (latency_us > task->trace_interval_latency_max_us)
+    {
+        task->trace_interval_latency_max_us = latency_us;
+    }
+}
+
+/**
+ * @brief Fold one event into the per-task statistics.
+ *
+ * @param core Core the event was recorded on.
+ * @param event Event.
+ */
+static void _process_event(int core, const trace_event_t *event)
+{
+    int slot = _slot_map_find(event->task);
+
+    if (event->type == TRACE_EVENT_READY)
+    {
+        // Keep the earliest ready time until the task runs
+        if (slot < 0 || self.tasks[slot].trace_ready_pending)
+        {
+            return;
+        }
+        // Ready events for a running task (e.g. a priority change) are not a wake-up
+        for (int c = 0; c < SYSMON_CORE_COUNT; c++)
+        {
+            if (s_running_slot[c] == slot)
+            {
+                return;
+            }
+        }
+        self.tasks[slot].trace_ready_us      = event->time_us;
+        self.tasks[slot].trace_ready_pending = true;
+        return;
+    }
+
+    s_running_slot[core] = slot;
+    if (slot < 0)
+    {
+        return;
+    }
+
+    TaskUsageSample *task = &self.tasks[slot];
+    task->trace_switches++;
+    task->trace_interval_switches++;
+    if (task->trace_ready_pending)
+    {
+        _record_latency(task, event->time_us - task->trace_ready_us);
+        task->trace_ready_pending = false;
+    }
+    else if (task->trace_has_run)
+    {
+        // Switched back in without being readied: it was switched out while still ready
+        task->trace_preemptions++;
+    }
+    task->trace_has_run = true;
+}
+
+// ============================================================================
+// Public API Functions
+// ============================================================================
+
+/**
+ * @brief Get the upper bound of a ready-latency histogram bucket.
+ *
+ * @param bucket Bucket index.
+ * @return Exclusive upper bound in microseconds (UINT32_MAX for the last bucket).
+ */
+uint32_t _trace_latency_bucket_limit_us(int bucket)
+{
+    if (bucket < 0 || bucket >= SYSMON_TRACE_LATENCY_BUCKETS)
+    {
+        return 0;
+    }
+    return s_latency_bucket_limits_us[bucket];
+}
+
+/**
+ * @brief Start recording trace events.
+ *
+ * Discards anything left in the rings from a previous run; the tail is the
+ * sampler's, so it is moved up to the head instead of resetting the head.
+ */
+void _trace_start(void)
+{
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        __atomic_store_n(&s_trace_rings[core].tail, __atomic_load_n(&s_trace_rings[core].head, __ATOMIC_ACQUIRE),
+                         __ATOMIC_RELEASE);
+        s_running_slot[core] = -1;
+    }
+    s_last_drain_us = esp_timer_get_time();
+    s_trace_enabled = true;
+}
+
+/**
+ * @brief Stop recording trace events and release the drain scratch space.
+ */
+void _trace_stop(void)
+{
+    s_trace_enabled = false;
+    free(s_slot_map_handles);
+    free(s_slot_map_slots);
+    s_slot_map_handles = NULL;
+    s_slot_map_slots   = NULL;
+    s_slot_map_size    = 0;
+}
+
+/**
+ * @brief Drain the per-core event rings into the per-task trace statistics.
+ *
+ * Events from all cores are processed in timestamp order. Only the events
+ * present when the drain starts are consumed; newer ones wait for the next sample.
+ */
+void _trace_drain_events(void)
+{
+    if (!s_trace_enabled || self.tasks == NULL)
+    {
+        return;
+    }
+    if (!_rebuild_slot_map())
+    {
+        ESP_LOGW(LOG_TAG, "Failed to allocate trace slot map, skipping drain");
+        return;
+    }
+
+    uint32_t read[SYSMON_CORE_COUNT];
+    uint32_t end[SYSMON_CORE_COUNT];
+    uint32_t dropped = 0;
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        read[core] = s_trace_rings[core].tail;
+        end[core]  = __atomic_load_n(&s_trace_rings[core].head, __ATOMIC_ACQUIRE);
+        dropped   += s_trace_rings[core].dropped;
+    }
+
+    for (;;)
+    {
+        // Pick the core whose next event is oldest
+        int next_core = -1;
+        uint32_t next_time = 0;
+        for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+        {
+            if (read[core] == end[core])
+            {
+                continue;
+            }
+            uint32_t time_us = s_trace_rings[core].events[read[core] & (CONFIG_SYSMON_TRACE_RING_DEPTH - 1)].time_us;
+            if (next_core < 0 || (int32_t)(time_us - next_time) < 0)
+            {
+                next_core = core;
+                next_time = time_us;
+            }
+        }
+        if (next_core < 0)
+        {
+            break;
+        }
+
+        _process_event(next_core, &s_trace_rings[next_core].events[read[next_core] & (CONFIG_SYSMON_TRACE_RING_DEPTH - 1)]);
+        read[next_core]++;
+        self.trace_events++;
+    }
+
+    for (int core = 0; core < SYSMON_CORE_COUNT; core++)
+    {
+        __atomic_store_n(&s_trace_rings[core].tail, read[core], __ATOMIC_RELEASE);
+    }
+    self.trace_dropped = dropped;
+
+    // Per-interval figures
+    int64_t now_us = esp_timer_get_time();
+    int64_t elapsed_us = now_us - s_last_drain_us;
+    s_last_drain_us = now_us;
+    for (int slot = 0; slot < self.task_capacity; slot++)
+    {
+        TaskUsageSample *task = &self.tasks[slot];
+        if (!task->is_active)
+        {
+            continue;
+        }
+        task->trace_switch_rate    = (elapsed_us > 0) ? (float)task->trace_interval_switches * 1000000.0f / (float)elapsed_us : 0.0f;
+        task->trace_latency_max_us = task->trace_interval_latency_max_us;
+        task->trace_interval_switches       = 0;
+        task->trace_interval_latency_max_us = 0;
+    }
+}
+
+#else // !CONFIG_SYSMON_TRACE
+
+uint32_t _trace_latency_bucket_limit_us(int bucket)
+{
+    return 0;
+}
+
+void _trace_start(void)
+{
+}
+
+void _trace_stop(void)
+{
+}
+
+void _trace_drain_events(void)
+{
+}
+
+#endif // CONFIG_SYSMON_TRACE
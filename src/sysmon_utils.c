@@ -3,8 +3,8 @@
  * @brief Utility functions for sysmon HTTP module.
  *
  * This file implements utility functions used across the sysmon HTTP
- * subsystem for content type detection, task name formatting, and JSON
- * cleanup operations.
+ * subsystem for content type detection, task name formatting, query string
+ * parsing, and JSON cleanup operations.
  */
 
 // Project-specific includes
@@ -15,9 +15,13 @@
 #include "esp_log.h"
 #include "esp_wifi.h"
 #include "esp_netif.h"
+#include "esp_http_server.h"
 
 // System includes
+#include <errno.h>
+#include <math.h>
 #include <stdarg.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
@@ -40,6 +44,25 @@ const char *_get_task_display_name(const char *task_name)
     return task_name;
 }
 
+/**
+ * @brief Quantize a percentage to hundredths of a percent in a uint16.
+ *
+ * @param percent Percentage value (clamped to 0..655.35).
+ * @return Quantized value (percent * 100, rounded).
+ */
+uint16_t _quantize_percent(float percent)
+{
+    if (!(percent > 0.0f))
+    {
+        return 0;
+    }
+    if (percent >= 655.34f)
+    {
+        return UINT16_MAX - 1;
+    }
+    return (uint16_t)lrintf(percent * 100.0f);
+}
+
 /**
  * @brief Determine content type from URI path.
  *
@@ -74,6 +97,86 @@ const char *_get_content_type_from_uri(const char *uri)
     return "application/octet-stream";
 }
 
+/**
+ * @brief Get the value of a URL query parameter.
+ *
+ * @param request HTTP request object.
+ * @param key Query parameter name.
+ * @param value_buffer Buffer to store the (NUL-terminated) value.
+ * @param buffer_size Size of the buffer.
+ * @return ESP_OK if found, ESP_ERR_NOT_FOUND if the request has no such parameter,
+ *         ESP_ERR_NO_MEM on allocation failure, or another httpd error code.
+ */
+esp_err_t _get_query_value(httpd_req_t *request, const char *key, char *value_buffer, size_t buffer_size)
+{
+    if (request == NULL || key == NULL || value_buffer == NULL || buffer_size == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t query_len = httpd_req_get_url_query_len(request);
+    if (query_len == 0)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Query length is client-controlled, so size the copy to the request
+    char *query = (char *)malloc(query_len + 1);
+    if (query == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t err = httpd_req_get_url_query_str(request, query, query_len + 1);
+    if (err == ESP_OK)
+    {
+        err = httpd_query_key_value(query, key, value_buffer, buffer_size);
+    }
+    free(query);
+    return err;
+}
+
+/**
+ * @brief Get a URL query parameter parsed as an unsigned 32-bit decimal.
+ *
+ * @param request HTTP request object.
+ * @param key Query parameter name.
+ * @param value Output: parsed value (unchanged unless ESP_OK is returned).
+ * @return ESP_OK if found and valid, ESP_ERR_NOT_FOUND if absent,
+ *         ESP_ERR_NO_MEM if the query could not be copied,
+ *         ESP_ERR_INVALID_ARG if present but not a valid unsigned number.
+ */
+esp_err_t _get_query_uint32(httpd_req_t *request, const char *key, uint32_t *value)
+{
+    if (value == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    char value_buffer[16] = { 0 };
+    esp_err_t err = _get_query_value(request, key, value_buffer, sizeof(value_buffer));
+    if (err != ESP_OK)
+    {
+        return (err == ESP_ERR_NOT_FOUND || err == ESP_ERR_NO_MEM) ? err : ESP_ERR_INVALID_ARG;
+    }
+
+    if (value_buffer[0] < '0' || value_buffer[0] > '9')
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    char *end = NULL;
+    errno = 0;
+    unsigned long parsed = strtoul(value_buffer, &end, 10);
+    if (errno != 0 || end == NULL || *end != '\0' || parsed > UINT32_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *value = (uint32_t)parsed;
+    return ESP_OK;
+}
+
 /**
  * @brief Clean up multiple cJSON objects.
  *
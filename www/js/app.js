@@ -26,7 +26,7 @@ function updateStatusPopup()
     showStatusPopup(STATUS_TYPES.PAUSED);
     return;
   }
-  if (AppState.ui.isHoveringCpu || AppState.ui.isHoveringMemory)
+  if (AppState.ui.isHoveringCpu || AppState.ui.isHoveringMemory || AppState.ui.isHoveringCustom)
   {
     showStatusPopup(STATUS_TYPES.CHARTS_HOVER);
     return;
@@ -58,6 +58,228 @@ function updateStatusPopup()
   hideStatusPopup();
 }
 
+/**
+ * Sequential little-endian reader over a DataView.
+ *
+ * @param {ArrayBuffer} buffer - Binary response body.
+ * @returns {Object} Reader with u8/i8/u16/u32/i32/percent/name methods, and sample
+ *   variants (samplePercent/sampleU32/sampleI32) that map the history "no value" markers to null.
+ */
+function createBinaryReader(buffer)
+{
+  const view = new DataView(buffer);
+  const textDecoder = new TextDecoder('utf-8');
+  let offset = 0;
+
+  return {
+    u8()      { const v = view.getUint8(offset); offset += 1; return v; },
+    i8()      { const v = view.getInt8(offset); offset += 1; return v; },
+    u16()     { const v = view.getUint16(offset, true); offset += 2; return v; },
+    u32()     { const v = view.getUint32(offset, true); offset += 4; return v; },
+    i32()     { const v = view.getInt32(offset, true); offset += 4; return v; },
+    percent() { return this.u16() / BINARY_FORMAT.PERCENT_SCALE; },
+    samplePercent() { const v = this.u16(); return v === BINARY_FORMAT.NO_PERCENT ? null : v / BINARY_FORMAT.PERCENT_SCALE; },
+    sampleU32()     { const v = this.u32(); return v === BINARY_FORMAT.NO_U32 ? null : v; },
+    sampleI32()     { const v = this.i32(); return v === BINARY_FORMAT.NO_I32 ? null : v; },
+    bytes(length)
+    {
+      const slice = new Uint8Array(buffer, offset, length);
+      offset += length;
+      return slice;
+    },
+    // Returns the task name, or null at the end-of-tasks marker
+    name()
+    {
+      const length = this.u8();
+      if (length === BINARY_FORMAT.END_OF_TASKS)
+      {
+        return null;
+      }
+      return textDecoder.decode(this.bytes(length));
+    }
+  };
+}
+
+/**
+ * Validate the common binary header and advance past it.
+ *
+ * @param {Object} reader - Reader created by createBinaryReader().
+ * @param {number} expectedKind - BINARY_FORMAT.KIND_* value.
+ * @throws {Error} If magic, version, or kind do not match.
+ */
+function readBinaryHeader(reader, expectedKind)
+{
+  const magic = String.fromCharCode(reader.u8(), reader.u8(), reader.u8(), reader.u8());
+  const version = reader.u8();
+  const kind = reader.u8();
+  reader.u16(); // reserved
+  if (magic !== BINARY_FORMAT.MAGIC || version !== BINARY_FORMAT.VERSION || kind !== expectedKind)
+  {
+    throw new Error(`Unsupported binary payload (magic=${magic}, version=${version}, kind=${kind})`);
+  }
+}
+
+/**
+ * Decode the custom metric section that follows the task records.
+ *
+ * @param {Object} reader - Reader positioned after the end-of-tasks marker.
+ * @param {Function} readValues - Reads one metric's value(s) from the reader.
+ * @returns {Object} { metricName: { type: 'counter'|'gauge', value } }, value as returned by readValues.
+ */
+function readCustomMetrics(reader, readValues)
+{
+  const metrics = {};
+  const metricCount = reader.u8();
+  for (let i = 0; i < metricCount; i++)
+  {
+    const name = reader.name();
+    const type = reader.u8() === BINARY_FORMAT.METRIC_COUNTER ? 'counter' : 'gauge';
+    metrics[name] = { type: type, value: readValues() };
+  }
+  return metrics;
+}
+
+/**
+ * Decode a /telemetry.bin payload into the same shape as the /telemetry JSON.
+ *
+ * @param {ArrayBuffer} buffer - Binary response body.
+ * @returns {Object} { summary: { cpu, mem, wifiRssi }, current: { taskName: { cpu, stack, stackPct, stackRemaining? } },
+ *   custom: { metricName: { type, value } }, self: { samplingGeneration } (low byte only) }
+ */
+function decodeTelemetryBinary(buffer)
+{
+  const reader = createBinaryReader(buffer);
+  readBinaryHeader(reader, BINARY_FORMAT.KIND_TELEMETRY);
+
+  const coreCount = reader.u8();
+  const flags = reader.u8();
+  const rssi = reader.i8();
+  const samplingGeneration = reader.u8();
+
+  const cpu = { overall: reader.percent(), cores: [] };
+  for (let core = 0; core < coreCount; core++)
+  {
+    cpu.cores.push(reader.percent());
+  }
+
+  const dram = {
+    free    : reader.u32(),
+    largest : reader.u32(),
+    total   : reader.u32(),
+    usedPct : reader.percent()
+  };
+  const psram = {
+    free    : reader.u32(),
+    total   : reader.u32(),
+    usedPct : reader.percent(),
+    present : (flags & 0x01) !== 0
+  };
+
+  const current = {};
+  for (let taskName = reader.name(); taskName !== null; taskName = reader.name())
+  {
+    const task = {
+      cpu      : reader.percent(),
+      stack    : reader.u32(),
+      stackPct : reader.percent()
+    };
+    const stackRemaining = reader.u32();
+    if (stackRemaining > 0)
+    {
+      task.stackRemaining = stackRemaining;
+    }
+    current[taskName] = task;
+  }
+
+  return {
+    summary: {
+      cpu      : cpu,
+      mem      : { dram: dram, psram: psram },
+      wifiRssi : (flags & 0x02) !== 0 ? rssi : null
+    },
+    current: current,
+    custom : readCustomMetrics(reader, () => reader.i32()),
+    self   : { samplingGeneration: samplingGeneration }
+  };
+}
+
+/**
+ * Decode a /history.bin payload.
+ *
+ * @param {ArrayBuffer} buffer - Binary response body.
+ * @returns {Object} { tasks: { taskName: { cpu: [...], stack?: [...] } }, series: { cpuOverall, cpuCores, dramFree, ... },
+ *   custom: { metricName: { type, value: [...] } } } where "tasks" has the same shape as the /history JSON.
+ *   Samples the device could not send intact are null, as in the JSON.
+ */
+function decodeHistoryBinary(buffer)
+{
+  const reader = createBinaryReader(buffer);
+  readBinaryHeader(reader, BINARY_FORMAT.KIND_HISTORY);
+
+  const sampleCount = reader.u16();
+  const coreCount = reader.u8();
+  const flags = reader.u8();
+  const readArray = (readValue) => Array.from({ length: sampleCount }, readValue);
+
+  const series = {
+    psramPresent : (flags & 0x01) !== 0,
+    dramTotal    : reader.u32(),
+    psramTotal   : reader.u32()
+  };
+  series.cpuOverall = readArray(() => reader.samplePercent());
+  series.cpuCores = Array.from({ length: coreCount }, () => readArray(() => reader.samplePercent()));
+  series.dramFree = readArray(() => reader.sampleU32());
+  series.dramMinFree = readArray(() => reader.sampleU32());
+  series.dramLargest = readArray(() => reader.sampleU32());
+  series.dramUsedPct = readArray(() => reader.samplePercent());
+  series.psramFree = readArray(() => reader.sampleU32());
+  series.psramUsedPct = readArray(() => reader.samplePercent());
+
+  const tasks = {};
+  for (let taskName = reader.name(); taskName !== null; taskName = reader.name())
+  {
+    const isRegistered = (reader.u8() & 0x01) !== 0;
+    reader.u32(); // stack size (also reported by /tasks)
+    const task = { cpu: readArray(() => reader.samplePercent()) };
+    if (isRegistered)
+    {
+      task.stack = readArray(() => reader.sampleU32());
+    }
+    tasks[taskName] = task;
+  }
+
+  const custom = readCustomMetrics(reader, () => readArray(() => reader.sampleI32()));
+  return { tasks: tasks, series: series, custom: custom };
+}
+
+/**
+ * Fetch and decode the whole history payload from the binary endpoint.
+ *
+ * @async
+ * @returns {Promise<Object|null>} Decoded payload (see decodeHistoryBinary()), or null on HTTP failure.
+ */
+async function fetchHistoryPayload()
+{
+  const response = await fetch(API_ROUTES.HISTORY_BIN);
+  if (!response.ok)
+  {
+    return null;
+  }
+  return decodeHistoryBinary(await response.arrayBuffer());
+}
+
+/**
+ * Fetch and decode task history from the binary endpoint.
+ *
+ * @async
+ * @returns {Promise<Object|null>} Task history in /history JSON shape, or null on HTTP failure.
+ */
+async function fetchHistory()
+{
+  const payload = await fetchHistoryPayload();
+  return payload !== null ? payload.tasks : null;
+}
+
 /**
  * Initialize and start the main dashboard application.
  *
@@ -118,12 +340,13 @@ async function initializeDashboard()
 
   try
   {
-    const response = await fetch(API_ROUTES.HISTORY);
-    if (response.ok)
+    const payload = await fetchHistoryPayload();
+    if (payload !== null)
     {
-      const data = await response.json();
+      const data = payload.tasks;
       createCpuChart(data);
       createMemoryChart(data); // Only includes registered tasks now
+      createCustomChart(payload.custom);
       AppState.status.lastTelemetrySuccess = Date.now();
       AppState.status.consecutiveFailures = 0;
     }
@@ -214,10 +437,9 @@ async function initializeDashboard()
         {
           try
           {
-            const response = await fetch(API_ROUTES.HISTORY);
-            if (response.ok)
+            const historyData = await fetchHistory();
+            if (historyData !== null)
             {
-              const historyData = await response.json();
               // Add system task datasets from history
               for (const [taskName, taskData] of Object.entries(historyData))
               {
@@ -311,18 +533,83 @@ async function initializeDashboard()
     });
   }
 
-  // Keep updating charts, summary, and table
-  setInterval(updateDashboard, CHART_TELEMETRY_UPDATE_INTERVAL_MS);
+  // Keep updating charts, summary, and table (telemetry is pushed when available, polled otherwise)
+  startTelemetryPolling();
+  startTelemetryPush();
   setInterval(updateTable, CHART_TASK_TABLE_UPDATE_INTERVAL_MS);
 }
 
+/**
+ * Start polling the telemetry endpoint, unless polling is already active.
+ */
+function startTelemetryPolling()
+{
+  if (AppState.push.telemetryTimerId === null)
+  {
+    AppState.push.telemetryTimerId = setInterval(updateDashboard, CHART_TELEMETRY_UPDATE_INTERVAL_MS);
+  }
+}
+
+/**
+ * Stop polling the telemetry endpoint.
+ */
+function stopTelemetryPolling()
+{
+  if (AppState.push.telemetryTimerId !== null)
+  {
+    clearInterval(AppState.push.telemetryTimerId);
+    AppState.push.telemetryTimerId = null;
+  }
+}
+
+/**
+ * Subscribe to the WebSocket push channel for live telemetry.
+ *
+ * The device sends one binary telemetry frame (same layout as /telemetry.bin) per
+ * sample. While the socket is open, telemetry polling is stopped; when it closes,
+ * polling resumes and a reconnect is attempted after PUSH_RECONNECT_DELAY_MS.
+ */
+function startTelemetryPush()
+{
+  if (!PUSH_ENABLED || typeof WebSocket === 'undefined' || AppState.push.socket !== null)
+  {
+    return;
+  }
+
+  const scheme = (window.location.protocol === 'https:') ? 'wss' : 'ws';
+  const socket = new WebSocket(`${scheme}://${window.location.host}${API_ROUTES.PUSH}`);
+  socket.binaryType = 'arraybuffer';
+  AppState.push.socket = socket;
+
+  socket.addEventListener('open', () => {
+    stopTelemetryPolling();
+  });
+
+  socket.addEventListener('message', (event) => {
+    try
+    {
+      applyTelemetry(decodeTelemetryBinary(event.data));
+    }
+    catch (error)
+    {
+      AppState.status.consecutiveFailures++;
+      updateStatusPopup();
+    }
+  });
+
+  socket.addEventListener('close', () => {
+    AppState.push.socket = null;
+    startTelemetryPolling();
+    setTimeout(startTelemetryPush, PUSH_RECONNECT_DELAY_MS);
+  });
+}
+
 /**
  * Update the main dashboard UI with the latest telemetry data.
  *
  * Retrieves the latest combined telemetry data (CPU, memory, PSRAM, etc.) from the API and 
- * uses it to update the summary badges, progress bars, and time series chart datasets in the 
- * UI. Handles server communication with timeouts, updates AppState with success or failure, 
- * and visually refreshes the main dashboard metrics to reflect the most recent device measurements.
+ * passes it to applyTelemetry(). Handles server communication with timeouts and updates
+ * AppState on failure. Only used while the WebSocket push channel is not connected.
  */
 async function updateDashboard()
 {
@@ -334,7 +621,7 @@ async function updateDashboard()
     const timeoutId = setTimeout(() => controller.abort(), TELEMETRY_TIMEOUT_MS);
     let response;
     try {
-      response = await fetch(API_ROUTES.TELEMETRY, { signal: controller.signal });
+      response = await fetch(API_ROUTES.TELEMETRY_BIN, { signal: controller.signal });
     } finally {
       clearTimeout(timeoutId);
     }
@@ -344,210 +631,247 @@ async function updateDashboard()
       updateStatusPopup();
       return;
     }
-    const telemetryData = await response.json();
-    AppState.status.lastTelemetrySuccess = Date.now();
-    AppState.status.consecutiveFailures = 0;
+    applyTelemetry(decodeTelemetryBinary(await response.arrayBuffer()));
+  }
+  catch (error)
+  {
+    AppState.status.consecutiveFailures++;
+    updateStatusPopup();
+  }
+}
 
-    // Compute current task names once for both paused and active paths
-    const currentTaskNames = new Set(Object.keys(telemetryData.current));
+/**
+ * Apply one telemetry snapshot to the dashboard.
+ *
+ * Updates the summary badges, progress bars, and time series chart datasets from a
+ * telemetry object (the /telemetry shape), whether it was polled or pushed.
+ *
+ * @param {Object} telemetryData - Decoded telemetry snapshot.
+ */
+function applyTelemetry(telemetryData)
+{
+  AppState.status.lastTelemetrySuccess = Date.now();
+  AppState.status.consecutiveFailures = 0;
 
-    // Skip visual updates if paused (data collection continues)
-    if (!AppState.ui.isPaused)
+  // Sampling interval or depth changed on the device: reload to rebuild the charts for the new window
+  if (telemetryData.self && telemetryData.self.samplingGeneration !== undefined)
+  {
+    const generation = telemetryData.self.samplingGeneration & 0xFF;
+    if (AppState.status.samplingGeneration === null)
     {
-      // Update summary badges with progress bars
-      const cpuOverall    = document.getElementById('cpuOverall');
-      const cpuC0         = document.getElementById('cpuC0');
-      const cpuC1         = document.getElementById('cpuC1');
-      const cpuOverallBar = document.getElementById('cpuOverallBar');
-      const cpuC0Bar      = document.getElementById('cpuC0Bar');
-      const cpuC1Bar      = document.getElementById('cpuC1Bar');
-
-      const overallValue = telemetryData.summary.cpu.overall;
-    const core0Value   = telemetryData.summary.cpu.cores[0];
-    const core1Value   = telemetryData.summary.cpu.cores[1];
-
-    cpuOverall.textContent = `${overallValue.toFixed(1)} %`;
-    cpuC0.textContent      = `${core0Value.toFixed(1)} %`;
-    cpuC1.textContent      = `${core1Value.toFixed(1)} %`;
-
-    // Update progress bars with color coding
-    updateCpuProgressBar(cpuOverallBar, overallValue);
-    updateCpuProgressBar(cpuC0Bar, core0Value);
-    updateCpuProgressBar(cpuC1Bar, core1Value);
-
-    // Update tooltips on containers (containers are always full width and hoverable)
-    const cpuOverallContainer = cpuOverallBar ? cpuOverallBar.closest('.progress-container') : null;
-    const cpuC0Container = cpuC0Bar ? cpuC0Bar.closest('.progress-container') : null;
-    const cpuC1Container = cpuC1Bar ? cpuC1Bar.closest('.progress-container') : null;
-
-    if (cpuOverallContainer)
+      AppState.status.samplingGeneration = generation;
+    }
+    else if (generation !== AppState.status.samplingGeneration)
     {
-      cpuOverallContainer.setAttribute('aria-label', `Overall CPU: ${overallValue.toFixed(1)}%`);
-      cpuOverallContainer.setAttribute('role', 'tooltip');
-      cpuOverallContainer.setAttribute('data-microtip-position', 'bottom');
+      window.location.reload();
+      return;
     }
-    if (cpuC0Container)
+  }
+
+  // Compute current task names once for both paused and active paths
+  const currentTaskNames = new Set(Object.keys(telemetryData.current));
+
+  // Skip visual updates if paused (data collection continues)
+  if (!AppState.ui.isPaused)
+  {
+    // Update summary badges with progress bars
+    const cpuOverall    = document.getElementById('cpuOverall');
+    const cpuOverallBar = document.getElementById('cpuOverallBar');
+
+    const overallValue = telemetryData.summary.cpu.overall;
+
+  cpuOverall.textContent = `${overallValue.toFixed(1)} %`;
+
+  // Update progress bars with color coding
+  updateCpuProgressBar(cpuOverallBar, overallValue);
+
+  // Update tooltips on containers (containers are always full width and hoverable)
+  const cpuOverallContainer = cpuOverallBar ? cpuOverallBar.closest('.progress-container') : null;
+
+  if (cpuOverallContainer)
+  {
+    cpuOverallContainer.setAttribute('aria-label', `Overall CPU: ${overallValue.toFixed(1)}%`);
+    cpuOverallContainer.setAttribute('role', 'tooltip');
+    cpuOverallContainer.setAttribute('data-microtip-position', 'bottom');
+  }
+
+  // Per-core rows; rows for cores the target doesn't have (single-core chips) are hidden
+  const cores         = telemetryData.summary.cpu.cores;
+  const coresUnpinned = telemetryData.summary.cpu.coresUnpinned;
+  for (let core = 0; core < 2; core++)
+  {
+    const coreText = document.getElementById(`cpuC${core}`);
+    const coreBar  = document.getElementById(`cpuC${core}Bar`);
+    const coreRow  = coreText ? coreText.closest('.info-row') : null;
+    if (coreRow)
     {
-      cpuC0Container.setAttribute('aria-label', `Core 0: ${core0Value.toFixed(1)}%`);
-      cpuC0Container.setAttribute('role', 'tooltip');
-      cpuC0Container.setAttribute('data-microtip-position', 'bottom');
+      coreRow.classList.toggle('hidden', core >= cores.length);
     }
-    if (cpuC1Container)
+    if (core >= cores.length || !coreText)
     {
-      cpuC1Container.setAttribute('aria-label', `Core 1: ${core1Value.toFixed(1)}%`);
-      cpuC1Container.setAttribute('role', 'tooltip');
-      cpuC1Container.setAttribute('data-microtip-position', 'bottom');
+      continue;
     }
 
-    // Update DRAM visualizations
-    const dramTotal   = telemetryData.summary.mem.dram.total;
-    const dramFree    = telemetryData.summary.mem.dram.free;
-    const dramUsed    = dramTotal - dramFree;
-    const dramUsedPct = telemetryData.summary.mem.dram.usedPct;
-    const dramLargest = telemetryData.summary.mem.dram.largest;
+    const coreValue = cores[core];
+    coreText.textContent = `${coreValue.toFixed(1)} %`;
+    updateCpuProgressBar(coreBar, coreValue);
 
-    // Update text elements
-    const dramUsedPctEl = document.getElementById('dramUsedPct');
-    const dramFreeEl    = document.getElementById('dramFree');
-    const dramUsedEl    = document.getElementById('dramUsed');
-    const dramLargestEl = document.getElementById('dramLargest');
-    const dramTotalEl   = document.getElementById('dramTotal');
-
-    dramUsedPctEl.textContent = `${dramUsedPct.toFixed(1)} %`;
-    dramFreeEl.textContent    = formatSize(dramFree, 'kb', true);
-    dramFreeEl.setAttribute('aria-label', formatSize(dramFree, 'bytes', true));
-    dramFreeEl.setAttribute('role', 'tooltip');
-    dramFreeEl.setAttribute('data-microtip-position', 'bottom');
-    dramUsedEl.textContent    = formatSize(dramUsed, 'kb', true);
-    dramUsedEl.setAttribute('aria-label', formatSize(dramUsed, 'bytes', true));
-    dramUsedEl.setAttribute('role', 'tooltip');
-    dramUsedEl.setAttribute('data-microtip-position', 'bottom');
-    dramLargestEl.textContent = formatSize(dramLargest, 'kb', true);
-    dramLargestEl.setAttribute('aria-label', formatSize(dramLargest, 'bytes', true));
-    dramLargestEl.setAttribute('role', 'tooltip');
-    dramLargestEl.setAttribute('data-microtip-position', 'bottom');
-    dramTotalEl.textContent   = formatSize(dramTotal, 'kb', true);
-    dramTotalEl.setAttribute('aria-label', formatSize(dramTotal, 'bytes', true));
-    dramTotalEl.setAttribute('role', 'tooltip');
-    dramTotalEl.setAttribute('data-microtip-position', 'bottom-left');
-
-    // Update WiFi RSSI icon if available in telemetry
-    if (telemetryData.summary && telemetryData.summary.wifiRssi !== undefined)
+    const coreContainer = coreBar ? coreBar.closest('.progress-container') : null;
+    if (coreContainer)
     {
-      updateWifiRssi(telemetryData.summary.wifiRssi);
+      // Share of the core's load not explained by tasks pinned to it
+      const unpinnedLabel = coresUnpinned ? `, unpinned tasks ${coresUnpinned[core].toFixed(1)}%` : '';
+      coreContainer.setAttribute('aria-label', `Core ${core}: ${coreValue.toFixed(1)}%${unpinnedLabel}`);
+      coreContainer.setAttribute('role', 'tooltip');
+      coreContainer.setAttribute('data-microtip-position', 'bottom');
     }
+  }
 
-    // Update usage progress bar (green for used, grey background for free)
-    const dramUsedBar = document.getElementById('dramUsedBar');
-    const dramUsedContainer = dramUsedBar ? dramUsedBar.closest('.progress-container') : null;
-    if (dramUsedBar)
-    {
-      updateDramProgressBar(dramUsedBar, dramUsedPct);
-      // Update tooltip with used/free/total on container
-      if (dramUsedContainer)
-      {
-        dramUsedContainer.setAttribute('aria-label', `DRAM: ${formatSize(dramUsed, 'bytes', true)} used (${dramUsedPct.toFixed(1)}%), ${formatSize(dramFree, 'bytes', true)} free, ${formatSize(dramTotal, 'bytes', true)} total`);
-        dramUsedContainer.setAttribute('role', 'tooltip');
-        dramUsedContainer.setAttribute('data-microtip-position', 'bottom');
-      }
-    }
+  // Update DRAM visualizations
+  const dramTotal   = telemetryData.summary.mem.dram.total;
+  const dramFree    = telemetryData.summary.mem.dram.free;
+  const dramUsed    = dramTotal - dramFree;
+  const dramUsedPct = telemetryData.summary.mem.dram.usedPct;
+  const dramLargest = telemetryData.summary.mem.dram.largest;
+
+  // Update text elements
+  const dramUsedPctEl = document.getElementById('dramUsedPct');
+  const dramFreeEl    = document.getElementById('dramFree');
+  const dramUsedEl    = document.getElementById('dramUsed');
+  const dramLargestEl = document.getElementById('dramLargest');
+  const dramTotalEl   = document.getElementById('dramTotal');
+
+  dramUsedPctEl.textContent = `${dramUsedPct.toFixed(1)} %`;
+  dramFreeEl.textContent    = formatSize(dramFree, 'kb', true);
+  dramFreeEl.setAttribute('aria-label', formatSize(dramFree, 'bytes', true));
+  dramFreeEl.setAttribute('role', 'tooltip');
+  dramFreeEl.setAttribute('data-microtip-position', 'bottom');
+  dramUsedEl.textContent    = formatSize(dramUsed, 'kb', true);
+  dramUsedEl.setAttribute('aria-label', formatSize(dramUsed, 'bytes', true));
+  dramUsedEl.setAttribute('role', 'tooltip');
+  dramUsedEl.setAttribute('data-microtip-position', 'bottom');
+  dramLargestEl.textContent = formatSize(dramLargest, 'kb', true);
+  dramLargestEl.setAttribute('aria-label', formatSize(dramLargest, 'bytes', true));
+  dramLargestEl.setAttribute('role', 'tooltip');
+  dramLargestEl.setAttribute('data-microtip-position', 'bottom');
+  dramTotalEl.textContent   = formatSize(dramTotal, 'kb', true);
+  dramTotalEl.setAttribute('aria-label', formatSize(dramTotal, 'bytes', true));
+  dramTotalEl.setAttribute('role', 'tooltip');
+  dramTotalEl.setAttribute('data-microtip-position', 'bottom-left');
+
+  // Update WiFi RSSI icon if available in telemetry
+  if (telemetryData.summary && telemetryData.summary.wifiRssi !== undefined)
+  {
+    updateWifiRssi(telemetryData.summary.wifiRssi);
+  }
 
-    // Update fragmentation bar (largest block as percentage of total, positioned from right)
-    const dramFragmentationBar = document.getElementById('dramFragmentationBar');
-    if (dramFragmentationBar && dramTotal > 0)
+  // Update usage progress bar (green for used, grey background for free)
+  const dramUsedBar = document.getElementById('dramUsedBar');
+  const dramUsedContainer = dramUsedBar ? dramUsedBar.closest('.progress-container') : null;
+  if (dramUsedBar)
+  {
+    updateDramProgressBar(dramUsedBar, dramUsedPct);
+    // Update tooltip with used/free/total on container
+    if (dramUsedContainer)
     {
-      // Show largest block as a percentage of total, positioned from the right edge
-      const largestPct = (dramLargest / dramTotal) * 100;
-      dramFragmentationBar.style.width = `${largestPct}%`;
-      dramFragmentationBar.style.display = (largestPct > 0 && largestPct <= 100) ? 'block' : 'none';
+      dramUsedContainer.setAttribute('aria-label', `DRAM: ${formatSize(dramUsed, 'bytes', true)} used (${dramUsedPct.toFixed(1)}%), ${formatSize(dramFree, 'bytes', true)} free, ${formatSize(dramTotal, 'bytes', true)} total`);
+      dramUsedContainer.setAttribute('role', 'tooltip');
+      dramUsedContainer.setAttribute('data-microtip-position', 'bottom');
     }
+  }
 
-    // Update PSRAM visualizations
-    const psramSection = document.getElementById('psramSection');
-    if (telemetryData.summary.mem.psram.present)
+  // Update fragmentation bar (largest block as percentage of total, positioned from right)
+  const dramFragmentationBar = document.getElementById('dramFragmentationBar');
+  if (dramFragmentationBar && dramTotal > 0)
+  {
+    // Show largest block as a percentage of total, positioned from the right edge
+    const largestPct = (dramLargest / dramTotal) * 100;
+    dramFragmentationBar.style.width = `${largestPct}%`;
+    dramFragmentationBar.style.display = (largestPct > 0 && largestPct <= 100) ? 'block' : 'none';
+  }
+
+  // Update PSRAM visualizations
+  const psramSection = document.getElementById('psramSection');
+  if (telemetryData.summary.mem.psram.present)
+  {
+    const psramTotal   = telemetryData.summary.mem.psram.total;
+    const psramFree    = telemetryData.summary.mem.psram.free;
+    const psramUsed    = psramTotal - psramFree;
+    const psramUsedPct = telemetryData.summary.mem.psram.usedPct;
+
+    // Show PSRAM section
+    psramSection.classList.remove('hidden');
+
+    // Update text elements
+    const psramUsedPctEl = document.getElementById('psramUsedPct');
+    const psramFreeEl    = document.getElementById('psramFree');
+    const psramUsedEl    = document.getElementById('psramUsed');
+    const psramTotalEl   = document.getElementById('psramTotal');
+
+    psramUsedPctEl.textContent = `${psramUsedPct.toFixed(1)} %`;
+    psramFreeEl.textContent    = formatSize(psramFree, 'kb', true);
+    psramFreeEl.setAttribute('aria-label', formatSize(psramFree, 'bytes', true));
+    psramFreeEl.setAttribute('role', 'tooltip');
+    psramFreeEl.setAttribute('data-microtip-position', 'bottom');
+    psramUsedEl.textContent    = formatSize(psramUsed, 'kb', true);
+    psramUsedEl.setAttribute('aria-label', formatSize(psramUsed, 'bytes', true));
+    psramUsedEl.setAttribute('role', 'tooltip');
+    psramUsedEl.setAttribute('data-microtip-position', 'bottom');
+    psramTotalEl.textContent   = formatSize(psramTotal, 'kb', true);
+    psramTotalEl.setAttribute('aria-label', formatSize(psramTotal, 'bytes', true));
+    psramTotalEl.setAttribute('role', 'tooltip');
+    psramTotalEl.setAttribute('data-microtip-position', 'bottom-left');
+
+    // Update usage progress bar (green for used, grey background for free)
+    const psramUsedBar = document.getElementById('psramUsedBar');
+    const psramUsedContainer = psramUsedBar ? psramUsedBar.closest('.progress-container') : null;
+    if (psramUsedBar)
     {
-      const psramTotal   = telemetryData.summary.mem.psram.total;
-      const psramFree    = telemetryData.summary.mem.psram.free;
-      const psramUsed    = psramTotal - psramFree;
-      const psramUsedPct = telemetryData.summary.mem.psram.usedPct;
-
-      // Show PSRAM section
-      psramSection.classList.remove('hidden');
-
-      // Update text elements
-      const psramUsedPctEl = document.getElementById('psramUsedPct');
-      const psramFreeEl    = document.getElementById('psramFree');
-      const psramUsedEl    = document.getElementById('psramUsed');
-      const psramTotalEl   = document.getElementById('psramTotal');
-
-      psramUsedPctEl.textContent = `${psramUsedPct.toFixed(1)} %`;
-      psramFreeEl.textContent    = formatSize(psramFree, 'kb', true);
-      psramFreeEl.setAttribute('aria-label', formatSize(psramFree, 'bytes', true));
-      psramFreeEl.setAttribute('role', 'tooltip');
-      psramFreeEl.setAttribute('data-microtip-position', 'bottom');
-      psramUsedEl.textContent    = formatSize(psramUsed, 'kb', true);
-      psramUsedEl.setAttribute('aria-label', formatSize(psramUsed, 'bytes', true));
-      psramUsedEl.setAttribute('role', 'tooltip');
-      psramUsedEl.setAttribute('data-microtip-position', 'bottom');
-      psramTotalEl.textContent   = formatSize(psramTotal, 'kb', true);
-      psramTotalEl.setAttribute('aria-label', formatSize(psramTotal, 'bytes', true));
-      psramTotalEl.setAttribute('role', 'tooltip');
-      psramTotalEl.setAttribute('data-microtip-position', 'bottom-left');
-
-      // Update usage progress bar (green for used, grey background for free)
-      const psramUsedBar = document.getElementById('psramUsedBar');
-      const psramUsedContainer = psramUsedBar ? psramUsedBar.closest('.progress-container') : null;
-      if (psramUsedBar)
+      updatePsramProgressBar(psramUsedBar, psramUsedPct);
+      // Update tooltip with used/free/total on container
+      if (psramUsedContainer)
       {
-        updatePsramProgressBar(psramUsedBar, psramUsedPct);
-        // Update tooltip with used/free/total on container
-        if (psramUsedContainer)
-        {
-          psramUsedContainer.setAttribute('aria-label', `PSRAM: ${formatSize(psramUsed, 'bytes', true)} used (${psramUsedPct.toFixed(1)}%), ${formatSize(psramFree, 'bytes', true)} free, ${formatSize(psramTotal, 'bytes', true)} total`);
-          psramUsedContainer.setAttribute('role', 'tooltip');
-          psramUsedContainer.setAttribute('data-microtip-position', 'bottom');
-        }
+        psramUsedContainer.setAttribute('aria-label', `PSRAM: ${formatSize(psramUsed, 'bytes', true)} used (${psramUsedPct.toFixed(1)}%), ${formatSize(psramFree, 'bytes', true)} free, ${formatSize(psramTotal, 'bytes', true)} total`);
+        psramUsedContainer.setAttribute('role', 'tooltip');
+        psramUsedContainer.setAttribute('data-microtip-position', 'bottom');
       }
     }
-    else
-    {
-      psramSection.classList.add('hidden');
-    }
-
-    // Detect task changes: if new tasks appeared or tasks disappeared, refresh table immediately
-    const previousTaskNames = AppState.data.lastTelemetryTaskNames;
-    const hasNewTasks       = [...currentTaskNames].some(name => !previousTaskNames.has(name));
-    const hasRemovedTasks   = [...previousTaskNames].some(name => !currentTaskNames.has(name));
+  }
+  else
+  {
+    psramSection.classList.add('hidden');
+  }
 
-    if (hasNewTasks || hasRemovedTasks)
-    {
-      // Task was added or removed - refresh table immediately to show current state
-      updateTable();
-    }
+  // Detect task changes: if new tasks appeared or tasks disappeared, refresh table immediately
+  const previousTaskNames = AppState.data.lastTelemetryTaskNames;
+  const hasNewTasks       = [...currentTaskNames].some(name => !previousTaskNames.has(name));
+  const hasRemovedTasks   = [...previousTaskNames].some(name => !currentTaskNames.has(name));
 
-    // Update tracked task names for next comparison
-    AppState.data.lastTelemetryTaskNames = new Set(currentTaskNames);
+  if (hasNewTasks || hasRemovedTasks)
+  {
+    // Task was added or removed - refresh table immediately to show current state
+    updateTable();
+  }
 
-      // Update charts with new telemetry data
-      updateCharts(telemetryData.current, currentTaskNames);
+  // Update tracked task names for next comparison
+  AppState.data.lastTelemetryTaskNames = new Set(currentTaskNames);
 
-      // Update table rows for registered tasks with telemetry data
-      updateTableRowsFromTelemetry(telemetryData.current);
-    }
-    else
-    {
-      // When paused, still update chart data but don't trigger visual update
-      // This allows data to accumulate in the background
-      updateCharts(telemetryData.current, currentTaskNames);
-    }
+    // Update charts with new telemetry data
+    updateCharts(telemetryData.current, currentTaskNames);
+    updateCustomChart(telemetryData.custom);
 
-    updateStatusPopup();
+    // Update table rows for registered tasks with telemetry data
+    updateTableRowsFromTelemetry(telemetryData.current);
   }
-  catch (error)
+  else
   {
-    AppState.status.consecutiveFailures++;
-    updateStatusPopup();
+    // When paused, still update chart data but don't trigger visual update
+    // This allows data to accumulate in the background
+    updateCharts(telemetryData.current, currentTaskNames);
+    updateCustomChart(telemetryData.custom);
   }
+
+  updateStatusPopup();
 }
 
 // Application startup (entry point)
@@ -480,10 +480,9 @@ function createCpuChart(initialData)
   {
     AppState.ui.isHoveringCpu = false;
     // Immediately update both charts with accumulated data if neither is now hovered and app is not paused
-    if (!AppState.ui.isHoveringMemory && !AppState.ui.isPaused)
+    if (!AppState.ui.isHoveringMemory && !AppState.ui.isHoveringCustom && !AppState.ui.isPaused)
     {
-      AppState.charts.cpu.update('none');
-      AppState.charts.memory.update('none');
+      refreshCharts();
     }
     updateStatusPopup();
   });
@@ -574,10 +573,9 @@ function createMemoryChart(initialData)
   {
     AppState.ui.isHoveringMemory = false;
     // Immediately update both charts with accumulated data if neither is now hovered and app is not paused
-    if (!AppState.ui.isHoveringCpu && !AppState.ui.isPaused)
+    if (!AppState.ui.isHoveringCpu && !AppState.ui.isHoveringCustom && !AppState.ui.isPaused)
     {
-      AppState.charts.cpu.update('none');
-      AppState.charts.memory.update('none');
+      refreshCharts();
     }
     updateStatusPopup();
   });
@@ -745,13 +743,176 @@ function updateCharts(telemetryCurrent, currentTaskNames)
   }
   AppState.charts.memory.data.labels = generateTimeLabels();
   
-  // Only update visual display if neither chart is being hovered and not paused
-  const isAnyChartHovered = AppState.ui.isHoveringCpu || AppState.ui.isHoveringMemory || AppState.ui.isPaused;
-  if (!isAnyChartHovered)
+  // Only update visual display if no chart is being hovered and not paused
+  if (!isChartDisplayFrozen())
   {
     AppState.charts.cpu.update('none');
     AppState.charts.memory.update('none');
   }
 }
 
+/**
+ * Check whether chart redraws are held back (a chart is hovered or updates are paused).
+ *
+ * @returns {boolean} True if charts should only accumulate data.
+ */
+function isChartDisplayFrozen()
+{
+  return AppState.ui.isHoveringCpu || AppState.ui.isHoveringMemory || AppState.ui.isHoveringCustom ||
+         AppState.ui.isPaused;
+}
+
+/**
+ * Redraw every chart with the data accumulated so far.
+ */
+function refreshCharts()
+{
+  AppState.charts.cpu.update('none');
+  AppState.charts.memory.update('none');
+  if (AppState.charts.custom)
+  {
+    AppState.charts.custom.update('none');
+  }
+}
+
+/**
+ * Convert a custom metric sample to its charted value.
+ *
+ * Counters are sent as the increase over one sampling interval and charted as
+ * a rate per second; gauges are charted as they are.
+ *
+ * @param {string} type - 'counter' or 'gauge'.
+ * @param {number} value - Sample value from the device.
+ * @returns {number} Charted value.
+ */
+function customMetricChartValue(type, value)
+{
+  if (type === 'counter')
+  {
+    return value * 1000 / CHART_TELEMETRY_UPDATE_INTERVAL_MS;
+  }
+  return value;
+}
+
+/**
+ * Create the custom metrics chart dataset for one metric.
+ *
+ * @param {string} name - Metric name.
+ * @param {string} type - 'counter' or 'gauge'.
+ * @param {Array<number>} data - Charted values, oldest first.
+ * @returns {Object} Chart.js dataset configuration object.
+ */
+function createCustomDataset(name, type, data)
+{
+  const dataset = createChartDataset(name, data);
+  dataset.label = type === 'counter' ? `${name} /s` : name;
+  dataset.metricName = name;
+  dataset.metricType = type;
+  return dataset;
+}
+
+/**
+ * Create the custom metrics chart with initial history.
+ *
+ * Charts every application-defined metric registered with sysmon_metric_register()
+ * on a shared axis: counters as a rate per second, gauges as their value. The
+ * panel stays hidden while the firmware reports no metrics; a metric registered
+ * later is added by updateCustomChart().
+ *
+ * @param {Object} initialData - { metricName: { type, value: [samples...] } } from /history.bin.
+ */
+function createCustomChart(initialData)
+{
+  const canvasContext = document.getElementById('customChart').getContext('2d');
+  const metrics = initialData && typeof initialData === 'object' ? initialData : {};
+
+  const datasets = Object.entries(metrics).map(([name, metric]) => {
+    const values = Array.isArray(metric.value) ? metric.value : [];
+    return createCustomDataset(name, metric.type, values.map(v => customMetricChartValue(metric.type, v)));
+  });
+
+  const tooltipCallbacks = createTooltipCallbacks(function(context)
+  {
+    const label = context.dataset.label || '';
+    const value = context.parsed.y;
+    if (value === null || value === undefined)
+    {
+      return label;
+    }
+    const valueString = Number.isInteger(value) ? String(value) : value.toFixed(2);
+    return label
+      ? `(${valueString}) ${label}`
+      : `(${valueString})`;
+  });
+
+  const yAxisConfig = {
+    max  : undefined,
+    label: 'Value'
+  };
+
+  AppState.charts.custom = new Chart(canvasContext, {
+    type: 'line',
+    data: {
+      labels  : generateTimeLabels(),
+      datasets: datasets
+    },
+    options: getBaseChartOptions(yAxisConfig, tooltipCallbacks, 'custom')
+  });
+  document.getElementById('customMetricsPanel').classList.toggle('hidden', datasets.length === 0);
+
+  const customCanvas = document.getElementById('customChart');
+  customCanvas.addEventListener('mouseenter', () =>
+  {
+    AppState.ui.isHoveringCustom = true;
+    updateStatusPopup();
+  });
+  customCanvas.addEventListener('mouseleave', () =>
+  {
+    AppState.ui.isHoveringCustom = false;
+    if (!AppState.ui.isHoveringCpu && !AppState.ui.isHoveringMemory && !AppState.ui.isPaused)
+    {
+      refreshCharts();
+    }
+    updateStatusPopup();
+  });
+}
+
+/**
+ * Append the newest custom metric values to the custom metrics chart.
+ *
+ * Adds a dataset (and shows the panel) for metrics that appear after page load.
+ * Metrics cannot be removed on the device, so datasets are never dropped.
+ *
+ * @param {Object} customCurrent - { metricName: { type, value } } from the telemetry payload.
+ */
+function updateCustomChart(customCurrent)
+{
+  const chart = AppState.charts.custom;
+  if (!chart || !customCurrent)
+  {
+    return;
+  }
+
+  for (const [name, metric] of Object.entries(customCurrent))
+  {
+    let dataset = chart.data.datasets.find(d => d.metricName === name);
+    if (!dataset)
+    {
+      dataset = createCustomDataset(name, metric.type, Array(CHART_SAMPLE_COUNT - 1).fill(0));
+      chart.data.datasets.push(dataset);
+      document.getElementById('customMetricsPanel').classList.remove('hidden');
+    }
+    dataset.data.push(customMetricChartValue(metric.type, metric.value));
+    if (dataset.data.length > CHART_SAMPLE_COUNT)
+    {
+      dataset.data.shift();
+    }
+  }
+
+  if (!isChartDisplayFrozen())
+  {
+    chart.update('none');
+  }
+}
+
 
@@ -1,13 +1,35 @@
 // API and networking constants
 const API_ROUTES = {
-  HISTORY   : '/history',
-  TELEMETRY : '/telemetry',
-  TASKS     : '/tasks',
-  HARDWARE  : '/hardware'
+  HISTORY       : '/history',
+  TELEMETRY     : '/telemetry',
+  TASKS         : '/tasks',
+  HARDWARE      : '/hardware',
+  HISTORY_BIN   : '/history.bin',
+  TELEMETRY_BIN : '/telemetry.bin',
+  PUSH          : '/ws'
+};
+
+// Packed binary endpoint format (see include/sysmon_binary.h)
+const BINARY_FORMAT = {
+  MAGIC          : 'SYSM',
+  VERSION        : 3,
+  KIND_TELEMETRY : 1,
+  KIND_HISTORY   : 2,
+  END_OF_TASKS   : 0xFF,
+  METRIC_COUNTER : 0,    // Custom metric types (see include/sysmon_custom.h)
+  METRIC_GAUGE   : 1,
+  PERCENT_SCALE  : 100,  // Percentages are sent as uint16 hundredths of a percent
+  NO_PERCENT     : 0xFFFF,      // History "no value" markers (sample overwritten while sending)
+  NO_U32         : 0xFFFFFFFF,
+  NO_I32         : -0x80000000
 };
 
 const TELEMETRY_TIMEOUT_MS = 4000;
 
+// WebSocket push channel (enabled from hardware endpoint config.pushEnabled)
+let PUSH_ENABLED = false;
+const PUSH_RECONNECT_DELAY_MS = 5000;
+
 // Chart configuration constants (defaults, will be overridden from hardware endpoint)
 let CHART_SAMPLE_COUNT                  = 100;
 let CHART_TELEMETRY_UPDATE_INTERVAL_MS  = 1000;
@@ -172,7 +194,8 @@ const PARTITION_DESCRIPTIONS = {
 const AppState = {
   charts: {
     cpu   : null,  // Chart.js instance for CPU
-    memory: null   // Chart.js instance for Memory
+    memory: null,  // Chart.js instance for Memory
+    custom: null   // Chart.js instance for custom metrics (created once metrics exist)
   },
   filters: {
     hideLowUsage    : true, // Whether to hide low-utilization datasets
@@ -184,6 +207,10 @@ const AppState = {
     taskInfo       : {},         // Cached task info data for calculating percentages
     lastTelemetryTaskNames: new Set() // Track task names from last telemetry to detect changes
   },
+  push: {
+    socket           : null,  // Open WebSocket on API_ROUTES.PUSH (null when polling)
+    telemetryTimerId : null   // setInterval id of the telemetry polling fallback
+  },
   ui: {
     tableSorter: {
       tasks     : null,  // Tablesort instance for task table
@@ -191,12 +218,14 @@ const AppState = {
     },
     isHoveringCpu    : false, // True when mouse is over CPU chart
     isHoveringMemory : false, // True when mouse is over memory chart
+    isHoveringCustom : false, // True when mouse is over custom metrics chart
     isPaused         : false  // True when updates are paused
   },
   status: {
     lastTelemetrySuccess: null,  // Timestamp of last successful telemetry fetch
     lastTableSuccess    : null,  // Timestamp of last successful table fetch
     consecutiveFailures : 0,     // Count of consecutive API failures
+    samplingGeneration  : null,  // Low byte of the sampling generation the charts were built for
     currentStatus       : null   // Current status message type
   }
 };
@@ -141,6 +141,38 @@ function updateTableRowStack(row, taskCurrent, taskName)
   }
 }
 
+/**
+ * Update scheduler trace columns in a table row from telemetry data.
+ *
+ * Only present when the firmware is built with CONFIG_SYSMON_TRACE; the columns
+ * stay hidden otherwise (see updateTableRowsFromTelemetry()).
+ *
+ * @param {HTMLElement} row - The table row element to update.
+ * @param {Object} taskCurrent - The telemetry data for the current task.
+ */
+function updateTableRowTrace(row, taskCurrent)
+{
+  const trace = taskCurrent.trace;
+
+  const switchRateCell = row.querySelector('[data-column="ctx-switch-rate"]');
+  if (switchRateCell)
+  {
+    switchRateCell.textContent = trace ? trace.switchRate.toFixed(1) : '-';
+  }
+
+  const preemptionsCell = row.querySelector('[data-column="preemptions"]');
+  if (preemptionsCell)
+  {
+    preemptionsCell.textContent = trace ? trace.preemptions : '-';
+  }
+
+  const latencyCell = row.querySelector('[data-column="ready-latency"]');
+  if (latencyCell)
+  {
+    latencyCell.textContent = trace ? `${trace.readyLatencyMaxUs} µs` : '-';
+  }
+}
+
 /**
  * Create a new table row for a task.
  *
@@ -283,6 +315,16 @@ function createTableRow(taskName, taskInfo)
   usagePctCell.textContent = stackPct.display;
   row.appendChild(usagePctCell);
 
+  // Scheduler trace cells - show '-' initially (will be updated by telemetry)
+  for (const column of ['ctx-switch-rate', 'preemptions', 'ready-latency'])
+  {
+    const traceCell = document.createElement('td');
+    traceCell.className = 'panel-table-cell text-right trace-column';
+    traceCell.setAttribute('data-column', column);
+    traceCell.textContent = '-';
+    row.appendChild(traceCell);
+  }
+
   return row;
 }
 
@@ -396,6 +438,14 @@ function updateTableRowsFromTelemetry(telemetryCurrent)
     return;
   }
 
+  // Show the trace columns only when the firmware reports trace data
+  const table = document.getElementById('taskTable');
+  const traceEnabled = Object.values(telemetryCurrent).some(task => task.trace !== undefined);
+  if (table)
+  {
+    table.classList.toggle('trace-enabled', traceEnabled);
+  }
+
   const rows = tbody.querySelectorAll('tr');
   for (const row of rows)
   {
@@ -420,6 +470,10 @@ function updateTableRowsFromTelemetry(telemetryCurrent)
 
     // Update CPU columns for all tasks (including system tasks)
     updateTableRowCpu(row, taskCurrent);
+    if (traceEnabled)
+    {
+      updateTableRowTrace(row, taskCurrent);
+    }
 
     // Only update stack-related columns for registered tasks
     if (AppState.data.registeredTasks.has(taskName))
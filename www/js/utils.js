@@ -696,6 +696,10 @@ async function updateHardwareInfo()
       {
         CHART_SAMPLE_COUNT = hardwareData.config.sampleCount;
       }
+      if (hardwareData.config.pushEnabled !== undefined)
+      {
+        PUSH_ENABLED = hardwareData.config.pushEnabled;
+      }
     }
 
     // Update chip information